@@ -0,0 +1,105 @@
+// Measures the compression ratio and throughput of writing tile compressed images with
+// fits_writer (Rice for 16 bit integer pixels, quantization and Rice for float pixels) and of
+// decompressing them with fits::read_compressed_image.
+//
+// usage: benchmark_fits_compress [image size] [iterations] [threads]
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include <boost/astronomy/io/fits.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+
+namespace {
+
+template <typename Function>
+double time_per_iteration(int iterations, Function function)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        function();
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+double file_size(std::string const& path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return static_cast<double>(file.tellg());
+}
+
+template <boost::astronomy::io::bitpix DataType>
+void measure
+(
+    char const* name,
+    boost::astronomy::io::image<DataType> const& frame,
+    int iterations,
+    std::size_t threads
+)
+{
+    using namespace boost::astronomy::io;
+
+    std::string const path = "benchmark_fits_compress.fits";
+    std::size_t const pixels = frame.get_width() * frame.get_height();
+    double const megabytes = static_cast<double>(pixels * bitpix_size(DataType)) / (1 << 20);
+
+    compression_options options;
+    options.threads = threads;
+    double write = time_per_iteration(iterations, [&]() {
+        fits_writer writer(path);
+        writer.write_primary_hdu();
+        writer.write_compressed_image(frame, {}, {}, options);
+        writer.close();
+    });
+    double const compressed = file_size(path) - 2880;
+
+    double read = time_per_iteration(iterations, [&]() {
+        fits file(path);
+        image<DataType> restored = file.read_compressed_image<DataType>(1, {}, threads);
+    });
+
+    std::cout << name << ": ratio " << megabytes * (1 << 20) / compressed
+        << ", compress " << write << " ms (" << megabytes * 1000 / write << " MiB/s)"
+        << ", decompress " << read << " ms (" << megabytes * 1000 / read << " MiB/s)\n";
+
+    std::remove(path.c_str());
+}
+
+} //namespace
+
+int main(int argc, char* argv[])
+{
+    using namespace boost::astronomy::io;
+
+    std::size_t const size = argc > 1 ? static_cast<std::size_t>(std::atoi(argv[1])) : 2048;
+    int const iterations = argc > 2 ? std::atoi(argv[2]) : 5;
+    std::size_t const threads = argc > 3 ? static_cast<std::size_t>(std::atoi(argv[3])) : 0;
+
+    //sky background with gaussian noise and a gradient, as in a calibrated exposure
+    std::mt19937 generator(42);
+    std::normal_distribution<double> noise(0, 12);
+    image<bitpix::B16> counts(size, size);
+    image<bitpix::_B32> flux(size, size);
+    for (std::size_t y = 0; y < size; y++)
+    {
+        for (std::size_t x = 0; x < size; x++)
+        {
+            double const value = 1000 + static_cast<double>(x + y) * 0.01 + noise(generator);
+            counts.pixels()[y * size + x] = static_cast<std::int16_t>(value);
+            flux.pixels()[y * size + x] = static_cast<float>(value * 0.25);
+        }
+    }
+
+    std::cout << size << " x " << size << " pixels, tiles of one row\n";
+    measure("B16 RICE_1", counts, iterations, threads);
+    measure("_B32 SUBTRACTIVE_DITHER_1 RICE_1", flux, iterations, threads);
+    return 0;
+}
@@ -0,0 +1,160 @@
+// Measures the time to read every image extension of many FITS files with image::read_image
+// (one file after another and files on all the cores) and with batch_read_images on the pool
+// of pread threads and on io_uring when it is available.
+// Files are read from page cache after the first iteration, drop the caches between runs
+// (echo 3 > /proc/sys/vm/drop_caches) to measure reads from the device.
+//
+// usage: benchmark_fits_ingest [files] [extensions] [image size] [iterations] [queue depth]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/astronomy/detail/parallel.hpp>
+#include <boost/astronomy/io/batch_reader.hpp>
+#include <boost/astronomy/io/fits.hpp>
+
+namespace {
+
+std::string card(std::string const& key, std::string const& value)
+{
+    std::string result = key;
+    result.resize(8, ' ');
+    result += "= " + value;
+    result.resize(80, ' ');
+    return result;
+}
+
+void write_header(std::ofstream& file, std::string header)
+{
+    header += "END" + std::string(77, ' ');
+    header.resize(header.size() + (2880 - header.size() % 2880) % 2880, ' ');
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+}
+
+//primary HDU without data followed by extensions of size x size 32 bit float images
+void write_exposure(std::string const& path, int extensions, int size)
+{
+    std::ofstream file(path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    write_header(file, card("SIMPLE", "T") + card("BITPIX", "8") + card("NAXIS", "0") +
+        card("EXTEND", "T"));
+
+    std::size_t bytes = static_cast<std::size_t>(size) * static_cast<std::size_t>(size) * 4;
+    std::string const data(bytes + (2880 - bytes % 2880) % 2880, '\x3f');
+    for (int i = 1; i <= extensions; i++)
+    {
+        write_header(file, card("XTENSION", "'IMAGE   '") + card("BITPIX", "-32") +
+            card("NAXIS", "2") + card("NAXIS1", std::to_string(size)) +
+            card("NAXIS2", std::to_string(size)) + card("PCOUNT", "0") + card("GCOUNT", "1") +
+            card("EXTNAME", "'CCD" + std::to_string(i) + "'"));
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+}
+
+template <typename Function>
+double time_per_iteration(int iterations, Function function)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        function();
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+//reads every image extension of file with image::read_image, returns the sum of first pixels
+double read_with_read_image(std::string const& path)
+{
+    using namespace boost::astronomy::io;
+
+    fits file(path);
+    std::ifstream stream(path, std::ios_base::in | std::ios_base::binary);
+    double sum = 0;
+    for (hdu_entry const& entry : file.index())
+    {
+        if (entry.xtension != "IMAGE")
+        {
+            continue;
+        }
+        image<bitpix::_B32> pixels;
+        pixels.read_image(stream, entry.naxis[1], entry.naxis[2], entry.data_offset);
+        sum += pixels.pixels()[0];
+    }
+    return sum;
+}
+
+} //namespace
+
+int main(int argc, char* argv[])
+{
+    using namespace boost::astronomy::io;
+
+    int const files = argc > 1 ? std::atoi(argv[1]) : 64;
+    int const extensions = argc > 2 ? std::atoi(argv[2]) : 4;
+    int const size = argc > 3 ? std::atoi(argv[3]) : 1024;
+    int const iterations = argc > 4 ? std::atoi(argv[4]) : 3;
+    std::size_t const queue_depth =
+        argc > 5 ? static_cast<std::size_t>(std::atoi(argv[5])) : 64;
+
+    std::vector<std::string> paths;
+    for (int i = 0; i < files; i++)
+    {
+        paths.push_back("benchmark_fits_ingest_" + std::to_string(i) + ".fits");
+        write_exposure(paths.back(), extensions, size);
+    }
+    double const mib = static_cast<double>(files) * extensions * size * size * 4 / (1 << 20);
+
+    std::cout << files << " files of " << extensions << " extensions of " << size << " x "
+        << size << " float pixels (" << mib << " MiB)\n";
+    auto report = [&](char const* name, double milliseconds)
+    {
+        std::cout << name << milliseconds << " ms (" << mib * 1000 / milliseconds
+            << " MiB/s)\n";
+    };
+
+    double sum = 0;
+    report("read_image, sequential:         ", time_per_iteration(iterations, [&]() {
+        for (std::string const& path : paths)
+        {
+            sum += read_with_read_image(path);
+        }
+    }));
+    report("read_image, file per core:      ", time_per_iteration(iterations, [&]() {
+        std::vector<double> sums(paths.size());
+        boost::astronomy::detail::parallel_for(paths.size(), 0, [&](std::size_t i)
+        {
+            sums[i] = read_with_read_image(paths[i]);
+        });
+        sum += sums[0];
+    }));
+
+    std::vector<io_backend> backends = {io_backend::thread_pool};
+    if (boost::astronomy::detail::io_uring_supported())
+    {
+        backends.push_back(io_backend::io_uring);
+    }
+    for (io_backend backend : backends)
+    {
+        batch_read_options options;
+        options.backend = backend;
+        options.queue_depth = queue_depth;
+        report(backend == io_backend::io_uring ? "batch_read_images, io_uring:    " :
+            "batch_read_images, thread_pool: ", time_per_iteration(iterations, [&]() {
+            batch_read_images(paths, [&](batch_image const&, auto& image)
+            {
+                sum += image.pixels()[0];
+            }, options);
+        }));
+    }
+
+    for (std::string const& path : paths)
+    {
+        std::remove(path.c_str());
+    }
+    return sum > 0 ? 0 : 1;
+}
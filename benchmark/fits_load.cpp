@@ -0,0 +1,104 @@
+// Measures the time to read all the image extensions of a multi-extension FITS file
+// one after another and concurrently with positioned reads on different number of threads.
+//
+// usage: benchmark_fits_load [extensions] [image size] [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/astronomy/io/fits.hpp>
+
+namespace {
+
+std::string card(std::string const& key, std::string const& value)
+{
+    std::string result = key;
+    result.resize(8, ' ');
+    result += "= " + value;
+    result.resize(80, ' ');
+    return result;
+}
+
+void write_header(std::ofstream& file, std::string header)
+{
+    header += "END" + std::string(77, ' ');
+    header.resize(header.size() + (2880 - header.size() % 2880) % 2880, ' ');
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+}
+
+//primary HDU without data followed by extensions of size x size 32 bit float images
+void write_mosaic(std::string const& path, int extensions, int size)
+{
+    std::ofstream file(path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    write_header(file, card("SIMPLE", "T") + card("BITPIX", "8") + card("NAXIS", "0") +
+        card("EXTEND", "T"));
+
+    std::size_t bytes = static_cast<std::size_t>(size) * static_cast<std::size_t>(size) * 4;
+    std::string const data(bytes + (2880 - bytes % 2880) % 2880, '\x3f');
+    for (int i = 1; i <= extensions; i++)
+    {
+        write_header(file, card("XTENSION", "'IMAGE   '") + card("BITPIX", "-32") +
+            card("NAXIS", "2") + card("NAXIS1", std::to_string(size)) +
+            card("NAXIS2", std::to_string(size)) + card("PCOUNT", "0") + card("GCOUNT", "1") +
+            card("EXTNAME", "'CCD" + std::to_string(i) + "'"));
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+}
+
+template <typename Function>
+double time_per_iteration(int iterations, Function function)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        function();
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+} //namespace
+
+int main(int argc, char* argv[])
+{
+    using namespace boost::astronomy::io;
+
+    int const extensions = argc > 1 ? std::atoi(argv[1]) : 62;
+    int const size = argc > 2 ? std::atoi(argv[2]) : 1024;
+    int const iterations = argc > 3 ? std::atoi(argv[3]) : 5;
+
+    std::string const path = "benchmark_fits_load.fits";
+    write_mosaic(path, extensions, size);
+
+    double sequential = time_per_iteration(iterations, [&]() {
+        fits file(path);
+        file.read_extensions();
+    });
+    std::cout << extensions << " extensions of " << size << " x " << size << " float pixels\n"
+        << "read_extensions:                " << sequential << " ms\n";
+
+    std::vector<std::size_t> threads = {1, 2, 4, 8};
+    unsigned cores = std::thread::hardware_concurrency();
+    if (cores > 8)
+    {
+        threads.push_back(cores);
+    }
+    for (std::size_t count : threads)
+    {
+        double parallel = time_per_iteration(iterations, [&]() {
+            fits file(path);
+            file.read_extensions_parallel(count);
+        });
+        std::cout << "read_extensions_parallel(" << count << "): " << parallel << " ms ("
+            << sequential / parallel << "x)\n";
+    }
+
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,101 @@
+// Measures the time to reopen a multi-extension FITS file and read one extension
+// when the HDU index is built by scanning the headers and when it is read from a sidecar.
+//
+// usage: benchmark_fits_open [extensions] [cards per header] [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <boost/astronomy/io/fits.hpp>
+
+namespace {
+
+std::string card(std::string const& key, std::string const& value)
+{
+    std::string result = key;
+    result.resize(8, ' ');
+    result += "= " + value;
+    result.resize(80, ' ');
+    return result;
+}
+
+void write_header(std::ofstream& file, std::string header)
+{
+    header += "END" + std::string(77, ' ');
+    header.resize(header.size() + (2880 - header.size() % 2880) % 2880, ' ');
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+}
+
+//primary HDU without data followed by extensions of 512 x 512 16 bit images
+void write_mosaic(std::string const& path, int extensions, int cards)
+{
+    std::ofstream file(path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    write_header(file, card("SIMPLE", "T") + card("BITPIX", "8") + card("NAXIS", "0") +
+        card("EXTEND", "T"));
+
+    std::string const data(512 * 512 * 2 + (2880 - 512 * 512 * 2 % 2880), '\0');
+    for (int i = 1; i <= extensions; i++)
+    {
+        std::string header = card("XTENSION", "'IMAGE   '") + card("BITPIX", "16") +
+            card("NAXIS", "2") + card("NAXIS1", "512") + card("NAXIS2", "512") +
+            card("PCOUNT", "0") + card("GCOUNT", "1") +
+            card("EXTNAME", "'CCD" + std::to_string(i) + "'");
+        for (int j = 0; j < cards; j++)
+        {
+            header += card("KEY" + std::to_string(j), std::to_string(j * 0.5));
+        }
+        write_header(file, header);
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+}
+
+template <typename Function>
+double time_per_iteration(int iterations, Function function)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        function();
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+} //namespace
+
+int main(int argc, char* argv[])
+{
+    using namespace boost::astronomy::io;
+
+    int const extensions = argc > 1 ? std::atoi(argv[1]) : 62;
+    int const cards = argc > 2 ? std::atoi(argv[2]) : 200;
+    int const iterations = argc > 3 ? std::atoi(argv[3]) : 50;
+
+    std::string const path = "benchmark_fits_open.fits";
+    std::string const sidecar = default_sidecar_path(path);
+    write_mosaic(path, extensions, cards);
+    std::remove(sidecar.c_str());
+
+    double scan = time_per_iteration(iterations, [&]() {
+        fits file(path);
+        file.get_hdu(extensions / 2);
+    });
+
+    fits(path, sidecar);
+    double cached = time_per_iteration(iterations, [&]() {
+        fits file(path, sidecar);
+        file.get_hdu(extensions / 2);
+    });
+
+    std::cout << extensions << " extensions, " << cards << " cards per header\n"
+        << "open with header scan:   " << scan << " us\n"
+        << "open with sidecar index: " << cached << " us\n";
+
+    std::remove(path.c_str());
+    std::remove(sidecar.c_str());
+    return 0;
+}
@@ -0,0 +1,90 @@
+// Measures the time to convert big-endian pixels held in memory to physical float values
+// (BZERO + BSCALE * stored value) by decoding them to native byte order first and scaling
+// them in a second pass, and by big_to_physical which does both in a single pass.
+//
+// usage: benchmark_fits_physical [pixels] [iterations]
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <boost/astronomy/detail/byteswap.hpp>
+#include <boost/astronomy/detail/physical.hpp>
+
+namespace {
+
+template <typename Function>
+double time_per_iteration(int iterations, Function function)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        function();
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+//converts stored pixels of type Raw with a byte order pass followed by a scaling pass
+template <typename Raw>
+void two_passes(std::vector<char> const& bytes, std::vector<Raw>& native,
+    std::vector<float>& physical, boost::astronomy::io::pixel_scaling const& scaling)
+{
+    boost::astronomy::detail::big_to_native_copy(bytes.data(), native.data(), native.size());
+    float const scale = static_cast<float>(scaling.bscale);
+    float const zero = static_cast<float>(scaling.bzero);
+    for (std::size_t i = 0; i < native.size(); i++)
+    {
+        physical[i] = static_cast<float>(native[i]) * scale + zero;
+    }
+}
+
+template <typename Raw>
+void run(char const* name, std::size_t pixels, int iterations,
+    boost::astronomy::io::pixel_scaling const& scaling)
+{
+    std::vector<char> bytes(pixels * sizeof(Raw));
+    for (std::size_t i = 0; i < bytes.size(); i++)
+    {
+        bytes[i] = static_cast<char>(i * 131);
+    }
+    std::vector<Raw> native(pixels);
+    std::vector<float> physical(pixels);
+    double const mib = static_cast<double>(bytes.size()) / (1 << 20);
+
+    auto report = [&](char const* method, double milliseconds)
+    {
+        std::cout << name << method << milliseconds << " ms (" << mib * 1000 / milliseconds
+            << " MiB/s)\n";
+    };
+    report(", two passes: ", time_per_iteration(iterations, [&]() {
+        two_passes(bytes, native, physical, scaling);
+    }));
+    report(", single pass: ", time_per_iteration(iterations, [&]() {
+        boost::astronomy::detail::big_to_physical<Raw>(bytes.data(), physical.data(), pixels,
+            scaling);
+    }));
+}
+
+} //namespace
+
+int main(int argc, char* argv[])
+{
+    std::size_t const pixels =
+        argc > 1 ? static_cast<std::size_t>(std::atoll(argv[1])) : std::size_t(16) << 20;
+    int const iterations = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    boost::astronomy::io::pixel_scaling unsigned_16;
+    unsigned_16.bzero = 32768;
+    boost::astronomy::io::pixel_scaling scaled;
+    scaled.bscale = 0.25;
+    scaled.bzero = 100;
+
+    std::cout << pixels << " pixels\n";
+    run<std::int16_t>("BITPIX 16, BZERO 32768", pixels, iterations, unsigned_16);
+    run<std::uint8_t>("BITPIX 8, BSCALE 0.25", pixels, iterations, scaled);
+    run<std::int32_t>("BITPIX 32, BSCALE 0.25", pixels, iterations, scaled);
+    return 0;
+}
@@ -0,0 +1,92 @@
+// Measures the throughput of writing a multi-extension FITS file of float images with
+// fits_writer and async_fits_writer and compares it with reading the same file back with fits.
+//
+// usage: benchmark_fits_write [extensions] [image size] [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <boost/astronomy/io/fits.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/io/async_fits_writer.hpp>
+
+namespace {
+
+template <typename Function>
+double time_per_iteration(int iterations, Function function)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        function();
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+} //namespace
+
+int main(int argc, char* argv[])
+{
+    using namespace boost::astronomy::io;
+
+    int const extensions = argc > 1 ? std::atoi(argv[1]) : 62;
+    std::size_t const size = argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2])) : 1024;
+    int const iterations = argc > 3 ? std::atoi(argv[3]) : 5;
+
+    image<bitpix::_B32> frame(size, size);
+    for (std::size_t i = 0; i < size * size; i++)
+    {
+        frame.pixels()[i] = static_cast<float>(i % 65536) * 0.5f;
+    }
+
+    std::string const path = "benchmark_fits_write.fits";
+    double const megabytes = static_cast<double>(extensions) * static_cast<double>(size * size) *
+        4 / (1 << 20);
+
+    double write = time_per_iteration(iterations, [&]() {
+        fits_writer writer(path);
+        writer.write_primary_hdu();
+        for (int i = 1; i <= extensions; i++)
+        {
+            writer.write_image_extension(frame,
+                {card("EXTNAME", "'CCD" + std::to_string(i) + "'")});
+        }
+        writer.close();
+    });
+
+    //time until the caller can continue and time until the file is complete
+    double handoff = 0;
+    double async_write = time_per_iteration(iterations, [&]() {
+        auto start = std::chrono::steady_clock::now();
+        async_fits_writer writer(path);
+        writer.write_primary_hdu();
+        for (int i = 1; i <= extensions; i++)
+        {
+            writer.write_image_extension(frame,
+                {card("EXTNAME", "'CCD" + std::to_string(i) + "'")});
+        }
+        std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+        handoff += elapsed.count() / iterations;
+        writer.close();
+    });
+
+    double read = time_per_iteration(iterations, [&]() {
+        fits file(path);
+        file.read_extensions();
+    });
+
+    std::cout << extensions << " extensions of " << size << " x " << size << " float pixels ("
+        << megabytes << " MiB)\n"
+        << "fits_writer:     " << write << " ms (" << megabytes * 1000 / write << " MiB/s)\n"
+        << "async_fits_writer: " << async_write << " ms (" << handoff
+        << " ms until all the frames are queued)\n"
+        << "read_extensions: " << read << " ms (" << megabytes * 1000 / read << " MiB/s)\n";
+
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,239 @@
+#ifndef BOOST_ASTRONOMY_DETAIL_BYTESWAP_HPP
+#define BOOST_ASTRONOMY_DETAIL_BYTESWAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <boost/endian/conversion.hpp>
+
+// The vectorized kernels are selected at compile time from the instruction sets enabled
+// for the translation unit (e.g. -mavx2, -mssse3, /arch:AVX2). Define
+// BOOST_ASTRONOMY_NO_SIMD to always use the scalar implementation.
+#if !defined(BOOST_ASTRONOMY_NO_SIMD)
+#   if defined(__AVX2__)
+#       define BOOST_ASTRONOMY_SIMD_AVX2
+#       include <immintrin.h>
+#   elif defined(__SSSE3__)
+#       define BOOST_ASTRONOMY_SIMD_SSSE3
+#       include <tmmintrin.h>
+#   elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#       define BOOST_ASTRONOMY_SIMD_SSE2
+#       include <emmintrin.h>
+#   elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#       define BOOST_ASTRONOMY_SIMD_NEON
+#       include <arm_neon.h>
+#   endif
+#endif
+
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// unsigned integer with the same size as T, used to byte swap floating point values
+template <std::size_t Size>
+struct uint_of_size {};
+
+template <>
+struct uint_of_size<1> { using type = std::uint8_t; };
+
+template <>
+struct uint_of_size<2> { using type = std::uint16_t; };
+
+template <>
+struct uint_of_size<4> { using type = std::uint32_t; };
+
+template <>
+struct uint_of_size<8> { using type = std::uint64_t; };
+
+// reads a single big-endian value of type T from unaligned memory
+template <typename T>
+inline T load_big_endian(void const* source)
+{
+    using uint_type = typename uint_of_size<sizeof(T)>::type;
+
+    uint_type bits;
+    std::memcpy(&bits, source, sizeof(T));
+    bits = boost::endian::big_to_native(bits);
+
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    return value;
+}
+
+// writes a single value of type T to unaligned memory in big-endian byte order
+template <typename T>
+inline void store_big_endian(void* destination, T value)
+{
+    using uint_type = typename uint_of_size<sizeof(T)>::type;
+
+    uint_type bits;
+    std::memcpy(&bits, &value, sizeof(T));
+    bits = boost::endian::native_to_big(bits);
+    std::memcpy(destination, &bits, sizeof(T));
+}
+
+// reverses the bytes of each of the count elements of Size bytes stored at data
+// works on raw bytes so floating point values are swapped bit-exactly
+template <std::size_t Size>
+inline void swap_bytes_scalar(unsigned char* data, std::size_t count)
+{
+    using uint_type = typename uint_of_size<Size>::type;
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        uint_type bits;
+        std::memcpy(&bits, data + i * Size, Size);
+        bits = boost::endian::endian_reverse(bits);
+        std::memcpy(data + i * Size, &bits, Size);
+    }
+}
+
+#if defined(BOOST_ASTRONOMY_SIMD_AVX2) || defined(BOOST_ASTRONOMY_SIMD_SSSE3)
+// shuffle control reversing each group of Size bytes in a 16 byte lane
+template <std::size_t Size>
+inline __m128i byte_reverse_mask()
+{
+    alignas(16) char mask[16];
+    for (int i = 0; i < 16; i++)
+    {
+        int group = i / static_cast<int>(Size) * static_cast<int>(Size);
+        mask[i] = static_cast<char>(group + static_cast<int>(Size) - 1 - (i - group));
+    }
+    return _mm_load_si128(reinterpret_cast<__m128i const*>(mask));
+}
+#endif
+
+// vectorized body of swap_bytes, returns the number of elements processed
+template <std::size_t Size>
+inline std::size_t swap_bytes_simd(unsigned char* data, std::size_t count)
+{
+    std::size_t const bytes = count * Size;
+    std::size_t i = 0;
+
+#if defined(BOOST_ASTRONOMY_SIMD_AVX2)
+    __m128i const lane_mask = byte_reverse_mask<Size>();
+    __m256i const mask = _mm256_broadcastsi128_si256(lane_mask);
+    for (; i + 32 <= bytes; i += 32)
+    {
+        __m256i* p = reinterpret_cast<__m256i*>(data + i);
+        _mm256_storeu_si256(p, _mm256_shuffle_epi8(_mm256_loadu_si256(p), mask));
+    }
+    for (; i + 16 <= bytes; i += 16)
+    {
+        __m128i* p = reinterpret_cast<__m128i*>(data + i);
+        _mm_storeu_si128(p, _mm_shuffle_epi8(_mm_loadu_si128(p), lane_mask));
+    }
+#elif defined(BOOST_ASTRONOMY_SIMD_SSSE3)
+    __m128i const mask = byte_reverse_mask<Size>();
+    for (; i + 16 <= bytes; i += 16)
+    {
+        __m128i* p = reinterpret_cast<__m128i*>(data + i);
+        _mm_storeu_si128(p, _mm_shuffle_epi8(_mm_loadu_si128(p), mask));
+    }
+#elif defined(BOOST_ASTRONOMY_SIMD_SSE2)
+    for (; i + 16 <= bytes; i += 16)
+    {
+        __m128i* p = reinterpret_cast<__m128i*>(data + i);
+        __m128i v = _mm_loadu_si128(p);
+
+        //swap bytes within 16 bit words
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        if (Size >= 4)
+        {
+            //swap 16 bit words within 32 bit words
+            v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xB1), 0xB1);
+        }
+        if (Size == 8)
+        {
+            //swap 32 bit words within 64 bit words
+            v = _mm_shuffle_epi32(v, 0xB1);
+        }
+        _mm_storeu_si128(p, v);
+    }
+#elif defined(BOOST_ASTRONOMY_SIMD_NEON)
+    for (; i + 16 <= bytes; i += 16)
+    {
+        uint8x16_t v = vld1q_u8(data + i);
+        switch (Size)
+        {
+        case 2:
+            v = vrev16q_u8(v);
+            break;
+        case 4:
+            v = vrev32q_u8(v);
+            break;
+        default:
+            v = vrev64q_u8(v);
+            break;
+        }
+        vst1q_u8(data + i, v);
+    }
+#else
+    (void)data;
+    (void)bytes;
+#endif
+
+    return i / Size;
+}
+
+// reverses the bytes of each of the count elements of Size bytes stored at data
+template <std::size_t Size>
+inline void swap_bytes(unsigned char* data, std::size_t count)
+{
+    std::size_t done = swap_bytes_simd<Size>(data, count);
+    swap_bytes_scalar<Size>(data + done * Size, count - done);
+}
+
+template <>
+inline void swap_bytes<1>(unsigned char*, std::size_t) {}
+
+// converts count big-endian values of type T stored at data to native byte order in place
+template <typename T>
+inline void big_to_native_inplace(T* data, std::size_t count)
+{
+    if (boost::endian::order::native == boost::endian::order::little)
+    {
+        swap_bytes<sizeof(T)>(reinterpret_cast<unsigned char*>(data), count);
+    }
+}
+
+// converts count native values of type T stored at data to big-endian byte order in place
+template <typename T>
+inline void native_to_big_inplace(T* data, std::size_t count)
+{
+    big_to_native_inplace(data, count);
+}
+
+// copies count big-endian values of type T from source to native values in destination
+template <typename T>
+inline void big_to_native_copy(void const* source, T* destination, std::size_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    std::memcpy(destination, source, count * sizeof(T));
+    big_to_native_inplace(destination, count);
+}
+
+// copies count native values of type T from source to big-endian values at destination
+// destination does not need to be aligned for T
+template <typename T>
+inline void native_to_big_copy(T const* source, void* destination, std::size_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    std::memcpy(destination, source, count * sizeof(T));
+    if (boost::endian::order::native == boost::endian::order::little)
+    {
+        swap_bytes<sizeof(T)>(static_cast<unsigned char*>(destination), count);
+    }
+}
+///@endcond
+
+}}} //namespace boost::astronomy::detail
+
+#endif // !BOOST_ASTRONOMY_DETAIL_BYTESWAP_HPP
@@ -0,0 +1,224 @@
+#ifndef BOOST_ASTRONOMY_DETAIL_CHARCONV_HPP
+#define BOOST_ASTRONOMY_DETAIL_CHARCONV_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include <boost/lexical_cast.hpp>
+
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// Locale independent parsing of numbers stored as text in FITS headers and ASCII tables.
+// Like std::from_chars these functions never allocate and report failure instead of throwing,
+// the whole range [first, last) must be a number (no leading or trailing spaces).
+
+// parses an optionally signed decimal integer
+template <typename Integer>
+inline bool parse_integer(char const* first, char const* last, Integer& value)
+{
+    static_assert(std::is_integral<Integer>::value, "parse_integer expects an integral type");
+
+    bool negative = false;
+    if (first != last && (*first == '+' || *first == '-'))
+    {
+        negative = *first == '-';
+        ++first;
+    }
+    if (first == last || (negative && !std::is_signed<Integer>::value))
+    {
+        return false;
+    }
+
+    // accumulate as negative number so that the minimum value of signed types can be parsed
+    using wide = typename std::conditional<std::is_signed<Integer>::value,
+        std::intmax_t, std::uintmax_t>::type;
+    wide const limit = negative ? static_cast<wide>(std::numeric_limits<Integer>::min())
+        : static_cast<wide>(std::numeric_limits<Integer>::max());
+
+    wide result = 0;
+    for (; first != last; ++first)
+    {
+        unsigned digit = static_cast<unsigned>(*first - '0');
+        if (digit > 9)
+        {
+            return false;
+        }
+
+        if (negative)
+        {
+            if (result < (limit + static_cast<wide>(digit)) / 10)
+            {
+                return false;
+            }
+            result = result * 10 - static_cast<wide>(digit);
+        }
+        else
+        {
+            if (result > (limit - static_cast<wide>(digit)) / 10)
+            {
+                return false;
+            }
+            result = result * 10 + static_cast<wide>(digit);
+        }
+    }
+
+    value = static_cast<Integer>(result);
+    return true;
+}
+
+// exact powers of ten representable by double
+inline double exact_power_of_ten(int exponent)
+{
+    static double const powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    return powers[exponent];
+}
+
+// parses a fixed or exponential decimal number, FITS allows D as well as E for the exponent
+// numbers with at most 15 significant digits and exponent in [-22, 22] (almost all values
+// in practice) are converted exactly with a single multiplication or division, others fall
+// back to boost::lexical_cast on a copy stored on stack
+inline bool parse_real(char const* first, char const* last, double& value)
+{
+    char const* const begin = first;
+
+    bool negative = false;
+    if (first != last && (*first == '+' || *first == '-'))
+    {
+        negative = *first == '-';
+        ++first;
+    }
+
+    std::uint64_t mantissa = 0;
+    int significant = 0; //significant digits stored in mantissa
+    int exponent = 0;
+    bool any_digit = false;
+    bool dot = false;
+    bool truncated = false;
+
+    for (; first != last; ++first)
+    {
+        char c = *first;
+        if (c == '.')
+        {
+            if (dot)
+            {
+                return false;
+            }
+            dot = true;
+            continue;
+        }
+
+        unsigned digit = static_cast<unsigned>(c - '0');
+        if (digit > 9)
+        {
+            break;
+        }
+        any_digit = true;
+
+        if (mantissa == 0 && digit == 0)
+        {
+            //leading zeros are not significant
+            exponent -= dot ? 1 : 0;
+        }
+        else if (significant < 19)
+        {
+            mantissa = mantissa * 10 + digit;
+            significant++;
+            exponent -= dot ? 1 : 0;
+        }
+        else
+        {
+            truncated = truncated || digit != 0;
+            exponent += dot ? 0 : 1;
+        }
+    }
+    if (!any_digit)
+    {
+        return false;
+    }
+
+    if (first != last)
+    {
+        char c = *first;
+        if (c != 'E' && c != 'e' && c != 'D' && c != 'd')
+        {
+            return false;
+        }
+        ++first;
+
+        int explicit_exponent = 0;
+        bool exponent_negative = false;
+        if (first != last && (*first == '+' || *first == '-'))
+        {
+            exponent_negative = *first == '-';
+            ++first;
+        }
+        if (first == last)
+        {
+            return false;
+        }
+        for (; first != last; ++first)
+        {
+            unsigned digit = static_cast<unsigned>(*first - '0');
+            if (digit > 9)
+            {
+                return false;
+            }
+            if (explicit_exponent < 100000)
+            {
+                explicit_exponent = explicit_exponent * 10 + static_cast<int>(digit);
+            }
+        }
+        exponent += exponent_negative ? -explicit_exponent : explicit_exponent;
+    }
+
+    if (mantissa == 0)
+    {
+        value = negative ? -0.0 : 0.0;
+        return true;
+    }
+
+    if (!truncated && significant <= 15 && exponent >= -22 && exponent <= 22)
+    {
+        double result = static_cast<double>(mantissa);
+        result = exponent < 0 ? result / exact_power_of_ten(-exponent)
+            : result * exact_power_of_ten(exponent);
+        value = negative ? -result : result;
+        return true;
+    }
+
+    //slow path, D exponent is not understood by lexical_cast
+    char buffer[128];
+    std::size_t length = static_cast<std::size_t>(last - begin);
+    if (length >= sizeof(buffer))
+    {
+        return false;
+    }
+    for (std::size_t i = 0; i < length; i++)
+    {
+        buffer[i] = (begin[i] == 'D' || begin[i] == 'd') ? 'E' : begin[i];
+    }
+    return boost::conversion::try_lexical_convert(buffer, length, value);
+}
+
+template <typename Real>
+inline bool parse_real(char const* first, char const* last, Real& value)
+{
+    double result;
+    if (!parse_real(first, last, result))
+    {
+        return false;
+    }
+    value = static_cast<Real>(result);
+    return true;
+}
+///@endcond
+
+}}} //namespace boost::astronomy::detail
+
+#endif // !BOOST_ASTRONOMY_DETAIL_CHARCONV_HPP
@@ -0,0 +1,34 @@
+#ifndef BOOST_ASTRONOMY_DETAIL_EXACT_COMPARE_HPP
+#define BOOST_ASTRONOMY_DETAIL_EXACT_COMPARE_HPP
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// returns true if value is exactly expected
+// only for values which are meant to be compared exactly and never for results of arithmetic:
+// keyword values such as BSCALE which read as exactly 1 when the keyword is absent and select
+// a code path by their exact value, or the pixels of SUBTRACTIVE_DITHER_2 which are stored as
+// a special value only if they are exactly 0
+inline bool is_exactly(double value, double expected)
+{
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wfloat-equal"
+#endif
+    return value == expected;
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+}
+
+// returns true if scale and zero (BSCALE and BZERO, TSCALn and TZEROn) leave the stored
+// values unchanged
+inline bool is_identity_scaling(double scale, double zero)
+{
+    return is_exactly(scale, 1) && is_exactly(zero, 0);
+}
+///@endcond
+
+}}} //namespace boost::astronomy::detail
+
+#endif // !BOOST_ASTRONOMY_DETAIL_EXACT_COMPARE_HPP
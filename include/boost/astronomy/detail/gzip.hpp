@@ -0,0 +1,314 @@
+#ifndef BOOST_ASTRONOMY_DETAIL_GZIP_HPP
+#define BOOST_ASTRONOMY_DETAIL_GZIP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+// GZIP compressed data is supported only when zlib is available, the CMake build defines
+// BOOST_ASTRONOMY_USE_ZLIB and links zlib when it is found. Without it the functions below
+// throw unsupported_compression_exception.
+#if defined(BOOST_ASTRONOMY_USE_ZLIB)
+#   include <zlib.h>
+#endif
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// returns true if GZIP compressed data can be read and written
+constexpr bool gzip_supported()
+{
+#if defined(BOOST_ASTRONOMY_USE_ZLIB)
+    return true;
+#else
+    return false;
+#endif
+}
+
+// decompresses the gzip (or zlib) stream of size bytes at source, which must decompress to
+// exactly destination_size bytes
+inline void gzip_decompress
+(
+    unsigned char const* source,
+    std::size_t size,
+    unsigned char* destination,
+    std::size_t destination_size
+)
+{
+#if defined(BOOST_ASTRONOMY_USE_ZLIB)
+    if (size > (std::numeric_limits<uInt>::max)() ||
+        destination_size > (std::numeric_limits<uInt>::max)())
+    {
+        throw invalid_compressed_tile_exception();
+    }
+
+    z_stream stream = z_stream();
+    //15 bits window, 32 enables detection of gzip and zlib headers
+    if (inflateInit2(&stream, 15 + 32) != Z_OK)
+    {
+        throw fits_exception();
+    }
+    stream.next_in = const_cast<Bytef*>(source);
+    stream.avail_in = static_cast<uInt>(size);
+    stream.next_out = destination;
+    stream.avail_out = static_cast<uInt>(destination_size);
+
+    int const result = inflate(&stream, Z_FINISH);
+    std::size_t const written = destination_size - stream.avail_out;
+    inflateEnd(&stream);
+    if (result != Z_STREAM_END || written != destination_size)
+    {
+        throw invalid_compressed_tile_exception();
+    }
+#else
+    (void)source;
+    (void)size;
+    (void)destination;
+    (void)destination_size;
+    throw unsupported_compression_exception();
+#endif
+}
+
+// appends the gzip stream of size bytes at source to destination
+inline void gzip_compress
+(
+    unsigned char const* source,
+    std::size_t size,
+    std::vector<unsigned char>& destination,
+    int level = 6
+)
+{
+#if defined(BOOST_ASTRONOMY_USE_ZLIB)
+    if (size > (std::numeric_limits<uInt>::max)())
+    {
+        throw fits_exception();
+    }
+
+    z_stream stream = z_stream();
+    //15 bits window, 16 writes gzip header
+    if (deflateInit2(&stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        throw fits_exception();
+    }
+    std::size_t const first = destination.size();
+    uLong const bound = deflateBound(&stream, static_cast<uLong>(size));
+    destination.resize(first + bound);
+
+    stream.next_in = const_cast<Bytef*>(source);
+    stream.avail_in = static_cast<uInt>(size);
+    stream.next_out = destination.data() + first;
+    stream.avail_out = static_cast<uInt>(bound);
+
+    int const result = deflate(&stream, Z_FINISH);
+    destination.resize(first + (bound - stream.avail_out));
+    deflateEnd(&stream);
+    if (result != Z_STREAM_END)
+    {
+        throw fits_exception();
+    }
+#else
+    (void)source;
+    (void)size;
+    (void)destination;
+    (void)level;
+    throw unsupported_compression_exception();
+#endif
+}
+
+// incremental decompression of a gzip stream whose input and output arrive in pieces
+class gzip_inflater
+{
+#if defined(BOOST_ASTRONOMY_USE_ZLIB)
+    z_stream stream_ = z_stream();
+    bool open_ = false;
+#endif
+
+public:
+    gzip_inflater() {}
+
+    gzip_inflater(gzip_inflater const&) = delete;
+    gzip_inflater& operator=(gzip_inflater const&) = delete;
+
+    ~gzip_inflater()
+    {
+#if defined(BOOST_ASTRONOMY_USE_ZLIB)
+        if (open_)
+        {
+            inflateEnd(&stream_);
+        }
+#endif
+    }
+
+    // starts decompressing the next gzip member
+    void reset()
+    {
+#if defined(BOOST_ASTRONOMY_USE_ZLIB)
+        if (open_)
+        {
+            if (inflateReset(&stream_) != Z_OK)
+            {
+                throw fits_exception();
+            }
+            return;
+        }
+        if (inflateInit2(&stream_, 15 + 32) != Z_OK)
+        {
+            throw fits_exception();
+        }
+        open_ = true;
+#else
+        throw unsupported_compression_exception();
+#endif
+    }
+
+    // decompresses the bytes at source into destination, consumed and produced receive the
+    // number of bytes used from source and written to destination
+    // returns true at the end of member
+    bool inflate
+    (
+        unsigned char const* source,
+        std::size_t size,
+        unsigned char* destination,
+        std::size_t capacity,
+        std::size_t& consumed,
+        std::size_t& produced
+    )
+    {
+#if defined(BOOST_ASTRONOMY_USE_ZLIB)
+        std::size_t const limit = (std::numeric_limits<uInt>::max)();
+        uInt const input = static_cast<uInt>(size < limit ? size : limit);
+        uInt const output = static_cast<uInt>(capacity < limit ? capacity : limit);
+        stream_.next_in = const_cast<Bytef*>(source);
+        stream_.avail_in = input;
+        stream_.next_out = destination;
+        stream_.avail_out = output;
+
+        int const result = ::inflate(&stream_, Z_NO_FLUSH);
+        consumed = input - stream_.avail_in;
+        produced = output - stream_.avail_out;
+        if (result == Z_STREAM_END)
+        {
+            return true;
+        }
+        if (result != Z_OK && result != Z_BUF_ERROR)
+        {
+            throw invalid_gzip_stream_exception();
+        }
+        return false;
+#else
+        (void)source;
+        (void)size;
+        (void)destination;
+        (void)capacity;
+        consumed = 0;
+        produced = 0;
+        throw unsupported_compression_exception();
+#endif
+    }
+};
+
+// returns true if the bytes at header start a gzip member
+inline bool is_gzip_member(unsigned char const* header, std::size_t available)
+{
+    return available >= 2 && header[0] == 0x1f && header[1] == 0x8b;
+}
+
+// returns the bytes of fixed header and extra field of the gzip member at header, which
+// needs atleast 12 bytes, or 0 if the member has no extra field
+inline std::size_t gzip_extra_end(unsigned char const* header)
+{
+    if ((header[3] & 4) == 0)
+    {
+        return 0;
+    }
+    return 12 + (static_cast<std::size_t>(header[10]) |
+        static_cast<std::size_t>(header[11]) << 8);
+}
+
+// returns the total size of the gzip member at header if its extra field records it (the
+// BC subfield of BGZF written by bgzip and htslib), otherwise 0
+// available must cover the extra field (see gzip_extra_end)
+inline std::size_t gzip_member_size(unsigned char const* header, std::size_t available)
+{
+    if (available < 12 || !is_gzip_member(header, available) || header[2] != 8)
+    {
+        return 0;
+    }
+    std::size_t const end = gzip_extra_end(header);
+    if (end == 0 || end > available)
+    {
+        return 0;
+    }
+
+    for (std::size_t position = 12; position + 4 <= end; )
+    {
+        std::size_t const length = static_cast<std::size_t>(header[position + 2]) |
+            static_cast<std::size_t>(header[position + 3]) << 8;
+        if (header[position] == 'B' && header[position + 1] == 'C' && length == 2 &&
+            position + 6 <= end)
+        {
+            return (static_cast<std::size_t>(header[position + 4]) |
+                static_cast<std::size_t>(header[position + 5]) << 8) + 1;
+        }
+        position += 4 + length;
+    }
+    return 0;
+}
+
+// returns the uncompressed size (modulo 2^32) recorded by the trailer of the gzip member of
+// size bytes at member
+inline std::size_t gzip_member_output(unsigned char const* member, std::size_t size)
+{
+    std::uint32_t value = 0;
+    for (std::size_t k = size; k > size - 4; k--)
+    {
+        value = value << 8 | member[k - 1];
+    }
+    return value;
+}
+
+// reorders count values of size bytes stored one after another (GZIP_2 of tile compression)
+// to the first bytes of all the values followed by their second bytes and so on
+inline void shuffle_bytes
+(
+    unsigned char const* source,
+    unsigned char* destination,
+    std::size_t count,
+    std::size_t size
+)
+{
+    for (std::size_t i = 0; i < count; i++)
+    {
+        for (std::size_t k = 0; k < size; k++)
+        {
+            destination[k * count + i] = source[i * size + k];
+        }
+    }
+}
+
+// reverses shuffle_bytes
+inline void unshuffle_bytes
+(
+    unsigned char const* source,
+    unsigned char* destination,
+    std::size_t count,
+    std::size_t size
+)
+{
+    for (std::size_t k = 0; k < size; k++)
+    {
+        unsigned char const* plane = source + k * count;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            destination[i * size + k] = plane[i];
+        }
+    }
+}
+///@endcond
+
+}}} //namespace boost::astronomy::detail
+
+#endif // !BOOST_ASTRONOMY_DETAIL_GZIP_HPP
@@ -0,0 +1,381 @@
+#ifndef BOOST_ASTRONOMY_DETAIL_GZIP_STREAMBUF_HPP
+#define BOOST_ASTRONOMY_DETAIL_GZIP_STREAMBUF_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <boost/astronomy/detail/gzip.hpp>
+#include <boost/astronomy/detail/parallel.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// stream buffer decompressing a gzip file while it is read, nothing is written to disk
+// decompressed bytes are held in a sliding window, which keeps a quarter of its previous
+// contents when it is refilled so that short backward seeks do not restart decompression
+// members whose compressed size is recorded in their header (BGZF) are decompressed in
+// batches by up to threads threads and are skipped without decompressing them by forward
+// seeks, other members are decompressed one after another
+// seeking forward decompresses and discards the bytes skipped, seeking backward past the
+// window decompresses the file again from its beginning and seeking from the end is not
+// supported since the decompressed size is not known in advance
+class gzip_streambuf : public std::streambuf
+{
+public:
+    static constexpr std::size_t default_window_bytes = std::size_t(4) << 20;
+    static constexpr std::size_t input_bytes = std::size_t(1) << 20;
+
+private:
+    std::ifstream file_; // compressed file
+    std::size_t threads_;
+    std::size_t window_bytes_;
+
+    std::vector<char> window_; // decompressed bytes, the get area is the filled part
+    std::uint64_t window_offset_ = 0; // offset of window_[0] in decompressed file
+
+    std::vector<unsigned char> input_; // compressed bytes read from file
+    std::size_t input_first_ = 0; // first byte of input_ not decompressed yet
+    std::size_t input_last_ = 0; // end of bytes read into input_
+    bool file_end_ = false;
+
+    gzip_inflater inflater_;
+    bool in_member_ = false; // inside a member decompressed by inflater_
+    bool finished_ = false; // no member left in file
+
+public:
+    explicit gzip_streambuf
+    (
+        std::string const& path,
+        std::size_t threads = 0,
+        std::size_t window_bytes = default_window_bytes
+    ) :
+        threads_(threads == 0 ? default_thread_count() : threads),
+        window_bytes_((std::max)(window_bytes, std::size_t(2880)))
+    {
+        if (!gzip_supported())
+        {
+            throw unsupported_compression_exception();
+        }
+        file_.open(path, std::ios_base::in | std::ios_base::binary);
+        if (!file_)
+        {
+            throw fits_exception();
+        }
+        window_.resize(window_bytes_);
+        input_.resize(input_bytes);
+        setg(window_.data(), window_.data(), window_.data());
+    }
+
+    gzip_streambuf(gzip_streambuf const&) = delete;
+    gzip_streambuf& operator=(gzip_streambuf const&) = delete;
+
+protected:
+    int_type underflow() override
+    {
+        if (gptr() == egptr() && fill() == 0)
+        {
+            return traits_type::eof();
+        }
+        return traits_type::to_int_type(*gptr());
+    }
+
+    pos_type seekoff
+    (
+        off_type offset,
+        std::ios_base::seekdir direction,
+        std::ios_base::openmode which
+    ) override
+    {
+        std::uint64_t const current = window_offset_ +
+            static_cast<std::uint64_t>(gptr() - eback());
+        if ((which & std::ios_base::in) == 0 || direction == std::ios_base::end)
+        {
+            return pos_type(off_type(-1));
+        }
+        if (direction == std::ios_base::cur)
+        {
+            if (offset == 0)
+            {
+                return pos_type(static_cast<off_type>(current));
+            }
+            offset += static_cast<off_type>(current);
+        }
+        if (offset < 0)
+        {
+            return pos_type(off_type(-1));
+        }
+        return seek(static_cast<std::uint64_t>(offset));
+    }
+
+    pos_type seekpos(pos_type position, std::ios_base::openmode which) override
+    {
+        return seekoff(off_type(position), std::ios_base::beg, which);
+    }
+
+private:
+    // moves the get area to target decompressing (or skipping) the bytes up to it
+    pos_type seek(std::uint64_t target)
+    {
+        if (target < window_offset_)
+        {
+            restart();
+        }
+        while (true)
+        {
+            std::uint64_t const end = window_offset_ +
+                static_cast<std::uint64_t>(egptr() - eback());
+            if (target <= end)
+            {
+                setg(eback(), eback() + static_cast<std::size_t>(target - window_offset_),
+                    egptr());
+                return pos_type(static_cast<off_type>(target));
+            }
+
+            window_offset_ = end;
+            setg(window_.data(), window_.data(), window_.data());
+            skip_members(target);
+            if (fill() == 0)
+            {
+                return pos_type(off_type(-1));
+            }
+        }
+    }
+
+    // starts decompressing the file again from its beginning
+    void restart()
+    {
+        file_.clear();
+        file_.seekg(0);
+        input_first_ = 0;
+        input_last_ = 0;
+        file_end_ = false;
+        in_member_ = false;
+        finished_ = false;
+        window_offset_ = 0;
+        setg(window_.data(), window_.data(), window_.data());
+    }
+
+    // returns the number of compressed bytes read but not decompressed yet
+    std::size_t available() const
+    {
+        return input_last_ - input_first_;
+    }
+
+    // reads compressed bytes until atleast size bytes are available or the file ends
+    // returns the number of bytes available
+    std::size_t buffer_input(std::size_t size)
+    {
+        if (available() >= size || file_end_)
+        {
+            return available();
+        }
+
+        std::memmove(input_.data(), input_.data() + input_first_, available());
+        input_last_ = available();
+        input_first_ = 0;
+        if (input_.size() < size)
+        {
+            input_.resize(size);
+        }
+        while (input_last_ < size && !file_end_)
+        {
+            file_.read(reinterpret_cast<char*>(input_.data() + input_last_),
+                static_cast<std::streamsize>(input_.size() - input_last_));
+            input_last_ += static_cast<std::size_t>(file_.gcount());
+            if (!file_)
+            {
+                if (file_.bad())
+                {
+                    throw fits_exception();
+                }
+                file_end_ = true;
+            }
+        }
+        return available();
+    }
+
+    // returns the total size of the member starting at the first byte not decompressed if its
+    // header records it, otherwise 0, sets finished_ when no member is left
+    // bytes following the last member which do not start a member are ignored like gzip does
+    std::size_t member_size()
+    {
+        std::size_t const header = buffer_input(12);
+        if (!is_gzip_member(input_.data() + input_first_, header))
+        {
+            finished_ = true;
+            return 0;
+        }
+        if (header < 12)
+        {
+            throw invalid_gzip_stream_exception();
+        }
+        std::size_t const extra = gzip_extra_end(input_.data() + input_first_);
+        if (extra == 0)
+        {
+            return 0;
+        }
+        return gzip_member_size(input_.data() + input_first_, buffer_input(extra));
+    }
+
+    // skips the members with recorded size which end before target
+    void skip_members(std::uint64_t target)
+    {
+        while (!in_member_ && !finished_)
+        {
+            std::size_t const size = member_size();
+            if (size == 0 || buffer_input(size) < size)
+            {
+                return;
+            }
+            std::size_t const output = gzip_member_output(input_.data() + input_first_, size);
+            if (window_offset_ + output > target)
+            {
+                return;
+            }
+            input_first_ += size;
+            window_offset_ += output;
+        }
+    }
+
+    // decompresses the next bytes into the window after the bytes kept from the last window
+    // returns the number of bytes decompressed, 0 at the end of file
+    std::size_t fill()
+    {
+        std::size_t const filled = static_cast<std::size_t>(egptr() - eback());
+        std::size_t const kept = (std::min)(filled, window_bytes_ / 4);
+        std::memmove(window_.data(), window_.data() + (filled - kept), kept);
+        window_offset_ += filled - kept;
+
+        std::size_t size = kept;
+        while (size == kept && !finished_)
+        {
+            if (!in_member_)
+            {
+                std::size_t const recorded = member_size();
+                if (finished_)
+                {
+                    break;
+                }
+                if (recorded != 0)
+                {
+                    size += decompress_batch(size);
+                    continue;
+                }
+                inflater_.reset();
+                in_member_ = true;
+            }
+
+            if (window_.size() < size + window_bytes_ / 2)
+            {
+                window_.resize(size + window_bytes_ / 2);
+            }
+            while (in_member_ && size < window_.size())
+            {
+                if (buffer_input(1) == 0)
+                {
+                    throw invalid_gzip_stream_exception();
+                }
+                std::size_t consumed = 0;
+                std::size_t produced = 0;
+                in_member_ = !inflater_.inflate(input_.data() + input_first_, available(),
+                    reinterpret_cast<unsigned char*>(window_.data() + size),
+                    window_.size() - size, consumed, produced);
+                input_first_ += consumed;
+                size += produced;
+                if (in_member_ && consumed == 0 && produced == 0)
+                {
+                    throw invalid_gzip_stream_exception();
+                }
+            }
+        }
+
+        setg(window_.data(), window_.data() + kept, window_.data() + size);
+        return size - kept;
+    }
+
+    // decompresses the following members with recorded size (up to 4 per thread) at the same
+    // time into the window after size bytes, returns the number of bytes decompressed
+    std::size_t decompress_batch(std::size_t size)
+    {
+        struct member
+        {
+            std::size_t offset; // from the first byte not decompressed
+            std::size_t size;
+            std::size_t output; // offset of decompressed bytes from the first one
+            std::size_t output_size;
+        };
+
+        std::vector<member> members;
+        std::size_t offset = 0;
+        std::size_t total = 0;
+        while (members.size() < 4 * threads_)
+        {
+            std::size_t const header = buffer_input(offset + 12) - offset;
+            unsigned char const* first = input_.data() + input_first_ + offset;
+            if (header < 12 || !is_gzip_member(first, header))
+            {
+                break;
+            }
+            std::size_t const extra = gzip_extra_end(first);
+            if (extra == 0)
+            {
+                break;
+            }
+            std::size_t const recorded = gzip_member_size(input_.data() + input_first_ + offset,
+                buffer_input(offset + extra) - offset);
+            if (recorded == 0)
+            {
+                break;
+            }
+            if (buffer_input(offset + recorded) < offset + recorded)
+            {
+                throw invalid_gzip_stream_exception();
+            }
+
+            std::size_t const output = gzip_member_output(input_.data() + input_first_ + offset,
+                recorded);
+            members.push_back(member{offset, recorded, total, output});
+            offset += recorded;
+            total += output;
+        }
+
+        if (window_.size() < size + total)
+        {
+            window_.resize(size + total);
+        }
+        unsigned char const* source = input_.data() + input_first_;
+        unsigned char* destination = reinterpret_cast<unsigned char*>(window_.data() + size);
+        parallel_for(members.size(), threads_, [&](std::size_t i)
+        {
+            member const& m = members[i];
+            if (m.output_size == 0)
+            {
+                return;
+            }
+            try
+            {
+                gzip_decompress(source + m.offset, m.size, destination + m.output,
+                    m.output_size);
+            }
+            catch (invalid_compressed_tile_exception const&)
+            {
+                throw invalid_gzip_stream_exception();
+            }
+        });
+        input_first_ += offset;
+        return total;
+    }
+};
+///@endcond
+
+}}} //namespace boost::astronomy::detail
+
+#endif // !BOOST_ASTRONOMY_DETAIL_GZIP_STREAMBUF_HPP
@@ -0,0 +1,251 @@
+#ifndef BOOST_ASTRONOMY_DETAIL_IO_URING_HPP
+#define BOOST_ASTRONOMY_DETAIL_IO_URING_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+// io_uring is used only on Linux when the CMake build finds <linux/io_uring.h> and defines
+// BOOST_ASTRONOMY_USE_IO_URING. The ring is set up with the system calls directly so that
+// liburing is not needed. Without it io_uring_supported() returns false and readers fall
+// back to positioned reads on a pool of threads.
+#if defined(BOOST_ASTRONOMY_USE_IO_URING)
+#   include <cerrno>
+#   include <linux/io_uring.h>
+#   include <sys/mman.h>
+#   include <sys/syscall.h>
+#   include <sys/uio.h>
+#   include <unistd.h>
+#endif
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+#if defined(BOOST_ASTRONOMY_USE_IO_URING)
+
+// submission and completion queues of an io_uring used to read files
+// reads are prepared with prepare_read and submitted by submit_and_wait, the caller must
+// keep atmost entries() reads in flight and keep the iovec of a read alive until it completes
+class io_uring_queue
+{
+    int fd_ = -1;
+    unsigned entries_ = 0;
+
+    void* sq_ring_ = MAP_FAILED;
+    std::size_t sq_ring_size_ = 0;
+    void* cq_ring_ = MAP_FAILED;
+    std::size_t cq_ring_size_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    std::size_t sqes_size_ = 0;
+
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_mask_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned* cq_mask_ = nullptr;
+    io_uring_cqe* cqes_ = nullptr;
+
+    unsigned prepared_ = 0; // reads prepared but not submitted yet
+
+public:
+    // sets up a ring of atleast entries entries, throws unsupported_io_backend_exception if
+    // the kernel does not provide io_uring or it is not allowed (e.g. by seccomp)
+    explicit io_uring_queue(unsigned entries)
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        long const fd = ::syscall(__NR_io_uring_setup, entries, &params);
+        if (fd < 0)
+        {
+            throw unsupported_io_backend_exception();
+        }
+        fd_ = static_cast<int>(fd);
+        entries_ = params.sq_entries;
+
+        sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool const single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap)
+        {
+            sq_ring_size_ = cq_ring_size_ = (std::max)(sq_ring_size_, cq_ring_size_);
+        }
+
+        sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+        if (sq_ring_ == MAP_FAILED)
+        {
+            close();
+            throw unsupported_io_backend_exception();
+        }
+        if (single_mmap)
+        {
+            cq_ring_ = sq_ring_;
+        }
+        else
+        {
+            cq_ring_ = ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+            if (cq_ring_ == MAP_FAILED)
+            {
+                close();
+                throw unsupported_io_backend_exception();
+            }
+        }
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED)
+        {
+            close();
+            throw unsupported_io_backend_exception();
+        }
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        char* sq = static_cast<char*>(sq_ring_);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        char* cq = static_cast<char*>(cq_ring_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    }
+
+    io_uring_queue(io_uring_queue const&) = delete;
+    io_uring_queue& operator=(io_uring_queue const&) = delete;
+
+    ~io_uring_queue()
+    {
+        close();
+    }
+
+    // returns the number of entries of submission queue
+    unsigned entries() const
+    {
+        return entries_;
+    }
+
+    // prepares the read of the buffer described by vector from offset of file descriptor fd
+    // user_data is returned along with the result when the read completes
+    void prepare_read
+    (
+        int fd,
+        iovec const* vector,
+        std::uint64_t offset,
+        std::uint64_t user_data
+    )
+    {
+        unsigned const tail = *sq_tail_;
+        unsigned const index = tail & *sq_mask_;
+        io_uring_sqe& sqe = sqes_[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READV;
+        sqe.fd = fd;
+        sqe.off = offset;
+        sqe.addr = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(vector));
+        sqe.len = 1;
+        sqe.user_data = user_data;
+        sq_array_[index] = index;
+
+        //the entry must be visible to the kernel before the new tail
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+        prepared_++;
+    }
+
+    // submits the prepared reads and waits until atleast one read is completed
+    void submit_and_wait()
+    {
+        while (true)
+        {
+            long const submitted = ::syscall(__NR_io_uring_enter, fd_, prepared_, 1u,
+                IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (submitted >= 0)
+            {
+                prepared_ -= static_cast<unsigned>(submitted);
+                if (prepared_ == 0)
+                {
+                    return;
+                }
+            }
+            else if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+            {
+                throw fits_exception();
+            }
+        }
+    }
+
+    // calls f(user_data, result) for every completed read, result is the number of bytes
+    // read or a negative error number
+    template <typename Function>
+    void for_each_completion(Function f)
+    {
+        unsigned head = *cq_head_;
+        unsigned const tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++)
+        {
+            io_uring_cqe const& cqe = cqes_[head & *cq_mask_];
+            f(cqe.user_data, cqe.res);
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    }
+
+private:
+    void close()
+    {
+        if (sqes_)
+        {
+            ::munmap(sqes_, sqes_size_);
+            sqes_ = nullptr;
+        }
+        if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_)
+        {
+            ::munmap(cq_ring_, cq_ring_size_);
+        }
+        cq_ring_ = MAP_FAILED;
+        if (sq_ring_ != MAP_FAILED)
+        {
+            ::munmap(sq_ring_, sq_ring_size_);
+            sq_ring_ = MAP_FAILED;
+        }
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+};
+
+#endif
+
+// returns true if files can be read with io_uring, which needs Linux 5.1 and can be
+// disabled at run time (e.g. by the seccomp profile of a container)
+inline bool io_uring_supported()
+{
+#if defined(BOOST_ASTRONOMY_USE_IO_URING)
+    static bool const supported = []()
+    {
+        try
+        {
+            io_uring_queue probe(1);
+            return true;
+        }
+        catch (unsupported_io_backend_exception const&)
+        {
+            return false;
+        }
+    }();
+    return supported;
+#else
+    return false;
+#endif
+}
+///@endcond
+
+}}} //namespace boost::astronomy::detail
+
+#endif // !BOOST_ASTRONOMY_DETAIL_IO_URING_HPP
@@ -0,0 +1,160 @@
+
+#ifndef BOOST_ASTRONOMY_DETAIL_OUTPUT_FILE_HPP
+#define BOOST_ASTRONOMY_DETAIL_OUTPUT_FILE_HPP
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
+
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// file created (or truncated) for writing, written sequentially with unbuffered system calls
+// so callers are expected to hand over large blocks
+class output_file
+{
+#if defined(_WIN32)
+    HANDLE handle_ = INVALID_HANDLE_VALUE;
+#else
+    int fd_ = -1;
+#endif
+
+public:
+    output_file() {}
+
+    explicit output_file(std::string const& path)
+    {
+        open(path);
+    }
+
+    output_file(output_file&& other) noexcept
+    {
+        swap(other);
+    }
+
+    output_file& operator=(output_file&& other) noexcept
+    {
+        output_file(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    output_file(output_file const&) = delete;
+    output_file& operator=(output_file const&) = delete;
+
+    ~output_file()
+    {
+        close();
+    }
+
+    void swap(output_file& other) noexcept
+    {
+#if defined(_WIN32)
+        std::swap(handle_, other.handle_);
+#else
+        std::swap(fd_, other.fd_);
+#endif
+    }
+
+    // creates or truncates the file, throws fits_exception if it can not be opened
+    void open(std::string const& path)
+    {
+        close();
+#if defined(_WIN32)
+        handle_ = ::CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (handle_ == INVALID_HANDLE_VALUE)
+        {
+            throw fits_exception();
+        }
+#else
+        do
+        {
+            fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+        } while (fd_ < 0 && errno == EINTR);
+        if (fd_ < 0)
+        {
+            throw fits_exception();
+        }
+#endif
+    }
+
+    bool is_open() const
+    {
+#if defined(_WIN32)
+        return handle_ != INVALID_HANDLE_VALUE;
+#else
+        return fd_ >= 0;
+#endif
+    }
+
+    void close()
+    {
+#if defined(_WIN32)
+        if (handle_ != INVALID_HANDLE_VALUE)
+        {
+            ::CloseHandle(handle_);
+            handle_ = INVALID_HANDLE_VALUE;
+        }
+#else
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+            fd_ = -1;
+        }
+#endif
+    }
+
+    // writes exactly size bytes at the end of file, throws fits_exception on error
+    void write(void const* buffer, std::size_t size)
+    {
+        char const* source = static_cast<char const*>(buffer);
+        while (size > 0)
+        {
+            std::size_t request = size < (std::size_t(1) << 30) ? size : (std::size_t(1) << 30);
+#if defined(_WIN32)
+            DWORD count = 0;
+            if (!::WriteFile(handle_, source, static_cast<DWORD>(request), &count, nullptr)
+                || count == 0)
+            {
+                throw fits_exception();
+            }
+            std::size_t done = static_cast<std::size_t>(count);
+#else
+            ssize_t count = ::write(fd_, source, request);
+            if (count < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (count <= 0)
+            {
+                throw fits_exception();
+            }
+            std::size_t done = static_cast<std::size_t>(count);
+#endif
+            source += done;
+            size -= done;
+        }
+    }
+};
+///@endcond
+
+}}} //namespace boost::astronomy::detail
+
+#endif // !BOOST_ASTRONOMY_DETAIL_OUTPUT_FILE_HPP
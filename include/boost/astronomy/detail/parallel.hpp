@@ -0,0 +1,175 @@
+#ifndef BOOST_ASTRONOMY_DETAIL_PARALLEL_HPP
+#define BOOST_ASTRONOMY_DETAIL_PARALLEL_HPP
+
+#include <cstddef>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <vector>
+#include <algorithm>
+
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// number of worker threads used when the caller does not specify it
+inline std::size_t default_thread_count()
+{
+    unsigned threads = std::thread::hardware_concurrency();
+    return threads == 0 ? 1 : static_cast<std::size_t>(threads);
+}
+
+// joins the joinable threads of threads when leaving its scope, also when starting one of
+// them threw, since destroying a joinable std::thread terminates the program
+class thread_join_guard
+{
+    std::vector<std::thread>& threads_;
+
+public:
+    explicit thread_join_guard(std::vector<std::thread>& threads) : threads_(threads) {}
+
+    thread_join_guard(thread_join_guard const&) = delete;
+    thread_join_guard& operator=(thread_join_guard const&) = delete;
+
+    ~thread_join_guard()
+    {
+        for (std::thread& t : threads_)
+        {
+            if (t.joinable())
+            {
+                t.join();
+            }
+        }
+    }
+};
+
+// calls f(index) for every index in [0, count) on up to threads workers (0 means default)
+// indices are handed out one at a time so uneven work is balanced, the calling thread is
+// one of the workers, the first exception thrown by f stops the loop and is rethrown
+template <typename Function>
+inline void parallel_for(std::size_t count, std::size_t threads, Function f)
+{
+    if (threads == 0)
+    {
+        threads = default_thread_count();
+    }
+    threads = (std::min)(threads, count);
+
+    if (threads <= 1)
+    {
+        for (std::size_t i = 0; i < count; i++)
+        {
+            f(i);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next(0);
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto worker = [&]()
+    {
+        while (!failed.load(std::memory_order_relaxed))
+        {
+            std::size_t i = next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= count)
+            {
+                break;
+            }
+            try
+            {
+                f(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+                failed = true;
+            }
+        }
+    };
+
+    {
+        std::vector<std::thread> workers;
+        thread_join_guard joined(workers);
+        try
+        {
+            workers.reserve(threads - 1);
+            for (std::size_t t = 1; t < threads; t++)
+            {
+                workers.emplace_back(worker);
+            }
+        }
+        catch (...)
+        {
+            //the threads already started stop before the error is rethrown
+            failed = true;
+            throw;
+        }
+        worker();
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+// limits the number of threads inside a section (e.g. files being read at the same time)
+class counting_semaphore
+{
+    std::mutex mutex_;
+    std::condition_variable available_;
+    std::size_t count_;
+
+public:
+    explicit counting_semaphore(std::size_t count) : count_(count) {}
+
+    void acquire()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        available_.wait(lock, [this]() { return count_ > 0; });
+        count_--;
+    }
+
+    void release()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            count_++;
+        }
+        available_.notify_one();
+    }
+};
+
+// acquires the semaphore for the lifetime of the guard
+class semaphore_guard
+{
+    counting_semaphore& semaphore_;
+
+public:
+    explicit semaphore_guard(counting_semaphore& semaphore) : semaphore_(semaphore)
+    {
+        semaphore_.acquire();
+    }
+
+    ~semaphore_guard()
+    {
+        semaphore_.release();
+    }
+
+    semaphore_guard(semaphore_guard const&) = delete;
+    semaphore_guard& operator=(semaphore_guard const&) = delete;
+};
+///@endcond
+
+}}} //namespace boost::astronomy::detail
+
+#endif // !BOOST_ASTRONOMY_DETAIL_PARALLEL_HPP
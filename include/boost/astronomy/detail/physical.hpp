@@ -0,0 +1,252 @@
+#ifndef BOOST_ASTRONOMY_DETAIL_PHYSICAL_HPP
+#define BOOST_ASTRONOMY_DETAIL_PHYSICAL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include <boost/astronomy/detail/byteswap.hpp>
+#include <boost/astronomy/io/bitpix.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// returns true if the stored integer is the BLANK value of scaling, floats are never blank
+template <typename Raw>
+inline typename std::enable_if<std::is_integral<Raw>::value, bool>::type
+is_blank(Raw value, io::pixel_scaling const& scaling)
+{
+    return scaling.has_blank && static_cast<std::int64_t>(value) == scaling.blank;
+}
+
+template <typename Raw>
+inline typename std::enable_if<!std::is_integral<Raw>::value, bool>::type
+is_blank(Raw, io::pixel_scaling const&)
+{
+    return false;
+}
+
+// returns true if the BLANK value of scaling can be stored in Raw, otherwise no pixel is blank
+template <typename Raw>
+inline bool blank_in_range(io::pixel_scaling const& scaling)
+{
+    return scaling.has_blank &&
+        scaling.blank >= static_cast<std::int64_t>((std::numeric_limits<Raw>::min)()) &&
+        scaling.blank <= static_cast<std::int64_t>((std::numeric_limits<Raw>::max)());
+}
+
+// converts count big-endian values of type Raw at source to physical values of type T
+// the multiplication and addition are done in T so that the vectorized kernels give the
+// same results
+template <typename Raw, typename T>
+inline void big_to_physical_scalar
+(
+    unsigned char const* source,
+    T* destination,
+    std::size_t count,
+    io::pixel_scaling const& scaling
+)
+{
+    T const scale = static_cast<T>(scaling.bscale);
+    T const zero = static_cast<T>(scaling.bzero);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        Raw const value = load_big_endian<Raw>(source + i * sizeof(Raw));
+        destination[i] = is_blank(value, scaling) ? std::numeric_limits<T>::quiet_NaN() :
+            static_cast<T>(value) * scale + zero;
+    }
+}
+
+// vectorized body of big_to_physical for Raw and T, returns the number of values converted
+template <typename Raw, typename T>
+struct physical_kernel
+{
+    static std::size_t convert(unsigned char const*, T*, std::size_t, io::pixel_scaling const&)
+    {
+        return 0;
+    }
+};
+
+#if defined(BOOST_ASTRONOMY_SIMD_AVX2) || defined(BOOST_ASTRONOMY_SIMD_SSSE3) || \
+    defined(BOOST_ASTRONOMY_SIMD_SSE2)
+// replaces the lanes of values selected by mask (all bits set) with NaN
+inline __m128 blank_to_nan(__m128 values, __m128i mask)
+{
+    __m128 const selected = _mm_castsi128_ps(mask);
+    return _mm_or_ps(_mm_andnot_ps(selected, values),
+        _mm_and_ps(selected, _mm_set1_ps(std::numeric_limits<float>::quiet_NaN())));
+}
+
+// applies scale and zero to the 4 integers of values converted to float
+inline __m128 scale_to_float(__m128i values, __m128 scale, __m128 zero)
+{
+    return _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(values), scale), zero);
+}
+
+// 8 bit unsigned integers (BITPIX = 8), 16 pixels at a time
+template <>
+struct physical_kernel<std::uint8_t, float>
+{
+    static std::size_t convert(unsigned char const* source, float* destination,
+        std::size_t count, io::pixel_scaling const& scaling)
+    {
+        __m128 const scale = _mm_set1_ps(static_cast<float>(scaling.bscale));
+        __m128 const zero = _mm_set1_ps(static_cast<float>(scaling.bzero));
+        bool const check_blank = blank_in_range<std::uint8_t>(scaling);
+        __m128i const blank = _mm_set1_epi8(static_cast<char>(scaling.blank));
+        __m128i const zeros = _mm_setzero_si128();
+
+        std::size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(source + i));
+            __m128i const words[2] = {_mm_unpacklo_epi8(v, zeros), _mm_unpackhi_epi8(v, zeros)};
+            __m128i const equal = _mm_cmpeq_epi8(v, blank);
+            __m128i const word_masks[2] = {_mm_unpacklo_epi8(equal, equal),
+                _mm_unpackhi_epi8(equal, equal)};
+            for (int w = 0; w < 2; w++)
+            {
+                __m128 low = scale_to_float(_mm_unpacklo_epi16(words[w], zeros), scale, zero);
+                __m128 high = scale_to_float(_mm_unpackhi_epi16(words[w], zeros), scale, zero);
+                if (check_blank)
+                {
+                    low = blank_to_nan(low, _mm_unpacklo_epi16(word_masks[w], word_masks[w]));
+                    high = blank_to_nan(high, _mm_unpackhi_epi16(word_masks[w], word_masks[w]));
+                }
+                _mm_storeu_ps(destination + i + 8 * w, low);
+                _mm_storeu_ps(destination + i + 8 * w + 4, high);
+            }
+        }
+        return i;
+    }
+};
+
+// 16 bit integers (BITPIX = 16, unsigned with BZERO = 32768), 8 pixels at a time
+template <>
+struct physical_kernel<std::int16_t, float>
+{
+    static std::size_t convert(unsigned char const* source, float* destination,
+        std::size_t count, io::pixel_scaling const& scaling)
+    {
+        __m128 const scale = _mm_set1_ps(static_cast<float>(scaling.bscale));
+        __m128 const zero = _mm_set1_ps(static_cast<float>(scaling.bzero));
+        bool const check_blank = blank_in_range<std::int16_t>(scaling);
+        __m128i const blank = _mm_set1_epi16(static_cast<short>(scaling.blank));
+
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(source + 2 * i));
+            v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+
+            //each value in both halves of a 32 bit lane, shifting right extends its sign
+            __m128 low = scale_to_float(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16),
+                scale, zero);
+            __m128 high = scale_to_float(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16),
+                scale, zero);
+            if (check_blank)
+            {
+                __m128i const equal = _mm_cmpeq_epi16(v, blank);
+                low = blank_to_nan(low, _mm_unpacklo_epi16(equal, equal));
+                high = blank_to_nan(high, _mm_unpackhi_epi16(equal, equal));
+            }
+            _mm_storeu_ps(destination + i, low);
+            _mm_storeu_ps(destination + i + 4, high);
+        }
+        return i;
+    }
+};
+
+// 32 bit integers (BITPIX = 32), 4 pixels at a time
+template <>
+struct physical_kernel<std::int32_t, float>
+{
+    static std::size_t convert(unsigned char const* source, float* destination,
+        std::size_t count, io::pixel_scaling const& scaling)
+    {
+        __m128 const scale = _mm_set1_ps(static_cast<float>(scaling.bscale));
+        __m128 const zero = _mm_set1_ps(static_cast<float>(scaling.bzero));
+        bool const check_blank = blank_in_range<std::int32_t>(scaling);
+        __m128i const blank = _mm_set1_epi32(static_cast<int>(scaling.blank));
+
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(source + 4 * i));
+            v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+            v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xB1), 0xB1);
+
+            __m128 values = scale_to_float(v, scale, zero);
+            if (check_blank)
+            {
+                values = blank_to_nan(values, _mm_cmpeq_epi32(v, blank));
+            }
+            _mm_storeu_ps(destination + i, values);
+        }
+        return i;
+    }
+};
+#endif
+
+// converts count big-endian values of type Raw stored at source to physical values of type T
+// applying BSCALE, BZERO and BLANK of scaling while the values are in registers
+template <typename Raw, typename T>
+inline void big_to_physical
+(
+    void const* source,
+    T* destination,
+    std::size_t count,
+    io::pixel_scaling const& scaling
+)
+{
+    if (std::is_same<Raw, T>::value && scaling.is_identity())
+    {
+        big_to_native_copy(source, reinterpret_cast<Raw*>(destination), count);
+        return;
+    }
+
+    unsigned char const* bytes = static_cast<unsigned char const*>(source);
+    std::size_t const done = physical_kernel<Raw, T>::convert(bytes, destination, count,
+        scaling);
+    big_to_physical_scalar<Raw>(bytes + done * sizeof(Raw), destination + done, count - done,
+        scaling);
+}
+
+// converts count big-endian values stored with given bitpix to physical values of type T
+template <typename T>
+inline void big_to_physical
+(
+    io::bitpix stored,
+    void const* source,
+    T* destination,
+    std::size_t count,
+    io::pixel_scaling const& scaling
+)
+{
+    switch (stored)
+    {
+    case io::bitpix::B8:
+        big_to_physical<std::uint8_t>(source, destination, count, scaling);
+        return;
+    case io::bitpix::B16:
+        big_to_physical<std::int16_t>(source, destination, count, scaling);
+        return;
+    case io::bitpix::B32:
+        big_to_physical<std::int32_t>(source, destination, count, scaling);
+        return;
+    case io::bitpix::_B32:
+        big_to_physical<float>(source, destination, count, scaling);
+        return;
+    case io::bitpix::_B64:
+        big_to_physical<double>(source, destination, count, scaling);
+        return;
+    }
+    throw fits_exception();
+}
+///@endcond
+
+}}} //namespace boost::astronomy::detail
+
+#endif // !BOOST_ASTRONOMY_DETAIL_PHYSICAL_HPP
@@ -0,0 +1,191 @@
+#ifndef BOOST_ASTRONOMY_DETAIL_POSITIONED_FILE_HPP
+#define BOOST_ASTRONOMY_DETAIL_POSITIONED_FILE_HPP
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
+
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// read only file read with positioned reads (pread), which do not move a shared cursor
+// so a single positioned_file can be read by many threads at the same time
+class positioned_file
+{
+#if defined(_WIN32)
+    HANDLE handle_ = INVALID_HANDLE_VALUE;
+#else
+    int fd_ = -1;
+#endif
+
+public:
+    positioned_file() {}
+
+    explicit positioned_file(std::string const& path)
+    {
+        open(path);
+    }
+
+    positioned_file(positioned_file&& other) noexcept
+    {
+        swap(other);
+    }
+
+    positioned_file& operator=(positioned_file&& other) noexcept
+    {
+        positioned_file(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    positioned_file(positioned_file const&) = delete;
+    positioned_file& operator=(positioned_file const&) = delete;
+
+    ~positioned_file()
+    {
+        close();
+    }
+
+    void swap(positioned_file& other) noexcept
+    {
+#if defined(_WIN32)
+        std::swap(handle_, other.handle_);
+#else
+        std::swap(fd_, other.fd_);
+#endif
+    }
+
+    // opens the file for reading, throws fits_exception if it can not be opened
+    void open(std::string const& path)
+    {
+        close();
+#if defined(_WIN32)
+        handle_ = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle_ == INVALID_HANDLE_VALUE)
+        {
+            throw fits_exception();
+        }
+#else
+        do
+        {
+            fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        } while (fd_ < 0 && errno == EINTR);
+        if (fd_ < 0)
+        {
+            throw fits_exception();
+        }
+#endif
+    }
+
+    bool is_open() const
+    {
+#if defined(_WIN32)
+        return handle_ != INVALID_HANDLE_VALUE;
+#else
+        return fd_ >= 0;
+#endif
+    }
+
+    void close()
+    {
+#if defined(_WIN32)
+        if (handle_ != INVALID_HANDLE_VALUE)
+        {
+            ::CloseHandle(handle_);
+            handle_ = INVALID_HANDLE_VALUE;
+        }
+#else
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+            fd_ = -1;
+        }
+#endif
+    }
+
+#if !defined(_WIN32)
+    // returns the descriptor of file (e.g. to submit reads to io_uring)
+    int native_handle() const
+    {
+        return fd_;
+    }
+#endif
+
+    // returns the size of file in bytes
+    std::uint64_t size() const
+    {
+#if defined(_WIN32)
+        LARGE_INTEGER result;
+        if (!::GetFileSizeEx(handle_, &result))
+        {
+            throw fits_exception();
+        }
+        return static_cast<std::uint64_t>(result.QuadPart);
+#else
+        struct stat status;
+        if (::fstat(fd_, &status) != 0)
+        {
+            throw fits_exception();
+        }
+        return static_cast<std::uint64_t>(status.st_size);
+#endif
+    }
+
+    // reads exactly size bytes at offset, throws fits_exception on error or end of file
+    void read_at(void* buffer, std::size_t size, std::uint64_t offset) const
+    {
+        char* destination = static_cast<char*>(buffer);
+        while (size > 0)
+        {
+            std::size_t request = size < (std::size_t(1) << 30) ? size : (std::size_t(1) << 30);
+#if defined(_WIN32)
+            OVERLAPPED position = {};
+            position.Offset = static_cast<DWORD>(offset & 0xFFFFFFFFu);
+            position.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            DWORD count = 0;
+            if (!::ReadFile(handle_, destination, static_cast<DWORD>(request), &count, &position)
+                || count == 0)
+            {
+                throw fits_exception();
+            }
+            std::size_t done = static_cast<std::size_t>(count);
+#else
+            ssize_t count = ::pread(fd_, destination, request, static_cast<off_t>(offset));
+            if (count < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (count <= 0)
+            {
+                throw fits_exception();
+            }
+            std::size_t done = static_cast<std::size_t>(count);
+#endif
+            destination += done;
+            offset += done;
+            size -= done;
+        }
+    }
+};
+///@endcond
+
+}}} //namespace boost::astronomy::detail
+
+#endif // !BOOST_ASTRONOMY_DETAIL_POSITIONED_FILE_HPP
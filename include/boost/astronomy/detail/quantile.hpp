@@ -0,0 +1,273 @@
+#ifndef BOOST_ASTRONOMY_DETAIL_QUANTILE_HPP
+#define BOOST_ASTRONOMY_DETAIL_QUANTILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+#include <boost/astronomy/detail/parallel.hpp>
+#include <boost/astronomy/detail/statistics.hpp>
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// maps pixels of type T to unsigned keys in the same order as the pixels and back
+// keys are selected one digit of digit_bits bits at a time, most significant digit first
+template <typename T>
+struct radix_key {};
+
+template <>
+struct radix_key<std::uint8_t>
+{
+    using type = std::uint8_t;
+    static constexpr unsigned digit_bits = 8;
+
+    static type to_key(std::uint8_t value)
+    {
+        return value;
+    }
+
+    static std::uint8_t from_key(type key)
+    {
+        return key;
+    }
+};
+
+template <>
+struct radix_key<std::int16_t>
+{
+    using type = std::uint16_t;
+    static constexpr unsigned digit_bits = 16;
+
+    static type to_key(std::int16_t value)
+    {
+        return static_cast<type>(static_cast<type>(value) ^ 0x8000u);
+    }
+
+    static std::int16_t from_key(type key)
+    {
+        return static_cast<std::int16_t>(static_cast<type>(key ^ 0x8000u));
+    }
+};
+
+template <>
+struct radix_key<std::int32_t>
+{
+    using type = std::uint32_t;
+    static constexpr unsigned digit_bits = 16;
+
+    static type to_key(std::int32_t value)
+    {
+        return static_cast<type>(value) ^ 0x80000000u;
+    }
+
+    static std::int32_t from_key(type key)
+    {
+        return static_cast<std::int32_t>(key ^ 0x80000000u);
+    }
+};
+
+// IEEE floating point values are ordered as their bits once the negative values are flipped
+template <typename Float, typename Bits>
+struct float_radix_key
+{
+    using type = Bits;
+    static constexpr unsigned digit_bits = 16;
+    static constexpr Bits sign = Bits(1) << (sizeof(Bits) * 8 - 1);
+
+    static type to_key(Float value)
+    {
+        Bits bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return (bits & sign) ? static_cast<Bits>(~bits) : static_cast<Bits>(bits | sign);
+    }
+
+    static Float from_key(type key)
+    {
+        Bits const bits = (key & sign) ? static_cast<Bits>(key & ~sign) :
+            static_cast<Bits>(~key);
+        Float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+};
+
+template <>
+struct radix_key<float> : float_radix_key<float, std::uint32_t> {};
+
+template <>
+struct radix_key<double> : float_radix_key<double, std::uint64_t> {};
+
+// exact selection of the pixels of given rank among the valid pixels of an image without
+// copying or reordering them, the histogram of the most significant digit of the keys is
+// built once and each selection refines it digit by digit (one more pass over the pixels for
+// each digit after the first, none for 8 and 16 bit pixels)
+// once the pixels left are few (at most 1 / gather_fraction of the valid pixels) they are
+// copied in one more pass and selected by nth_element instead of refining the next digits
+// passes over large images are split among threads whose histograms are added together
+template <typename T>
+class radix_selector
+{
+    using key = radix_key<T>;
+    using key_type = typename key::type;
+
+    static constexpr unsigned key_bits = sizeof(key_type) * 8;
+    static constexpr unsigned digit_bits = key::digit_bits;
+    static constexpr unsigned digits = key_bits / digit_bits;
+    static constexpr std::size_t bins = std::size_t(1) << digit_bits;
+
+    // minimum number of pixels given to a thread by a pass
+    static constexpr std::size_t parallel_pixels = std::size_t(1) << 20;
+
+    // pixels left are copied when at most valid pixels / gather_fraction
+    static constexpr std::size_t gather_fraction = 16;
+
+    T const* pixels_;
+    std::size_t count_;
+    pixel_filter filter_;
+    std::size_t threads_;
+    std::vector<std::size_t> first_digit_; // histogram of most significant digit
+    std::size_t valid_ = 0;
+
+public:
+    // builds the histogram of the most significant digit of the valid pixels, pixels must
+    // stay alive and unchanged while the selector is used
+    radix_selector
+    (
+        T const* pixels,
+        std::size_t count,
+        pixel_filter const& filter,
+        std::size_t threads
+    ) : pixels_(pixels), count_(count), filter_(filter),
+        threads_(threads == 0 ? default_thread_count() : threads)
+    {
+        first_digit_ = histogram(0, 0);
+        for (std::size_t n : first_digit_)
+        {
+            valid_ += n;
+        }
+    }
+
+    // returns the number of valid pixels
+    std::size_t size() const
+    {
+        return valid_;
+    }
+
+    // returns the valid pixel which would be at rank (0 based, less than size()) if the
+    // valid pixels were sorted
+    T select(std::size_t rank) const
+    {
+        key_type prefix = 0;
+        std::vector<std::size_t> counts;
+        for (unsigned level = 0; level < digits; level++)
+        {
+            if (level != 0)
+            {
+                counts = histogram(level, prefix);
+            }
+            std::vector<std::size_t> const& current = level == 0 ? first_digit_ : counts;
+            std::size_t digit = 0;
+            while (rank >= current[digit])
+            {
+                rank -= current[digit];
+                digit++;
+            }
+            prefix = static_cast<key_type>((prefix << digit_bits) | digit);
+            if (level + 1 < digits && current[digit] <= valid_ / gather_fraction)
+            {
+                return gather_select(level, prefix, rank, current[digit]);
+            }
+        }
+        return key::from_key(prefix);
+    }
+
+private:
+    // histogram of digit at level (0 is the most significant) of the keys of valid pixels
+    // whose more significant digits are prefix
+    std::vector<std::size_t> histogram(unsigned level, key_type prefix) const
+    {
+        std::size_t const chunks = (std::min)(threads_, count_ / parallel_pixels);
+        if (chunks <= 1)
+        {
+            std::vector<std::size_t> result(bins, 0);
+            histogram_of_range(level, prefix, 0, count_, result.data());
+            return result;
+        }
+
+        std::vector<std::vector<std::size_t>> partial(chunks);
+        parallel_for(chunks, threads_, [&](std::size_t chunk)
+        {
+            partial[chunk].assign(bins, 0);
+            histogram_of_range(level, prefix, count_ / chunks * chunk,
+                chunk + 1 == chunks ? count_ : count_ / chunks * (chunk + 1),
+                partial[chunk].data());
+        });
+        std::vector<std::size_t> result(bins, 0);
+        for (std::vector<std::size_t> const& part : partial)
+        {
+            for (std::size_t bin = 0; bin < bins; bin++)
+            {
+                result[bin] += part[bin];
+            }
+        }
+        return result;
+    }
+
+    // copies the size valid pixels whose digits down to level are prefix and returns the one
+    // of rank among them
+    T gather_select(unsigned level, key_type prefix, std::size_t rank, std::size_t size) const
+    {
+        unsigned const shift = key_bits - (level + 1) * digit_bits;
+        std::vector<key_type> candidates;
+        candidates.reserve(size);
+        for (std::size_t i = 0; i < count_; i++)
+        {
+            if (!is_valid_pixel(pixels_, filter_.mask, i, filter_))
+            {
+                continue;
+            }
+            key_type const k = key::to_key(pixels_[i]);
+            if ((k >> shift) == prefix)
+            {
+                candidates.push_back(k);
+            }
+        }
+        std::nth_element(candidates.begin(), candidates.begin() + rank, candidates.end());
+        return key::from_key(candidates[rank]);
+    }
+
+    void histogram_of_range
+    (
+        unsigned level,
+        key_type prefix,
+        std::size_t first,
+        std::size_t last,
+        std::size_t* result
+    ) const
+    {
+        unsigned const shift = key_bits - (level + 1) * digit_bits;
+        key_type const digit_mask = static_cast<key_type>(bins - 1);
+        for (std::size_t i = first; i < last; i++)
+        {
+            if (!is_valid_pixel(pixels_, filter_.mask, i, filter_))
+            {
+                continue;
+            }
+            key_type const k = key::to_key(pixels_[i]);
+            //the digits above the current one must match prefix, at level 0 there are none
+            if (level != 0 && (k >> (shift + digit_bits)) != prefix)
+            {
+                continue;
+            }
+            result[(k >> shift) & digit_mask]++;
+        }
+    }
+};
+///@endcond
+
+}}} //namespace boost::astronomy::detail
+
+#endif // !BOOST_ASTRONOMY_DETAIL_QUANTILE_HPP
@@ -0,0 +1,247 @@
+#ifndef BOOST_ASTRONOMY_DETAIL_QUANTIZE_HPP
+#define BOOST_ASTRONOMY_DETAIL_QUANTIZE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <boost/astronomy/detail/exact_compare.hpp>
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// number of values in the sequence of random numbers used to dither quantized pixels
+constexpr std::size_t dither_random_count = 10000;
+
+// value of quantized pixels which are zero in the image (SUBTRACTIVE_DITHER_2)
+constexpr std::int32_t dither_zero_value = -2147483646;
+
+// value of quantized pixels which are NaN in the image (ZBLANK written by quantize)
+constexpr std::int32_t dither_null_value = -2147483647;
+
+// returns the uniformly distributed random values in (0, 1) used by subtractive dithering
+// generated by the Park-Miller generator from seed 1, as defined by the tile compression
+// convention so that images are restored exactly as they were quantized
+inline float const* dither_random_values()
+{
+    struct random_table
+    {
+        float values[dither_random_count];
+
+        random_table()
+        {
+            double const a = 16807.0;
+            double const m = 2147483647.0;
+            double seed = 1;
+            for (std::size_t i = 0; i < dither_random_count; i++)
+            {
+                double const temp = a * seed;
+                seed = temp - m * static_cast<double>(static_cast<std::int64_t>(temp / m));
+                values[i] = static_cast<float>(seed / m);
+            }
+        }
+    };
+
+    static random_table const table;
+    return table.values;
+}
+
+// method used to quantize floating point pixels to integers (ZQUANTIZ)
+enum class quantization
+{
+    none,
+    no_dither,
+    subtractive_dither_1,
+    subtractive_dither_2
+};
+
+// walks the sequence of dither values of a tile, tile is the position of tile (from 0)
+// and seed the value of ZDITHER0
+struct dither_sequence
+{
+    float const* random = dither_random_values();
+    std::size_t seed_index = 0;
+    std::size_t next = 0;
+
+    dither_sequence(std::size_t tile, std::size_t seed)
+    {
+        seed_index = (tile + (seed == 0 ? 0 : seed - 1)) % dither_random_count;
+        next = static_cast<std::size_t>(random[seed_index] * 500);
+    }
+
+    // returns the next dither value (the same one for every pixel, null or not)
+    float operator()()
+    {
+        float const value = random[next];
+        if (++next == dither_random_count)
+        {
+            seed_index = (seed_index + 1) % dither_random_count;
+            next = static_cast<std::size_t>(random[seed_index] * 500);
+        }
+        return value;
+    }
+};
+
+// restores count floating point pixels of tile from quantized values
+template <typename T>
+inline void dequantize
+(
+    std::int32_t const* values,
+    std::size_t count,
+    T* destination,
+    quantization method,
+    double scale,
+    double zero,
+    std::size_t tile,
+    std::size_t seed,
+    bool has_blank,
+    std::int32_t blank
+)
+{
+    T const nan = std::numeric_limits<T>::quiet_NaN();
+    if (method == quantization::no_dither || method == quantization::none)
+    {
+        for (std::size_t i = 0; i < count; i++)
+        {
+            destination[i] = has_blank && values[i] == blank ? nan :
+                static_cast<T>(values[i] * scale + zero);
+        }
+        return;
+    }
+
+    dither_sequence dither(tile, seed);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        double const offset = dither();
+        if (has_blank && values[i] == blank)
+        {
+            destination[i] = nan;
+        }
+        else if (method == quantization::subtractive_dither_2 && values[i] == dither_zero_value)
+        {
+            destination[i] = 0;
+        }
+        else
+        {
+            destination[i] = static_cast<T>((values[i] - offset + 0.5) * scale + zero);
+        }
+    }
+}
+
+// estimates the standard deviation of noise of count pixels from the median of absolute
+// second order differences (|2 x[i] - x[i-2] - x[i+2]|) of finite pixels, which is not biased
+// by smooth variations of the signal, returns 0 if there are less than 5 finite pixels
+template <typename T>
+inline double estimate_noise(T const* values, std::size_t count)
+{
+    std::vector<double> finite;
+    finite.reserve(count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        if (std::isfinite(values[i]))
+        {
+            finite.push_back(values[i]);
+        }
+    }
+    if (finite.size() < 5)
+    {
+        return 0;
+    }
+
+    std::vector<double> differences(finite.size() - 4);
+    for (std::size_t i = 2; i + 2 < finite.size(); i++)
+    {
+        differences[i - 2] = std::abs(2 * finite[i] - finite[i - 2] - finite[i + 2]);
+    }
+    std::size_t const middle = differences.size() / 2;
+    std::nth_element(differences.begin(), differences.begin() + static_cast<std::ptrdiff_t>(
+        middle), differences.end());
+    return 0.6052697 * differences[middle];
+}
+
+// quantizes count floating point pixels of tile to integers with scale (quantization step)
+// of noise / level, or -level when level is negative, and zero at the middle of the range
+// of pixels, dithered by the sequence of tile unless method is no_dither
+// NaN pixels are set to dither_null_value and has_null is set, zeros are kept exactly by
+// subtractive_dither_2, returns false if the tile can not be quantized (no noise, infinite
+// pixels or range too large for 32 bit integers), it must be stored losslessly then
+template <typename T>
+inline bool quantize
+(
+    T const* values,
+    std::size_t count,
+    std::int32_t* destination,
+    quantization method,
+    double level,
+    std::size_t tile,
+    std::size_t seed,
+    double& scale,
+    double& zero,
+    bool& has_null
+)
+{
+    if (level > 0)
+    {
+        scale = estimate_noise(values, count) / level;
+    }
+    else
+    {
+        scale = -level;
+    }
+    if (!(scale > 0))
+    {
+        return false;
+    }
+
+    double minimum = std::numeric_limits<double>::max();
+    double maximum = std::numeric_limits<double>::lowest();
+    for (std::size_t i = 0; i < count; i++)
+    {
+        if (std::isinf(values[i]))
+        {
+            return false;
+        }
+        if (!std::isnan(values[i]))
+        {
+            minimum = (std::min)(minimum, static_cast<double>(values[i]));
+            maximum = (std::max)(maximum, static_cast<double>(values[i]));
+        }
+    }
+    zero = minimum <= maximum ? minimum / 2 + maximum / 2 : 0;
+    //a few values below the range of int32 are reserved for nulls and zeros
+    if (minimum <= maximum && (maximum - minimum) / scale / 2 + 1 >= 2147483637.0)
+    {
+        return false;
+    }
+
+    dither_sequence dither(tile, seed);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        double const offset = method == quantization::no_dither ? 0.5 : dither();
+        if (std::isnan(values[i]))
+        {
+            destination[i] = dither_null_value;
+            has_null = true;
+        }
+        //only pixels which are exactly 0 are restored as 0 by SUBTRACTIVE_DITHER_2
+        else if (method == quantization::subtractive_dither_2 &&
+            is_exactly(static_cast<double>(values[i]), 0))
+        {
+            destination[i] = dither_zero_value;
+        }
+        else
+        {
+            destination[i] = static_cast<std::int32_t>(
+                std::lround((values[i] - zero) / scale + offset - 0.5));
+        }
+    }
+    return true;
+}
+///@endcond
+
+}}} //namespace boost::astronomy::detail
+
+#endif // !BOOST_ASTRONOMY_DETAIL_QUANTIZE_HPP
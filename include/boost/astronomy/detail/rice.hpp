@@ -0,0 +1,345 @@
+#ifndef BOOST_ASTRONOMY_DETAIL_RICE_HPP
+#define BOOST_ASTRONOMY_DETAIL_RICE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// parameters of the Rice code (RICE_1) of FITS tile compression for pixels of bytepix bytes
+// every block of pixels starts with fsbits bits holding the number of low bits stored
+// verbatim plus one, 0 marks a block of equal pixels and fsmax + 1 a block of raw pixels
+struct rice_parameters
+{
+    int fsbits = 0;
+    int fsmax = 0;
+    int bbits = 0;
+
+    explicit rice_parameters(std::size_t bytepix)
+    {
+        switch (bytepix)
+        {
+        case 1:
+            fsbits = 3;
+            fsmax = 6;
+            break;
+        case 2:
+            fsbits = 4;
+            fsmax = 14;
+            break;
+        case 4:
+            fsbits = 5;
+            fsmax = 25;
+            break;
+        default:
+            throw unsupported_compression_exception();
+        }
+        bbits = static_cast<int>(8 * bytepix);
+    }
+};
+
+// number of significant bits of every byte value (position of the highest bit set)
+struct rice_bit_count
+{
+    unsigned char bits[256];
+
+    rice_bit_count()
+    {
+        bits[0] = 0;
+        for (unsigned value = 1; value < 256; value++)
+        {
+            unsigned char count = 0;
+            for (unsigned rest = value; rest != 0; rest >>= 1)
+            {
+                count++;
+            }
+            bits[value] = count;
+        }
+    }
+};
+
+inline unsigned char const* rice_significant_bits()
+{
+    static rice_bit_count const table;
+    return table.bits;
+}
+
+// decodes count pixels compressed by the Rice algorithm in blocks of block_size pixels from
+// size bytes at source, Stored is the type of pixels compressed (std::uint8_t, std::int16_t
+// or std::int32_t for BYTEPIX 1, 2 and 4) and pixels are converted to Output
+// differences are accumulated modulo 2^32 and truncated to Stored, which wraps them the same
+// way as the encoder
+template <typename Stored, typename Output>
+inline void rice_decompress
+(
+    unsigned char const* source,
+    std::size_t size,
+    Output* destination,
+    std::size_t count,
+    std::size_t block_size
+)
+{
+    using unsigned_type = typename std::make_unsigned<Stored>::type;
+
+    if (count == 0)
+    {
+        return;
+    }
+    if (block_size == 0 || size < sizeof(Stored) + 1)
+    {
+        throw invalid_compressed_tile_exception();
+    }
+
+    rice_parameters const rice(sizeof(Stored));
+    unsigned char const* const bits_of = rice_significant_bits();
+    unsigned char const* const end = source + size;
+
+    auto next = [&]() -> std::uint32_t
+    {
+        if (source == end)
+        {
+            throw invalid_compressed_tile_exception();
+        }
+        return *source++;
+    };
+    auto store = [&](std::size_t i, std::uint32_t value)
+    {
+        destination[i] = static_cast<Output>(static_cast<Stored>(
+            static_cast<unsigned_type>(value)));
+    };
+
+    //first pixel is stored verbatim
+    std::uint32_t last = 0;
+    for (std::size_t k = 0; k < sizeof(Stored); k++)
+    {
+        last = (last << 8) | next();
+    }
+
+    std::uint32_t b = next(); //bits not consumed yet
+    int nbits = 8; //number of bits in b
+
+    for (std::size_t i = 0; i < count; )
+    {
+        nbits -= rice.fsbits;
+        while (nbits < 0)
+        {
+            b = (b << 8) | next();
+            nbits += 8;
+        }
+        int const fs = static_cast<int>(b >> nbits) - 1;
+        b &= (1u << nbits) - 1;
+
+        std::size_t const block_end = (std::min)(i + block_size, count);
+        if (fs < 0)
+        {
+            //all the differences are zero
+            for (; i < block_end; i++)
+            {
+                store(i, last);
+            }
+        }
+        else if (fs == rice.fsmax)
+        {
+            //differences are stored with bbits each
+            for (; i < block_end; i++)
+            {
+                int k = rice.bbits - nbits;
+                std::uint32_t diff = k < 32 ? b << k : 0;
+                for (k -= 8; k >= 0; k -= 8)
+                {
+                    diff |= next() << k;
+                }
+                if (nbits > 0)
+                {
+                    b = next();
+                    diff |= b >> (-k);
+                    b &= (1u << nbits) - 1;
+                }
+                else
+                {
+                    b = 0;
+                }
+
+                diff = (diff & 1) == 0 ? diff >> 1 : ~(diff >> 1);
+                last += diff;
+                store(i, last);
+            }
+        }
+        else
+        {
+            //zeros terminated by one give the high bits, followed by fs low bits
+            for (; i < block_end; i++)
+            {
+                while (b == 0)
+                {
+                    nbits += 8;
+                    b = next();
+                }
+                int const nzero = nbits - bits_of[b];
+                nbits -= nzero + 1;
+                b ^= 1u << nbits;
+                nbits -= fs;
+                while (nbits < 0)
+                {
+                    b = (b << 8) | next();
+                    nbits += 8;
+                }
+                std::uint32_t diff = (static_cast<std::uint32_t>(nzero) << fs) | (b >> nbits);
+                b &= (1u << nbits) - 1;
+
+                diff = (diff & 1) == 0 ? diff >> 1 : ~(diff >> 1);
+                last += diff;
+                store(i, last);
+            }
+        }
+    }
+}
+
+// writes bits most significant first, the last byte is padded with zero bits by finish
+struct rice_bit_writer
+{
+    std::vector<unsigned char>& bytes;
+    std::uint32_t pending = 0; //bits not written yet
+    int count = 0; //number of bits in pending (less than 8 between calls)
+
+    explicit rice_bit_writer(std::vector<unsigned char>& destination) : bytes(destination) {}
+
+    //writes the low n bits of value
+    void put(std::uint32_t value, int n)
+    {
+        if (n > 24)
+        {
+            put(value >> 16, n - 16);
+            n = 16;
+        }
+        pending = (pending << n) | (value & ((1u << n) - 1));
+        count += n;
+        while (count >= 8)
+        {
+            count -= 8;
+            bytes.push_back(static_cast<unsigned char>(pending >> count));
+        }
+        pending &= (1u << count) - 1;
+    }
+
+    //writes zeros bits of value 0 followed by a single bit of value 1
+    void put_unary(std::uint32_t zeros)
+    {
+        for (; zeros >= 16; zeros -= 16)
+        {
+            put(0, 16);
+        }
+        put(1, static_cast<int>(zeros) + 1);
+    }
+
+    void finish()
+    {
+        if (count > 0)
+        {
+            bytes.push_back(static_cast<unsigned char>(pending << (8 - count)));
+            count = 0;
+            pending = 0;
+        }
+    }
+};
+
+// appends count pixels compressed by the Rice algorithm in blocks of block_size pixels to
+// destination, pixels are converted to Stored (std::uint8_t, std::int16_t or std::int32_t for
+// BYTEPIX 1, 2 and 4) and differences of adjacent pixels wrap around the range of Stored
+// the split position of every block is chosen from the mean of mapped differences
+template <typename Stored, typename Input>
+inline void rice_compress
+(
+    Input const* source,
+    std::size_t count,
+    std::size_t block_size,
+    std::vector<unsigned char>& destination
+)
+{
+    using unsigned_type = typename std::make_unsigned<Stored>::type;
+    using signed_type = typename std::make_signed<Stored>::type;
+
+    if (count == 0)
+    {
+        return;
+    }
+    if (block_size == 0)
+    {
+        throw unsupported_compression_exception();
+    }
+
+    rice_parameters const rice(sizeof(Stored));
+    rice_bit_writer writer(destination);
+    std::vector<std::uint32_t> diff(block_size);
+
+    auto bits_of = [](Input value)
+    {
+        return static_cast<std::uint32_t>(static_cast<unsigned_type>(static_cast<Stored>(value)));
+    };
+
+    std::uint32_t last = bits_of(source[0]);
+    writer.put(last, rice.bbits);
+
+    for (std::size_t i = 0; i < count; i += block_size)
+    {
+        std::size_t const pixels = (std::min)(block_size, count - i);
+
+        //differences mapped to unsigned (0, -1, 1, -2, 2... to 0, 1, 2, 3, 4...)
+        double sum = 0;
+        for (std::size_t j = 0; j < pixels; j++)
+        {
+            std::uint32_t const next = bits_of(source[i + j]);
+            std::int32_t const delta = static_cast<std::int32_t>(static_cast<signed_type>(
+                static_cast<unsigned_type>(next - last)));
+            std::uint32_t const doubled = static_cast<std::uint32_t>(delta) << 1;
+            diff[j] = delta < 0 ? ~doubled : doubled;
+            sum += diff[j];
+            last = next;
+        }
+
+        double mean = (sum - static_cast<double>(pixels / 2) - 1) / static_cast<double>(pixels);
+        std::uint32_t rest = mean < 0 ? 0 : static_cast<std::uint32_t>(mean) >> 1;
+        int fs = 0;
+        for (; rest > 0; fs++)
+        {
+            rest >>= 1;
+        }
+
+        if (fs >= rice.fsmax)
+        {
+            writer.put(static_cast<std::uint32_t>(rice.fsmax + 1), rice.fsbits);
+            for (std::size_t j = 0; j < pixels; j++)
+            {
+                writer.put(diff[j], rice.bbits);
+            }
+        }
+        else if (fs == 0 && sum <= 0)
+        {
+            writer.put(0, rice.fsbits);
+        }
+        else
+        {
+            writer.put(static_cast<std::uint32_t>(fs + 1), rice.fsbits);
+            for (std::size_t j = 0; j < pixels; j++)
+            {
+                writer.put_unary(diff[j] >> fs);
+                if (fs > 0)
+                {
+                    writer.put(diff[j], fs);
+                }
+            }
+        }
+    }
+    writer.finish();
+}
+///@endcond
+
+}}} //namespace boost::astronomy::detail
+
+#endif // !BOOST_ASTRONOMY_DETAIL_RICE_HPP
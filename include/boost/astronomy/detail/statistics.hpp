@@ -0,0 +1,447 @@
+#ifndef BOOST_ASTRONOMY_DETAIL_STATISTICS_HPP
+#define BOOST_ASTRONOMY_DETAIL_STATISTICS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <algorithm>
+#include <vector>
+
+#include <boost/astronomy/detail/byteswap.hpp>
+#include <boost/astronomy/detail/parallel.hpp>
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// pixels used by the statistics, a pixel is valid unless it is NaN (if skip_nan), an integer
+// equal to blank (if has_blank) or marked by a nonzero byte in mask (if not null)
+struct pixel_filter
+{
+    bool skip_nan = true;
+    bool has_blank = false;
+    std::int64_t blank = 0;
+    std::uint8_t const* mask = nullptr;
+};
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value, bool>::type
+is_valid_value(T value, pixel_filter const& filter)
+{
+    return !filter.has_blank || static_cast<std::int64_t>(value) != filter.blank;
+}
+
+template <typename T>
+inline typename std::enable_if<!std::is_integral<T>::value, bool>::type
+is_valid_value(T value, pixel_filter const& filter)
+{
+    return !filter.skip_nan || !std::isnan(value);
+}
+
+// returns true if pixel i of pixels is valid, mask is the mask of filter moved to pixels
+template <typename T>
+inline bool is_valid_pixel
+(
+    T const* pixels,
+    std::uint8_t const* mask,
+    std::size_t i,
+    pixel_filter const& filter
+)
+{
+    return is_valid_value(pixels[i], filter) && !(mask && mask[i] != 0);
+}
+
+// count, extremes and central moments (m2, m3 and m4 are the sums of (x - mean)^k) of a set
+// of values, sets are combined with the pairwise formulas of Chan and Pebay so that blocks
+// and threads can be summarised on their own and merged
+struct moments
+{
+    std::size_t count = 0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    double mean = 0;
+    double m2 = 0;
+    double m3 = 0;
+    double m4 = 0;
+
+    // adds the values summarised by other to the values summarised by this
+    void merge(moments const& other)
+    {
+        if (other.count == 0)
+        {
+            return;
+        }
+        if (count == 0)
+        {
+            *this = other;
+            return;
+        }
+
+        double const na = static_cast<double>(count);
+        double const nb = static_cast<double>(other.count);
+        double const n = na + nb;
+        double const delta = other.mean - mean;
+        double const delta_n = delta / n;
+        double const delta_n2 = delta_n * delta_n;
+        double const cross = delta * delta_n * na * nb; // delta^2 * na * nb / n
+
+        m4 += other.m4 + cross * delta_n2 * (na * na - na * nb + nb * nb) +
+            6 * delta_n2 * (na * na * other.m2 + nb * nb * m2) +
+            4 * delta_n * (na * other.m3 - nb * m3);
+        m3 += other.m3 + cross * delta_n * (na - nb) + 3 * delta_n * (na * other.m2 - nb * m2);
+        m2 += other.m2 + cross;
+        mean += delta_n * nb;
+        count += other.count;
+        min = (std::min)(min, other.min);
+        max = (std::max)(max, other.max);
+    }
+};
+
+// sums of the powers of (x - shift) of the valid pixels of a block
+struct power_sums
+{
+    double count = 0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    double s1 = 0;
+    double s2 = 0;
+    double s3 = 0;
+    double s4 = 0;
+
+    // returns the moments of the block, shift must be close to the mean of the block for
+    // the central moments not to lose precision
+    moments central(double shift) const
+    {
+        moments result;
+        result.count = static_cast<std::size_t>(count);
+        if (result.count == 0)
+        {
+            return result;
+        }
+        double const c = s1 / count;
+        result.min = min;
+        result.max = max;
+        result.mean = shift + c;
+        result.m2 = s2 - c * s1;
+        result.m3 = s3 - 3 * c * s2 + 2 * c * c * s1;
+        result.m4 = s4 - 4 * c * s3 + 6 * c * c * s2 - 3 * c * c * c * s1;
+        return result;
+    }
+};
+
+// adds the valid pixels among count pixels to sums one at a time
+template <typename T>
+inline void power_sums_scalar
+(
+    T const* pixels,
+    std::uint8_t const* mask,
+    std::size_t count,
+    pixel_filter const& filter,
+    double shift,
+    power_sums& sums
+)
+{
+    for (std::size_t i = 0; i < count; i++)
+    {
+        if (!is_valid_pixel(pixels, mask, i, filter))
+        {
+            continue;
+        }
+        double const value = static_cast<double>(pixels[i]);
+        double const d = value - shift;
+        double const d2 = d * d;
+        sums.count++;
+        sums.min = (std::min)(sums.min, value);
+        sums.max = (std::max)(sums.max, value);
+        sums.s1 += d;
+        sums.s2 += d2;
+        sums.s3 += d2 * d;
+        sums.s4 += d2 * d2;
+    }
+}
+
+// converts 4 pixels of type T to two pairs of doubles for the vectorized power sums
+template <typename T>
+struct double_lanes
+{
+    static constexpr bool vectorized = false;
+};
+
+// vectorized body of accumulate_power_sums for T, returns the number of pixels processed
+template <typename T, bool Vectorized = double_lanes<T>::vectorized>
+struct power_sums_kernel
+{
+    static std::size_t run(T const*, std::uint8_t const*, std::size_t, pixel_filter const&,
+        double, power_sums&)
+    {
+        return 0;
+    }
+};
+
+#if defined(BOOST_ASTRONOMY_SIMD_AVX2) || defined(BOOST_ASTRONOMY_SIMD_SSSE3) || \
+    defined(BOOST_ASTRONOMY_SIMD_SSE2)
+template <>
+struct double_lanes<std::uint8_t>
+{
+    static constexpr bool vectorized = true;
+
+    static void load(std::uint8_t const* pixels, __m128d* values)
+    {
+        std::int32_t bytes;
+        std::memcpy(&bytes, pixels, sizeof(bytes));
+        __m128i const zeros = _mm_setzero_si128();
+        __m128i v = _mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zeros);
+        v = _mm_unpacklo_epi16(v, zeros);
+        values[0] = _mm_cvtepi32_pd(v);
+        values[1] = _mm_cvtepi32_pd(_mm_shuffle_epi32(v, 0xEE));
+    }
+};
+
+template <>
+struct double_lanes<std::int16_t>
+{
+    static constexpr bool vectorized = true;
+
+    static void load(std::int16_t const* pixels, __m128d* values)
+    {
+        __m128i v = _mm_loadl_epi64(reinterpret_cast<__m128i const*>(pixels));
+        v = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        values[0] = _mm_cvtepi32_pd(v);
+        values[1] = _mm_cvtepi32_pd(_mm_shuffle_epi32(v, 0xEE));
+    }
+};
+
+template <>
+struct double_lanes<std::int32_t>
+{
+    static constexpr bool vectorized = true;
+
+    static void load(std::int32_t const* pixels, __m128d* values)
+    {
+        __m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(pixels));
+        values[0] = _mm_cvtepi32_pd(v);
+        values[1] = _mm_cvtepi32_pd(_mm_shuffle_epi32(v, 0xEE));
+    }
+};
+
+template <>
+struct double_lanes<float>
+{
+    static constexpr bool vectorized = true;
+
+    static void load(float const* pixels, __m128d* values)
+    {
+        __m128 const v = _mm_loadu_ps(pixels);
+        values[0] = _mm_cvtps_pd(v);
+        values[1] = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+    }
+};
+
+template <>
+struct double_lanes<double>
+{
+    static constexpr bool vectorized = true;
+
+    static void load(double const* pixels, __m128d* values)
+    {
+        values[0] = _mm_loadu_pd(pixels);
+        values[1] = _mm_loadu_pd(pixels + 2);
+    }
+};
+
+// power sums of 4 pixels at a time in double lanes, validity is tested without branches
+// returns the number of pixels processed
+template <typename T, bool UseMask>
+inline std::size_t power_sums_simd
+(
+    T const* pixels,
+    std::uint8_t const* mask,
+    std::size_t count,
+    pixel_filter const& filter,
+    double shift,
+    power_sums& sums
+)
+{
+    __m128d const all = _mm_castsi128_pd(_mm_set1_epi32(-1));
+    __m128d const keep_nan = filter.skip_nan ? _mm_setzero_pd() : all;
+    __m128d const keep_blank =
+        filter.has_blank && std::is_integral<T>::value ? _mm_setzero_pd() : all;
+    __m128d const blank = _mm_set1_pd(static_cast<double>(filter.blank));
+    __m128d const shift_lanes = _mm_set1_pd(shift);
+    __m128d const one = _mm_set1_pd(1.0);
+    __m128d const infinity = _mm_set1_pd(std::numeric_limits<double>::infinity());
+    __m128d const minus_infinity = _mm_set1_pd(-std::numeric_limits<double>::infinity());
+    __m128i const zeros = _mm_setzero_si128();
+
+    __m128d n = _mm_setzero_pd();
+    __m128d low = infinity;
+    __m128d high = minus_infinity;
+    __m128d s1 = _mm_setzero_pd();
+    __m128d s2 = _mm_setzero_pd();
+    __m128d s3 = _mm_setzero_pd();
+    __m128d s4 = _mm_setzero_pd();
+
+    std::size_t const vector_end = count - count % 4;
+    for (std::size_t i = 0; i < vector_end; i += 4)
+    {
+        __m128d x[2];
+        double_lanes<T>::load(pixels + i, x);
+        __m128d flags[2] = {all, all};
+        if (UseMask)
+        {
+            std::int32_t bytes;
+            std::memcpy(&bytes, mask + i, sizeof(bytes));
+            __m128i m = _mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zeros);
+            m = _mm_cmpeq_epi32(_mm_unpacklo_epi16(m, zeros), zeros);
+            flags[0] = _mm_castsi128_pd(_mm_unpacklo_epi32(m, m));
+            flags[1] = _mm_castsi128_pd(_mm_unpackhi_epi32(m, m));
+        }
+        for (int h = 0; h < 2; h++)
+        {
+            __m128d const valid = _mm_and_pd(flags[h], _mm_and_pd(
+                _mm_or_pd(_mm_cmpord_pd(x[h], x[h]), keep_nan),
+                _mm_or_pd(_mm_cmpneq_pd(x[h], blank), keep_blank)));
+            n = _mm_add_pd(n, _mm_and_pd(valid, one));
+            low = _mm_min_pd(low, _mm_or_pd(_mm_and_pd(valid, x[h]),
+                _mm_andnot_pd(valid, infinity)));
+            high = _mm_max_pd(high, _mm_or_pd(_mm_and_pd(valid, x[h]),
+                _mm_andnot_pd(valid, minus_infinity)));
+
+            __m128d const d = _mm_and_pd(valid, _mm_sub_pd(x[h], shift_lanes));
+            __m128d const d2 = _mm_mul_pd(d, d);
+            s1 = _mm_add_pd(s1, d);
+            s2 = _mm_add_pd(s2, d2);
+            s3 = _mm_add_pd(s3, _mm_mul_pd(d2, d));
+            s4 = _mm_add_pd(s4, _mm_mul_pd(d2, d2));
+        }
+    }
+
+    double lanes[2];
+    auto reduce = [&lanes](__m128d v)
+    {
+        _mm_storeu_pd(lanes, v);
+        return lanes[0] + lanes[1];
+    };
+    sums.count += reduce(n);
+    sums.s1 += reduce(s1);
+    sums.s2 += reduce(s2);
+    sums.s3 += reduce(s3);
+    sums.s4 += reduce(s4);
+    _mm_storeu_pd(lanes, low);
+    sums.min = (std::min)(sums.min, (std::min)(lanes[0], lanes[1]));
+    _mm_storeu_pd(lanes, high);
+    sums.max = (std::max)(sums.max, (std::max)(lanes[0], lanes[1]));
+    return vector_end;
+}
+
+template <typename T>
+struct power_sums_kernel<T, true>
+{
+    static std::size_t run(T const* pixels, std::uint8_t const* mask, std::size_t count,
+        pixel_filter const& filter, double shift, power_sums& sums)
+    {
+        return mask ? power_sums_simd<T, true>(pixels, mask, count, filter, shift, sums) :
+            power_sums_simd<T, false>(pixels, mask, count, filter, shift, sums);
+    }
+};
+#endif
+
+// adds the valid pixels among count pixels to sums, vectorized where possible
+template <typename T>
+inline void accumulate_power_sums
+(
+    T const* pixels,
+    std::uint8_t const* mask,
+    std::size_t count,
+    pixel_filter const& filter,
+    double shift,
+    power_sums& sums
+)
+{
+    std::size_t const done = power_sums_kernel<T>::run(pixels, mask, count, filter, shift,
+        sums);
+    power_sums_scalar(pixels + done, mask ? mask + done : nullptr, count - done, filter,
+        shift, sums);
+}
+
+// number of pixels whose power sums are taken about the same shift
+constexpr std::size_t moments_block = 4096;
+
+// minimum number of pixels given to a thread by image_moments
+constexpr std::size_t moments_parallel_pixels = std::size_t(1) << 20;
+
+// returns the moments of the valid pixels in [first, last) in a single pass
+// the power sums of a block are taken about the mean of the blocks before it (the first valid
+// pixel for the first block) and merged pairwise, so the result stays accurate when the mean
+// is large compared to the spread or the first pixels are outliers
+template <typename T>
+inline moments moments_of_range
+(
+    T const* pixels,
+    std::size_t first,
+    std::size_t last,
+    pixel_filter const& filter
+)
+{
+    moments result;
+    while (first < last && !is_valid_pixel(pixels, filter.mask, first, filter))
+    {
+        first++;
+    }
+    if (first == last)
+    {
+        return result;
+    }
+
+    double shift = static_cast<double>(pixels[first]);
+    for (std::size_t i = first; i < last; i += moments_block)
+    {
+        power_sums sums;
+        accumulate_power_sums(pixels + i, filter.mask ? filter.mask + i : nullptr,
+            (std::min)(moments_block, last - i), filter, shift, sums);
+        result.merge(sums.central(shift));
+        shift = result.mean;
+    }
+    return result;
+}
+
+// returns the count, extremes and central moments of the valid pixels among count pixels in
+// a single pass without copying or allocating per pixel, large images are split among up to
+// threads threads (0 for all the cores) whose moments are merged at the end
+template <typename T>
+inline moments image_moments
+(
+    T const* pixels,
+    std::size_t count,
+    pixel_filter const& filter,
+    std::size_t threads
+)
+{
+    std::size_t const workers = threads == 0 ? default_thread_count() : threads;
+    std::size_t const chunks = (std::min)(workers, count / moments_parallel_pixels);
+    if (chunks <= 1)
+    {
+        return moments_of_range(pixels, 0, count, filter);
+    }
+
+    std::vector<moments> partial(chunks);
+    parallel_for(chunks, workers, [&](std::size_t chunk)
+    {
+        partial[chunk] = moments_of_range(pixels, count / chunks * chunk,
+            chunk + 1 == chunks ? count : count / chunks * (chunk + 1), filter);
+    });
+
+    moments result;
+    for (moments const& part : partial)
+    {
+        result.merge(part);
+    }
+    return result;
+}
+///@endcond
+
+}}} //namespace boost::astronomy::detail
+
+#endif // !BOOST_ASTRONOMY_DETAIL_STATISTICS_HPP
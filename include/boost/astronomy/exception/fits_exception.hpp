@@ -79,6 +79,69 @@ namespace boost
             }
         };
 
+        class invalid_cutout_range_exception : public fits_exception
+        {
+        public:
+            const char* what() const throw()
+            {
+                return "Cutout range must be inside the image and stride must be positive";
+            }
+        };
+
+        class invalid_table_field_exception : public fits_exception
+        {
+        public:
+            const char* what() const throw()
+            {
+                return "Field of ASCII table is not a valid number";
+            }
+        };
+
+        class unsupported_compression_exception : public fits_exception
+        {
+        public:
+            const char* what() const throw()
+            {
+                return "Compression algorithm or access to compressed data is not supported";
+            }
+        };
+
+        class invalid_compressed_tile_exception : public fits_exception
+        {
+        public:
+            const char* what() const throw()
+            {
+                return "Tile of compressed image is corrupted";
+            }
+        };
+
+        class invalid_gzip_stream_exception : public fits_exception
+        {
+        public:
+            const char* what() const throw()
+            {
+                return "Gzip compressed file is corrupted or truncated";
+            }
+        };
+
+        class unsupported_io_backend_exception : public fits_exception
+        {
+        public:
+            const char* what() const throw()
+            {
+                return "I/O backend is not supported on this system";
+            }
+        };
+
+        class invalid_quantile_exception : public fits_exception
+        {
+        public:
+            const char* what() const throw()
+            {
+                return "Quantile must be between 0 and 1";
+            }
+        };
+
     } //namespace astronomy
 } //namespace boost
 #endif // !BOOST_ASTRONOMY_EXCEPTION_FITS_EXCEPTION_HPP
@@ -0,0 +1,230 @@
+#ifndef BOOST_ASTRONOMY_IO_ARRAY_VIEW_HPP
+#define BOOST_ASTRONOMY_IO_ARRAY_VIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <complex>
+
+#include <boost/astronomy/io/column.hpp>
+#include <boost/astronomy/detail/byteswap.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// decodes big-endian elements of a variable length array stored in heap
+template <typename T>
+struct array_element
+{
+    static std::size_t const size = sizeof(T);
+
+    static T load(char const* source)
+    {
+        return load_big_endian<T>(source);
+    }
+
+    static void decode(char const* source, T* destination, std::size_t count)
+    {
+        big_to_native_copy(source, destination, count);
+    }
+};
+
+// characters of A arrays
+template <>
+struct array_element<char>
+{
+    static std::size_t const size = 1;
+
+    static char load(char const* source)
+    {
+        return *source;
+    }
+
+    static void decode(char const* source, char* destination, std::size_t count)
+    {
+        std::memcpy(destination, source, count);
+    }
+};
+
+// logical values of L arrays, 'T' is true and anything else is false
+template <>
+struct array_element<bool>
+{
+    static std::size_t const size = 1;
+
+    static bool load(char const* source)
+    {
+        return *source == 'T';
+    }
+
+    static void decode(char const* source, bool* destination, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; i++)
+        {
+            destination[i] = source[i] == 'T';
+        }
+    }
+};
+
+// real and imaginary parts of C and M arrays are swapped as separate values
+template <typename T>
+struct array_element<std::complex<T>>
+{
+    static std::size_t const size = 2 * sizeof(T);
+
+    static std::complex<T> load(char const* source)
+    {
+        return std::complex<T>(load_big_endian<T>(source), load_big_endian<T>(source + sizeof(T)));
+    }
+
+    static void decode(char const* source, std::complex<T>* destination, std::size_t count)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        std::memcpy(destination, source, count * size);
+        big_to_native_inplace(reinterpret_cast<T*>(destination), 2 * count);
+    }
+};
+///@endcond
+
+} //namespace detail
+
+namespace io {
+
+//! non-owning view of the big-endian elements of a variable length array stored in the heap
+//! of a binary table, elements are decoded only when accessed
+template <typename T>
+struct array_view
+{
+public:
+    using value_type = T;
+
+protected:
+    char const* bytes_ = nullptr; //! first byte of the array in heap
+    std::size_t size_ = 0; //! number of elements in array
+
+public:
+    array_view() {}
+
+    array_view(char const* bytes, std::size_t size) : bytes_(bytes), size_(size) {}
+
+    //! returns the number of elements in the array
+    std::size_t size() const
+    {
+        return this->size_;
+    }
+
+    //! returns true if the array has no elements
+    bool empty() const
+    {
+        return this->size_ == 0;
+    }
+
+    //! returns the raw (big-endian) bytes of the array
+    char const* bytes() const
+    {
+        return this->bytes_;
+    }
+
+    //! returns the element at index i decoded to native byte order
+    T operator[] (std::size_t i) const
+    {
+        return detail::array_element<T>::load(this->bytes_ + i * detail::array_element<T>::size);
+    }
+
+    //! decodes count elements starting from index first into the destination
+    void decode(T* destination, std::size_t first, std::size_t count) const
+    {
+        detail::array_element<T>::decode(this->bytes_ + first * detail::array_element<T>::size,
+            destination, count);
+    }
+
+    //! decodes all the elements into the destination
+    void decode(T* destination) const
+    {
+        decode(destination, 0, this->size_);
+    }
+};
+
+//! non-owning view of a variable length array column (TFORM rPt(emax) or rQt(emax)) of a
+//! binary table stored in memory (usually a memory mapped file or the data unit read)
+//! descriptors are read from the rows and arrays are exposed as array_view into the heap
+//! so iterating the rows neither copies nor allocates
+template <typename T>
+struct variable_length_column
+{
+protected:
+    char const* descriptors_ = nullptr; //! descriptor of the first row
+    std::size_t rows_ = 0; //! number of rows
+    std::size_t row_size_ = 0; //! bytes in a row
+    bool wide_ = false; //! true for 64 bit (Q) descriptors
+    bool bits_ = false; //! true for arrays of bits (X), elements are bytes holding 8 bits
+    char const* heap_ = nullptr; //! first byte of heap
+    std::size_t heap_size_ = 0; //! bytes in heap
+
+public:
+    variable_length_column() {}
+
+    //! creates the view of column col of a table with rows of row_size bytes starting at
+    //! table whose heap of heap_size bytes starts at heap
+    variable_length_column
+    (
+        column const& col,
+        char const* table,
+        std::size_t rows,
+        std::size_t row_size,
+        char const* heap,
+        std::size_t heap_size
+    ) :
+        descriptors_(table + col.offset()), rows_(rows), row_size_(row_size),
+        wide_(col.type() == 'Q'), bits_(col.array_type() == 'X'), heap_(heap),
+        heap_size_(heap_size) {}
+
+    //! returns the number of rows
+    std::size_t size() const
+    {
+        return this->rows_;
+    }
+
+    //! returns the number of elements of the array of row as stored in descriptor
+    //! (bits for arrays of X)
+    std::size_t length(std::size_t row) const
+    {
+        return static_cast<std::size_t>(wide_ ?
+            detail::load_big_endian<std::uint64_t>(descriptor(row)) :
+            detail::load_big_endian<std::uint32_t>(descriptor(row)));
+    }
+
+    //! returns the offset of the array of row from the start of heap
+    std::size_t heap_offset(std::size_t row) const
+    {
+        return static_cast<std::size_t>(wide_ ?
+            detail::load_big_endian<std::uint64_t>(descriptor(row) + 8) :
+            detail::load_big_endian<std::uint32_t>(descriptor(row) + 4));
+    }
+
+    //! returns the view of the array of row
+    array_view<T> operator[] (std::size_t row) const
+    {
+        std::size_t const count = bits_ ? (length(row) + 7) / 8 : length(row);
+        std::size_t const offset = heap_offset(row);
+        if (offset > heap_size_ || count > (heap_size_ - offset) / detail::array_element<T>::size)
+        {
+            throw fits_exception();
+        }
+        return array_view<T>(heap_ + offset, count);
+    }
+
+protected:
+    char const* descriptor(std::size_t row) const
+    {
+        return descriptors_ + row * row_size_;
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_ARRAY_VIEW_HPP
@@ -0,0 +1,403 @@
+#ifndef BOOST_ASTRONOMY_IO_ASCII_TABLE_EXTENSION_HPP
+#define BOOST_ASTRONOMY_IO_ASCII_TABLE_EXTENSION_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <boost/astronomy/detail/charconv.hpp>
+#include <boost/astronomy/io/byte_source.hpp>
+#include <boost/astronomy/io/table_extension.hpp>
+#include <boost/astronomy/io/binary_table_extension.hpp>
+#include <boost/astronomy/io/column.hpp>
+#include <boost/astronomy/io/column_data.hpp>
+#include <boost/astronomy/io/hdu_index.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// sets data type, width and offset in row of column from its TFORM (Aw, Iw, Fw.d, Ew.d or Dw.d)
+// and TBCOL, returns the number of digits after implied decimal point (d)
+inline std::size_t parse_ascii_tform(io::column& col)
+{
+    std::string const tform = col.TFORM();
+    if (tform.empty() || col.TBCOL() == 0)
+    {
+        throw invalid_table_colum_format();
+    }
+
+    char const type = tform[0];
+    if (type != 'A' && type != 'I' && type != 'F' && type != 'E' && type != 'D')
+    {
+        throw invalid_table_colum_format();
+    }
+
+    char const* first = tform.data() + 1;
+    char const* const last = tform.data() + tform.size();
+    char const* dot = first;
+    while (dot != last && *dot != '.')
+    {
+        ++dot;
+    }
+
+    std::size_t width = 0;
+    std::size_t decimals = 0;
+    if (!parse_integer(first, dot, width) || width == 0 ||
+        (dot != last && !parse_integer(dot + 1, last, decimals)))
+    {
+        throw invalid_table_colum_format();
+    }
+
+    col.repeat(1);
+    col.type(type);
+    col.width(width);
+    col.offset(col.TBCOL() - 1);
+    return decimals;
+}
+
+// calls f(type_tag<T>()) with the type T used by column_data to store values of ASCII type
+template <typename Function>
+inline void visit_ascii_type(char type, Function&& f)
+{
+    switch (type)
+    {
+    case 'A':
+        f(type_tag<std::string>());
+        return;
+    case 'I':
+        f(type_tag<std::int64_t>());
+        return;
+    case 'F':
+    case 'E':
+    case 'D':
+        f(type_tag<double>());
+        return;
+    }
+    throw invalid_table_colum_format();
+}
+
+// layout of an ASCII table column needed to decode its fields
+struct ascii_field_format
+{
+    std::size_t offset = 0; // offset of field in row
+    std::size_t width = 0; // characters in field
+    std::size_t decimals = 0; // digits after implied decimal point of F, E and D
+    std::string null; // TNULL without trailing spaces, empty if not defined
+};
+
+// narrows [first, last) to the field without leading and trailing spaces
+inline void trim_field(char const*& first, char const*& last)
+{
+    while (first != last && *first == ' ')
+    {
+        ++first;
+    }
+    while (last != first && last[-1] == ' ')
+    {
+        --last;
+    }
+}
+
+inline bool is_null_field(char const* first, char const* last, ascii_field_format const& format)
+{
+    std::size_t const length = static_cast<std::size_t>(last - first);
+    return first == last ||
+        (!format.null.empty() && format.null.size() == length &&
+            format.null.compare(0, length, first, length) == 0);
+}
+
+// null and blank integer fields are 0
+inline void parse_ascii_field(char const* first, char const* last,
+    ascii_field_format const& format, std::int64_t& value)
+{
+    value = 0;
+    if (!is_null_field(first, last, format) && !parse_integer(first, last, value))
+    {
+        throw invalid_table_field_exception();
+    }
+}
+
+// null and blank real fields are NaN, values without decimal point are scaled by 10^-d
+inline void parse_ascii_field(char const* first, char const* last,
+    ascii_field_format const& format, double& value)
+{
+    if (is_null_field(first, last, format))
+    {
+        value = std::numeric_limits<double>::quiet_NaN();
+        return;
+    }
+    if (!parse_real(first, last, value))
+    {
+        throw invalid_table_field_exception();
+    }
+    if (format.decimals != 0 && std::char_traits<char>::find(first,
+        static_cast<std::size_t>(last - first), '.') == nullptr)
+    {
+        for (std::size_t i = 0; i < format.decimals; i++)
+        {
+            value /= 10;
+        }
+    }
+}
+
+// appends the values of column in count rows starting at rows, fields are parsed in place
+template <typename T>
+inline void decode_ascii_rows
+(
+    char const* rows,
+    std::size_t count,
+    std::size_t row_size,
+    ascii_field_format const& format,
+    std::vector<T>& values
+)
+{
+    std::size_t const first_value = values.size();
+    values.resize(first_value + count);
+
+    char const* field = rows + format.offset;
+    for (std::size_t r = 0; r < count; r++, field += row_size)
+    {
+        char const* first = field;
+        char const* last = field + format.width;
+        trim_field(first, last);
+        parse_ascii_field(first, last, format, values[first_value + r]);
+    }
+}
+
+// one string for each row without trailing spaces
+inline void decode_ascii_rows
+(
+    char const* rows,
+    std::size_t count,
+    std::size_t row_size,
+    ascii_field_format const& format,
+    std::vector<std::string>& values
+)
+{
+    char const* field = rows + format.offset;
+    for (std::size_t r = 0; r < count; r++, field += row_size)
+    {
+        std::size_t length = format.width;
+        while (length > 0 && field[length - 1] == ' ')
+        {
+            length--;
+        }
+        values.emplace_back(field, length);
+    }
+}
+///@endcond
+
+} //namespace detail
+
+namespace io {
+
+//! ASCII table extension (XTENSION = 'TABLE'), every field is text at TBCOL of a row and
+//! values of columns are parsed on request into column_data<T> where T is the type of
+//! TFORM (std::string for Aw, std::int64_t for Iw, double for Fw.d, Ew.d and Dw.d)
+//! blank fields and fields equal to TNULL are 0 for integers and NaN for reals
+struct ascii_table_extension : public table_extension
+{
+protected:
+    std::vector<detail::ascii_field_format> field_formats;
+
+public:
+    //! default number of bytes read at once when columns are read from file
+    static constexpr std::size_t default_block_bytes = std::size_t(4) << 20;
+
+    ascii_table_extension() {}
+
+    //!reads the header and data unit from current position of file
+    ascii_table_extension(std::istream &file) : table_extension(file)
+    {
+        set_column_layout();
+        read_data(file);
+    }
+
+    //!reads the data unit from current position of file
+    ascii_table_extension(std::istream &file, hdu const& other) : table_extension(file, other)
+    {
+        set_column_layout();
+        read_data(file);
+    }
+
+    //!creates the table from header only, columns can be read from file by read_columns
+    ascii_table_extension(hdu const& other) : table_extension(other)
+    {
+        set_column_layout();
+    }
+
+    //!returns the values of column with TTYPE name from the data unit read
+    //!T is either the type of TFORM or an arithmetic type to which the physical
+    //!values (TZERO + TSCAL * value) are converted
+    template <typename T>
+    column_data<T> get_column_data(std::string const& name) const
+    {
+        column const& col = get_column_metadata(name);
+        if (data.size() < rows() * row_size())
+        {
+            throw fits_exception();
+        }
+
+        column_data<T> result(col);
+        result.get_data().reserve(rows());
+
+        detail::visit_ascii_type(col.type(), [&](auto tag)
+        {
+            using stored_type = typename decltype(tag)::type;
+            decode_as<stored_type>(col, result.get_data(), std::is_same<T, stored_type>());
+        });
+        return result;
+    }
+
+    //!returns column_data of the type of TFORM for column with TTYPE name
+    std::unique_ptr<column> get_column(std::string name) const override
+    {
+        std::vector<std::unique_ptr<column>> result = read_columns({name});
+        return std::move(result.front());
+    }
+
+    //!parses the columns with given TTYPE (all the columns if names is empty) from the data
+    //!unit read, each column is column_data of the type of TFORM
+    std::vector<std::unique_ptr<column>> read_columns(std::vector<std::string> const& names) const
+    {
+        std::vector<std::unique_ptr<column>> columns = make_columns(names);
+        if (data.size() < rows() * row_size())
+        {
+            throw fits_exception();
+        }
+        decode_block(columns, data.data(), rows());
+        return columns;
+    }
+
+    //!parses the columns with given TTYPE (all the columns if names is empty) reading rows
+    //!of data unit at data_offset of file in blocks of at most block_bytes (atleast one row)
+    std::vector<std::unique_ptr<column>> read_columns
+    (
+        byte_source const& file,
+        std::streamoff data_offset,
+        std::vector<std::string> const& names,
+        std::size_t block_bytes = default_block_bytes
+    ) const
+    {
+        std::vector<std::unique_ptr<column>> columns = make_columns(names);
+        if (row_size() == 0)
+        {
+            return columns;
+        }
+
+        std::size_t const block_rows = (std::max)(block_bytes / row_size(), std::size_t(1));
+        std::vector<char> buffer((std::min)(block_rows, rows()) * row_size());
+        for (std::size_t first = 0; first < rows(); first += block_rows)
+        {
+            std::size_t const count = (std::min)(block_rows, rows() - first);
+            file.read_at(buffer.data(), count * row_size(),
+                static_cast<std::uint64_t>(data_offset) + first * row_size());
+            decode_block(columns, buffer.data(), count);
+        }
+        return columns;
+    }
+
+protected:
+    //!sets the type, width and offset in row of every column from TFORM and TBCOL
+    void set_column_layout()
+    {
+        field_formats.resize(this->col_metadata.size());
+        for (std::size_t i = 0; i < this->col_metadata.size(); i++)
+        {
+            column& col = this->col_metadata[i];
+            detail::ascii_field_format& format = field_formats[i];
+            format.decimals = detail::parse_ascii_tform(col);
+            format.offset = col.offset();
+            format.width = col.width();
+            if (format.offset + format.width > row_size())
+            {
+                throw invalid_table_colum_format();
+            }
+
+            std::size_t card_index;
+            if (this->get_key_index().find(indexed_keyword::tnull, col.index(), card_index))
+            {
+                format.null = detail::unquote(this->cards[card_index].value<std::string>());
+                char const* first = format.null.data();
+                char const* last = first + format.null.size();
+                detail::trim_field(first, last);
+                format.null.assign(first, last);
+            }
+        }
+    }
+
+    detail::ascii_field_format const& field_format(column const& col) const
+    {
+        return field_formats[col.index() - 1];
+    }
+
+    //!creates empty column_data of the type of TFORM for every requested column
+    std::vector<std::unique_ptr<column>> make_columns(std::vector<std::string> const& names) const
+    {
+        std::vector<column const*> selected;
+        if (names.empty())
+        {
+            for (column const& col : this->col_metadata)
+            {
+                selected.push_back(&col);
+            }
+        }
+        for (std::string const& name : names)
+        {
+            selected.push_back(&get_column_metadata(name));
+        }
+
+        std::vector<std::unique_ptr<column>> columns;
+        for (column const* col : selected)
+        {
+            detail::visit_ascii_type(col->type(), [&](auto tag)
+            {
+                using stored_type = typename decltype(tag)::type;
+                std::unique_ptr<column_data<stored_type>> values(new column_data<stored_type>(*col));
+                values->get_data().reserve(rows());
+                columns.push_back(std::move(values));
+            });
+        }
+        return columns;
+    }
+
+    //!appends the values of count rows to every column
+    void decode_block(std::vector<std::unique_ptr<column>>& columns, char const* block,
+        std::size_t count) const
+    {
+        for (std::unique_ptr<column>& col : columns)
+        {
+            detail::visit_ascii_type(col->type(), [&](auto tag)
+            {
+                using stored_type = typename decltype(tag)::type;
+                detail::decode_ascii_rows(block, count, row_size(), field_format(*col),
+                    static_cast<column_data<stored_type>&>(*col).get_data());
+            });
+        }
+    }
+
+    template <typename S, typename T>
+    void decode_as(column const& col, std::vector<T>& values, std::true_type) const
+    {
+        detail::decode_ascii_rows(data.data(), rows(), row_size(), field_format(col), values);
+    }
+
+    template <typename S, typename T>
+    void decode_as(column const& col, std::vector<T>& values, std::false_type) const
+    {
+        std::vector<S> raw;
+        detail::decode_ascii_rows(data.data(), rows(), row_size(), field_format(col), raw);
+        detail::physical_values(raw, col.TSCAL(), col.TZERO(), values);
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_ASCII_TABLE_EXTENSION_HPP
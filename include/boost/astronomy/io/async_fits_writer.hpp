@@ -0,0 +1,352 @@
+#ifndef BOOST_ASTRONOMY_IO_ASYNC_FITS_WRITER_HPP
+#define BOOST_ASTRONOMY_IO_ASYNC_FITS_WRITER_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/astronomy/io/bitpix.hpp>
+#include <boost/astronomy/io/card.hpp>
+#include <boost/astronomy/io/column.hpp>
+#include <boost/astronomy/io/column_data.hpp>
+#include <boost/astronomy/io/image.hpp>
+#include <boost/astronomy/io/binary_table_extension.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// HDU waiting to be written by the background thread of async_fits_writer
+struct pending_hdu
+{
+    std::size_t bytes = 0; // bytes of data held by the HDU, counted against the queue limit
+    std::promise<std::uint64_t> done; // receives the offset of HDU in file
+
+    virtual ~pending_hdu() {}
+
+    virtual void write(io::fits_writer& writer) = 0;
+};
+
+// HDU written by a (move only) function object holding the image or columns
+template <typename Function>
+struct pending_function : public pending_hdu
+{
+    Function function;
+
+    pending_function(Function&& f, std::size_t data_bytes) : function(std::move(f))
+    {
+        this->bytes = data_bytes;
+    }
+
+    void write(io::fits_writer& writer) override
+    {
+        function(writer);
+    }
+};
+///@endcond
+
+} //namespace detail
+
+namespace io {
+
+//! writes a FITS file on a background thread so that the caller can continue while
+//! HDU are converted to big-endian, padded and written (write-behind)
+//! the images and columns are moved (or copied) into a queue and every write returns a
+//! future which is ready once the HDU is handed to the file with the offset of the HDU
+//! in file, or holds the exception thrown while writing it
+//! the queue is bounded by the bytes of data it holds, writes block while it is full
+//! once writing a HDU fails, all the following HDU fail with the same exception
+struct async_fits_writer
+{
+public:
+    //! default limit of the bytes of data waiting in the queue
+    static constexpr std::size_t default_queue_bytes = std::size_t(256) << 20;
+
+protected:
+    fits_writer writer; //! used only by the background thread until close
+    std::size_t queue_limit; //! limit of queued bytes
+
+    std::mutex mutex;
+    std::condition_variable queue_changed;
+    std::deque<std::unique_ptr<detail::pending_hdu>> queue; //! HDU waiting to be written
+    std::size_t queued_bytes = 0; //! bytes of data held by queue and the HDU being written
+    std::size_t unfinished = 0; //! HDU in queue or being written
+    bool closing = false;
+    std::exception_ptr error; //! first error of background thread
+
+    std::thread worker;
+
+public:
+    //!creates (or truncates) the file at path and starts the background thread
+    //!queue_bytes limits the data waiting to be written, a single HDU larger than the
+    //!limit is accepted when the queue is empty
+    async_fits_writer
+    (
+        std::string const& path,
+        std::size_t queue_bytes = default_queue_bytes,
+        std::size_t buffer_bytes = fits_writer::default_buffer_bytes
+    ) : writer(path, buffer_bytes), queue_limit(queue_bytes)
+    {
+        worker = std::thread([this]() { run(); });
+    }
+
+    async_fits_writer(async_fits_writer const&) = delete;
+    async_fits_writer& operator=(async_fits_writer const&) = delete;
+
+    //!waits for the queued HDU and closes the file, errors are ignored (call close to
+    //!handle them)
+    ~async_fits_writer()
+    {
+        try
+        {
+            close();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    //!returns the bytes of data waiting to be written
+    std::size_t pending_bytes()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return queued_bytes;
+    }
+
+    //!blocks until all the queued HDU are written to file
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        queue_changed.wait(lock, [this]() { return unfinished == 0; });
+    }
+
+    //!writes all the queued HDU, closes the file and rethrows the first error of writing
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (closing)
+            {
+                return;
+            }
+            closing = true;
+        }
+        queue_changed.notify_all();
+        worker.join();
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+        writer.close();
+    }
+
+    //!queues a primary HDU without data
+    std::future<std::uint64_t> write_primary_hdu(std::vector<card> cards = std::vector<card>())
+    {
+        return submit([cards = std::move(cards)](fits_writer& w)
+        {
+            w.write_primary_hdu(cards);
+        }, 0);
+    }
+
+    //!queues a primary HDU with image, see fits_writer::write_primary_hdu
+    template <bitpix DataType>
+    std::future<std::uint64_t> write_primary_hdu
+    (
+        image<DataType> data,
+        std::vector<card> cards = std::vector<card>(),
+        std::vector<std::size_t> naxis = std::vector<std::size_t>()
+    )
+    {
+        std::size_t const bytes = image_bytes(data);
+        return submit([data = std::move(data), cards = std::move(cards),
+            naxis = std::move(naxis)](fits_writer& w)
+        {
+            w.write_primary_hdu(data, cards, naxis);
+        }, bytes);
+    }
+
+    //!queues an image extension, see fits_writer::write_image_extension
+    template <bitpix DataType>
+    std::future<std::uint64_t> write_image_extension
+    (
+        image<DataType> data,
+        std::vector<card> cards = std::vector<card>(),
+        std::vector<std::size_t> naxis = std::vector<std::size_t>()
+    )
+    {
+        std::size_t const bytes = image_bytes(data);
+        return submit([data = std::move(data), cards = std::move(cards),
+            naxis = std::move(naxis)](fits_writer& w)
+        {
+            w.write_image_extension(data, cards, naxis);
+        }, bytes);
+    }
+
+    //!queues a tile compressed image, see fits_writer::write_compressed_image
+    template <bitpix DataType>
+    std::future<std::uint64_t> write_compressed_image
+    (
+        image<DataType> data,
+        std::vector<card> cards = std::vector<card>(),
+        std::vector<std::size_t> naxis = std::vector<std::size_t>(),
+        compression_options options = compression_options()
+    )
+    {
+        std::size_t const bytes = image_bytes(data);
+        return submit([data = std::move(data), cards = std::move(cards),
+            naxis = std::move(naxis), options = std::move(options)](fits_writer& w)
+        {
+            w.write_compressed_image(data, cards, naxis, options);
+        }, bytes);
+    }
+
+    //!queues a binary table extension, see fits_writer::write_binary_table
+    std::future<std::uint64_t> write_binary_table
+    (
+        std::vector<std::unique_ptr<column>> columns,
+        std::vector<card> cards = std::vector<card>()
+    )
+    {
+        std::size_t const bytes = table_bytes(columns);
+        return submit([columns = std::move(columns), cards = std::move(cards)](fits_writer& w)
+        {
+            w.write_binary_table(columns, cards);
+        }, bytes);
+    }
+
+protected:
+    //!queues the function writing a HDU, blocks while the queue is full
+    template <typename Function>
+    std::future<std::uint64_t> submit(Function&& function, std::size_t bytes)
+    {
+        std::unique_ptr<detail::pending_hdu> hdu(
+            new detail::pending_function<Function>(std::move(function), bytes));
+        std::future<std::uint64_t> result = hdu->done.get_future();
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (closing)
+            {
+                throw fits_exception();
+            }
+            queue_changed.wait(lock, [&]()
+            {
+                return queued_bytes == 0 || queued_bytes + bytes <= queue_limit;
+            });
+            queued_bytes += bytes;
+            unfinished++;
+            queue.push_back(std::move(hdu));
+        }
+        queue_changed.notify_all();
+        return result;
+    }
+
+    //!background thread, writes the queued HDU one after another and writes the buffer of
+    //!writer to file whenever the queue runs empty
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            queue_changed.wait(lock, [this]() { return closing || !queue.empty(); });
+            if (queue.empty())
+            {
+                break;
+            }
+            std::unique_ptr<detail::pending_hdu> hdu = std::move(queue.front());
+            queue.pop_front();
+            std::exception_ptr failure = error;
+            lock.unlock();
+
+            std::uint64_t offset = 0;
+            if (!failure)
+            {
+                try
+                {
+                    writer.end_data_unit();
+                    offset = writer.size();
+                    hdu->write(writer);
+                    if (queue_empty())
+                    {
+                        writer.flush();
+                    }
+                }
+                catch (...)
+                {
+                    failure = std::current_exception();
+                }
+            }
+            if (failure)
+            {
+                hdu->done.set_exception(failure);
+            }
+            else
+            {
+                hdu->done.set_value(offset);
+            }
+            std::size_t const bytes = hdu->bytes;
+            hdu.reset();
+
+            lock.lock();
+            if (failure && !error)
+            {
+                error = failure;
+            }
+            queued_bytes -= bytes;
+            unfinished--;
+            queue_changed.notify_all();
+        }
+    }
+
+    bool queue_empty()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return queue.empty();
+    }
+
+    template <bitpix DataType>
+    static std::size_t image_bytes(image<DataType> const& data)
+    {
+        return data.get_width() * data.get_height() * bitpix_size(DataType);
+    }
+
+    //!returns the bytes of values stored in columns
+    static std::size_t table_bytes(std::vector<std::unique_ptr<column>> const& columns)
+    {
+        std::size_t bytes = 0;
+        for (std::unique_ptr<column> const& col : columns)
+        {
+            column layout = *col;
+            detail::parse_binary_tform(layout);
+            if (layout.type() == 'P' || layout.type() == 'Q')
+            {
+                continue;
+            }
+            detail::visit_binary_type(layout.type(), [&](auto tag)
+            {
+                using stored_type = typename decltype(tag)::type;
+                auto typed = dynamic_cast<column_data<stored_type> const*>(col.get());
+                if (typed)
+                {
+                    bytes += typed->get_data().size() * sizeof(stored_type);
+                }
+            });
+        }
+        return bytes;
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_ASYNC_FITS_WRITER_HPP
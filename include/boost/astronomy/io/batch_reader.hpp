@@ -0,0 +1,920 @@
+#ifndef BOOST_ASTRONOMY_IO_BATCH_READER_HPP
+#define BOOST_ASTRONOMY_IO_BATCH_READER_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/astronomy/detail/byteswap.hpp>
+#include <boost/astronomy/detail/io_uring.hpp>
+#include <boost/astronomy/detail/positioned_file.hpp>
+#include <boost/astronomy/io/bitpix.hpp>
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/hdu_index.hpp>
+#include <boost/astronomy/io/image.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+//! the way batch_read_images reads files
+enum class io_backend
+{
+    automatic, //! io_uring if it is supported, thread_pool otherwise
+    io_uring, //! reads submitted in batches to an io_uring (Linux only)
+    thread_pool //! positioned reads (pread) on a pool of threads
+};
+
+//! options of batch_read_images
+struct batch_read_options
+{
+    io_backend backend = io_backend::automatic;
+    std::size_t queue_depth = 64; //! number of reads in flight at the same time
+    std::size_t threads = 0; //! threads of thread_pool, 0 uses one for each read in flight
+    std::size_t max_open_files = 64; //! number of files read at the same time
+    std::size_t read_bytes = std::size_t(1) << 20; //! size of each read of a data unit
+
+    //! memory of images read but not handed to the callback yet, an image larger than it is
+    //! still read when no other image is pending
+    std::size_t max_pending_bytes = std::size_t(64) << 20;
+
+    //! HDU read from every file (0 is primary HDU), empty reads every image HDU
+    std::vector<std::size_t> hdus;
+};
+
+//! image HDU handed to the callback of batch_read_images
+struct batch_image
+{
+    std::size_t file = 0; //! index of the file in paths given to batch_read_images
+    std::size_t hdu_number = 0; //! number of HDU in the file (0 is primary HDU)
+    hdu_entry entry; //! location, header and dimension of HDU
+};
+
+//! summary of batch_read_images
+struct batch_read_result
+{
+    io_backend backend = io_backend::thread_pool; //! backend used to read the files
+    std::vector<std::string> errors; //! reason each file could not be read, empty if read
+    std::size_t images = 0; //! number of images handed to the callback
+    std::uint64_t bytes = 0; //! number of bytes of pixels read
+};
+
+}}} //namespace boost::astronomy::io
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// read submitted to a read_engine, tag identifies the read when it completes
+// bytes read are big-endian pixels of pixel_size bytes converted to native byte order by the
+// engine, which does it on the thread which read them while they are in cache (0 for bytes
+// which are not converted)
+struct engine_read
+{
+    positioned_file const* file;
+    char* buffer;
+    std::size_t size;
+    std::uint64_t offset;
+    std::size_t tag;
+    std::size_t pixel_size;
+};
+
+// converts size bytes of big-endian pixels of pixel_size bytes at buffer to native byte order
+inline void engine_to_native(char* buffer, std::size_t size, std::size_t pixel_size)
+{
+    switch (pixel_size)
+    {
+    case 2:
+        big_to_native_inplace(reinterpret_cast<std::uint16_t*>(buffer), size / 2);
+        break;
+    case 4:
+        big_to_native_inplace(reinterpret_cast<std::uint32_t*>(buffer), size / 4);
+        break;
+    case 8:
+        big_to_native_inplace(reinterpret_cast<std::uint64_t*>(buffer), size / 8);
+        break;
+    default:
+        break;
+    }
+}
+
+// completed read, result is the size of read when all of it is read, 0 if the end of file is
+// reached before or negative if the read failed
+// error holds any exception other than a read error thrown by the engine thread (e.g.
+// std::bad_alloc), which is rethrown on the calling thread
+struct engine_completion
+{
+    std::size_t tag;
+    std::int64_t result;
+    std::exception_ptr error;
+};
+
+// reads many parts of files at the same time
+class read_engine
+{
+public:
+    virtual ~read_engine() {}
+
+    // queues the read, the caller keeps atmost the queue depth of engine reads in flight
+    virtual void submit(engine_read const& read) = 0;
+
+    // starts the queued reads and waits until atleast one read in flight is completed
+    // the completed reads are appended to completions
+    virtual void wait(std::vector<engine_completion>& completions) = 0;
+};
+
+// positioned reads on a pool of threads, each thread reads a whole request at once
+class pread_engine : public read_engine
+{
+    std::mutex mutex_;
+    std::condition_variable submitted_;
+    std::condition_variable completed_;
+    std::deque<engine_read> queue_;
+    std::vector<engine_completion> done_;
+    bool stop_ = false;
+    std::vector<std::thread> workers_;
+
+public:
+    explicit pread_engine(std::size_t threads)
+    {
+        try
+        {
+            for (std::size_t i = 0; i < (std::max)(threads, std::size_t(1)); i++)
+            {
+                workers_.emplace_back([this]() { work(); });
+            }
+        }
+        catch (...)
+        {
+            //the destructor is not called, the threads already started are stopped here
+            stop();
+            throw;
+        }
+    }
+
+    ~pread_engine()
+    {
+        stop();
+    }
+
+    void submit(engine_read const& read) override
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(read);
+        }
+        submitted_.notify_one();
+    }
+
+    void wait(std::vector<engine_completion>& completions) override
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        completed_.wait(lock, [this]() { return !done_.empty(); });
+        completions.insert(completions.end(), done_.begin(), done_.end());
+        done_.clear();
+    }
+
+private:
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        submitted_.notify_all();
+        for (std::thread& worker : workers_)
+        {
+            worker.join();
+        }
+    }
+
+    void work()
+    {
+        while (true)
+        {
+            engine_read read;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                submitted_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+                if (stop_)
+                {
+                    return;
+                }
+                read = queue_.front();
+                queue_.pop_front();
+            }
+
+            std::int64_t result = static_cast<std::int64_t>(read.size);
+            std::exception_ptr error;
+            try
+            {
+                read.file->read_at(read.buffer, read.size, read.offset);
+                engine_to_native(read.buffer, read.size, read.pixel_size);
+            }
+            catch (fits_exception const&)
+            {
+                result = -1;
+            }
+            catch (...)
+            {
+                //an exception leaving the thread would terminate the program
+                result = -1;
+                error = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                done_.push_back(engine_completion{read.tag, result, error});
+            }
+            completed_.notify_one();
+        }
+    }
+};
+
+#if defined(BOOST_ASTRONOMY_USE_IO_URING)
+// reads submitted to an io_uring in a single system call along with the wait for completions
+// reads completed partially are submitted again for the bytes left
+class uring_engine : public read_engine
+{
+    io_uring_queue ring_;
+    std::vector<engine_read> reads_; // reads in flight, indexed by slot
+    std::vector<iovec> vectors_; // bytes left to read of each read in flight
+    std::vector<std::size_t> free_slots_;
+
+public:
+    explicit uring_engine(std::size_t queue_depth) :
+        ring_(static_cast<unsigned>(queue_depth)),
+        reads_(ring_.entries()),
+        vectors_(ring_.entries())
+    {
+        for (std::size_t slot = vectors_.size(); slot > 0; slot--)
+        {
+            free_slots_.push_back(slot - 1);
+        }
+    }
+
+    void submit(engine_read const& read) override
+    {
+        if (free_slots_.empty())
+        {
+            throw fits_exception();
+        }
+        std::size_t const slot = free_slots_.back();
+        free_slots_.pop_back();
+        reads_[slot] = read;
+        vectors_[slot].iov_base = read.buffer;
+        vectors_[slot].iov_len = read.size;
+        ring_.prepare_read(read.file->native_handle(), &vectors_[slot], read.offset, slot);
+    }
+
+    void wait(std::vector<engine_completion>& completions) override
+    {
+        std::size_t const first = completions.size();
+        while (completions.size() == first)
+        {
+            ring_.submit_and_wait();
+            ring_.for_each_completion([&](std::uint64_t user_data, std::int32_t result)
+            {
+                std::size_t const slot = static_cast<std::size_t>(user_data);
+                engine_read const& read = reads_[slot];
+                iovec& left = vectors_[slot];
+                if (result > 0 && static_cast<std::size_t>(result) < left.iov_len)
+                {
+                    left.iov_base = static_cast<char*>(left.iov_base) + result;
+                    left.iov_len -= static_cast<std::size_t>(result);
+                    ring_.prepare_read(read.file->native_handle(), &left,
+                        read.offset + (read.size - left.iov_len), slot);
+                    return;
+                }
+
+                if (result > 0)
+                {
+                    engine_to_native(read.buffer, read.size, read.pixel_size);
+                }
+                completions.push_back(engine_completion{read.tag,
+                    result > 0 ? static_cast<std::int64_t>(read.size) : result, nullptr});
+                free_slots_.push_back(slot);
+            });
+        }
+    }
+};
+#endif
+
+// creates the engine of backend requested by options and stores the backend used
+// automatic falls back to the thread pool when a ring of the queue depth can not be set up
+// (e.g. more entries than the kernel allows or a tight RLIMIT_MEMLOCK)
+inline std::unique_ptr<read_engine> make_read_engine
+(
+    io::batch_read_options const& options,
+    io::io_backend& used
+)
+{
+    std::size_t const queue_depth = (std::max)(options.queue_depth, std::size_t(1));
+    if (options.backend != io::io_backend::thread_pool)
+    {
+#if defined(BOOST_ASTRONOMY_USE_IO_URING)
+        if (io_uring_supported())
+        {
+            try
+            {
+                std::unique_ptr<read_engine> engine(new uring_engine(queue_depth));
+                used = io::io_backend::io_uring;
+                return engine;
+            }
+            catch (unsupported_io_backend_exception const&)
+            {
+                if (options.backend == io::io_backend::io_uring)
+                {
+                    throw;
+                }
+            }
+        }
+#endif
+        if (options.backend == io::io_backend::io_uring)
+        {
+            throw unsupported_io_backend_exception();
+        }
+    }
+    used = io::io_backend::thread_pool;
+    return std::unique_ptr<read_engine>(
+        new pread_engine(options.threads == 0 ? queue_depth : options.threads));
+}
+
+// pixels of an image being read, type of pixels is known only when its header is read
+struct batch_pixels
+{
+    virtual ~batch_pixels() {}
+
+    // returns the storage of pixels which is filled with the data unit
+    virtual char* bytes() = 0;
+};
+
+template <io::bitpix DataType>
+struct batch_pixels_of : public batch_pixels
+{
+    io::image<DataType> image;
+
+    batch_pixels_of(std::size_t width, std::size_t height) : image(width, height) {}
+
+    char* bytes() override
+    {
+        return reinterpret_cast<char*>(image.pixels());
+    }
+};
+
+inline std::unique_ptr<batch_pixels> make_batch_pixels
+(
+    io::bitpix value,
+    std::size_t width,
+    std::size_t height
+)
+{
+    using pixels = std::unique_ptr<batch_pixels>;
+    switch (value)
+    {
+    case io::bitpix::B8:
+        return pixels(new batch_pixels_of<io::bitpix::B8>(width, height));
+    case io::bitpix::B16:
+        return pixels(new batch_pixels_of<io::bitpix::B16>(width, height));
+    case io::bitpix::B32:
+        return pixels(new batch_pixels_of<io::bitpix::B32>(width, height));
+    case io::bitpix::_B32:
+        return pixels(new batch_pixels_of<io::bitpix::_B32>(width, height));
+    case io::bitpix::_B64:
+        return pixels(new batch_pixels_of<io::bitpix::_B64>(width, height));
+    }
+    throw fits_exception();
+}
+
+struct batch_file;
+
+// image HDU found in a file, its pixels are allocated when it is admitted for reading
+struct batch_pending_image
+{
+    io::batch_image info;
+    batch_file* file = nullptr;
+    std::unique_ptr<batch_pixels> pixels;
+    std::size_t size = 0; // bytes of data unit
+    std::size_t submitted = 0; // bytes for which a read has been submitted
+    std::size_t read = 0; // bytes read
+    std::size_t reads = 0; // reads in flight
+    bool queued = true; // in the waiting or reading queue of batch reader
+};
+
+// file being read, its headers are read one after another and the data units of its images
+// are read while the following headers are read
+struct batch_file
+{
+    std::size_t index = 0; // in paths
+    positioned_file file;
+    std::uint64_t size = 0;
+    std::uint64_t header_offset = 0; // offset of the header being read
+    std::size_t hdu_number = 0; // number of HDU whose header is being read
+    std::string header; // blocks of the header being read
+    bool headers_done = false;
+    bool header_queued = false; // waiting for its next header read to be submitted
+    bool failed = false;
+    std::size_t reads = 0; // reads in flight
+    std::size_t images = 0; // images found but not handed to the callback or dropped
+    std::vector<std::unique_ptr<batch_pending_image>> found;
+};
+
+// read in flight
+struct batch_operation
+{
+    batch_file* file = nullptr;
+    batch_pending_image* image = nullptr; // nullptr for the read of a header
+    std::size_t size = 0;
+};
+
+// reads the image HDU of many files keeping queue depth reads in flight, the headers of
+// every file are read one after another and the data units are read in reads of read_bytes
+// which the engine converts to native byte order, images are handed to the callback on
+// calling thread while the engine reads the following ones
+template <typename Callback>
+class batch_reader
+{
+    // number of bytes read at once when reading a header
+    static constexpr std::size_t header_read_bytes = 4 * 2880;
+
+    std::vector<std::string> const& paths_;
+    io::batch_read_options const& options_;
+    Callback& callback_;
+    io::batch_read_result result_;
+    std::unique_ptr<read_engine> engine_;
+    std::size_t queue_depth_;
+    std::size_t last_hdu_ = 0; // largest HDU number requested by options
+
+    std::list<batch_file> files_; // open files
+    std::size_t next_path_ = 0;
+    std::deque<batch_file*> header_queue_;
+    std::deque<batch_pending_image*> waiting_; // found images not allocated yet
+    std::deque<batch_pending_image*> reading_; // images with reads left to submit
+    std::size_t pending_bytes_ = 0;
+
+    std::vector<batch_operation> operations_; // indexed by tag
+    std::vector<std::size_t> free_operations_;
+    std::vector<engine_completion> completions_;
+
+public:
+    batch_reader
+    (
+        std::vector<std::string> const& paths,
+        io::batch_read_options const& options,
+        Callback& callback
+    ) :
+        paths_(paths),
+        options_(options),
+        callback_(callback),
+        queue_depth_((std::max)(options.queue_depth, std::size_t(1)))
+    {
+        result_.errors.resize(paths.size());
+        engine_ = make_read_engine(options, result_.backend);
+        operations_.resize(queue_depth_);
+        for (std::size_t tag = queue_depth_; tag > 0; tag--)
+        {
+            free_operations_.push_back(tag - 1);
+        }
+        if (!options.hdus.empty())
+        {
+            last_hdu_ = *std::max_element(options.hdus.begin(), options.hdus.end());
+        }
+    }
+
+    io::batch_read_result run()
+    {
+        try
+        {
+            submit_reads();
+            while (in_flight() != 0)
+            {
+                completions_.clear();
+                engine_->wait(completions_);
+                for (engine_completion const& completion : completions_)
+                {
+                    complete(completion);
+                }
+                submit_reads();
+            }
+        }
+        catch (...)
+        {
+            //reads in flight write to buffers owned by reader, they must complete first
+            drain();
+            throw;
+        }
+        return std::move(result_);
+    }
+
+private:
+    std::size_t in_flight() const
+    {
+        return queue_depth_ - free_operations_.size();
+    }
+
+    void submit(batch_file& file, batch_pending_image* image, char* buffer, std::size_t size,
+        std::uint64_t offset)
+    {
+        std::size_t const tag = free_operations_.back();
+        free_operations_.pop_back();
+        operations_[tag] = batch_operation{&file, image, size};
+        file.reads++;
+        std::size_t pixel_size = 0;
+        if (image)
+        {
+            image->reads++;
+            pixel_size = io::bitpix_size(image->info.entry.bitpix_value);
+        }
+        engine_->submit(engine_read{&file.file, buffer, size, offset, tag, pixel_size});
+    }
+
+    // fills the queue with reads of headers first, then opens new files and reads images
+    void submit_reads()
+    {
+        while (in_flight() < queue_depth_)
+        {
+            if (!header_queue_.empty())
+            {
+                batch_file& file = *header_queue_.front();
+                header_queue_.pop_front();
+                file.header_queued = false;
+                if (file.failed)
+                {
+                    finish(file);
+                    continue;
+                }
+                read_header(file);
+            }
+            else if (files_.size() < (std::max)(options_.max_open_files, std::size_t(1)) &&
+                next_path_ < paths_.size())
+            {
+                open(next_path_++);
+            }
+            else if (!reading_.empty())
+            {
+                read_image(*reading_.front());
+            }
+            else if (!waiting_.empty() && (pending_bytes_ == 0 ||
+                pending_bytes_ + waiting_.front()->size <= options_.max_pending_bytes))
+            {
+                admit(*waiting_.front());
+            }
+            else
+            {
+                return;
+            }
+        }
+    }
+
+    void open(std::size_t index)
+    {
+        try
+        {
+            files_.emplace_back();
+            batch_file& file = files_.back();
+            file.index = index;
+            file.file.open(paths_[index]);
+            file.size = file.file.size();
+            file.header_queued = true;
+            header_queue_.push_back(&file);
+        }
+        catch (std::exception const& e)
+        {
+            result_.errors[index] = e.what();
+            files_.pop_back();
+        }
+    }
+
+    // submits the read of the next blocks of header being read
+    void read_header(batch_file& file)
+    {
+        std::uint64_t const offset = file.header_offset + file.header.size();
+        if (offset >= file.size)
+        {
+            fail(file, "Header of HDU is truncated");
+            finish(file);
+            return;
+        }
+        std::size_t const size = static_cast<std::size_t>((std::min)(
+            static_cast<std::uint64_t>(header_read_bytes), file.size - offset));
+        std::size_t const first = file.header.size();
+        file.header.resize(first + size);
+        submit(file, nullptr, &file.header[first], size, offset);
+    }
+
+    // submits the next read of the data unit of image
+    void read_image(batch_pending_image& image)
+    {
+        if (image.file->failed)
+        {
+            reading_.pop_front();
+            image.queued = false;
+            if (image.reads == 0)
+            {
+                release(image);
+                finish(*image.file);
+            }
+            return;
+        }
+
+        //reads end at the boundary of pixels so that each of them can be converted
+        std::size_t const pixel_size = io::bitpix_size(image.info.entry.bitpix_value);
+        std::size_t size = image.size - image.submitted;
+        if (options_.read_bytes != 0)
+        {
+            size = (std::min)(size,
+                (std::max)(options_.read_bytes / pixel_size, std::size_t(1)) * pixel_size);
+        }
+        submit(*image.file, &image, image.pixels->bytes() + image.submitted, size,
+            static_cast<std::uint64_t>(image.info.entry.data_offset) + image.submitted);
+        image.submitted += size;
+        if (image.submitted == image.size)
+        {
+            reading_.pop_front();
+            image.queued = false;
+        }
+    }
+
+    // allocates the pixels of image so that its data unit can be read
+    void admit(batch_pending_image& image)
+    {
+        waiting_.pop_front();
+        if (image.file->failed)
+        {
+            image.queued = false;
+            release(image);
+            finish(*image.file);
+            return;
+        }
+
+        std::vector<std::size_t> const& naxis = image.info.entry.naxis;
+        std::size_t height = 1;
+        for (std::size_t i = 2; i < naxis.size(); i++)
+        {
+            height *= naxis[i];
+        }
+        image.pixels = make_batch_pixels(image.info.entry.bitpix_value, naxis[1], height);
+        pending_bytes_ += image.size;
+        reading_.push_back(&image);
+    }
+
+    void complete(engine_completion const& completion)
+    {
+        batch_operation& operation = operations_[completion.tag];
+        batch_file& file = *operation.file;
+        batch_pending_image* image = operation.image;
+
+        free_operations_.push_back(completion.tag);
+        file.reads--;
+        if (image)
+        {
+            image->reads--;
+        }
+        if (completion.error)
+        {
+            std::rethrow_exception(completion.error);
+        }
+        if (completion.result <= 0 && !file.failed)
+        {
+            fail(file, completion.result == 0 ? "Data unit of HDU is truncated" :
+                "File could not be read");
+        }
+
+        if (image)
+        {
+            image->read += operation.size;
+            if (file.failed)
+            {
+                if (image->reads == 0 && !image->queued)
+                {
+                    release(*image);
+                }
+            }
+            else if (image->read == image->size)
+            {
+                deliver(*image);
+            }
+        }
+        else if (!file.failed)
+        {
+            parse_header(file);
+        }
+        finish(file);
+    }
+
+    // looks for the END card in the blocks of header read so far and reads the HDU when
+    // it is found, otherwise reads the next blocks
+    void parse_header(batch_file& file)
+    {
+        std::size_t end = 0;
+        for (std::size_t block = 0; block + 2880 <= file.header.size() && end == 0;
+            block += 2880)
+        {
+            for (std::size_t position = block; position < block + 2880; position += 80)
+            {
+                if (std::memcmp(file.header.data() + position, "END     ", 8) == 0)
+                {
+                    end = block + 2880;
+                    break;
+                }
+            }
+        }
+        if (end == 0)
+        {
+            queue_header(file);
+            return;
+        }
+
+        io::hdu_entry entry;
+        try
+        {
+            std::shared_ptr<io::hdu> header = std::make_shared<io::hdu>(file.header.data(),
+                file.header.data() + end);
+            entry = io::make_hdu_entry(header,
+                static_cast<std::streamoff>(file.header_offset),
+                static_cast<std::streamoff>(file.header_offset + end));
+        }
+        catch (std::exception const& e)
+        {
+            fail(file, e.what());
+            return;
+        }
+
+        std::size_t const hdu_number = file.hdu_number++;
+        std::uint64_t const data_size = entry.data_size;
+        file.header_offset = static_cast<std::uint64_t>(entry.data_offset) + data_size +
+            (2880 - data_size % 2880) % 2880;
+        file.header.clear();
+
+        bool const requested = options_.hdus.empty() || std::find(options_.hdus.begin(),
+            options_.hdus.end(), hdu_number) != options_.hdus.end();
+        bool const is_image = (entry.is_primary() || entry.xtension == "IMAGE") &&
+            entry.data_size != 0 && entry.naxis.size() > 1;
+        if (requested && is_image)
+        {
+            if (static_cast<std::uint64_t>(entry.data_offset) + data_size > file.size)
+            {
+                fail(file, "Data unit of HDU is truncated");
+                return;
+            }
+            std::unique_ptr<batch_pending_image> image(new batch_pending_image());
+            image->info.file = file.index;
+            image->info.hdu_number = hdu_number;
+            image->info.entry = std::move(entry);
+            image->file = &file;
+            image->size = static_cast<std::size_t>(data_size);
+            file.images++;
+            waiting_.push_back(image.get());
+            file.found.push_back(std::move(image));
+        }
+        else if (requested && !options_.hdus.empty())
+        {
+            fail(file, "HDU is not an image");
+            return;
+        }
+
+        if (!options_.hdus.empty() && file.hdu_number > last_hdu_)
+        {
+            file.headers_done = true;
+        }
+        else if (file.header_offset >= file.size)
+        {
+            file.headers_done = true;
+            if (!options_.hdus.empty())
+            {
+                fail(file, "HDU is not present in file");
+            }
+        }
+        else
+        {
+            queue_header(file);
+        }
+    }
+
+    void queue_header(batch_file& file)
+    {
+        file.header_queued = true;
+        header_queue_.push_front(&file);
+    }
+
+    // hands the image whose pixels are all read to the callback
+    void deliver(batch_pending_image& image)
+    {
+        switch (image.info.entry.bitpix_value)
+        {
+        case io::bitpix::B8:
+            deliver_as<io::bitpix::B8>(image);
+            break;
+        case io::bitpix::B16:
+            deliver_as<io::bitpix::B16>(image);
+            break;
+        case io::bitpix::B32:
+            deliver_as<io::bitpix::B32>(image);
+            break;
+        case io::bitpix::_B32:
+            deliver_as<io::bitpix::_B32>(image);
+            break;
+        case io::bitpix::_B64:
+            deliver_as<io::bitpix::_B64>(image);
+            break;
+        }
+        result_.images++;
+        result_.bytes += image.size;
+        release(image);
+    }
+
+    template <io::bitpix DataType>
+    void deliver_as(batch_pending_image& image)
+    {
+        callback_(static_cast<io::batch_image const&>(image.info),
+            static_cast<batch_pixels_of<DataType>&>(*image.pixels).image);
+    }
+
+    // frees the pixels of image which has been handed to the callback or dropped
+    void release(batch_pending_image& image)
+    {
+        if (image.pixels)
+        {
+            pending_bytes_ -= image.size;
+            image.pixels.reset();
+        }
+        image.file->images--;
+    }
+
+    void fail(batch_file& file, char const* reason)
+    {
+        file.failed = true;
+        result_.errors[file.index] = reason;
+    }
+
+    // closes the file when nothing is left to read from it
+    void finish(batch_file& file)
+    {
+        if ((file.headers_done || file.failed) && !file.header_queued && file.reads == 0 &&
+            file.images == 0)
+        {
+            files_.remove_if([&](batch_file const& open) { return &open == &file; });
+        }
+    }
+
+    // waits for the reads in flight ignoring their results
+    void drain()
+    {
+        try
+        {
+            while (in_flight() != 0)
+            {
+                completions_.clear();
+                engine_->wait(completions_);
+                for (engine_completion const& completion : completions_)
+                {
+                    free_operations_.push_back(completion.tag);
+                }
+            }
+        }
+        catch (...)
+        {
+        }
+    }
+};
+///@endcond
+
+} //namespace detail
+
+namespace io {
+
+//! reads the image HDU (primary HDU and IMAGE extensions, tile compressed images are not
+//! read) of many files with many reads in flight at the same time, headers and data units
+//! of different files and HDU are read at the same time
+//! every image is handed to callback(batch_image const& info, image<DataType>& image) as
+//! soon as it is read, so callback must accept an image of every bitpix (e.g. a generic
+//! lambda) and can move the image away, it is called on the calling thread one image at a
+//! time in no particular order
+//! io_uring submits the reads of a batch with a single system call, the thread pool is used
+//! when io_uring is not available (or not supported by the kernel) unless options ask for it
+//! files which can not be read are reported by batch_read_result::errors instead of throwing
+//! exceptions thrown by callback are rethrown once the reads in flight are completed
+template <typename Callback>
+inline batch_read_result batch_read_images
+(
+    std::vector<std::string> const& paths,
+    Callback callback,
+    batch_read_options const& options = batch_read_options()
+)
+{
+    detail::batch_reader<Callback> reader(paths, options, callback);
+    return reader.run();
+}
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_BATCH_READER_HPP
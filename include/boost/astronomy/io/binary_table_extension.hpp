@@ -0,0 +1,837 @@
+#ifndef BOOST_ASTRONOMY_IO_BINARY_TABLE_EXTENSION_HPP
+#define BOOST_ASTRONOMY_IO_BINARY_TABLE_EXTENSION_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <complex>
+#include <fstream>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <boost/astronomy/detail/byteswap.hpp>
+#include <boost/astronomy/detail/charconv.hpp>
+#include <boost/astronomy/detail/exact_compare.hpp>
+#include <boost/astronomy/io/byte_source.hpp>
+#include <boost/astronomy/io/table_extension.hpp>
+#include <boost/astronomy/io/column.hpp>
+#include <boost/astronomy/io/column_data.hpp>
+#include <boost/astronomy/io/array_view.hpp>
+#include <boost/astronomy/io/column_predicate.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+template <typename T>
+struct type_tag
+{
+    using type = T;
+};
+
+// size in bytes of a single element of binary table data type
+inline std::size_t binary_type_size(char type)
+{
+    switch (type)
+    {
+    case 'L':
+    case 'X':
+    case 'B':
+    case 'A':
+        return 1;
+    case 'I':
+        return 2;
+    case 'J':
+    case 'E':
+        return 4;
+    case 'K':
+    case 'D':
+    case 'C':
+    case 'P':
+        return 8;
+    case 'M':
+    case 'Q':
+        return 16;
+    }
+    throw invalid_table_colum_format();
+}
+
+// sets element type and maximum length of variable length array column from the part of
+// TFORM after P or Q (e.g. E(200)), repeat count of descriptor can only be 0 or 1
+inline void parse_array_descriptor(io::column& col, std::size_t repeat, std::string const& array)
+{
+    if (repeat > 1 || array.empty() || array[0] == 'P' || array[0] == 'Q')
+    {
+        throw invalid_table_colum_format();
+    }
+    binary_type_size(array[0]);
+    col.array_type(array[0]);
+
+    std::size_t max_length = 0;
+    if (array.size() > 1)
+    {
+        if (array[1] != '(' || array.back() != ')' ||
+            !parse_integer(array.data() + 2, array.data() + array.size() - 1, max_length))
+        {
+            throw invalid_table_colum_format();
+        }
+    }
+    col.max_length(max_length);
+}
+
+// sets repeat count, data type and width of column from its TFORM (rT, e.g. 16E or 1PD(200))
+inline void parse_binary_tform(io::column& col)
+{
+    std::string const tform = col.TFORM();
+
+    std::size_t position = 0;
+    std::size_t repeat = 0;
+    while (position < tform.size() && tform[position] >= '0' && tform[position] <= '9')
+    {
+        repeat = repeat * 10 + static_cast<std::size_t>(tform[position] - '0');
+        position++;
+    }
+    if (position == 0)
+    {
+        repeat = 1;
+    }
+    if (position == tform.size())
+    {
+        throw invalid_table_colum_format();
+    }
+
+    char const type = tform[position];
+    if (type == 'P' || type == 'Q')
+    {
+        parse_array_descriptor(col, repeat, tform.substr(position + 1));
+    }
+    col.repeat(repeat);
+    col.type(type);
+    col.width(type == 'X' ? (repeat + 7) / 8 : repeat * binary_type_size(type));
+}
+
+// calls f(type_tag<T>()) with the type T used by column_data to store values of binary type
+template <typename Function>
+inline void visit_binary_type(char type, Function&& f)
+{
+    switch (type)
+    {
+    case 'L':
+        f(type_tag<bool>());
+        return;
+    case 'X':
+    case 'B':
+        f(type_tag<std::uint8_t>());
+        return;
+    case 'I':
+        f(type_tag<std::int16_t>());
+        return;
+    case 'J':
+        f(type_tag<std::int32_t>());
+        return;
+    case 'K':
+        f(type_tag<std::int64_t>());
+        return;
+    case 'P':
+        f(type_tag<std::uint32_t>());
+        return;
+    case 'Q':
+        f(type_tag<std::uint64_t>());
+        return;
+    case 'A':
+        f(type_tag<std::string>());
+        return;
+    case 'E':
+        f(type_tag<float>());
+        return;
+    case 'D':
+        f(type_tag<double>());
+        return;
+    case 'C':
+        f(type_tag<std::complex<float>>());
+        return;
+    case 'M':
+        f(type_tag<std::complex<double>>());
+        return;
+    }
+    throw invalid_table_colum_format();
+}
+
+// true if T is the type used by array_view for elements of binary type (char for A)
+template <typename T>
+inline bool is_array_element_type(char type)
+{
+    if (type == 'A')
+    {
+        return std::is_same<T, char>::value;
+    }
+
+    bool result = false;
+    visit_binary_type(type, [&](auto tag)
+    {
+        result = std::is_same<T, typename decltype(tag)::type>::value;
+    });
+    return result;
+}
+
+template <typename T>
+inline void big_to_native_elements(T* values, std::size_t count)
+{
+    big_to_native_inplace(values, count);
+}
+
+template <typename T>
+inline void big_to_native_elements(std::complex<T>* values, std::size_t count)
+{
+    big_to_native_inplace(reinterpret_cast<T*>(values), 2 * count);
+}
+
+// appends the values of column in count rows starting at rows, only the bytes of column are
+// read and values are converted to native byte order in a single pass over the result
+template <typename T>
+inline void decode_binary_rows
+(
+    char const* rows,
+    std::size_t count,
+    std::size_t row_size,
+    io::column const& col,
+    std::vector<T>& values
+)
+{
+    std::size_t const elements = col.width() / sizeof(T);
+    std::size_t const bytes = elements * sizeof(T);
+    std::size_t const first = values.size();
+    values.resize(first + count * elements);
+
+    T* destination = values.data() + first;
+    char const* source = rows + col.offset();
+    if (bytes == row_size)
+    {
+        std::memcpy(destination, source, count * bytes);
+    }
+    else
+    {
+        for (std::size_t r = 0; r < count; r++)
+        {
+            std::memcpy(destination + r * elements, source + r * row_size, bytes);
+        }
+    }
+    big_to_native_elements(destination, count * elements);
+}
+
+// logical values, 'T' is true and anything else ('F' or null) is false
+inline void decode_binary_rows
+(
+    char const* rows,
+    std::size_t count,
+    std::size_t row_size,
+    io::column const& col,
+    std::vector<bool>& values
+)
+{
+    char const* source = rows + col.offset();
+    for (std::size_t r = 0; r < count; r++)
+    {
+        for (std::size_t e = 0; e < col.repeat(); e++)
+        {
+            values.push_back(source[r * row_size + e] == 'T');
+        }
+    }
+}
+
+// one string for each row, ends at first null or before trailing spaces
+inline void decode_binary_rows
+(
+    char const* rows,
+    std::size_t count,
+    std::size_t row_size,
+    io::column const& col,
+    std::vector<std::string>& values
+)
+{
+    char const* source = rows + col.offset();
+    for (std::size_t r = 0; r < count; r++)
+    {
+        char const* field = source + r * row_size;
+        char const* end = static_cast<char const*>(std::memchr(field, '\0', col.width()));
+        std::size_t length = end ? static_cast<std::size_t>(end - field) : col.width();
+        while (length > 0 && field[length - 1] == ' ')
+        {
+            length--;
+        }
+        values.emplace_back(field, length);
+    }
+}
+
+// returns the number of values of column_data stored for a single row of column
+inline std::size_t values_per_row(io::column const& col)
+{
+    switch (col.type())
+    {
+    case 'A':
+        return 1;
+    case 'L':
+        return col.repeat();
+    }
+
+    std::size_t size = 0;
+    visit_binary_type(col.type(), [&](auto tag)
+    {
+        size = sizeof(typename decltype(tag)::type);
+    });
+    return col.width() / size;
+}
+
+// stores the values of count rows starting at first_row into the bytes of column in rows
+// values are converted to big-endian byte order in a single pass before they are scattered
+template <typename T>
+inline void encode_binary_rows
+(
+    std::vector<T> const& values,
+    std::size_t first_row,
+    std::size_t count,
+    std::size_t row_size,
+    io::column const& col,
+    char* rows
+)
+{
+    std::size_t const elements = col.width() / sizeof(T);
+    std::size_t const bytes = elements * sizeof(T);
+    std::vector<T> swapped(values.begin() + static_cast<std::ptrdiff_t>(first_row * elements),
+        values.begin() + static_cast<std::ptrdiff_t>((first_row + count) * elements));
+    big_to_native_elements(swapped.data(), swapped.size());
+
+    char* destination = rows + col.offset();
+    if (bytes == row_size)
+    {
+        std::memcpy(destination, swapped.data(), count * bytes);
+    }
+    else
+    {
+        for (std::size_t r = 0; r < count; r++)
+        {
+            std::memcpy(destination + r * row_size, swapped.data() + r * elements, bytes);
+        }
+    }
+}
+
+// logical values are stored as 'T' and 'F'
+inline void encode_binary_rows
+(
+    std::vector<bool> const& values,
+    std::size_t first_row,
+    std::size_t count,
+    std::size_t row_size,
+    io::column const& col,
+    char* rows
+)
+{
+    char* destination = rows + col.offset();
+    for (std::size_t r = 0; r < count; r++)
+    {
+        for (std::size_t e = 0; e < col.repeat(); e++)
+        {
+            destination[r * row_size + e] = values[(first_row + r) * col.repeat() + e] ? 'T' : 'F';
+        }
+    }
+}
+
+// strings are padded with spaces, strings longer than the column can not be stored
+inline void encode_binary_rows
+(
+    std::vector<std::string> const& values,
+    std::size_t first_row,
+    std::size_t count,
+    std::size_t row_size,
+    io::column const& col,
+    char* rows
+)
+{
+    char* destination = rows + col.offset();
+    for (std::size_t r = 0; r < count; r++)
+    {
+        std::string const& value = values[first_row + r];
+        if (value.size() > col.width())
+        {
+            throw invalid_value_length_exception();
+        }
+        char* field = destination + r * row_size;
+        std::memcpy(field, value.data(), value.size());
+        std::memset(field + value.size(), ' ', col.width() - value.size());
+    }
+}
+
+// returns true if physical values of integers stored with scale and zero are the stored
+// values plus an integral zero, offset is then zero as 64 bit two's complement integer
+// (e.g. TZERO = 2^63 for uint64) which is added exactly
+inline bool integer_offset(double scale, double zero, std::uint64_t& offset)
+{
+    if (!is_exactly(scale, 1) || !(zero > -9223372036854775808.0 &&
+        zero < 18446744073709551616.0))
+    {
+        return false;
+    }
+    offset = zero < 0 ? static_cast<std::uint64_t>(static_cast<std::int64_t>(zero))
+        : static_cast<std::uint64_t>(zero);
+    double const integral = zero < 0 ? static_cast<double>(static_cast<std::int64_t>(zero))
+        : static_cast<double>(offset);
+    return is_exactly(integral, zero);
+}
+
+// converts stored values to physical values (TZERO + TSCAL * value)
+// integers with unit scale and integral zero are offset exactly (see integer_offset)
+template <typename T, typename S>
+inline typename std::enable_if<std::is_arithmetic<T>::value && std::is_arithmetic<S>::value &&
+    !std::is_same<T, bool>::value>::type
+physical_values(std::vector<S> const& raw, double scale, double zero, std::vector<T>& values)
+{
+    values.resize(raw.size());
+
+    //offset as 64 bit two's complement integer, additions wrap around like for unsigned types
+    std::uint64_t offset = 0;
+    if (std::is_integral<T>::value && std::is_integral<S>::value &&
+        integer_offset(scale, zero, offset))
+    {
+        for (std::size_t i = 0; i < raw.size(); i++)
+        {
+            values[i] = static_cast<T>(
+                static_cast<std::uint64_t>(static_cast<std::int64_t>(raw[i])) + offset);
+        }
+    }
+    else
+    {
+        for (std::size_t i = 0; i < raw.size(); i++)
+        {
+            values[i] = static_cast<T>(zero + scale * static_cast<double>(raw[i]));
+        }
+    }
+}
+
+template <typename S>
+inline typename std::enable_if<std::is_integral<S>::value, bool>::type is_nonzero(S value)
+{
+    return value != 0;
+}
+
+template <typename S>
+inline typename std::enable_if<std::is_floating_point<S>::value, bool>::type
+is_nonzero(S value)
+{
+    return std::fpclassify(value) != FP_ZERO;
+}
+
+// logical values of stored values, nonzero values are true, TSCAL and TZERO do not apply
+// to logical values
+template <typename S>
+inline typename std::enable_if<std::is_arithmetic<S>::value>::type
+physical_values(std::vector<S> const& raw, double, double, std::vector<bool>& values)
+{
+    values.resize(raw.size());
+    for (std::size_t i = 0; i < raw.size(); i++)
+    {
+        values[i] = is_nonzero(raw[i]);
+    }
+}
+
+template <typename T, typename S>
+inline typename std::enable_if<!(std::is_arithmetic<T>::value && std::is_arithmetic<S>::value)>::type
+physical_values(std::vector<S> const&, double, double, std::vector<T>&)
+{
+    throw invalid_table_colum_format();
+}
+///@endcond
+
+} //namespace detail
+
+namespace io {
+
+//! binary table extension (XTENSION = 'BINTABLE'), values of columns are decoded on request
+//! into column_data<T> where T is the type stored in file (bool for L, std::uint8_t for B and X,
+//! std::int16_t for I, std::int32_t for J, std::int64_t for K, std::string for A, float for E,
+//! double for D, std::complex<float> for C and std::complex<double> for M)
+//! array columns store repeat values for each row one row after another
+//! variable length array columns (P and Q) are decoded as their descriptors (std::uint32_t
+//! for P and std::uint64_t for Q, element count followed by heap offset for each row), the
+//! arrays themselves are accessed through variable_length_column views into the heap
+struct binary_table_extension : public table_extension
+{
+    //! default number of bytes read at once when columns are read from file
+    static constexpr std::size_t default_block_bytes = std::size_t(4) << 20;
+
+    binary_table_extension() {}
+
+    //!reads the header and data unit from current position of file
+    binary_table_extension(std::istream &file) : table_extension(file)
+    {
+        set_column_layout();
+        read_data(file);
+    }
+
+    //!reads the data unit from current position of file
+    binary_table_extension(std::istream &file, hdu const& other) : table_extension(file, other)
+    {
+        set_column_layout();
+        read_data(file);
+    }
+
+    //!creates the table from header only, columns can be read from file by read_columns
+    binary_table_extension(hdu const& other) : table_extension(other)
+    {
+        set_column_layout();
+    }
+
+    //!returns the values of column with TTYPE name from the data unit read
+    //!T is either the type stored in file or an arithmetic type to which the physical
+    //!values (TZERO + TSCAL * value) are converted
+    template <typename T>
+    column_data<T> get_column_data(std::string const& name) const
+    {
+        column const& col = get_column_metadata(name);
+        if (data.size() < rows() * row_size())
+        {
+            throw fits_exception();
+        }
+
+        column_data<T> result(col);
+        result.get_data().reserve(rows() * col.repeat());
+
+        detail::visit_binary_type(col.type(), [&](auto tag)
+        {
+            using stored_type = typename decltype(tag)::type;
+            decode_as<stored_type>(col, result.get_data(),
+                std::is_same<T, stored_type>());
+        });
+        return result;
+    }
+
+    //!returns column_data of the type stored in file for column with TTYPE name
+    std::unique_ptr<column> get_column(std::string name) const override
+    {
+        std::vector<std::unique_ptr<column>> result = read_columns({name});
+        return std::move(result.front());
+    }
+
+    //!decodes the columns with given TTYPE (all the columns if names is empty) from the data
+    //!unit read, each column is column_data of the type stored in file
+    std::vector<std::unique_ptr<column>> read_columns(std::vector<std::string> const& names) const
+    {
+        std::vector<std::unique_ptr<column>> columns = make_columns(names, rows());
+        if (data.size() < rows() * row_size())
+        {
+            throw fits_exception();
+        }
+        decode_block(columns, data.data(), rows());
+        return columns;
+    }
+
+    //!decodes the columns with given TTYPE (all the columns if names is empty) reading rows
+    //!of data unit at data_offset of file in blocks of at most block_bytes (atleast one row)
+    //!only the bytes of requested columns are decoded
+    std::vector<std::unique_ptr<column>> read_columns
+    (
+        byte_source const& file,
+        std::streamoff data_offset,
+        std::vector<std::string> const& names,
+        std::size_t block_bytes = default_block_bytes
+    ) const
+    {
+        std::vector<std::unique_ptr<column>> columns = make_columns(names, rows());
+        if (row_size() == 0)
+        {
+            return columns;
+        }
+
+        std::size_t const block_rows = (std::max)(block_bytes / row_size(), std::size_t(1));
+        std::vector<char> buffer((std::min)(block_rows, rows()) * row_size());
+        for (std::size_t first = 0; first < rows(); first += block_rows)
+        {
+            std::size_t const count = (std::min)(block_rows, rows() - first);
+            file.read_at(buffer.data(), count * row_size(),
+                static_cast<std::uint64_t>(data_offset) + first * row_size());
+            decode_block(columns, buffer.data(), count);
+        }
+        return columns;
+    }
+
+    //!decodes the columns with given TTYPE (all the columns if names is empty) of the rows of
+    //!data unit read which satisfy all the predicates, the data unit is scanned in blocks of
+    //!at most block_bytes and only the rows selected in a block are decoded
+    std::vector<std::unique_ptr<column>> scan
+    (
+        std::vector<column_predicate> const& predicates,
+        std::vector<std::string> const& names,
+        std::size_t block_bytes = default_block_bytes
+    ) const
+    {
+        std::vector<column const*> filters = predicate_columns(predicates);
+        std::vector<std::unique_ptr<column>> columns = make_columns(names, 0);
+        if (data.size() < rows() * row_size())
+        {
+            throw fits_exception();
+        }
+        if (row_size() == 0)
+        {
+            return columns;
+        }
+
+        std::size_t const block_rows = (std::max)(block_bytes / row_size(), std::size_t(1));
+        std::vector<std::uint8_t> selected;
+        std::vector<char> matches;
+        for (std::size_t first = 0; first < rows(); first += block_rows)
+        {
+            std::size_t const count = (std::min)(block_rows, rows() - first);
+            scan_block(filters, predicates, columns, data.data() + first * row_size(), count,
+                selected, matches);
+        }
+        return columns;
+    }
+
+    //!decodes the columns with given TTYPE (all the columns if names is empty) of the rows
+    //!which satisfy all the predicates reading rows of data unit at data_offset of file in
+    //!blocks of at most block_bytes (atleast one row), the columns of predicates are evaluated
+    //!first and the requested columns are decoded only for the rows selected in a block
+    std::vector<std::unique_ptr<column>> scan
+    (
+        byte_source const& file,
+        std::streamoff data_offset,
+        std::vector<column_predicate> const& predicates,
+        std::vector<std::string> const& names,
+        std::size_t block_bytes = default_block_bytes
+    ) const
+    {
+        std::vector<column const*> filters = predicate_columns(predicates);
+        std::vector<std::unique_ptr<column>> columns = make_columns(names, 0);
+        if (row_size() == 0)
+        {
+            return columns;
+        }
+
+        std::size_t const block_rows = (std::max)(block_bytes / row_size(), std::size_t(1));
+        std::vector<char> buffer((std::min)(block_rows, rows()) * row_size());
+        std::vector<std::uint8_t> selected;
+        std::vector<char> matches;
+        for (std::size_t first = 0; first < rows(); first += block_rows)
+        {
+            std::size_t const count = (std::min)(block_rows, rows() - first);
+            file.read_at(buffer.data(), count * row_size(),
+                static_cast<std::uint64_t>(data_offset) + first * row_size());
+            scan_block(filters, predicates, columns, buffer.data(), count, selected, matches);
+        }
+        return columns;
+    }
+
+    //!returns the offset of heap from the start of data unit
+    //!(THEAP if present, otherwise the end of main table)
+    std::size_t heap_offset() const
+    {
+        if (this->contains("THEAP"))
+        {
+            return this->value_of<std::size_t>("THEAP");
+        }
+        return rows() * row_size();
+    }
+
+    //!returns the view of variable length array column with TTYPE name into the data unit
+    //!read, T is the type of elements (char for A, otherwise the type stored in file)
+    template <typename T>
+    variable_length_column<T> get_array_column(std::string const& name) const
+    {
+        return array_column<T>(name, data.data(), data.size());
+    }
+
+    //!returns the view of variable length array column with TTYPE name into the data unit
+    //!(main table followed by heap) of size bytes stored at data_unit, e.g. in a memory
+    //!mapped file, the data unit must outlive the view
+    template <typename T>
+    variable_length_column<T> array_column
+    (
+        std::string const& name,
+        char const* data_unit,
+        std::size_t size
+    ) const
+    {
+        column const& col = get_column_metadata(name);
+        if ((col.type() != 'P' && col.type() != 'Q') || col.repeat() != 1 ||
+            !detail::is_array_element_type<T>(col.array_type()))
+        {
+            throw invalid_table_colum_format();
+        }
+
+        std::size_t const heap = heap_offset();
+        if (size < rows() * row_size() || heap < rows() * row_size() || heap > size)
+        {
+            throw fits_exception();
+        }
+        return variable_length_column<T>(col, data_unit, rows(), row_size(),
+            data_unit + heap, size - heap);
+    }
+
+protected:
+    //!sets the repeat count, type, width and offset in row of every column from TFORM
+    void set_column_layout()
+    {
+        std::size_t offset = 0;
+        for (column& col : this->col_metadata)
+        {
+            detail::parse_binary_tform(col);
+            col.offset(offset);
+            offset += col.width();
+        }
+        if (offset != row_size())
+        {
+            throw invalid_table_colum_format();
+        }
+    }
+
+    //!creates empty column_data of stored type for every requested column with space
+    //!reserved for expected_rows rows
+    std::vector<std::unique_ptr<column>> make_columns
+    (
+        std::vector<std::string> const& names,
+        std::size_t expected_rows
+    ) const
+    {
+        std::vector<column const*> selected;
+        if (names.empty())
+        {
+            for (column const& col : this->col_metadata)
+            {
+                selected.push_back(&col);
+            }
+        }
+        for (std::string const& name : names)
+        {
+            selected.push_back(&get_column_metadata(name));
+        }
+
+        std::vector<std::unique_ptr<column>> columns;
+        for (column const* col : selected)
+        {
+            detail::visit_binary_type(col->type(), [&](auto tag)
+            {
+                using stored_type = typename decltype(tag)::type;
+                std::unique_ptr<column_data<stored_type>> values(new column_data<stored_type>(*col));
+                values->get_data().reserve(expected_rows * (col->type() == 'A' ? 1 : col->repeat()));
+                columns.push_back(std::move(values));
+            });
+        }
+        return columns;
+    }
+
+    //!returns the metadata of the column of every predicate, only scalar numeric
+    //!columns (B, I, J, K, E and D with repeat count 1) can be compared
+    std::vector<column const*> predicate_columns
+    (
+        std::vector<column_predicate> const& predicates
+    ) const
+    {
+        std::vector<column const*> filters;
+        for (column_predicate const& predicate : predicates)
+        {
+            column const& col = get_column_metadata(predicate.column());
+            if (col.repeat() != 1 || std::string("BIJKED").find(col.type()) == std::string::npos)
+            {
+                throw invalid_table_colum_format();
+            }
+            filters.push_back(&col);
+        }
+        return filters;
+    }
+
+    //!appends the rows of block which satisfy all the predicates to every column
+    //!selected and matches are scratch buffers reused between blocks
+    void scan_block
+    (
+        std::vector<column const*> const& filters,
+        std::vector<column_predicate> const& predicates,
+        std::vector<std::unique_ptr<column>>& columns,
+        char const* block,
+        std::size_t count,
+        std::vector<std::uint8_t>& selected,
+        std::vector<char>& matches
+    ) const
+    {
+        selected.assign(count, 1);
+        for (std::size_t p = 0; p < predicates.size(); p++)
+        {
+            detail::visit_binary_type(filters[p]->type(), [&](auto tag)
+            {
+                filter_block(*filters[p], predicates[p], block, count, selected.data(), tag);
+            });
+            if (std::find(selected.begin(), selected.end(), 1) == selected.end())
+            {
+                return;
+            }
+        }
+
+        std::size_t matched = 0;
+        matches.resize(count * row_size());
+        for (std::size_t r = 0; r < count; r++)
+        {
+            if (selected[r])
+            {
+                std::memcpy(matches.data() + matched * row_size(), block + r * row_size(),
+                    row_size());
+                matched++;
+            }
+        }
+        decode_block(columns, matched == count ? block : matches.data(), matched);
+    }
+
+    //!clears the rows of block whose value of col does not satisfy predicate
+    template <typename T>
+    typename std::enable_if<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>::type
+    filter_block(column const& col, column_predicate const& predicate, char const* block,
+        std::size_t count, std::uint8_t* selected, detail::type_tag<T>) const
+    {
+        std::vector<T> values;
+        detail::decode_binary_rows(block, count, row_size(), col, values);
+        detail::filter_values(values.data(), count, col.TSCAL(), col.TZERO(), predicate,
+            selected);
+    }
+
+    template <typename T>
+    typename std::enable_if<!std::is_arithmetic<T>::value || std::is_same<T, bool>::value>::type
+    filter_block(column const&, column_predicate const&, char const*, std::size_t,
+        std::uint8_t*, detail::type_tag<T>) const
+    {
+        throw invalid_table_colum_format();
+    }
+
+    //!appends the values of count rows to every column
+    void decode_block(std::vector<std::unique_ptr<column>>& columns, char const* block,
+        std::size_t count) const
+    {
+        for (std::unique_ptr<column>& col : columns)
+        {
+            detail::visit_binary_type(col->type(), [&](auto tag)
+            {
+                using stored_type = typename decltype(tag)::type;
+                detail::decode_binary_rows(block, count, row_size(), *col,
+                    static_cast<column_data<stored_type>&>(*col).get_data());
+            });
+        }
+    }
+
+    template <typename S, typename T>
+    void decode_as(column const& col, std::vector<T>& values, std::true_type) const
+    {
+        detail::decode_binary_rows(data.data(), rows(), row_size(), col, values);
+    }
+
+    template <typename S, typename T>
+    void decode_as(column const& col, std::vector<T>& values, std::false_type) const
+    {
+        std::vector<S> raw;
+        detail::decode_binary_rows(data.data(), rows(), row_size(), col, raw);
+        detail::physical_values(raw, col.TSCAL(), col.TZERO(), values);
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_BINARY_TABLE_EXTENSION_HPP
@@ -1,6 +1,13 @@
 #ifndef BOOST_ASTRONOMY_IO_BITPIX_HPP
 #define BOOST_ASTRONOMY_IO_BITPIX_HPP
 
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/cstdfloat.hpp>
+
+#include <boost/astronomy/detail/exact_compare.hpp>
+
 namespace boost { namespace astronomy { namespace io {
 
 //! enum used to represetn different values of bitpix in header
@@ -13,6 +20,79 @@ enum class bitpix
     _B64 //! 64-bit IEEE double precesion floating point
 };
 
+//! maps a bitpix value to the pixel type used to store it in memory
+template <bitpix DataType>
+struct bitpix_traits {};
+
+template <>
+struct bitpix_traits<bitpix::B8>
+{
+    using type = std::uint8_t;
+    static constexpr int value = 8;
+};
+
+template <>
+struct bitpix_traits<bitpix::B16>
+{
+    using type = std::int16_t;
+    static constexpr int value = 16;
+};
+
+template <>
+struct bitpix_traits<bitpix::B32>
+{
+    using type = std::int32_t;
+    static constexpr int value = 32;
+};
+
+template <>
+struct bitpix_traits<bitpix::_B32>
+{
+    using type = boost::float32_t;
+    static constexpr int value = -32;
+};
+
+template <>
+struct bitpix_traits<bitpix::_B64>
+{
+    using type = boost::float64_t;
+    static constexpr int value = -64;
+};
+
+//! returns the number of bytes used by a single pixel of given bitpix
+inline std::size_t bitpix_size(bitpix value)
+{
+    switch (value)
+    {
+    case bitpix::B8:
+        return 1;
+    case bitpix::B16:
+        return 2;
+    case bitpix::B32:
+    case bitpix::_B32:
+        return 4;
+    case bitpix::_B64:
+        return 8;
+    }
+    return 0;
+}
+
+//! scaling of stored pixel values given by BSCALE, BZERO and BLANK keywords of an image
+//! physical value = BZERO + BSCALE * stored value, stored values equal to BLANK are undefined
+struct pixel_scaling
+{
+    double bscale = 1;
+    double bzero = 0;
+    bool has_blank = false;
+    std::int64_t blank = 0;
+
+    //! returns true if physical values are the stored values
+    bool is_identity() const
+    {
+        return detail::is_identity_scaling(bscale, bzero) && !has_blank;
+    }
+};
+
 }}} //namespace boost::astronomy::io
 
 #endif // !BOOST_ASTRONOMY_IO_BITPIX_HPP
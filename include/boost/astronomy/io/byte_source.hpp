@@ -0,0 +1,315 @@
+#ifndef BOOST_ASTRONOMY_IO_BYTE_SOURCE_HPP
+#define BOOST_ASTRONOMY_IO_BYTE_SOURCE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ios>
+#include <istream>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/astronomy/detail/positioned_file.hpp>
+#include <boost/astronomy/io/mapped_file.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+//! bytes of a FITS (file, memory buffer, mapping...) read by the FITS readers
+//! read_at must be safe to call from many threads at the same time, sequential reads are
+//! provided for any source by source_istream
+struct byte_source
+{
+    virtual ~byte_source() {}
+
+    //! returns the number of bytes in source
+    virtual std::uint64_t size() const = 0;
+
+    //! reads exactly size bytes at offset into buffer, throws fits_exception if the bytes
+    //! are not in source or can not be read
+    virtual void read_at(void* buffer, std::size_t size, std::uint64_t offset) const = 0;
+
+    //! returns the bytes [offset, offset + size) in place if source is held in memory
+    //! (memory buffer or mapping) so that readers can decode them without a copy,
+    //! nullptr otherwise
+    virtual char const* view(std::uint64_t offset, std::size_t size) const
+    {
+        (void)offset;
+        (void)size;
+        return nullptr;
+    }
+};
+
+//! file read with positioned reads (pread), see detail::positioned_file
+struct file_source : public byte_source
+{
+protected:
+    detail::positioned_file file; //! file read by read_at
+
+public:
+    explicit file_source(std::string const& path) : file(path) {}
+
+    std::uint64_t size() const override
+    {
+        return file.size();
+    }
+
+    void read_at(void* buffer, std::size_t size, std::uint64_t offset) const override
+    {
+        file.read_at(buffer, size, offset);
+    }
+};
+
+//! bytes held in memory, e.g. a FITS received over IPC, either owned by the source or
+//! borrowed from the caller who keeps them alive as long as the source is used
+struct memory_source : public byte_source
+{
+protected:
+    std::vector<char> owned; //! bytes owned by source, empty if they are borrowed
+    char const* start = nullptr; //! first byte of source
+    std::size_t length = 0; //! number of bytes in source
+
+public:
+    //! borrows size bytes at data
+    memory_source(char const* data, std::size_t size) : start(data), length(size) {}
+
+    //! takes the ownership of bytes
+    explicit memory_source(std::vector<char> bytes) :
+        owned(std::move(bytes)), start(owned.data()), length(owned.size()) {}
+
+    memory_source(memory_source const&) = delete;
+    memory_source& operator=(memory_source const&) = delete;
+
+    std::uint64_t size() const override
+    {
+        return length;
+    }
+
+    void read_at(void* buffer, std::size_t size, std::uint64_t offset) const override
+    {
+        char const* bytes = checked(offset, size);
+        if (size != 0)
+        {
+            std::memcpy(buffer, bytes, size);
+        }
+    }
+
+    char const* view(std::uint64_t offset, std::size_t size) const override
+    {
+        return checked(offset, size);
+    }
+
+protected:
+    char const* checked(std::uint64_t offset, std::size_t size) const
+    {
+        if (offset > length || size > length - offset)
+        {
+            throw fits_exception();
+        }
+        return start + offset;
+    }
+};
+
+//! file read through a read-only memory mapping, see mapped_file
+struct mapped_source : public byte_source
+{
+protected:
+    mapped_file file; //! mapping of whole file
+
+public:
+    explicit mapped_source(std::string const& path) : file(path) {}
+
+    std::uint64_t size() const override
+    {
+        return file.size();
+    }
+
+    void read_at(void* buffer, std::size_t size, std::uint64_t offset) const override
+    {
+        char const* bytes = view(offset, size);
+        if (size != 0)
+        {
+            std::memcpy(buffer, bytes, size);
+        }
+    }
+
+    char const* view(std::uint64_t offset, std::size_t size) const override
+    {
+        if (offset > file.size() || size > file.size() - offset)
+        {
+            throw fits_exception();
+        }
+        return file.data() + offset;
+    }
+};
+
+//! stream buffer reading a byte_source sequentially, sources held in memory are read in
+//! place and other sources are read in blocks of buffer_bytes with positioned reads
+//! (reads larger than a block go directly to the destination)
+struct source_streambuf : public std::streambuf
+{
+public:
+    static constexpr std::size_t default_buffer_bytes = std::size_t(1) << 20;
+
+protected:
+    byte_source const& input; //! source read
+    std::uint64_t input_size; //! number of bytes in source
+    char* in_place; //! whole source in place, nullptr if it is not held in memory
+    std::vector<char> block; //! block of source read last
+    std::uint64_t block_offset = 0; //! offset of first byte of block in source
+
+public:
+    explicit source_streambuf
+    (
+        byte_source const& source,
+        std::size_t buffer_bytes = default_buffer_bytes
+    ) :
+        input(source),
+        input_size(source.size()),
+        in_place(const_cast<char*>(source.view(0, static_cast<std::size_t>(input_size))))
+    {
+        if (in_place)
+        {
+            setg(in_place, in_place, in_place + input_size);
+            return;
+        }
+        block.resize((std::max)(buffer_bytes, std::size_t(1)));
+        setg(block.data(), block.data(), block.data());
+    }
+
+    source_streambuf(source_streambuf const&) = delete;
+    source_streambuf& operator=(source_streambuf const&) = delete;
+
+protected:
+    int_type underflow() override
+    {
+        if (gptr() == egptr() && (in_place || !fill(position())))
+        {
+            return traits_type::eof();
+        }
+        return traits_type::to_int_type(*gptr());
+    }
+
+    std::streamsize xsgetn(char* destination, std::streamsize count) override
+    {
+        std::size_t const buffered = static_cast<std::size_t>(egptr() - gptr());
+        std::size_t const wanted = static_cast<std::size_t>(count);
+        if (in_place || wanted <= buffered || wanted - buffered < block.size())
+        {
+            return std::streambuf::xsgetn(destination, count);
+        }
+
+        //large read, bytes in buffer followed by a read straight into destination
+        std::memcpy(destination, gptr(), buffered);
+        std::uint64_t const first = position() + buffered;
+        std::size_t const direct = static_cast<std::size_t>((std::min)(
+            static_cast<std::uint64_t>(wanted - buffered), input_size - first));
+        input.read_at(destination + buffered, direct, first);
+        block_offset = first + direct;
+        setg(block.data(), block.data(), block.data());
+        return static_cast<std::streamsize>(buffered + direct);
+    }
+
+    pos_type seekoff
+    (
+        off_type offset,
+        std::ios_base::seekdir direction,
+        std::ios_base::openmode which
+    ) override
+    {
+        if ((which & std::ios_base::in) == 0)
+        {
+            return pos_type(off_type(-1));
+        }
+        off_type base = 0;
+        if (direction == std::ios_base::cur)
+        {
+            base = static_cast<off_type>(position());
+        }
+        else if (direction == std::ios_base::end)
+        {
+            base = static_cast<off_type>(input_size);
+        }
+        off_type const target = base + offset;
+        if (target < 0 || static_cast<std::uint64_t>(target) > input_size)
+        {
+            return pos_type(off_type(-1));
+        }
+        seek(static_cast<std::uint64_t>(target));
+        return pos_type(target);
+    }
+
+    pos_type seekpos(pos_type position, std::ios_base::openmode which) override
+    {
+        return seekoff(off_type(position), std::ios_base::beg, which);
+    }
+
+    //! returns the offset of the next byte read
+    std::uint64_t position() const
+    {
+        if (in_place)
+        {
+            return static_cast<std::uint64_t>(gptr() - in_place);
+        }
+        return block_offset + static_cast<std::uint64_t>(gptr() - eback());
+    }
+
+    void seek(std::uint64_t target)
+    {
+        if (in_place)
+        {
+            setg(in_place, in_place + target, in_place + input_size);
+            return;
+        }
+        std::uint64_t const end = block_offset +
+            static_cast<std::uint64_t>(egptr() - eback());
+        if (target >= block_offset && target <= end)
+        {
+            setg(eback(), eback() + static_cast<std::size_t>(target - block_offset), egptr());
+            return;
+        }
+        block_offset = target;
+        setg(block.data(), block.data(), block.data());
+    }
+
+    //! reads the block starting at offset into block, returns false at the end of source
+    bool fill(std::uint64_t offset)
+    {
+        if (offset >= input_size)
+        {
+            return false;
+        }
+        std::size_t const count = static_cast<std::size_t>((std::min)(
+            static_cast<std::uint64_t>(block.size()), input_size - offset));
+        input.read_at(block.data(), count, offset);
+        block_offset = offset;
+        setg(block.data(), block.data(), block.data() + count);
+        return true;
+    }
+};
+
+//! input stream reading a byte_source sequentially, e.g. to read the headers and HDU of
+//! FITS held in memory with the readers taking std::istream
+//! the source must outlive the stream
+struct source_istream : public std::istream
+{
+protected:
+    source_streambuf buffer; //! buffer reading source
+
+public:
+    explicit source_istream
+    (
+        byte_source const& source,
+        std::size_t buffer_bytes = source_streambuf::default_buffer_bytes
+    ) : std::istream(nullptr), buffer(source, buffer_bytes)
+    {
+        rdbuf(&buffer);
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_BYTE_SOURCE_HPP
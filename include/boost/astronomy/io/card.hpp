@@ -1,45 +1,56 @@
+
 #ifndef BOOST_ASTRONOMY_IO_CARD_HPP
 #define BOOST_ASTRONOMY_IO_CARD_HPP
 
 #include <string>
 #include <sstream>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+#include <limits>
+#include <locale>
+#include <type_traits>
+#include <typeinfo>
 
-#include <boost/algorithm/string/trim.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/type.hpp>
+#include <boost/utility/string_view.hpp>
 
+#include <boost/astronomy/detail/charconv.hpp>
 #include <boost/astronomy/exception/fits_exception.hpp>
 
 namespace boost { namespace astronomy { namespace io {
 
 //!structure to store a card (80 byte key value pairs as well as comments and history cards)
+//!the 80 chars are stored inline so that reading and parsing a card never allocates
 struct card
 {
 private:
-    std::string card_;
+    char card_[80];
 
 public:
     card()
     {
-        this->card_.reserve(80);
+        std::memset(this->card_, ' ', 80);
     }
+
     //! creating card from const char*
     //! it will read 80 char from provided pointer
-    card(char const* c) : card()
+    card(char const* c)
     {
-        this->card_.assign(c, 80);
+        std::memcpy(this->card_, c, 80);
     }
 
-    //!a string is expected with lenght no more than 80 chars 
+    //!a string is expected with lenght no more than 80 chars
     //!this string will be directly stored in the card
     //!string must follow all the standerd of the key, value and comment for card
-    card(std::string str) : card()
+    card(std::string const& str) : card()
     {
         if (str.length() > 80)
         {
             throw invalid_card_length_exception();
         }
-        this->card_ = str.append(80 - str.length(), ' ');
+        std::memcpy(this->card_, str.data(), str.length());
     }
 
     //!key, value and optional comments are expected
@@ -50,32 +61,9 @@ public:
         std::string const& key,
         std::string const& value,
         std::string const& comment = ""
-    )
+    ) : card()
     {
-        if (key.length() > 8)
-        {
-            throw invalid_key_length_exception();
-        }
-        if ((comment.length() > 0) && (value.length() + comment.length() > 68))
-        {
-            throw invalid_value_length_exception();
-        }
-        else if (value.length() > 70)
-        {
-            throw invalid_value_length_exception();
-        }
-
-        if (comment.length())
-        {
-            this->card_ = std::string(key).append(8 - key.length(), ' ') +
-                "= " + value + " /" + comment +
-                std::string("").append(68 - value.length() + comment.length(), ' ');
-        }
-        else
-        {
-            this->card_ = std::string(key).append(8 - key.length(), ' ') + "= " +
-                std::string(value).append(70 - key.length(), ' ');
-        }
+        create_card(key, value, comment);
     }
 
     //!this overload supports date and string types
@@ -93,7 +81,7 @@ public:
         {
             throw invalid_key_length_exception();
         }
-        if ((comment.length() > 0) && (value.length() + comment.length() > 68))
+        if ((comment.length() > 0) && (value.length() + comment.length() > 67))
         {
             throw invalid_value_length_exception();
         }
@@ -102,47 +90,52 @@ public:
             throw invalid_value_length_exception();
         }
 
+        std::memset(this->card_, ' ', 80);
+        std::memcpy(this->card_, key.data(), key.length());
+        this->card_[8] = '=';
+        std::memcpy(this->card_ + 10, value.data(), value.length());
+
         if (comment.length())
         {
-            this->card_ = std::string(key).append(8 - key.length(), ' ') +
-                "= " + value + " /" + comment +
-                std::string("").append(68 - value.length() + comment.length(), ' ');
-        }
-        else
-        {
-            this->card_ = std::string(key).append(8 - key.length(), ' ') +
-                "= " + std::string(value).append(70 - key.length(), ' ');
+            std::size_t position = 10 + value.length() + 1;
+            this->card_[position] = '/';
+            std::memcpy(this->card_ + position + 2, comment.data(),
+                (std::min)(comment.length(), 80 - position - 2));
         }
     }
 
     //!create card with boolean value
     void create_card(std::string const& key, bool value, std::string const& comment = "")
     {
-        if (value)
-        {
-            create_card(key, std::string("T").insert(0, ' ', 19), comment);
-        }
-        else
-        {
-            create_card(key, std::string("F").insert(0, ' ', 19), comment);
-        }
+        //logical value is placed in column 30
+        create_card(key, std::string(19, ' ') + (value ? "T" : "F"), comment);
     }
 
     //!create card with numeric value
+    //!real values are written with enough digits to be read back exactly and an uppercase
+    //!exponent (e.g. 1.0000000000000001E-05) as required by FITS
     template <typename Value>
-    void create_card(std::string const& key, Value value, std::string const& comment = "")
+    typename std::enable_if<std::is_arithmetic<Value>::value>::type
+    create_card(std::string const& key, Value value, std::string const& comment = "")
     {
         std::ostringstream stream;
-        stream << value;
+        stream.imbue(std::locale::classic());
+        stream.precision(std::numeric_limits<Value>::max_digits10);
+        stream << std::uppercase << +value;
 
+        //numeric value is right justified to column 30
         std::string val = stream.str();
-        val.insert(0, ' ', 20 - val.length());
+        if (val.length() < 20)
+        {
+            val.insert(0, 20 - val.length(), ' ');
+        }
         create_card(key, val, comment);
     }
 
     //!create card for complex value
     template <typename Real, typename Imaginary>
-    void create_card
+    typename std::enable_if<std::is_arithmetic<Imaginary>::value>::type
+    create_card
     (
         std::string const& key,
         Real real,
@@ -151,7 +144,10 @@ public:
     )
     {
         std::ostringstream stream;
-        stream << real << ", " << imaginary;
+        stream.imbue(std::locale::classic());
+        stream.precision((std::max)(std::numeric_limits<Real>::max_digits10,
+            std::numeric_limits<Imaginary>::max_digits10));
+        stream << std::uppercase << real << ", " << imaginary;
 
         std::string value = "(" + stream.str() + ")";
 
@@ -171,23 +167,33 @@ public:
             throw invalid_value_length_exception();
         }
 
-        this->card_ = std::string(key).append(8 - key.length(), ' ') +
-            "  " + std::string(value).append(70 - key.length(), ' ');
+        std::memset(this->card_, ' ', 80);
+        std::memcpy(this->card_, key.data(), key.length());
+        std::memcpy(this->card_ + 10, value.data(), value.length());
     }
 
-    //!if whole value is set to true then string is returned with trailing spaces
-    std::string key(bool whole = false) const
+    //!returns the key without surrounding spaces
+    //!if whole value is set to true then all 8 chars are returned with trailing spaces
+    boost::string_view key(bool whole = false) const
     {
+        boost::string_view key(this->card_, 8);
         if (whole)
         {
-            return this->card_.substr(0, 8);
+            return key;
         }
-        return boost::algorithm::trim_copy(this->card_.substr(0, 8));
+        return trim(key);
+    }
+
+    //!returns true if the card has a value indicator ("= " in columns 9 and 10)
+    bool has_value() const
+    {
+        return this->card_[8] == '=' && this->card_[9] == ' ';
     }
 
     /*!
-    return types can be int, float, double, bool, string
+    return types can be int, float, double, bool, string or boost::string_view
     (date and complex numbers are returned as string surrounded in single quotes or in brackets)
+    numeric values are parsed without allocation and independent of the global locale
     */
     template <typename ReturnType>
     ReturnType value() const
@@ -195,10 +201,22 @@ public:
         return value_imp(boost::type<ReturnType>());
     }
 
-    //!returns value portion of card with comment as std::string 
-    std::string value_with_comment() const
+    //!returns value portion of card with comment
+    boost::string_view value_with_comment() const
     {
-        return this->card_.substr(10);
+        return boost::string_view(this->card_ + 10, 70);
+    }
+
+    //!returns comment of card without the separator and surrounding spaces
+    boost::string_view comment() const
+    {
+        boost::string_view rest = value_with_comment();
+        std::size_t separator = comment_position();
+        if (separator == boost::string_view::npos)
+        {
+            return boost::string_view();
+        }
+        return trim(rest.substr(separator + 1));
     }
 
     //!set value of current card
@@ -212,32 +230,126 @@ public:
         {
             throw invalid_value_length_exception();
         }
-        this->card_.append(70 - value.length(), ' ');
+        this->card_[8] = '=';
+        this->card_[9] = ' ';
+        std::memset(this->card_ + 10, ' ', 70);
+        std::memcpy(this->card_ + 10, value.data(), value.length());
+    }
+
+    //!returns pointer to the 80 chars of card
+    char const* data() const
+    {
+        return this->card_;
     }
 
 private:
+    static boost::string_view trim(boost::string_view text)
+    {
+        while (!text.empty() && text.front() == ' ')
+        {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && text.back() == ' ')
+        {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+
+    //!position of comment separator in value_with_comment(), slashes inside a string are skipped
+    std::size_t comment_position() const
+    {
+        boost::string_view rest = value_with_comment();
+        std::size_t start = rest.find_first_not_of(' ');
+        if (start != boost::string_view::npos && rest[start] == '\'')
+        {
+            //quotes inside string are escaped by another quote
+            std::size_t i = start + 1;
+            while (i < rest.size())
+            {
+                if (rest[i] == '\'')
+                {
+                    if (i + 1 < rest.size() && rest[i + 1] == '\'')
+                    {
+                        i += 2;
+                        continue;
+                    }
+                    break;
+                }
+                i++;
+            }
+            return rest.find('/', i);
+        }
+        return rest.find('/');
+    }
+
+    //!value without comment and surrounding spaces
+    boost::string_view value_view() const
+    {
+        boost::string_view rest = value_with_comment();
+        return trim(rest.substr(0, comment_position()));
+    }
 
     template <typename ReturnType>
-    ReturnType value_imp(boost::type<ReturnType>) const
+    ReturnType parse(std::true_type /*integral*/) const
     {
-        std::string val = boost::algorithm::trim_copy(
-            this->card_.substr(10, this->card_.find('/') - 10));
-        return boost::lexical_cast<ReturnType>(val);
+        boost::string_view val = value_view();
+        ReturnType result;
+        if (!detail::parse_integer(val.data(), val.data() + val.size(), result))
+        {
+            throw boost::bad_lexical_cast(typeid(char const*), typeid(ReturnType));
+        }
+        return result;
     }
 
-    bool value_imp(boost::type<bool>) const
+    template <typename ReturnType>
+    ReturnType parse(std::false_type /*floating point*/) const
     {
-        std::string val = boost::algorithm::trim_copy(
-            this->card_.substr(10, this->card_.find('/') - 10));
-        if (val == "T")
+        boost::string_view val = value_view();
+        ReturnType result;
+        if (!detail::parse_real(val.data(), val.data() + val.size(), result))
         {
-            return true;
+            throw boost::bad_lexical_cast(typeid(char const*), typeid(ReturnType));
         }
-        return false;
+        return result;
+    }
+
+    template <typename ReturnType>
+    ReturnType value_imp(boost::type<ReturnType>) const
+    {
+        return value_imp(boost::type<ReturnType>(),
+            std::integral_constant<bool, std::is_arithmetic<ReturnType>::value>());
+    }
+
+    template <typename ReturnType>
+    ReturnType value_imp(boost::type<ReturnType>, std::true_type /*arithmetic*/) const
+    {
+        return parse<ReturnType>(std::is_integral<ReturnType>());
+    }
+
+    template <typename ReturnType>
+    ReturnType value_imp(boost::type<ReturnType>, std::false_type /*arithmetic*/) const
+    {
+        boost::string_view val = value_view();
+        return boost::lexical_cast<ReturnType>(val.data(), val.size());
+    }
+
+    std::string value_imp(boost::type<std::string>) const
+    {
+        return value_view().to_string();
+    }
+
+    boost::string_view value_imp(boost::type<boost::string_view>) const
+    {
+        return value_view();
+    }
+
+    bool value_imp(boost::type<bool>) const
+    {
+        return value_view() == "T";
     }
 
 };
 
 }}} //namespace boost
 #endif // !BOOST_ASTRONOMY_IO_CARD_HPP
-
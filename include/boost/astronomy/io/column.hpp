@@ -12,21 +12,30 @@ namespace boost { namespace astronomy { namespace io {
 struct column
 {
 private:
-    std::size_t index_;     //index
+    std::size_t index_ = 0;     //index
     std::string name;       //TTYPE
-    std::size_t start;      //TBCOL
+    std::size_t start = 0;      //TBCOL
     std::string format;     //TFORM
     std::string unit;       //TUNIT
-    double scale;           //TSCAL
-    double zero;            //TZERO
+    double scale = 1;           //TSCAL
+    double zero = 0;            //TZERO
     std::string display;    //TDISP
     std::string dimension;   //TDIM
     std::string comment_;
 
+    std::size_t repeat_ = 1;    //repeat count of TFORM
+    char type_ = 'A';           //data type of TFORM
+    std::size_t width_ = 0;     //bytes of a row occupied by column
+    std::size_t offset_ = 0;    //offset of the first byte of column in a row
+    char array_type_ = 0;       //data type of elements of variable length array (P or Q)
+    std::size_t max_length_ = 0; //maximum number of elements of variable length array
+
 public:
 
     column(){}
 
+    virtual ~column() {}
+
     column(std::size_t tbcol, std::string tform): start(tbcol), format(tform) {}
 
     column(std::string tform) : format(tform) {}
@@ -130,6 +139,73 @@ public:
     {
         dimension = tdim;
     }
+
+    //!repeat count of TFORM (number of elements of column in a row)
+    std::size_t repeat() const
+    {
+        return repeat_;
+    }
+
+    void repeat(std::size_t count)
+    {
+        repeat_ = count;
+    }
+
+    //!data type code of TFORM (e.g. 'J' for binary table, 'F' for ASCII table)
+    char type() const
+    {
+        return type_;
+    }
+
+    void type(char code)
+    {
+        type_ = code;
+    }
+
+    //!bytes of a row occupied by column
+    std::size_t width() const
+    {
+        return width_;
+    }
+
+    void width(std::size_t bytes)
+    {
+        width_ = bytes;
+    }
+
+    //!offset of the first byte of column in a row
+    std::size_t offset() const
+    {
+        return offset_;
+    }
+
+    void offset(std::size_t bytes)
+    {
+        offset_ = bytes;
+    }
+
+    //!data type code of elements stored in heap by variable length array column
+    //!(e.g. 'E' for TFORM 1PE(200)), 0 for other columns
+    char array_type() const
+    {
+        return array_type_;
+    }
+
+    void array_type(char code)
+    {
+        array_type_ = code;
+    }
+
+    //!maximum number of elements of variable length array column (emax of TFORM)
+    std::size_t max_length() const
+    {
+        return max_length_;
+    }
+
+    void max_length(std::size_t count)
+    {
+        max_length_ = count;
+    }
 };
 
 }}}
@@ -18,6 +18,11 @@ private:
     std::vector<Type> column_data_;
 
 public:
+    column_data() {}
+
+    //!creates empty column with the metadata of given column
+    column_data(column const& metadata) : column(metadata) {}
+
     std::vector<Type> get_data() const
     {
         return column_data_;
@@ -0,0 +1,125 @@
+#ifndef BOOST_ASTRONOMY_IO_COLUMN_PREDICATE_HPP
+#define BOOST_ASTRONOMY_IO_COLUMN_PREDICATE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace boost { namespace astronomy { namespace io {
+
+//! comparison applied by column_predicate to the physical value of a column
+enum class comparison
+{
+    equal,
+    not_equal,
+    less,
+    less_equal,
+    greater,
+    greater_equal
+};
+
+//! condition on a scalar numeric column of a table (e.g. MAG < 20) evaluated on the
+//! physical value (TZERO + TSCAL * value) of the column in every row
+//! comparisons with NaN are false except for not_equal
+struct column_predicate
+{
+private:
+    std::string name; //! TTYPE of the column
+    comparison op = comparison::equal; //! comparison
+    double threshold = 0; //! value to which the column is compared
+
+public:
+    column_predicate() {}
+
+    column_predicate(std::string const& ttype, comparison compare, double value) :
+        name(ttype), op(compare), threshold(value) {}
+
+    //!returns the TTYPE of the column
+    std::string const& column() const
+    {
+        return this->name;
+    }
+
+    //!returns the comparison
+    comparison compare() const
+    {
+        return this->op;
+    }
+
+    //!returns the value to which the column is compared
+    double value() const
+    {
+        return this->threshold;
+    }
+};
+
+} //namespace io
+
+namespace detail {
+
+///@cond INTERNAL
+// clears selected[i] of every value which does not satisfy compare(physical value, threshold)
+// the loop is branchless so that compilers vectorize it
+template <typename T, typename Compare>
+inline void filter_values
+(
+    T const* values,
+    std::size_t count,
+    double scale,
+    double zero,
+    Compare compare,
+    double threshold,
+    std::uint8_t* selected
+)
+{
+    for (std::size_t i = 0; i < count; i++)
+    {
+        selected[i] = static_cast<std::uint8_t>(selected[i] &
+            static_cast<std::uint8_t>(compare(zero + scale * static_cast<double>(values[i]),
+                threshold)));
+    }
+}
+
+// clears selected[i] of every row whose value does not satisfy the predicate
+template <typename T>
+inline void filter_values
+(
+    T const* values,
+    std::size_t count,
+    double scale,
+    double zero,
+    io::column_predicate const& predicate,
+    std::uint8_t* selected
+)
+{
+    double const threshold = predicate.value();
+    switch (predicate.compare())
+    {
+    case io::comparison::equal:
+        filter_values(values, count, scale, zero, std::equal_to<double>(), threshold, selected);
+        return;
+    case io::comparison::not_equal:
+        filter_values(values, count, scale, zero, std::not_equal_to<double>(), threshold,
+            selected);
+        return;
+    case io::comparison::less:
+        filter_values(values, count, scale, zero, std::less<double>(), threshold, selected);
+        return;
+    case io::comparison::less_equal:
+        filter_values(values, count, scale, zero, std::less_equal<double>(), threshold, selected);
+        return;
+    case io::comparison::greater:
+        filter_values(values, count, scale, zero, std::greater<double>(), threshold, selected);
+        return;
+    case io::comparison::greater_equal:
+        filter_values(values, count, scale, zero, std::greater_equal<double>(), threshold,
+            selected);
+        return;
+    }
+}
+///@endcond
+
+}}} //namespace boost::astronomy::detail
+
+#endif // !BOOST_ASTRONOMY_IO_COLUMN_PREDICATE_HPP
@@ -0,0 +1,841 @@
+#ifndef BOOST_ASTRONOMY_IO_COMPRESSED_IMAGE_EXTENSION_HPP
+#define BOOST_ASTRONOMY_IO_COMPRESSED_IMAGE_EXTENSION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <boost/astronomy/detail/byteswap.hpp>
+#include <boost/astronomy/detail/gzip.hpp>
+#include <boost/astronomy/detail/parallel.hpp>
+#include <boost/astronomy/io/byte_source.hpp>
+#include <boost/astronomy/detail/quantize.hpp>
+#include <boost/astronomy/detail/rice.hpp>
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/hdu_index.hpp>
+#include <boost/astronomy/io/bitpix.hpp>
+#include <boost/astronomy/io/column.hpp>
+#include <boost/astronomy/io/image.hpp>
+#include <boost/astronomy/io/array_view.hpp>
+#include <boost/astronomy/io/binary_table_extension.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// sets the first pixel and the size along every axis of tile of an image of given axes
+// split into tiles of given shape, tiles are numbered with axis 1 varying fastest
+inline void tile_geometry
+(
+    std::size_t tile,
+    std::vector<std::size_t> const& axes,
+    std::vector<std::size_t> const& shape,
+    std::vector<std::size_t>& first,
+    std::vector<std::size_t>& size
+)
+{
+    for (std::size_t i = 0; i < axes.size(); i++)
+    {
+        std::size_t const along = (axes[i] + shape[i] - 1) / shape[i];
+        first[i] = (tile % along) * shape[i];
+        size[i] = (std::min)(shape[i], axes[i] - first[i]);
+        tile /= along;
+    }
+}
+
+// returns the number of tiles of given shape covering an image of given axes
+inline std::size_t tile_count(std::vector<std::size_t> const& axes,
+    std::vector<std::size_t> const& shape)
+{
+    std::size_t count = axes.empty() ? 0 : 1;
+    for (std::size_t i = 0; i < axes.size(); i++)
+    {
+        count *= (axes[i] + shape[i] - 1) / shape[i];
+    }
+    return count;
+}
+
+// copies the pixels of tile (given by its first pixel and size along every axis) of image
+// with given axes to destination, axis 1 varying fastest
+template <typename PixelType>
+inline void gather_tile
+(
+    PixelType const* pixels,
+    std::vector<std::size_t> const& axes,
+    std::vector<std::size_t> const& first,
+    std::vector<std::size_t> const& size,
+    PixelType* destination
+)
+{
+    std::size_t tile_rows = 1;
+    for (std::size_t i = 1; i < axes.size(); i++)
+    {
+        tile_rows *= size[i];
+    }
+
+    std::vector<std::size_t> position(axes.size(), 0);
+    for (std::size_t row = 0; row < tile_rows; row++)
+    {
+        std::size_t pixel = 0;
+        std::size_t pitch = 1;
+        for (std::size_t i = 0; i < axes.size(); i++)
+        {
+            pixel += (first[i] + position[i]) * pitch;
+            pitch *= axes[i];
+        }
+        std::copy(pixels + pixel, pixels + pixel + size[0], destination + row * size[0]);
+
+        for (std::size_t i = 1; i < axes.size(); i++)
+        {
+            if (++position[i] < size[i])
+            {
+                break;
+            }
+            position[i] = 0;
+        }
+    }
+}
+
+// heap of a binary table held in memory
+struct memory_heap
+{
+    char const* heap = nullptr;
+    std::size_t size = 0;
+
+    unsigned char const* read
+    (
+        std::size_t offset,
+        std::size_t bytes,
+        std::vector<unsigned char>&
+    ) const
+    {
+        if (offset > size || bytes > size - offset)
+        {
+            throw invalid_compressed_tile_exception();
+        }
+        return reinterpret_cast<unsigned char const*>(heap + offset);
+    }
+};
+
+// heap of a binary table read from file with positioned reads, only when needed, or in
+// place if the file is held in memory
+struct file_heap
+{
+    io::byte_source const* file = nullptr;
+    std::uint64_t start = 0;
+    std::size_t size = 0;
+
+    unsigned char const* read
+    (
+        std::size_t offset,
+        std::size_t bytes,
+        std::vector<unsigned char>& buffer
+    ) const
+    {
+        if (offset > size || bytes > size - offset)
+        {
+            throw invalid_compressed_tile_exception();
+        }
+        char const* in_place = file->view(start + offset, bytes);
+        if (in_place)
+        {
+            return reinterpret_cast<unsigned char const*>(in_place);
+        }
+        buffer.resize(bytes);
+        file->read_at(buffer.data(), bytes, start + offset);
+        return buffer.data();
+    }
+};
+
+// returns the value of a scalar numeric field of row as double
+inline double field_value(io::column const& col, char const* rows, std::size_t row_size,
+    std::size_t row)
+{
+    char const* field = rows + row * row_size + col.offset();
+    switch (col.type())
+    {
+    case 'B':
+        return static_cast<unsigned char>(*field);
+    case 'I':
+        return load_big_endian<std::int16_t>(field);
+    case 'J':
+        return load_big_endian<std::int32_t>(field);
+    case 'K':
+        return static_cast<double>(load_big_endian<std::int64_t>(field));
+    case 'E':
+        return load_big_endian<float>(field);
+    case 'D':
+        return load_big_endian<double>(field);
+    }
+    throw invalid_table_colum_format();
+}
+
+// returns the first selected pixel of range at or after pixel
+inline std::size_t first_selected(io::axis_range const& range, std::size_t pixel)
+{
+    if (pixel <= range.first)
+    {
+        return range.first;
+    }
+    return range.first + (pixel - range.first + range.stride - 1) / range.stride * range.stride;
+}
+///@endcond
+
+} //namespace detail
+
+namespace io {
+
+//! tile compressed image (ZIMAGE = T) stored in a binary table extension
+//! the image of ZNAXISn pixels along every axis is split into tiles of ZTILEn pixels (one row
+//! of the image by default) and every tile is compressed into a row of COMPRESSED_DATA
+//! tiles compressed by Rice (RICE_1), GZIP_1, GZIP_2 or NOCOMPRESS are decoded (GZIP only
+//! when zlib is available), floating point images quantized to integers are restored from
+//! ZSCALE and ZZERO with the dithering given by ZQUANTIZ and ZDITHER0, tiles which could not
+//! be compressed are read from GZIP_COMPRESSED_DATA or UNCOMPRESSED_DATA
+//! tiles are decompressed in parallel and only the tiles overlapping a cutout are read
+struct compressed_image_extension : public binary_table_extension
+{
+protected:
+    io::bitpix zbitpix_ = io::bitpix::B8; //! BITPIX of image (ZBITPIX)
+    std::vector<std::size_t> znaxis_; //! pixels of image along every axis (ZNAXIS1, ZNAXIS2...)
+    std::vector<std::size_t> ztile_; //! pixels of tiles along every axis (ZTILE1, ZTILE2...)
+    std::string zcmptype_; //! compression algorithm (ZCMPTYPE)
+    std::size_t block_size_ = 32; //! pixels in a block of Rice code (BLOCKSIZE)
+    std::size_t bytepix_ = 4; //! bytes of integers compressed by Rice (BYTEPIX)
+    detail::quantization quantize_ = detail::quantization::none; //! ZQUANTIZ of quantized images
+    std::size_t zdither0_ = 1; //! seed of dithering (ZDITHER0)
+
+public:
+    compressed_image_extension() {}
+
+    //!reads the header and data unit from current position of file
+    compressed_image_extension(std::istream &file) : binary_table_extension(file)
+    {
+        read_image_keywords();
+    }
+
+    //!reads the data unit from current position of file
+    compressed_image_extension(std::istream &file, hdu const& other) :
+        binary_table_extension(file, other)
+    {
+        read_image_keywords();
+    }
+
+    //!creates the compressed image from header only, tiles can be read from file by decompress
+    compressed_image_extension(hdu const& other) : binary_table_extension(other)
+    {
+        read_image_keywords();
+    }
+
+    //!returns true if the header describes a tile compressed image
+    static bool is_compressed_image(hdu const& header)
+    {
+        return header.contains("ZIMAGE") && header.value_of<bool>("ZIMAGE");
+    }
+
+    //!returns BITPIX of the image
+    io::bitpix zbitpix() const
+    {
+        return zbitpix_;
+    }
+
+    //!returns the pixels of the image along every axis
+    std::vector<std::size_t> const& znaxis() const
+    {
+        return znaxis_;
+    }
+
+    //!returns the pixels of tiles along every axis
+    std::vector<std::size_t> const& ztile() const
+    {
+        return ztile_;
+    }
+
+    //!returns the name of compression algorithm (e.g. RICE_1)
+    std::string const& compression() const
+    {
+        return zcmptype_;
+    }
+
+    //!returns the number of tiles of the image
+    std::size_t tiles() const
+    {
+        return detail::tile_count(znaxis_, ztile_);
+    }
+
+    //!decompresses the pixels selected by ranges (one for each axis, missing ranges select the
+    //!whole axis) from the data unit read using up to threads threads (0 for all the cores)
+    //!width of image is the size of range along ZNAXIS1 and height is the product of the sizes
+    //!along remaining axes, DataType must be the ZBITPIX of image
+    template <io::bitpix DataType>
+    image<DataType> decompress
+    (
+        std::vector<axis_range> const& ranges = std::vector<axis_range>(),
+        std::size_t threads = 0
+    ) const
+    {
+        std::size_t const heap = heap_offset();
+        if (data.size() < rows() * row_size() || heap > data.size())
+        {
+            throw fits_exception();
+        }
+
+        detail::memory_heap source;
+        source.heap = data.data() + heap;
+        source.size = data.size() - heap;
+        return decompress_tiles<DataType>(data.data(), source, ranges, threads);
+    }
+
+    //!decompresses the pixels selected by ranges from the data unit at data_offset of file
+    //!only the table of tile descriptors and the tiles overlapping the ranges are read
+    template <io::bitpix DataType>
+    image<DataType> decompress
+    (
+        byte_source const& file,
+        std::streamoff data_offset,
+        std::vector<axis_range> const& ranges = std::vector<axis_range>(),
+        std::size_t threads = 0
+    ) const
+    {
+        std::size_t const heap = heap_offset();
+        if (heap > data_size())
+        {
+            throw fits_exception();
+        }
+
+        std::vector<char> table(rows() * row_size());
+        file.read_at(table.data(), table.size(), static_cast<std::uint64_t>(data_offset));
+
+        detail::file_heap source;
+        source.file = &file;
+        source.start = static_cast<std::uint64_t>(data_offset) + heap;
+        source.size = data_size() - heap;
+        return decompress_tiles<DataType>(table.data(), source, ranges, threads);
+    }
+
+protected:
+    //! columns of the table of tiles, nullptr for columns not present
+    struct tile_columns
+    {
+        column const* compressed = nullptr;
+        column const* gzip_compressed = nullptr;
+        column const* uncompressed = nullptr;
+        column const* zscale = nullptr;
+        column const* zzero = nullptr;
+        column const* zblank = nullptr;
+    };
+
+    //!reads the keywords describing the image and its compression
+    void read_image_keywords()
+    {
+        if (!is_compressed_image(*this))
+        {
+            throw wrong_extension_type();
+        }
+
+        switch (this->value_of<int>("ZBITPIX"))
+        {
+        case 8:
+            zbitpix_ = io::bitpix::B8;
+            break;
+        case 16:
+            zbitpix_ = io::bitpix::B16;
+            break;
+        case 32:
+            zbitpix_ = io::bitpix::B32;
+            break;
+        case -32:
+            zbitpix_ = io::bitpix::_B32;
+            break;
+        case -64:
+            zbitpix_ = io::bitpix::_B64;
+            break;
+        default:
+            throw fits_exception();
+        }
+
+        std::size_t const axes = this->value_of<std::size_t>("ZNAXIS");
+        znaxis_.clear();
+        ztile_.clear();
+        for (std::size_t i = 1; i <= axes; i++)
+        {
+            znaxis_.push_back(this->value_of<std::size_t>("ZNAXIS", i));
+            //tiles are rows of image by default
+            ztile_.push_back(this->contains("ZTILE" + std::to_string(i)) ?
+                this->value_of<std::size_t>("ZTILE", i) : (i == 1 ? znaxis_.back() : 1));
+            if (znaxis_.back() == 0 || ztile_.back() == 0)
+            {
+                throw fits_exception();
+            }
+        }
+
+        zcmptype_ = detail::unquote(this->value_of<std::string>("ZCMPTYPE"));
+        if (zcmptype_ != "RICE_1" && zcmptype_ != "GZIP_1" && zcmptype_ != "GZIP_2" &&
+            zcmptype_ != "NOCOMPRESS")
+        {
+            throw unsupported_compression_exception();
+        }
+
+        //parameters of algorithm are ZNAMEi = 'BLOCKSIZE' ZVALi = 32...
+        bytepix_ = zbitpix_ == io::bitpix::B8 ? 1 : (zbitpix_ == io::bitpix::B16 ? 2 : 4);
+        for (std::size_t i = 1; this->contains("ZNAME" + std::to_string(i)); i++)
+        {
+            std::string const name = detail::unquote(this->value_of<std::string>("ZNAME", i));
+            if (name == "BLOCKSIZE")
+            {
+                block_size_ = this->value_of<std::size_t>("ZVAL", i);
+            }
+            else if (name == "BYTEPIX")
+            {
+                bytepix_ = this->value_of<std::size_t>("ZVAL", i);
+            }
+        }
+
+        bool const scaled = this->contains("ZSCALE") || find_column("ZSCALE") != nullptr;
+        quantize_ = detail::quantization::none;
+        if (scaled && (zbitpix_ == io::bitpix::_B32 || zbitpix_ == io::bitpix::_B64))
+        {
+            std::string const method = this->contains("ZQUANTIZ") ?
+                detail::unquote(this->value_of<std::string>("ZQUANTIZ")) : "NO_DITHER";
+            if (method == "SUBTRACTIVE_DITHER_1")
+            {
+                quantize_ = detail::quantization::subtractive_dither_1;
+            }
+            else if (method == "SUBTRACTIVE_DITHER_2")
+            {
+                quantize_ = detail::quantization::subtractive_dither_2;
+            }
+            else
+            {
+                quantize_ = detail::quantization::no_dither;
+            }
+        }
+        if (this->contains("ZDITHER0"))
+        {
+            zdither0_ = this->value_of<std::size_t>("ZDITHER0");
+        }
+    }
+
+    //!returns the column with TTYPE name or nullptr if table has no such column
+    column const* find_column(std::string const& name) const
+    {
+        for (column const& col : this->col_metadata)
+        {
+            if (col.TTYPE() == name)
+            {
+                return &col;
+            }
+        }
+        return nullptr;
+    }
+
+    //!returns the columns of the table of tiles, throws if COMPRESSED_DATA is missing
+    tile_columns get_tile_columns() const
+    {
+        tile_columns columns;
+        columns.compressed = find_column("COMPRESSED_DATA");
+        columns.gzip_compressed = find_column("GZIP_COMPRESSED_DATA");
+        columns.uncompressed = find_column("UNCOMPRESSED_DATA");
+        columns.zscale = find_column("ZSCALE");
+        columns.zzero = find_column("ZZERO");
+        columns.zblank = find_column("ZBLANK");
+        for (column const* col : {columns.compressed, columns.gzip_compressed,
+            columns.uncompressed})
+        {
+            if (col && ((col->type() != 'P' && col->type() != 'Q') || col->repeat() != 1))
+            {
+                throw invalid_table_colum_format();
+            }
+        }
+        if (!columns.compressed || rows() < tiles())
+        {
+            throw invalid_table_colum_format();
+        }
+        return columns;
+    }
+
+    //!decompresses the tiles overlapping ranges into the image, table holds the rows of the
+    //!table of tiles and Heap reads the compressed bytes of tiles from the heap
+    template <io::bitpix DataType, typename Heap>
+    image<DataType> decompress_tiles
+    (
+        char const* table,
+        Heap const& heap,
+        std::vector<axis_range> const& ranges,
+        std::size_t threads
+    ) const
+    {
+        using pixel_type = typename image<DataType>::pixel_type;
+
+        if (DataType != zbitpix_)
+        {
+            throw wrong_extension_type();
+        }
+        if (znaxis_.empty())
+        {
+            return image<DataType>();
+        }
+
+        std::vector<axis_range> const selected = detail::cutout_ranges(ranges, znaxis_);
+        tile_columns const columns = get_tile_columns();
+
+        std::size_t height = 1;
+        bool whole = true; //every pixel of image is selected
+        for (std::size_t i = 0; i < selected.size(); i++)
+        {
+            if (i > 0)
+            {
+                height *= selected[i].size();
+            }
+            whole = whole && selected[i].first == 0 && selected[i].last == znaxis_[i] &&
+                selected[i].stride == 1;
+        }
+        image<DataType> result(selected[0].size(), height);
+        pixel_type* const pixels = result.pixels();
+
+        //tiles overlapping the ranges
+        std::vector<std::size_t> overlapping;
+        std::vector<std::size_t> first(znaxis_.size());
+        std::vector<std::size_t> size(znaxis_.size());
+        for (std::size_t tile = 0; tile < tiles(); tile++)
+        {
+            detail::tile_geometry(tile, znaxis_, ztile_, first, size);
+            bool overlaps = true;
+            for (std::size_t i = 0; i < selected.size() && overlaps; i++)
+            {
+                std::size_t const pixel = detail::first_selected(selected[i], first[i]);
+                overlaps = pixel < first[i] + size[i] && pixel < selected[i].last;
+            }
+            if (overlaps)
+            {
+                overlapping.push_back(tile);
+            }
+        }
+
+        detail::parallel_for(overlapping.size(), threads, [&](std::size_t n)
+        {
+            std::size_t const tile = overlapping[n];
+            std::vector<std::size_t> tile_first(znaxis_.size());
+            std::vector<std::size_t> tile_size(znaxis_.size());
+            detail::tile_geometry(tile, znaxis_, ztile_, tile_first, tile_size);
+
+            std::size_t count = 1;
+            for (std::size_t s : tile_size)
+            {
+                count *= s;
+            }
+
+            if (whole && is_contiguous(tile_size))
+            {
+                //pixels of tile follow each other in image, decode them in place
+                std::size_t offset = 0;
+                std::size_t pitch = 1;
+                for (std::size_t i = 0; i < znaxis_.size(); i++)
+                {
+                    offset += tile_first[i] * pitch;
+                    pitch *= znaxis_[i];
+                }
+                decode_tile(columns, table, heap, tile, pixels + offset, count);
+                return;
+            }
+
+            std::vector<pixel_type> values(count);
+            decode_tile(columns, table, heap, tile, values.data(), count);
+            copy_tile(values.data(), tile_first, tile_size, selected, pixels,
+                result.get_width());
+        });
+        return result;
+    }
+
+    //!returns true if the pixels of tile are adjacent in image, i.e. the tile covers whole
+    //!axes below the highest axis along which it has more than one pixel
+    bool is_contiguous(std::vector<std::size_t> const& size) const
+    {
+        bool partial = false; //some lower axis is not covered whole
+        for (std::size_t i = 0; i < znaxis_.size(); i++)
+        {
+            if (partial && size[i] > 1)
+            {
+                return false;
+            }
+            partial = partial || size[i] != znaxis_[i];
+        }
+        return true;
+    }
+
+    //!copies the pixels of decoded tile selected by ranges into image of given width
+    template <typename PixelType>
+    static void copy_tile
+    (
+        PixelType const* values,
+        std::vector<std::size_t> const& first,
+        std::vector<std::size_t> const& size,
+        std::vector<axis_range> const& selected,
+        PixelType* pixels,
+        std::size_t width
+    )
+    {
+        std::size_t const axes = first.size();
+        std::size_t tile_rows = 1;
+        for (std::size_t i = 1; i < axes; i++)
+        {
+            tile_rows *= size[i];
+        }
+
+        axis_range const& x = selected[0];
+        std::size_t const x_first = detail::first_selected(x, first[0]);
+        std::size_t const x_last = (std::min)(first[0] + size[0], x.last);
+
+        std::vector<std::size_t> position(axes, 0); //pixel of row in tile along every axis
+        for (std::size_t row = 0; row < tile_rows; row++)
+        {
+            //row of image containing the row of tile, if it is selected
+            bool row_selected = true;
+            std::size_t image_row = 0;
+            std::size_t pitch = 1;
+            for (std::size_t i = 1; i < axes && row_selected; i++)
+            {
+                std::size_t const pixel = first[i] + position[i];
+                row_selected = pixel >= selected[i].first && pixel < selected[i].last &&
+                    (pixel - selected[i].first) % selected[i].stride == 0;
+                image_row += (pixel - selected[i].first) / selected[i].stride * pitch;
+                pitch *= selected[i].size();
+            }
+
+            if (row_selected)
+            {
+                PixelType const* source = values + row * size[0];
+                PixelType* destination = pixels + image_row * width;
+                for (std::size_t p = x_first; p < x_last; p += x.stride)
+                {
+                    destination[(p - x.first) / x.stride] = source[p - first[0]];
+                }
+            }
+
+            for (std::size_t i = 1; i < axes; i++)
+            {
+                if (++position[i] < size[i])
+                {
+                    break;
+                }
+                position[i] = 0;
+            }
+        }
+    }
+
+    //!decodes count pixels of tile into destination
+    template <typename PixelType, typename Heap>
+    void decode_tile
+    (
+        tile_columns const& columns,
+        char const* table,
+        Heap const& heap,
+        std::size_t tile,
+        PixelType* destination,
+        std::size_t count
+    ) const
+    {
+        std::vector<unsigned char> buffer;
+
+        std::size_t length = 0;
+        std::size_t offset = 0;
+        descriptor(*columns.compressed, table, tile, length, offset);
+        if (length != 0)
+        {
+            unsigned char const* bytes = heap.read(offset, length, buffer);
+            if (quantize_ == detail::quantization::none)
+            {
+                decode_stream(bytes, length, destination, count);
+                return;
+            }
+
+            std::vector<std::int32_t> values(count);
+            decode_stream(bytes, length, values.data(), count);
+
+            double const scale = columns.zscale ?
+                detail::field_value(*columns.zscale, table, row_size(), tile) :
+                this->value_of<double>("ZSCALE");
+            double zero = 0;
+            if (columns.zzero || this->contains("ZZERO"))
+            {
+                zero = columns.zzero ?
+                    detail::field_value(*columns.zzero, table, row_size(), tile) :
+                    this->value_of<double>("ZZERO");
+            }
+            bool const has_blank = columns.zblank || this->contains("ZBLANK");
+            std::int32_t blank = 0;
+            if (has_blank)
+            {
+                blank = columns.zblank ? static_cast<std::int32_t>(
+                    detail::field_value(*columns.zblank, table, row_size(), tile)) :
+                    this->value_of<std::int32_t>("ZBLANK");
+            }
+            dequantize_values(values.data(), count, destination, scale, zero, tile, has_blank,
+                blank);
+            return;
+        }
+
+        //tiles which could not be compressed (or quantized) are stored losslessly
+        if (columns.gzip_compressed)
+        {
+            descriptor(*columns.gzip_compressed, table, tile, length, offset);
+            if (length != 0)
+            {
+                unsigned char const* bytes = heap.read(offset, length, buffer);
+                detail::gzip_decompress(bytes, length,
+                    reinterpret_cast<unsigned char*>(destination), count * sizeof(PixelType));
+                detail::big_to_native_inplace(destination, count);
+                return;
+            }
+        }
+        if (columns.uncompressed)
+        {
+            descriptor(*columns.uncompressed, table, tile, length, offset);
+            if (length == count)
+            {
+                detail::visit_binary_type(columns.uncompressed->array_type(), [&](auto tag)
+                {
+                    using stored_type = typename decltype(tag)::type;
+                    copy_uncompressed<stored_type>(heap, offset, destination, count, buffer);
+                });
+                return;
+            }
+        }
+        throw invalid_compressed_tile_exception();
+    }
+
+    //!decodes the stream of compressed integers (or lossless floating point values) of tile
+    template <typename T>
+    void decode_stream
+    (
+        unsigned char const* bytes,
+        std::size_t length,
+        T* destination,
+        std::size_t count
+    ) const
+    {
+        if (zcmptype_ == "RICE_1")
+        {
+            switch (bytepix_)
+            {
+            case 1:
+                detail::rice_decompress<std::uint8_t>(bytes, length, destination, count,
+                    block_size_);
+                return;
+            case 2:
+                detail::rice_decompress<std::int16_t>(bytes, length, destination, count,
+                    block_size_);
+                return;
+            case 4:
+                detail::rice_decompress<std::int32_t>(bytes, length, destination, count,
+                    block_size_);
+                return;
+            }
+            throw unsupported_compression_exception();
+        }
+
+        unsigned char* const raw = reinterpret_cast<unsigned char*>(destination);
+        std::size_t const raw_size = count * sizeof(T);
+        if (zcmptype_ == "NOCOMPRESS")
+        {
+            if (length != raw_size)
+            {
+                throw invalid_compressed_tile_exception();
+            }
+            detail::big_to_native_copy(bytes, destination, count);
+            return;
+        }
+        if (zcmptype_ == "GZIP_2")
+        {
+            std::vector<unsigned char> shuffled(raw_size);
+            detail::gzip_decompress(bytes, length, shuffled.data(), raw_size);
+            detail::unshuffle_bytes(shuffled.data(), raw, count, sizeof(T));
+        }
+        else
+        {
+            detail::gzip_decompress(bytes, length, raw, raw_size);
+        }
+        detail::big_to_native_inplace(destination, count);
+    }
+
+    template <typename PixelType>
+    typename std::enable_if<std::is_floating_point<PixelType>::value>::type dequantize_values
+    (
+        std::int32_t const* values,
+        std::size_t count,
+        PixelType* destination,
+        double scale,
+        double zero,
+        std::size_t tile,
+        bool has_blank,
+        std::int32_t blank
+    ) const
+    {
+        detail::dequantize(values, count, destination, quantize_, scale, zero, tile, zdither0_,
+            has_blank, blank);
+    }
+
+    //!integer images are never quantized
+    template <typename PixelType>
+    typename std::enable_if<!std::is_floating_point<PixelType>::value>::type dequantize_values
+    (
+        std::int32_t const*, std::size_t, PixelType*, double, double, std::size_t, bool,
+        std::int32_t
+    ) const
+    {
+        throw fits_exception();
+    }
+
+    //!converts the uncompressed values of tile stored as Stored to pixels
+    template <typename Stored, typename PixelType, typename Heap>
+    static typename std::enable_if<std::is_arithmetic<Stored>::value>::type copy_uncompressed
+    (
+        Heap const& heap,
+        std::size_t offset,
+        PixelType* destination,
+        std::size_t count,
+        std::vector<unsigned char>& buffer
+    )
+    {
+        unsigned char const* bytes = heap.read(offset, count * sizeof(Stored), buffer);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            destination[i] = static_cast<PixelType>(
+                detail::load_big_endian<Stored>(bytes + i * sizeof(Stored)));
+        }
+    }
+
+    template <typename Stored, typename PixelType, typename Heap>
+    static typename std::enable_if<!std::is_arithmetic<Stored>::value>::type copy_uncompressed
+    (
+        Heap const&, std::size_t, PixelType*, std::size_t, std::vector<unsigned char>&
+    )
+    {
+        throw invalid_table_colum_format();
+    }
+
+    //!reads the element count and heap offset of the array of col in row
+    void descriptor
+    (
+        column const& col,
+        char const* table,
+        std::size_t row,
+        std::size_t& length,
+        std::size_t& offset
+    ) const
+    {
+        variable_length_column<std::uint8_t> const arrays(col, table, rows(), row_size(),
+            nullptr, 0);
+        length = arrays.length(row);
+        offset = arrays.heap_offset(row);
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_COMPRESSED_IMAGE_EXTENSION_HPP
@@ -20,25 +20,44 @@ protected:
 public:
     extension_hdu() {}
 
-    extension_hdu(std::fstream &file) : hdu(file) 
+    extension_hdu(std::istream &file) : hdu(file) 
     {
         gcount = this->value_of<int>("GCOUNT");
         pcount = this->value_of<int>("PCOUNT");
-        extname = this->value_of<std::string>("EXTNAME");
+        if (this->contains("EXTNAME"))
+        {
+            extname = this->value_of<std::string>("EXTNAME");
+        }
     }
 
-    extension_hdu(std::fstream &file, hdu const& other) : hdu(other)
+    extension_hdu(std::istream &file, hdu const& other) : hdu(other)
     {
         gcount = this->value_of<int>("GCOUNT");
         pcount = this->value_of<int>("PCOUNT");
-        extname = this->value_of<std::string>("EXTNAME");
+        if (this->contains("EXTNAME"))
+        {
+            extname = this->value_of<std::string>("EXTNAME");
+        }
     }
 
-    extension_hdu(std::fstream &file, std::streampos pos) : hdu(file, pos)
+    extension_hdu(hdu const& other) : hdu(other)
     {
         gcount = this->value_of<int>("GCOUNT");
         pcount = this->value_of<int>("PCOUNT");
-        extname = this->value_of<std::string>("EXTNAME");
+        if (this->contains("EXTNAME"))
+        {
+            extname = this->value_of<std::string>("EXTNAME");
+        }
+    }
+
+    extension_hdu(std::istream &file, std::streampos pos) : hdu(file, pos)
+    {
+        gcount = this->value_of<int>("GCOUNT");
+        pcount = this->value_of<int>("PCOUNT");
+        if (this->contains("EXTNAME"))
+        {
+            extname = this->value_of<std::string>("EXTNAME");
+        }
     }
 };
 
@@ -5,113 +5,471 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <cstddef>
+#include <utility>
+#include <numeric>
+#include <functional>
 
+#include <boost/astronomy/detail/parallel.hpp>
+#include <boost/astronomy/io/byte_source.hpp>
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/hdu_index.hpp>
+#include <boost/astronomy/io/index_sidecar.hpp>
 #include <boost/astronomy/io/primary_hdu.hpp>
 #include <boost/astronomy/io/extension_hdu.hpp>
 #include <boost/astronomy/io/image_extension.hpp>
+#include <boost/astronomy/io/image.hpp>
+#include <boost/astronomy/io/table_extension.hpp>
+#include <boost/astronomy/io/binary_table_extension.hpp>
+#include <boost/astronomy/io/ascii_table_extension.hpp>
+#include <boost/astronomy/io/compressed_image_extension.hpp>
+#include <boost/astronomy/io/gzip_istream.hpp>
 #include <boost/astronomy/exception/fits_exception.hpp>
 
 namespace boost { namespace astronomy { namespace io {
 
-struct fits 
+struct fits
 {
 protected:
     std::fstream fits_file; //!FITS to be processed
-    std::vector<std::shared_ptr<hdu>> hdu_; //!Stores all th HDU in file
+    std::vector<hdu_entry> index_; //!Location of every HDU in file found by scanning the headers
+    std::vector<std::shared_ptr<hdu>> hdu_; //!Stores the HDU loaded so far (nullptr if not loaded)
+    std::string fits_path; //!path of FITS
+    std::shared_ptr<byte_source const> positioned_fits; //!FITS read with positioned reads
+    std::unique_ptr<gzip_istream> gzip_fits; //!decompresses FITS while reading when gzipped
+    std::unique_ptr<source_istream> source_fits; //!reads FITS given as byte_source in order
 
 public:
     fits() {}
 
+    //!Scans the headers of all the HDU and reads the primary HDU,
+    //!extensions are read only when requested
+    //!gzip compressed files (.fits.gz) are decompressed while they are read without a
+    //!temporary file, reading their HDU in order decompresses the file only once but
+    //!positioned reads (read_cutout, read_table_columns, scan_table and
+    //!read_compressed_image) are not supported for them
     fits
     (
         std::string file_path,
         std::ios_base::openmode mode = std::ios_base::in | std::ios_base::binary
-    )
+    ) : fits_path(file_path)
     {
-        fits_file.open(file_path, std::ios_base::in | std::ios_base::binary | mode);
+        open(file_path, mode);
+        read_index();
+        read_primary_hdu();
+    }
+
+    //!Reads the FITS from source, e.g. memory_source for FITS received in memory or
+    //!mapped_source to read a file through a memory mapping instead of positioned reads
+    //!headers are scanned with sequential reads of source and the data units read with
+    //!positioned reads are decoded in place if source is held in memory
+    explicit fits(std::shared_ptr<byte_source const> source) :
+        positioned_fits(std::move(source))
+    {
+        source_fits.reset(new source_istream(*positioned_fits));
+        read_index();
         read_primary_hdu();
-        //read_extensions();
     }
 
+    //!Reads the index from the sidecar instead of scanning the headers when the sidecar is
+    //!up to date, otherwise the headers are scanned and the sidecar is (re)written
+    //!see boost::astronomy::io::default_sidecar_path for the usual location of sidecar
+    fits
+    (
+        std::string file_path,
+        std::string const& sidecar_path,
+        std::ios_base::openmode mode = std::ios_base::in | std::ios_base::binary
+    ) : fits_path(file_path)
+    {
+        open(file_path, mode);
+        if (!read_index_sidecar(sidecar_path, file_path, index_))
+        {
+            //the sidecar is only written if the file did not change during the scan
+            detail::file_signature scanned;
+            bool const known = detail::get_file_signature(file_path, scanned);
+            read_index();
+            if (known)
+            {
+                write_index_sidecar(sidecar_path, file_path, index_, scanned);
+            }
+        }
+        hdu_.assign(index_.size(), nullptr);
+        read_primary_hdu();
+    }
+
+    //!Scans the headers of all the HDU in file without reading any data unit
+    void read_index()
+    {
+        index_ = scan_hdu_index(input());
+        hdu_.assign(index_.size(), nullptr);
+    }
+
+    //!throws fits_exception if file has no HDU (e.g. it is empty)
     void read_primary_hdu()
     {
-        hdu_.emplace_back(std::make_shared<hdu>(fits_file));
-                    
-        switch (hdu_[0]->value_of<int>(std::string("BITPIX")))
-        {
-        case 8:
-            hdu_[0] = std::make_shared<primary_hdu<bitpix::B8>>(fits_file, *hdu_[0]);
-            break;
-        case 16:
-            hdu_[0] = std::make_shared<primary_hdu<bitpix::B16>>(fits_file, *hdu_[0]);
-            break;
-        case 32:
-            hdu_[0] = std::make_shared<primary_hdu<bitpix::B32>>(fits_file, *hdu_[0]);
-            break;
-        case -32:
-            hdu_[0] = std::make_shared<primary_hdu<bitpix::_B32>>(fits_file, *hdu_[0]);
-            break;
-        case -64:
-            hdu_[0] = std::make_shared<primary_hdu<bitpix::_B64>>(fits_file, *hdu_[0]);
-            break;
-        default:
+        if (index_.empty())
+        {
             throw fits_exception();
         }
+        get_hdu(0);
     }
 
+    //!Reads all the extensions which are not read yet
     void read_extensions()
     {
-        //if no extension then return
-        if (!hdu_[0]->value_of<bool>("EXTEND"))
+        for (std::size_t i = 1; i < index_.size(); i++)
+        {
+            get_hdu(i);
+        }
+    }
+
+    //!decodes the columns with given TTYPE (all the columns if names is empty) of the binary
+    //!or ASCII table at index reading its rows in blocks, the whole table is never held in
+    //!memory, each column is column_data of the type stored in file
+    std::vector<std::unique_ptr<column>> read_table_columns
+    (
+        std::size_t index,
+        std::vector<std::string> const& names = std::vector<std::string>()
+    )
+    {
+        hdu_entry const& entry = index_.at(index);
+        if (entry.xtension == "BINTABLE")
+        {
+            binary_table_extension table(*read_header(entry));
+            return table.read_columns(positioned(), entry.data_offset, names);
+        }
+        if (entry.xtension == "TABLE")
+        {
+            ascii_table_extension table(*read_header(entry));
+            return table.read_columns(positioned(), entry.data_offset, names);
+        }
+        throw wrong_extension_type();
+    }
+
+    //!decodes the columns with given TTYPE (all the columns if names is empty) of the rows of
+    //!binary table at index which satisfy all the predicates, rows are read in blocks and the
+    //!requested columns are decoded only for the selected rows
+    std::vector<std::unique_ptr<column>> scan_table
+    (
+        std::size_t index,
+        std::vector<column_predicate> const& predicates,
+        std::vector<std::string> const& names = std::vector<std::string>()
+    )
+    {
+        hdu_entry const& entry = index_.at(index);
+        if (entry.xtension != "BINTABLE")
         {
+            throw wrong_extension_type();
+        }
+
+        binary_table_extension table(*read_header(entry));
+        return table.scan(positioned(), entry.data_offset, predicates, names);
+    }
+
+    //!Reads all the extensions which are not read yet, image extensions are read and decoded
+    //!concurrently by threads workers (0 uses all the cores) with positioned reads
+    //!other extensions are read one after another by the calling thread
+    void read_extensions_parallel(std::size_t threads = 0)
+    {
+        if (gzip_fits)
+        {
+            //HDU of gzip compressed file can only be decompressed one after another
+            read_extensions();
             return;
         }
 
-        while (!fits_file.eof())
+        std::vector<std::size_t> images;
+        for (std::size_t i = 1; i < index_.size(); i++)
         {
-            //this statement allows up to read all the cards stored
-            //It gives us the benefit of knowing which kind of data we need to store
-            hdu_.emplace_back(std::make_shared<hdu>(fits_file));
+            if (hdu_[i])
+            {
+                continue;
+            }
+            if (index_[i].xtension == "IMAGE")
+            {
+                images.push_back(i);
+            }
+            else
+            {
+                get_hdu(i);
+            }
+        }
 
-            if (hdu_.back()->value_of<std::string>("XTENSION") == "'IMAGE   '")
+        byte_source const& file = positioned();
+        detail::parallel_for(images.size(), threads, [&](std::size_t i)
+        {
+            hdu_entry const& entry = index_[images[i]];
+            std::shared_ptr<hdu> header = entry_header(entry);
+            if (!header)
             {
-                switch (hdu_.back()->value_of<int>(std::string("BITPIX")))
-                {
-                case 8:
-                    hdu_.back() =
-                        std::make_shared<image_extension<bitpix::B8>>(fits_file, *hdu_.back());
-                    break;
-                case 16:
-                    hdu_.back() =
-                        std::make_shared<image_extension<bitpix::B16>>(fits_file, *hdu_.back());
-                    break;
-                case 32:
-                    hdu_.back() =
-                        std::make_shared<image_extension<bitpix::B32>>(fits_file, *hdu_.back());
-                    break;
-                case -32:
-                    hdu_.back() =
-                        std::make_shared<image_extension<bitpix::_B32>>(fits_file, *hdu_.back());
-                    break;
-                case -64:
-                    hdu_.back() =
-                        std::make_shared<image_extension<bitpix::_B64>>(fits_file, *hdu_.back());
-                    break;
-                default:
-                    throw fits_exception();
-                    break;
-                }
+                throw fits_exception();
             }
-            else if (hdu_.back()->value_of<std::string>("XTENSION") == "'TABLE   '")
+            hdu_[images[i]] = make_image_hdu<image_extension>(entry.bitpix_value, file,
+                entry.data_offset, *header);
+        });
+    }
+
+    //!returns the number of HDU in file
+    std::size_t size() const
+    {
+        return index_.size();
+    }
+
+    //!returns the location and basic properties of all the HDU in file
+    std::vector<hdu_entry> const& index() const
+    {
+        return index_;
+    }
+
+    //!returns true if the HDU at index is already read
+    bool is_loaded(std::size_t index) const
+    {
+        return hdu_.at(index) != nullptr;
+    }
+
+    //!returns the position of HDU with given EXTNAME
+    std::size_t find(std::string const& extname) const
+    {
+        for (std::size_t i = 0; i < index_.size(); i++)
+        {
+            if (index_[i].extname == extname)
             {
+                return i;
+            }
+        }
+        throw key_not_defined_exception();
+    }
+
+    //!returns the HDU at index, reading it from file if not read yet
+    std::shared_ptr<hdu> get_hdu(std::size_t index)
+    {
+        if (!hdu_.at(index))
+        {
+            hdu_[index] = read_hdu(index_[index]);
+        }
+        return hdu_[index];
+    }
+
+    //!returns the HDU with given EXTNAME, reading it from file if not read yet
+    std::shared_ptr<hdu> get_hdu(std::string const& extname)
+    {
+        return get_hdu(find(extname));
+    }
 
+    //!reads only the pixels selected by ranges (one for each naxis, missing ranges select
+    //!the whole axis) from the image HDU at index, the HDU itself is not read
+    template <bitpix DataType>
+    image<DataType> read_cutout(std::size_t index, std::vector<axis_range> const& ranges)
+    {
+        hdu_entry const& entry = index_.at(index);
+        if (entry.bitpix_value != DataType || !(entry.is_primary() || entry.xtension == "IMAGE"))
+        {
+            throw wrong_extension_type();
+        }
+
+        image<DataType> cutout;
+        cutout.read_cutout(positioned(), entry.data_offset, entry.naxis, ranges);
+        return cutout;
+    }
+
+    //!decompresses the pixels selected by ranges (missing ranges select the whole axis) from
+    //!the tile compressed image at index using up to threads threads (0 for all the cores),
+    //!only the tiles overlapping ranges are read and the HDU itself is not read
+    template <bitpix DataType>
+    image<DataType> read_compressed_image
+    (
+        std::size_t index,
+        std::vector<axis_range> const& ranges = std::vector<axis_range>(),
+        std::size_t threads = 0
+    )
+    {
+        hdu_entry const& entry = index_.at(index);
+        if (entry.xtension != "BINTABLE")
+        {
+            throw wrong_extension_type();
+        }
+        std::shared_ptr<hdu> header = read_header(entry);
+        if (!compressed_image_extension::is_compressed_image(*header))
+        {
+            throw wrong_extension_type();
+        }
+
+        compressed_image_extension const compressed(*header);
+        return compressed.decompress<DataType>(positioned(), entry.data_offset, ranges, threads);
+    }
+
+    //!reads the image HDU at index of any BITPIX as physical values BZERO + BSCALE * stored
+    //!value (stored values equal to BLANK are NaN), pixels are converted and scaled in the
+    //!same pass which converts them from big-endian, the HDU itself is not read
+    //!images with NAXIS > 2 are flattened as NAXIS1 x (NAXIS2 * NAXIS3 * ...)
+    template <bitpix DataType = bitpix::_B32>
+    image<DataType> read_physical_image(std::size_t index)
+    {
+        hdu_entry const& entry = index_.at(index);
+        if (!(entry.is_primary() || entry.xtension == "IMAGE"))
+        {
+            throw wrong_extension_type();
+        }
+        pixel_scaling const scaling = read_header(entry)->scaling();
+
+        std::size_t width = 0;
+        std::size_t height = 0;
+        if (entry.naxis.size() > 1)
+        {
+            width = entry.naxis[1];
+            height = std::accumulate(entry.naxis.begin() + 2, entry.naxis.end(),
+                std::size_t(1), std::multiplies<std::size_t>());
+        }
+
+        image<DataType> result;
+        if (gzip_fits)
+        {
+            std::istream& file = input();
+            file.clear();
+            file.seekg(entry.data_offset);
+            result.read_physical_image(file, width, height, entry.bitpix_value, scaling);
+        }
+        else
+        {
+            result.read_physical_image(positioned(), width, height, entry.data_offset,
+                entry.bitpix_value, scaling);
+        }
+        return result;
+    }
+
+protected:
+    //!opens the FITS, gzip compressed files are decompressed while they are read
+    //!throws fits_exception if the file can not be opened
+    void open(std::string const& file_path, std::ios_base::openmode mode)
+    {
+        if (is_gzip_file(file_path))
+        {
+            gzip_fits.reset(new gzip_istream(file_path));
+            return;
+        }
+        fits_file.open(file_path, std::ios_base::in | std::ios_base::binary | mode);
+        if (!fits_file.is_open())
+        {
+            throw fits_exception();
+        }
+    }
+
+    //!returns the stream from which HDU are read
+    std::istream& input()
+    {
+        if (gzip_fits)
+        {
+            return *gzip_fits;
+        }
+        if (source_fits)
+        {
+            return *source_fits;
+        }
+        return fits_file;
+    }
+
+    //!returns the FITS opened for positioned reads
+    //!throws unsupported_compression_exception for gzip compressed FITS
+    byte_source const& positioned()
+    {
+        if (gzip_fits)
+        {
+            throw unsupported_compression_exception();
+        }
+        if (!positioned_fits)
+        {
+            positioned_fits = std::make_shared<file_source>(fits_path);
+        }
+        return *positioned_fits;
+    }
+
+    //!reads a single HDU, if the header is already recorded in entry
+    //!only the data unit is read from the file
+    std::shared_ptr<hdu> read_hdu(hdu_entry const& entry)
+    {
+        std::istream& file = input();
+        file.clear();
+
+        std::shared_ptr<hdu> header = entry_header(entry);
+        if (header)
+        {
+            file.seekg(entry.data_offset);
+        }
+        else
+        {
+            file.seekg(entry.header_offset);
+            header = std::make_shared<hdu>(file);
+        }
+
+        if (entry.is_primary())
+        {
+            return make_image_hdu<primary_hdu>(entry.bitpix_value, file, *header);
+        }
+        if (entry.xtension == "IMAGE")
+        {
+            return make_image_hdu<image_extension>(entry.bitpix_value, file, *header);
+        }
+        if (entry.xtension == "BINTABLE")
+        {
+            if (compressed_image_extension::is_compressed_image(*header))
+            {
+                return std::make_shared<compressed_image_extension>(file, *header);
             }
-                        
+            return std::make_shared<binary_table_extension>(file, *header);
+        }
+        if (entry.xtension == "TABLE")
+        {
+            return std::make_shared<ascii_table_extension>(file, *header);
+        }
+        return header;
+    }
+
+    //!returns the parsed header of entry, restoring it if needed or nullptr if not parsed yet
+    static std::shared_ptr<hdu> entry_header(hdu_entry const& entry)
+    {
+        if (!entry.header && entry.restore_header)
+        {
+            return entry.restore_header();
+        }
+        return entry.header;
+    }
+
+    //!returns the header of entry, reading it from file if not parsed yet
+    std::shared_ptr<hdu> read_header(hdu_entry const& entry)
+    {
+        std::shared_ptr<hdu> header = entry_header(entry);
+        if (!header)
+        {
+            std::istream& file = input();
+            file.clear();
+            file.seekg(entry.header_offset);
+            header = std::make_shared<hdu>(file);
+        }
+        return header;
+    }
+
+    //!creates the HDU of given template with the type of pixels specified by BITPIX
+    //!arguments are passed to the constructor of HDU
+    template <template <bitpix> class HduType, typename... Args>
+    static std::shared_ptr<hdu> make_image_hdu(bitpix value, Args&&... args)
+    {
+        switch (value)
+        {
+        case bitpix::B8:
+            return std::make_shared<HduType<bitpix::B8>>(std::forward<Args>(args)...);
+        case bitpix::B16:
+            return std::make_shared<HduType<bitpix::B16>>(std::forward<Args>(args)...);
+        case bitpix::B32:
+            return std::make_shared<HduType<bitpix::B32>>(std::forward<Args>(args)...);
+        case bitpix::_B32:
+            return std::make_shared<HduType<bitpix::_B32>>(std::forward<Args>(args)...);
+        case bitpix::_B64:
+            return std::make_shared<HduType<bitpix::_B64>>(std::forward<Args>(args)...);
         }
+        throw fits_exception();
     }
 };
 
 }}} //namespace boost::astronomy::io
 
 #endif // !BOOST_ASTRONOMY_IO_FITS_HPP
-
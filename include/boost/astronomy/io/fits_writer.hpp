@@ -0,0 +1,687 @@
+#ifndef BOOST_ASTRONOMY_IO_FITS_WRITER_HPP
+#define BOOST_ASTRONOMY_IO_FITS_WRITER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <boost/astronomy/detail/byteswap.hpp>
+#include <boost/astronomy/detail/exact_compare.hpp>
+#include <boost/astronomy/detail/output_file.hpp>
+#include <boost/astronomy/detail/parallel.hpp>
+#include <boost/astronomy/detail/quantize.hpp>
+#include <boost/astronomy/detail/rice.hpp>
+#include <boost/astronomy/io/bitpix.hpp>
+#include <boost/astronomy/io/card.hpp>
+#include <boost/astronomy/io/column.hpp>
+#include <boost/astronomy/io/column_data.hpp>
+#include <boost/astronomy/io/image.hpp>
+#include <boost/astronomy/io/table_extension.hpp>
+#include <boost/astronomy/io/binary_table_extension.hpp>
+#include <boost/astronomy/io/compressed_image_extension.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// returns a card with numeric or logical value
+template <typename Value>
+inline io::card make_card(std::string const& key, Value value)
+{
+    io::card result;
+    result.create_card(key, value);
+    return result;
+}
+
+// returns a card with string value enclosed in quotes, padded to atleast 8 chars
+inline io::card make_string_card(std::string const& key, std::string value)
+{
+    value.resize((std::max)(value.size(), std::size_t(8)), ' ');
+    return io::card(key, "'" + value + "'");
+}
+
+// mandatory cards of primary HDU (xtension is empty) or extension with given dimension
+inline std::vector<io::card> mandatory_cards
+(
+    std::string const& xtension,
+    int bitpix,
+    std::vector<std::size_t> const& naxis
+)
+{
+    std::vector<io::card> cards;
+    if (xtension.empty())
+    {
+        cards.push_back(make_card("SIMPLE", true));
+    }
+    else
+    {
+        cards.push_back(make_string_card("XTENSION", xtension));
+    }
+    cards.push_back(make_card("BITPIX", bitpix));
+    cards.push_back(make_card("NAXIS", naxis.size()));
+    for (std::size_t i = 0; i < naxis.size(); i++)
+    {
+        cards.push_back(make_card("NAXIS" + std::to_string(i + 1), naxis[i]));
+    }
+    if (xtension.empty())
+    {
+        cards.push_back(make_card("EXTEND", true));
+    }
+    else
+    {
+        cards.push_back(make_card("PCOUNT", 0));
+        cards.push_back(make_card("GCOUNT", 1));
+    }
+    return cards;
+}
+///@endcond
+
+} //namespace detail
+
+namespace io {
+
+//! parameters of the tile compression of images written by
+//! fits_writer::write_compressed_image
+struct compression_options
+{
+    //! pixels of tiles along every axis, missing (or zero) sizes cover the whole NAXIS1 and
+    //! a single pixel along other axes, so tiles are rows of image by default
+    std::vector<std::size_t> tile;
+
+    //! pixels in a block of Rice code
+    std::size_t block_size = 32;
+
+    //! floating point pixels are quantized with a step of noise / quantize_level, negative
+    //! values give the step itself (-quantize_level), tiles which can not be quantized are
+    //! stored uncompressed
+    double quantize_level = 4;
+
+    //! keeps the pixels equal to zero exactly (SUBTRACTIVE_DITHER_2 instead of 1)
+    bool preserve_zeros = false;
+
+    //! position of the first value of the dither sequence (ZDITHER0, from 1 to 10000)
+    std::size_t dither_seed = 1;
+
+    //! number of threads compressing tiles (0 for all the cores)
+    std::size_t threads = 0;
+};
+
+//! writes a FITS file one HDU after another
+//! headers and data are serialized into a single large page aligned buffer, pixels and
+//! values of columns are converted to big-endian byte order while they are copied into it
+//! and the file is written only when the buffer is full, so that writing a file takes a
+//! few large writes regardless of the number and size of HDU
+struct fits_writer
+{
+public:
+    //! default size of the output buffer
+    static constexpr std::size_t default_buffer_bytes = std::size_t(4) << 20;
+
+protected:
+    //! alignment of the output buffer
+    static constexpr std::size_t buffer_alignment = 4096;
+
+    detail::output_file file; //! file being written
+    std::unique_ptr<char[]> storage; //! memory of output buffer
+    char* buffer = nullptr; //! aligned output buffer
+    std::size_t capacity = 0; //! size of output buffer
+    std::size_t used = 0; //! bytes in output buffer
+    std::uint64_t offset = 0; //! bytes written to file and buffer
+
+public:
+    //!creates (or truncates) the file at path, buffer_bytes is rounded up to a multiple of
+    //!the page size
+    fits_writer(std::string const& path, std::size_t buffer_bytes = default_buffer_bytes) :
+        file(path)
+    {
+        capacity = (std::max)((buffer_bytes + buffer_alignment - 1) / buffer_alignment,
+            std::size_t(1)) * buffer_alignment;
+        storage.reset(new char[capacity + buffer_alignment]);
+        std::size_t const misalignment =
+            reinterpret_cast<std::uintptr_t>(storage.get()) % buffer_alignment;
+        buffer = storage.get() + (misalignment ? buffer_alignment - misalignment : 0);
+    }
+
+    fits_writer(fits_writer const&) = delete;
+    fits_writer& operator=(fits_writer const&) = delete;
+
+    //!completes and closes the file, errors are ignored (call close to handle them)
+    ~fits_writer()
+    {
+        try
+        {
+            close();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    //!returns the number of bytes written so far (including the buffered bytes)
+    std::uint64_t size() const
+    {
+        return this->offset;
+    }
+
+    //!pads the last data unit, writes the buffered bytes and closes the file
+    void close()
+    {
+        if (!file.is_open())
+        {
+            return;
+        }
+        end_data_unit();
+        flush();
+        file.close();
+    }
+
+    //!writes the buffered bytes to file
+    void flush()
+    {
+        if (used != 0)
+        {
+            file.write(buffer, used);
+            used = 0;
+        }
+    }
+
+    //!starts a new HDU with header made of cards, END card is appended if it is missing
+    //!and the header is padded with spaces to a multiple of 2880 bytes
+    //!the data unit of previous HDU is padded with zeros before the header
+    void write_header(std::vector<card> const& cards)
+    {
+        end_data_unit();
+        for (card const& c : cards)
+        {
+            write_bytes(c.data(), 80);
+        }
+        if (cards.empty() || cards.back().key(true) != "END     ")
+        {
+            card end;
+            end.create_commentary_card("END", "");
+            write_bytes(end.data(), 80);
+        }
+        pad(' ');
+    }
+
+    //!appends count values to the data unit of current HDU in big-endian byte order
+    template <typename T>
+    void write_data(T const* values, std::size_t count)
+    {
+        while (count > 0)
+        {
+            if (capacity - used < sizeof(T))
+            {
+                flush();
+            }
+            std::size_t const chunk = (std::min)(count, (capacity - used) / sizeof(T));
+            detail::native_to_big_copy(values, buffer + used, chunk);
+            used += chunk * sizeof(T);
+            offset += chunk * sizeof(T);
+            values += chunk;
+            count -= chunk;
+        }
+    }
+
+    //!appends bytes already in file order (e.g. the data unit of a table read from file)
+    void write_bytes(char const* bytes, std::size_t size)
+    {
+        while (size > 0)
+        {
+            if (used == capacity)
+            {
+                flush();
+            }
+            std::size_t const chunk = (std::min)(size, capacity - used);
+            std::memcpy(buffer + used, bytes, chunk);
+            used += chunk;
+            offset += chunk;
+            bytes += chunk;
+            size -= chunk;
+        }
+    }
+
+    //!pads the data unit of current HDU with zeros to a multiple of 2880 bytes
+    void end_data_unit()
+    {
+        pad('\0');
+    }
+
+    //!writes a primary HDU without data
+    void write_primary_hdu(std::vector<card> const& cards = std::vector<card>())
+    {
+        write_header(header_cards(detail::mandatory_cards("", 8, {}), cards));
+    }
+
+    //!writes a primary HDU with image, naxis gives the dimension of image (by default
+    //!width x height) and cards are added to header after the mandatory cards
+    template <bitpix DataType>
+    void write_primary_hdu
+    (
+        image<DataType> const& data,
+        std::vector<card> const& cards = std::vector<card>(),
+        std::vector<std::size_t> const& naxis = std::vector<std::size_t>()
+    )
+    {
+        write_image("", data, cards, naxis);
+    }
+
+    //!writes an image extension, naxis gives the dimension of image (by default
+    //!width x height) and cards are added to header after the mandatory cards
+    template <bitpix DataType>
+    void write_image_extension
+    (
+        image<DataType> const& data,
+        std::vector<card> const& cards = std::vector<card>(),
+        std::vector<std::size_t> const& naxis = std::vector<std::size_t>()
+    )
+    {
+        write_image("IMAGE", data, cards, naxis);
+    }
+
+    //!writes a table extension (header and data unit) read from file as it is
+    void write_table_extension(table_extension const& table)
+    {
+        if (table.get_data().size() != table.data_size())
+        {
+            throw fits_exception();
+        }
+        write_header(table.get_cards());
+        write_bytes(table.get_data().data(), table.get_data().size());
+    }
+
+    //!writes a binary table extension made of columns, every column must be column_data of
+    //!the type given by its TFORM (see binary_table_extension) and have the same number
+    //!of rows, cards are added to header after the cards describing the columns
+    void write_binary_table
+    (
+        std::vector<std::unique_ptr<column>> const& columns,
+        std::vector<card> const& cards = std::vector<card>()
+    )
+    {
+        std::vector<column> layout;
+        std::size_t row_size = 0;
+        std::size_t rows = 0;
+        for (std::size_t i = 0; i < columns.size(); i++)
+        {
+            column col = *columns[i];
+            detail::parse_binary_tform(col);
+            if (col.type() == 'P' || col.type() == 'Q')
+            {
+                throw invalid_table_colum_format();
+            }
+            col.offset(row_size);
+            row_size += col.width();
+
+            std::size_t const values = stored_values(*columns[i], col);
+            std::size_t const per_row = detail::values_per_row(col);
+            std::size_t const column_rows = per_row == 0 ? rows : values / per_row;
+            if ((i != 0 && column_rows != rows) || (per_row != 0 && values % per_row != 0))
+            {
+                throw invalid_table_colum_format();
+            }
+            rows = column_rows;
+            layout.push_back(col);
+        }
+
+        std::vector<card> header = detail::mandatory_cards("BINTABLE", 8, {row_size, rows});
+        header.push_back(detail::make_card("TFIELDS", layout.size()));
+        for (std::size_t i = 0; i < layout.size(); i++)
+        {
+            column_cards(layout[i], i + 1, header);
+        }
+        write_header(header_cards(header, cards));
+
+        if (row_size == 0)
+        {
+            return;
+        }
+        std::size_t const block_rows = (std::max)(capacity / row_size, std::size_t(1));
+        std::vector<char> block((std::min)(block_rows, rows) * row_size);
+        for (std::size_t first = 0; first < rows; first += block_rows)
+        {
+            std::size_t const count = (std::min)(block_rows, rows - first);
+            for (std::size_t i = 0; i < layout.size(); i++)
+            {
+                detail::visit_binary_type(layout[i].type(), [&](auto tag)
+                {
+                    using stored_type = typename decltype(tag)::type;
+                    detail::encode_binary_rows(
+                        static_cast<column_data<stored_type> const&>(*columns[i]).get_data(),
+                        first, count, row_size, layout[i], block.data());
+                });
+            }
+            write_bytes(block.data(), count * row_size);
+        }
+    }
+
+    //!writes image as a tile compressed image (binary table extension with ZIMAGE = T, see
+    //!compressed_image_extension), integer pixels are compressed losslessly by Rice and
+    //!floating point pixels are quantized with subtractive dithering and then compressed by
+    //!Rice, tiles are compressed in parallel before the HDU is written
+    //!naxis gives the dimension of image (by default width x height) and cards are added to
+    //!header after the cards describing the compression
+    template <bitpix DataType>
+    void write_compressed_image
+    (
+        image<DataType> const& data,
+        std::vector<card> const& cards = std::vector<card>(),
+        std::vector<std::size_t> const& naxis = std::vector<std::size_t>(),
+        compression_options const& options = compression_options()
+    )
+    {
+        using pixel_type = typename image<DataType>::pixel_type;
+        bool const floating = std::is_floating_point<pixel_type>::value;
+
+        std::vector<std::size_t> const axes = image_axes(data, naxis);
+        if (axes.empty() || options.block_size == 0)
+        {
+            throw fits_exception();
+        }
+        std::vector<std::size_t> const shape = tile_shape(axes, options.tile);
+        std::size_t const tiles = detail::tile_count(axes, shape);
+
+        std::vector<compressed_tile> compressed(tiles);
+        detail::parallel_for(tiles, options.threads, [&](std::size_t t)
+        {
+            std::vector<std::size_t> first(axes.size());
+            std::vector<std::size_t> size(axes.size());
+            detail::tile_geometry(t, axes, shape, first, size);
+            std::size_t count = 1;
+            for (std::size_t s : size)
+            {
+                count *= s;
+            }
+
+            std::vector<pixel_type> values(count);
+            detail::gather_tile(data.pixels(), axes, first, size, values.data());
+            compress_tile(values.data(), count, t, options, compressed[t]);
+        });
+
+        //COMPRESSED_DATA, then UNCOMPRESSED_DATA, ZSCALE and ZZERO for floating point images
+        std::size_t heap = 0;
+        std::size_t longest = 0;
+        bool has_null = false;
+        for (compressed_tile const& tile : compressed)
+        {
+            heap += tile.bytes.size();
+            longest = (std::max)(longest, tile.bytes.size());
+            has_null = has_null || tile.has_null;
+        }
+        //descriptors of P columns hold 32 bit lengths and offsets into the heap
+        if (heap > (std::numeric_limits<std::uint32_t>::max)())
+        {
+            throw fits_exception();
+        }
+        std::vector<column> layout(floating ? 4 : 1);
+        layout[0].TTYPE("COMPRESSED_DATA");
+        layout[0].TFORM("1PB(" + std::to_string(longest) + ")");
+        if (floating)
+        {
+            layout[1].TTYPE("UNCOMPRESSED_DATA");
+            layout[1].TFORM(std::string("1P") + (sizeof(pixel_type) == 4 ? "E(" : "D(") +
+                std::to_string(longest / sizeof(pixel_type)) + ")");
+            layout[2].TTYPE("ZSCALE");
+            layout[2].TFORM("1D");
+            layout[3].TTYPE("ZZERO");
+            layout[3].TFORM("1D");
+        }
+        std::size_t const row_size = floating ? 32 : 8;
+
+        std::vector<card> header = detail::mandatory_cards("BINTABLE", 8, {row_size, tiles});
+        header[header.size() - 2] = detail::make_card("PCOUNT", heap); //PCOUNT precedes GCOUNT
+        header.push_back(detail::make_card("TFIELDS", layout.size()));
+        for (std::size_t i = 0; i < layout.size(); i++)
+        {
+            column_cards(layout[i], i + 1, header);
+        }
+        header.push_back(detail::make_card("ZIMAGE", true));
+        header.push_back(detail::make_card("ZBITPIX", bitpix_traits<DataType>::value));
+        header.push_back(detail::make_card("ZNAXIS", axes.size()));
+        for (std::size_t i = 0; i < axes.size(); i++)
+        {
+            header.push_back(detail::make_card("ZNAXIS" + std::to_string(i + 1), axes[i]));
+        }
+        for (std::size_t i = 0; i < axes.size(); i++)
+        {
+            header.push_back(detail::make_card("ZTILE" + std::to_string(i + 1), shape[i]));
+        }
+        header.push_back(detail::make_string_card("ZCMPTYPE", "RICE_1"));
+        header.push_back(detail::make_string_card("ZNAME1", "BLOCKSIZE"));
+        header.push_back(detail::make_card("ZVAL1", options.block_size));
+        header.push_back(detail::make_string_card("ZNAME2", "BYTEPIX"));
+        header.push_back(detail::make_card("ZVAL2", floating ? 4 : sizeof(pixel_type)));
+        if (floating)
+        {
+            header.push_back(detail::make_string_card("ZQUANTIZ", options.preserve_zeros ?
+                "SUBTRACTIVE_DITHER_2" : "SUBTRACTIVE_DITHER_1"));
+            header.push_back(detail::make_card("ZDITHER0", options.dither_seed));
+            if (has_null)
+            {
+                header.push_back(detail::make_card("ZBLANK", detail::dither_null_value));
+            }
+        }
+        write_header(header_cards(header, cards));
+
+        std::vector<char> table(tiles * row_size, 0);
+        std::uint32_t offset_in_heap = 0;
+        for (std::size_t t = 0; t < tiles; t++)
+        {
+            compressed_tile const& tile = compressed[t];
+            char* row = table.data() + t * row_size;
+            std::uint32_t const length = static_cast<std::uint32_t>(tile.bytes.size());
+            //uncompressed tiles hold pixels, their descriptor counts pixels instead of bytes
+            char* descriptor = floating && !tile.quantized ? row + 8 : row;
+            detail::store_big_endian(descriptor, floating && !tile.quantized ?
+                static_cast<std::uint32_t>(length / sizeof(pixel_type)) : length);
+            detail::store_big_endian(descriptor + 4, offset_in_heap);
+            if (floating)
+            {
+                detail::store_big_endian(row + 16, tile.scale);
+                detail::store_big_endian(row + 24, tile.zero);
+            }
+            offset_in_heap += length;
+        }
+        write_bytes(table.data(), table.size());
+        for (compressed_tile const& tile : compressed)
+        {
+            write_bytes(reinterpret_cast<char const*>(tile.bytes.data()), tile.bytes.size());
+        }
+    }
+
+protected:
+    //! tile of image compressed by write_compressed_image
+    struct compressed_tile
+    {
+        std::vector<unsigned char> bytes; //! compressed tile or big-endian pixels
+        bool quantized = false; //! floating point pixels were quantized and compressed
+        double scale = 0; //! ZSCALE of quantized tile
+        double zero = 0; //! ZZERO of quantized tile
+        bool has_null = false; //! some quantized pixel is NaN
+    };
+
+    //!compresses integer pixels of tile losslessly
+    template <typename PixelType>
+    static typename std::enable_if<std::is_integral<PixelType>::value>::type compress_tile
+    (
+        PixelType const* values,
+        std::size_t count,
+        std::size_t,
+        compression_options const& options,
+        compressed_tile& tile
+    )
+    {
+        detail::rice_compress<PixelType>(values, count, options.block_size, tile.bytes);
+    }
+
+    //!quantizes floating point pixels of tile and compresses them, or stores them as they
+    //!are if they can not be quantized
+    template <typename PixelType>
+    static typename std::enable_if<std::is_floating_point<PixelType>::value>::type compress_tile
+    (
+        PixelType const* values,
+        std::size_t count,
+        std::size_t index,
+        compression_options const& options,
+        compressed_tile& tile
+    )
+    {
+        std::vector<std::int32_t> quantized(count);
+        tile.quantized = detail::quantize(values, count, quantized.data(),
+            options.preserve_zeros ? detail::quantization::subtractive_dither_2 :
+            detail::quantization::subtractive_dither_1, options.quantize_level, index,
+            options.dither_seed, tile.scale, tile.zero, tile.has_null);
+        if (tile.quantized)
+        {
+            detail::rice_compress<std::int32_t>(quantized.data(), count, options.block_size,
+                tile.bytes);
+            return;
+        }
+        tile.bytes.resize(count * sizeof(PixelType));
+        detail::native_to_big_copy(values, tile.bytes.data(), count);
+    }
+
+    //!returns the size of tiles along every axis of image
+    static std::vector<std::size_t> tile_shape
+    (
+        std::vector<std::size_t> const& axes,
+        std::vector<std::size_t> const& requested
+    )
+    {
+        std::vector<std::size_t> shape(axes.size());
+        for (std::size_t i = 0; i < axes.size(); i++)
+        {
+            shape[i] = i < requested.size() && requested[i] != 0 ?
+                (std::min)(requested[i], axes[i]) : (i == 0 ? axes[0] : 1);
+        }
+        return shape;
+    }
+
+    //!returns the dimension of image (by default width x height), which must have as many
+    //!pixels as the image
+    template <bitpix DataType>
+    static std::vector<std::size_t> image_axes
+    (
+        image<DataType> const& data,
+        std::vector<std::size_t> naxis
+    )
+    {
+        std::size_t const pixels = data.get_width() * data.get_height();
+        if (naxis.empty() && pixels != 0)
+        {
+            naxis = {data.get_width(), data.get_height()};
+        }
+        if (std::accumulate(naxis.begin(), naxis.end(), std::size_t(naxis.empty() ? 0 : 1),
+            std::multiplies<std::size_t>()) != pixels)
+        {
+            throw fits_exception();
+        }
+        return naxis;
+    }
+
+    //!appends fill to the last 2880 bytes block
+    void pad(char fill)
+    {
+        std::size_t remaining = static_cast<std::size_t>((2880 - offset % 2880) % 2880);
+        while (remaining > 0)
+        {
+            if (used == capacity)
+            {
+                flush();
+            }
+            std::size_t const chunk = (std::min)(remaining, capacity - used);
+            std::memset(buffer + used, fill, chunk);
+            used += chunk;
+            offset += chunk;
+            remaining -= chunk;
+        }
+    }
+
+    //!returns mandatory cards followed by the cards of user, END card of user is dropped
+    static std::vector<card> header_cards(std::vector<card> header, std::vector<card> const& cards)
+    {
+        for (card const& c : cards)
+        {
+            if (c.key(true) != "END     ")
+            {
+                header.push_back(c);
+            }
+        }
+        return header;
+    }
+
+    template <bitpix DataType>
+    void write_image
+    (
+        std::string const& xtension,
+        image<DataType> const& data,
+        std::vector<card> const& cards,
+        std::vector<std::size_t> naxis
+    )
+    {
+        naxis = image_axes(data, naxis);
+        write_header(header_cards(detail::mandatory_cards(xtension,
+            bitpix_traits<DataType>::value, naxis), cards));
+        write_data(data.pixels(), data.get_width() * data.get_height());
+    }
+
+    //!returns the number of values stored in column_data, which must be of the type of TFORM
+    static std::size_t stored_values(column const& values, column const& layout)
+    {
+        std::size_t count = 0;
+        detail::visit_binary_type(layout.type(), [&](auto tag)
+        {
+            using stored_type = typename decltype(tag)::type;
+            auto typed = dynamic_cast<column_data<stored_type> const*>(&values);
+            if (!typed)
+            {
+                throw invalid_table_colum_format();
+            }
+            count = typed->get_data().size();
+        });
+        return count;
+    }
+
+    //!appends the cards describing n-th column
+    static void column_cards(column const& col, std::size_t n, std::vector<card>& header)
+    {
+        std::string const index = std::to_string(n);
+        if (!col.TTYPE().empty())
+        {
+            header.push_back(detail::make_string_card("TTYPE" + index, col.TTYPE()));
+        }
+        header.push_back(detail::make_string_card("TFORM" + index, col.TFORM()));
+        if (!col.TUNIT().empty())
+        {
+            header.push_back(detail::make_string_card("TUNIT" + index, col.TUNIT()));
+        }
+        if (!detail::is_exactly(col.TSCAL(), 1))
+        {
+            header.push_back(detail::make_card("TSCAL" + index, col.TSCAL()));
+        }
+        if (!detail::is_exactly(col.TZERO(), 0))
+        {
+            header.push_back(detail::make_card("TZERO" + index, col.TZERO()));
+        }
+        if (!col.TDISP().empty())
+        {
+            header.push_back(detail::make_string_card("TDISP" + index, col.TDISP()));
+        }
+        if (!col.TDIM().empty())
+        {
+            header.push_back(detail::make_string_card("TDIM" + index, col.TDIM()));
+        }
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_FITS_WRITER_HPP
@@ -0,0 +1,67 @@
+#ifndef BOOST_ASTRONOMY_IO_GZIP_ISTREAM_HPP
+#define BOOST_ASTRONOMY_IO_GZIP_ISTREAM_HPP
+
+#include <cstddef>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <string>
+
+#include <boost/astronomy/detail/gzip_streambuf.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+//! input stream of a gzip compressed file (e.g. .fits.gz) which is decompressed while it is
+//! read, so FITS can be read from it without decompressing it to a temporary file
+//! files made of members whose size is recorded in their header (BGZF, written by bgzip)
+//! are decompressed by up to threads threads (0 for all the cores)
+//! seekg forward and tellg are supported, seekg backward past the last few MiB decompresses
+//! the file again from its beginning
+//! throws unsupported_compression_exception if zlib is not available
+struct gzip_istream : public std::istream
+{
+protected:
+    detail::gzip_streambuf buffer; //! buffer decompressing file
+
+public:
+    explicit gzip_istream
+    (
+        std::string const& path,
+        std::size_t threads = 0,
+        std::size_t window_bytes = detail::gzip_streambuf::default_window_bytes
+    ) : std::istream(nullptr), buffer(path, threads, window_bytes)
+    {
+        rdbuf(&buffer);
+    }
+};
+
+//! returns true if the file at path starts with the magic bytes of gzip
+inline bool is_gzip_file(std::string const& path)
+{
+    std::ifstream file(path, std::ios_base::in | std::ios_base::binary);
+    unsigned char magic[2] = {0, 0};
+    file.read(reinterpret_cast<char*>(magic), 2);
+    return file && magic[0] == 0x1f && magic[1] == 0x8b;
+}
+
+//! opens the FITS at path for reading, gzip compressed files are decompressed while read
+inline std::unique_ptr<std::istream> open_fits_stream(std::string const& path)
+{
+    if (is_gzip_file(path))
+    {
+        return std::unique_ptr<std::istream>(new gzip_istream(path));
+    }
+
+    std::unique_ptr<std::istream> file(
+        new std::ifstream(path, std::ios_base::in | std::ios_base::binary));
+    if (!*file)
+    {
+        throw fits_exception();
+    }
+    return file;
+}
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_GZIP_ISTREAM_HPP
@@ -5,16 +5,18 @@
 #include <fstream>
 #include <vector>
 #include <cstddef>
-#include <unordered_map>
 #include <memory>
+#include <numeric>
+#include <functional>
 
 #include <boost/algorithm/string/trim.hpp>
-#include <boost/lexical_cast.hpp>
+#include <boost/utility/string_view.hpp>
 
 #include <boost/astronomy/io/bitpix.hpp>
 #include <boost/astronomy/io/image.hpp>
 #include <boost/astronomy/exception/fits_exception.hpp>
 #include <boost/astronomy/io/card.hpp>
+#include <boost/astronomy/io/keyword_index.hpp>
 #include <boost/astronomy/io/column.hpp>
 
 namespace boost { namespace astronomy { namespace io {
@@ -31,7 +33,7 @@ protected:
     std::vector<card> cards;
 
     //! stores the card-key index (used for faster searching)
-    std::unordered_map<std::string, std::size_t> key_index; 
+    keyword_index key_index;
 
 public:
     hdu() {}
@@ -50,20 +52,45 @@ public:
         file.close();
     }
 
-    hdu(std::fstream &file)
+    hdu(std::istream &file)
     {
         read_header(file);
     }
 
-    hdu(std::fstream &file, std::streampos pos)
+    hdu(std::istream &file, std::streampos pos)
     {
         read_header(file, pos);
     }
 
+    hdu(char const* first, char const* last)
+    {
+        read_header(first, last);
+    }
+
+    //!Creates the header from already parsed cards (e.g. restored from a sidecar index)
+    //!without parsing the values of any card again
+    hdu
+    (
+        std::vector<card> header_cards,
+        io::bitpix header_bitpix,
+        std::vector<std::size_t> header_naxis
+    ) :
+        bitpix_value(header_bitpix),
+        naxis_(std::move(header_naxis)),
+        cards(std::move(header_cards))
+    {
+        key_index.reserve(cards.size());
+        for (card const& header_card : cards)
+        {
+            key_index.push_back(header_card.data());
+        }
+    }
+
     //!Starts reading the header from current streampos of file
-    void read_header(std::fstream &file)
+    void read_header(std::istream &file)
     {
         cards.reserve(36); //reserves the space of atleast 1 HDU unit 
+        key_index.reserve(36);
         char _80_char_from_file[80]; //used as buffer to read a card consisting of 80 char
 
         //reading file card by card until END card is found
@@ -71,56 +98,52 @@ public:
         {
             //read from file and create push card into the vector
             file.read(_80_char_from_file, 80);
-            cards.emplace_back(_80_char_from_file);
-
-            //store the index of the card in map
-            this->key_index[this->cards.back().key()] = this->cards.size() - 1;
+            if (!file)
+            {
+                throw fits_exception();
+            }
 
-            //check if end card is found
-            if(this->cards.back().key(true) == "END     ")
+            if (add_card(_80_char_from_file))
             {
                 break;
             }
         }
         set_unit_end(file);    //set cursor to the end of the HDU unit
 
-        //finding and storing bitpix value
-                    
-        switch (cards[key_index["BITPIX"]].value<int>())
-        {
-        case 8:
-            this->bitpix_value = io::bitpix::B8;
-            break;
-        case 16:
-            this->bitpix_value = io::bitpix::B16;
-            break;
-        case 32:
-            this->bitpix_value = io::bitpix::B32;
-            break;
-        case -32:
-            this->bitpix_value = io::bitpix::_B32;
-            break;
-        case -64:
-            this->bitpix_value = io::bitpix::_B64;
-            break;
-        default:
-            throw fits_exception();
-            break;
-        }
-                    
-        //setting naxis values
-        naxis_.emplace_back(cards[key_index["NAXIS"]].value<std::size_t>());
-        naxis_.reserve(naxis_[0]);
-                    
-        for (std::size_t i = 1; i <= naxis_[0]; i++)
+        set_header_values();
+    }
+
+    //!Reads the header from memory (e.g. a memory mapped file) starting at first
+    //!returns the number of bytes occupied by the header including the padding
+    std::size_t read_header(char const* first, char const* last)
+    {
+        cards.reserve(36); //reserves the space of atleast 1 HDU unit 
+        key_index.reserve(static_cast<std::size_t>(last - first) / 80);
+
+        //reading card by card until END card is found
+        char const* current = first;
+        while (true)
         {
-            naxis_.emplace_back(cards[key_index["NAXIS" +
-                boost::lexical_cast<std::string>(i)]].value<std::size_t>());
+            if (last - current < 80)
+            {
+                throw fits_exception();
+            }
+
+            current += 80;
+            if (add_card(current - 80))
+            {
+                break;
+            }
         }
+
+        set_header_values();
+
+        std::size_t header_size = static_cast<std::size_t>(current - first);
+        return header_size + (2880 - header_size % 2880) % 2880;
     }
 
     //!starts reading file from the position specified
-    void read_header(std::fstream &file, std::streampos pos)
+    void read_header(std::istream &file, std::streampos pos)
     {
         file.seekg(pos);
         read_header(file);
@@ -132,6 +155,27 @@ public:
         return this->bitpix_value;
     }
 
+    //!returns the scaling of pixel values given by BSCALE, BZERO and BLANK
+    //!keys which are not present keep their default (BSCALE = 1, BZERO = 0, no BLANK)
+    io::pixel_scaling scaling() const
+    {
+        io::pixel_scaling result;
+        if (contains(io::keyword::bscale))
+        {
+            result.bscale = value_of<double>(io::keyword::bscale);
+        }
+        if (contains(io::keyword::bzero))
+        {
+            result.bzero = value_of<double>(io::keyword::bzero);
+        }
+        if (contains(io::keyword::blank))
+        {
+            result.has_blank = true;
+            result.blank = value_of<std::int64_t>(io::keyword::blank);
+        }
+        return result;
+    }
+
     //!returns the value of all naxis (NAXIS, NAXIS1, NAXIS2...)
     std::vector<std::size_t> all_naxis() const
     {
@@ -144,23 +188,181 @@ public:
         return this->naxis_[n];
     }
 
-    //!returns the value of perticular key 
+    //!returns all the cards of header
+    std::vector<card> const& get_cards() const
+    {
+        return this->cards;
+    }
+
+    //!returns the card-key index of header
+    keyword_index const& get_key_index() const
+    {
+        return this->key_index;
+    }
+
+    //!returns the value of perticular key, throws key_not_defined_exception if key is not present
+    //!if key appears more than once the value of its last card is returned
     template <typename ReturnType>
-    ReturnType value_of(std::string const& key)// const
+    ReturnType value_of(boost::string_view key) const
     {
-        return this->cards[key_index[key]].value<ReturnType>();
+        std::size_t index;
+        if (!this->key_index.find(key, index))
+        {
+            throw key_not_defined_exception();
+        }
+        return this->cards[index].value<ReturnType>();
     }
 
-    void set_unit_end(std::fstream &file) const
+    //!returns the value of indexed key formed by prefix followed by n (e.g. "NAXIS", 2 for NAXIS2)
+    template <typename ReturnType>
+    ReturnType value_of(boost::string_view prefix, std::size_t n) const
     {
-        //set cursor to the end of the HDU unit
-        file.seekg((file.tellg() + (2880 - (file.tellg() % 2880))));    
+        std::size_t index;
+        if (!this->key_index.find(prefix, n, index))
+        {
+            throw key_not_defined_exception();
+        }
+        return this->cards[index].value<ReturnType>();
+    }
+
+    //!returns the value of mandatory or reserved key stored in fixed slot
+    template <typename ReturnType>
+    ReturnType value_of(io::keyword key) const
+    {
+        std::size_t index;
+        if (!this->key_index.find(key, index))
+        {
+            throw key_not_defined_exception();
+        }
+        return this->cards[index].value<ReturnType>();
+    }
+
+    //!returns the value of n-th indexed key stored in fixed slot (e.g. indexed_keyword::tform, 3)
+    template <typename ReturnType>
+    ReturnType value_of(io::indexed_keyword key, std::size_t n) const
+    {
+        std::size_t index;
+        if (!this->key_index.find(key, n, index))
+        {
+            throw key_not_defined_exception();
+        }
+        return this->cards[index].value<ReturnType>();
+    }
+
+    //!returns true if the header contains the key
+    bool contains(boost::string_view key) const
+    {
+        return this->key_index.contains(key);
+    }
+
+    //!returns true if the header contains the mandatory or reserved key
+    bool contains(io::keyword key) const
+    {
+        std::size_t index;
+        return this->key_index.find(key, index);
+    }
+
+    //!returns all the cards with the key (e.g. HISTORY or COMMENT) in the order of header
+    std::vector<card const*> cards_of(boost::string_view key) const
+    {
+        std::vector<card const*> result;
+        result.reserve(this->key_index.count(key));
+        for (std::size_t index : this->key_index.equal_range(key))
+        {
+            result.push_back(&this->cards[index]);
+        }
+        return result;
+    }
+
+    //!returns the size in bytes of the data unit following the header without padding
+    //!size = |BITPIX| / 8 * GCOUNT * (PCOUNT + NAXIS1 * NAXIS2 * ... * NAXISm)
+    std::size_t data_size() const
+    {
+        if (this->naxis_[0] == 0)
+        {
+            return 0;
+        }
+
+        std::size_t pcount = 0;
+        std::size_t gcount = 1;
+        if (contains(io::keyword::pcount))
+        {
+            pcount = value_of<std::size_t>(io::keyword::pcount);
+        }
+        if (contains(io::keyword::gcount))
+        {
+            gcount = value_of<std::size_t>(io::keyword::gcount);
+        }
+
+        return bitpix_size(this->bitpix_value) * gcount * (pcount +
+            std::accumulate(this->naxis_.begin() + 1, this->naxis_.end(),
+                std::size_t(1), std::multiplies<std::size_t>()));
+    }
+
+    void set_unit_end(std::istream &file) const
+    {
+        //set cursor to the end of the HDU unit, nothing to skip if already at the end
+        std::streamoff remainder = file.tellg() % 2880;
+        if (remainder != 0)
+        {
+            file.seekg(file.tellg() + (2880 - remainder));
+        }
     }
 
     virtual std::unique_ptr<column> get_column(std::string name) const
     {
         throw wrong_extension_type();
     }
+
+protected:
+    //!stores the card and its index, returns true if the card is the END card
+    bool add_card(char const* card_begin)
+    {
+        cards.emplace_back(card_begin);
+
+        //store the index of the card
+        this->key_index.push_back(card_begin);
+
+        //check if end card is found
+        return this->cards.back().key(true) == "END     ";
+    }
+
+    //!finds and stores the values of BITPIX and NAXIS once all the cards are read
+    void set_header_values()
+    {
+        //finding and storing bitpix value
+                    
+        switch (value_of<int>(io::keyword::bitpix))
+        {
+        case 8:
+            this->bitpix_value = io::bitpix::B8;
+            break;
+        case 16:
+            this->bitpix_value = io::bitpix::B16;
+            break;
+        case 32:
+            this->bitpix_value = io::bitpix::B32;
+            break;
+        case -32:
+            this->bitpix_value = io::bitpix::_B32;
+            break;
+        case -64:
+            this->bitpix_value = io::bitpix::_B64;
+            break;
+        default:
+            throw fits_exception();
+            break;
+        }
+                    
+        //setting naxis values
+        naxis_.emplace_back(value_of<std::size_t>(io::keyword::naxis));
+        naxis_.reserve(naxis_[0] + 1);
+                    
+        for (std::size_t i = 1; i <= naxis_[0]; i++)
+        {
+            naxis_.emplace_back(value_of<std::size_t>(io::indexed_keyword::naxis, i));
+        }
+    }
 };
 }}} //namespace boost::astronomy::io
 
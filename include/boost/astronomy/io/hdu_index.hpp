@@ -0,0 +1,109 @@
+#ifndef BOOST_ASTRONOMY_IO_HDU_INDEX_HPP
+#define BOOST_ASTRONOMY_IO_HDU_INDEX_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <functional>
+
+#include <boost/algorithm/string/trim.hpp>
+
+#include <boost/astronomy/io/bitpix.hpp>
+#include <boost/astronomy/io/hdu.hpp>
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// removes the quotes and trailing spaces from a string value of a card ('SCI     ' -> SCI)
+inline std::string unquote(std::string value)
+{
+    if (value.size() >= 2 && value.front() == '\'' && value.back() == '\'')
+    {
+        value = value.substr(1, value.size() - 2);
+    }
+    return boost::algorithm::trim_right_copy(value);
+}
+///@endcond
+
+} //namespace detail
+
+namespace io {
+
+//! location and basic properties of a HDU recorded while scanning the headers of a file
+struct hdu_entry
+{
+    std::streamoff header_offset = 0; //! offset of the first card of the header
+    std::streamoff data_offset = 0; //! offset of the first byte of the data unit
+    std::size_t data_size = 0; //! size of the data unit in bytes without padding
+    io::bitpix bitpix_value = io::bitpix::B8; //! value of BITPIX
+    std::vector<std::size_t> naxis; //! values of all naxis (NAXIS, NAXIS1, NAXIS2...)
+    std::string xtension; //! value of XTENSION without quotes, empty for primary HDU
+    std::string extname; //! value of EXTNAME without quotes, empty if not present
+    std::shared_ptr<hdu> header; //! parsed header, reused when the HDU is read
+
+    //! creates the header when it is not parsed yet (e.g. entry read from a sidecar index)
+    std::function<std::shared_ptr<hdu>()> restore_header;
+
+    //! returns true if the entry describes the primary HDU
+    bool is_primary() const
+    {
+        return xtension.empty();
+    }
+};
+
+//! creates the entry for a HDU whose header has already been read
+inline hdu_entry make_hdu_entry(std::shared_ptr<hdu> const& header,
+    std::streamoff header_offset, std::streamoff data_offset)
+{
+    hdu_entry entry;
+    entry.header = header;
+    entry.header_offset = header_offset;
+    entry.data_offset = data_offset;
+    entry.data_size = header->data_size();
+    entry.bitpix_value = header->bitpix();
+    entry.naxis = header->all_naxis();
+    if (header->contains("XTENSION"))
+    {
+        entry.xtension = detail::unquote(header->value_of<std::string>("XTENSION"));
+    }
+    if (header->contains("EXTNAME"))
+    {
+        entry.extname = detail::unquote(header->value_of<std::string>("EXTNAME"));
+    }
+    return entry;
+}
+
+//! scans the file from the beginning and records the entry of every HDU in it
+//! only the headers are read, data units are skipped by seeking past them
+//! the end of file is found by reading past the last HDU so that streams whose size is not
+//! known in advance (e.g. gzip_istream) can be scanned
+inline std::vector<hdu_entry> scan_hdu_index(std::istream &file)
+{
+    std::vector<hdu_entry> index;
+
+    file.clear();
+    std::streamoff offset = 0;
+    while (true)
+    {
+        file.seekg(offset);
+        if (!file || file.peek() == std::char_traits<char>::eof())
+        {
+            break;
+        }
+
+        auto header = std::make_shared<hdu>(file, offset);
+        index.push_back(make_hdu_entry(header, offset, file.tellg()));
+
+        //skip the data unit along with its padding
+        std::streamoff data_size = static_cast<std::streamoff>(index.back().data_size);
+        offset = index.back().data_offset + data_size + (2880 - data_size % 2880) % 2880;
+    }
+
+    return index;
+}
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_HDU_INDEX_HPP
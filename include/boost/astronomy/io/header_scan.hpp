@@ -0,0 +1,266 @@
+#ifndef BOOST_ASTRONOMY_IO_HEADER_SCAN_HPP
+#define BOOST_ASTRONOMY_IO_HEADER_SCAN_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <exception>
+#include <utility>
+
+#include <boost/astronomy/detail/parallel.hpp>
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/hdu_index.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// appends the 2880 byte blocks of a header to buffer until the block containing END card
+// only the header is read, the stream is left at the first byte of the data unit
+inline void read_header_blocks(std::istream& file, std::string& buffer)
+{
+    buffer.clear();
+    while (true)
+    {
+        std::size_t const block = buffer.size();
+        buffer.resize(block + 2880);
+        file.read(&buffer[block], 2880);
+        if (!file)
+        {
+            throw fits_exception();
+        }
+
+        for (std::size_t position = block; position < block + 2880; position += 80)
+        {
+            if (std::memcmp(buffer.data() + position, "END     ", 8) == 0)
+            {
+                return;
+            }
+        }
+    }
+}
+
+// converts the value of a card to the type of header column
+template <typename T>
+inline T header_value(io::hdu const& header, std::string const& keyword)
+{
+    return header.value_of<T>(keyword);
+}
+
+// string values are returned without quotes and trailing spaces
+template <>
+inline std::string header_value<std::string>(io::hdu const& header, std::string const& keyword)
+{
+    return unquote(header.value_of<std::string>(keyword));
+}
+///@endcond
+
+} //namespace detail
+
+namespace io {
+
+//! values of a keyword for every file scanned, type of values is not known to header_table
+struct header_column_base
+{
+    std::string keyword; //! keyword whose values are stored in column
+    std::vector<unsigned char> present; //! 0 if the keyword is missing or its value is invalid
+
+    explicit header_column_base(std::string name) : keyword(std::move(name)) {}
+    virtual ~header_column_base() {}
+
+    //! creates an empty column of the same keyword and type for rows number of files
+    virtual std::unique_ptr<header_column_base> make_column(std::size_t rows) const = 0;
+
+    //! stores the value of keyword in header at the row
+    virtual void extract(hdu const& header, std::size_t row) = 0;
+};
+
+//! values of a keyword for every file scanned
+template <typename T>
+struct header_column : public header_column_base
+{
+    std::vector<T> values; //! value of keyword for each file, T() if not present
+
+    explicit header_column(std::string name, std::size_t rows = 0)
+        : header_column_base(std::move(name)), values(rows)
+    {
+        this->present.resize(rows, 0);
+    }
+
+    std::unique_ptr<header_column_base> make_column(std::size_t rows) const override
+    {
+        return std::unique_ptr<header_column_base>(new header_column<T>(this->keyword, rows));
+    }
+
+    void extract(hdu const& header, std::size_t row) override
+    {
+        if (!header.contains(this->keyword))
+        {
+            return;
+        }
+        try
+        {
+            values[row] = detail::header_value<T>(header, this->keyword);
+            this->present[row] = 1;
+        }
+        catch (std::exception const&)
+        {
+            //invalid value is treated as missing
+        }
+    }
+};
+
+//! keywords to be collected by scan_headers along with the type of their values
+struct header_query
+{
+protected:
+    std::vector<std::unique_ptr<header_column_base>> keyword_columns; //! in order of add
+
+public:
+    //! adds a keyword whose values are converted to T (strings are returned without quotes)
+    template <typename T>
+    header_query& add(std::string const& keyword)
+    {
+        if (keyword.length() > 8)
+        {
+            throw invalid_key_length_exception();
+        }
+        keyword_columns.emplace_back(new header_column<T>(keyword));
+        return *this;
+    }
+
+    std::vector<std::unique_ptr<header_column_base>> const& columns() const
+    {
+        return keyword_columns;
+    }
+};
+
+//! columnar result of scan_headers, one row for each file and one column for each keyword
+struct header_table
+{
+protected:
+    std::vector<std::string> file_paths; //! file of every row
+    std::vector<std::string> file_errors; //! error of every row, empty if file was read
+    std::vector<std::unique_ptr<header_column_base>> value_columns; //! in order of query
+
+public:
+    header_table(std::vector<std::string> const& paths, header_query const& query)
+        : file_paths(paths), file_errors(paths.size())
+    {
+        for (auto const& column : query.columns())
+        {
+            value_columns.push_back(column->make_column(paths.size()));
+        }
+    }
+
+    //! returns the number of files scanned
+    std::size_t rows() const
+    {
+        return file_paths.size();
+    }
+
+    std::vector<std::string> const& paths() const
+    {
+        return file_paths;
+    }
+
+    //! returns the reason the file at row could not be read, empty if it was read
+    std::vector<std::string> const& errors() const
+    {
+        return file_errors;
+    }
+
+    //! returns the values of keyword, T must be the type given to header_query::add
+    template <typename T>
+    header_column<T> const& column(std::string const& keyword) const
+    {
+        for (auto const& column : value_columns)
+        {
+            if (column->keyword == keyword)
+            {
+                return dynamic_cast<header_column<T> const&>(*column);
+            }
+        }
+        throw key_not_defined_exception();
+    }
+
+    //! returns all the columns in the order of query
+    std::vector<std::unique_ptr<header_column_base>> const& columns() const
+    {
+        return value_columns;
+    }
+
+    //! reads the header of HDU number hdu_number in file at row and stores the values
+    void scan(std::size_t row, std::size_t hdu_number, detail::counting_semaphore& io_slots)
+    {
+        try
+        {
+            std::string buffer;
+            {
+                detail::semaphore_guard guard(io_slots);
+
+                //unbuffered so that nothing past the header is read
+                std::ifstream file;
+                file.rdbuf()->pubsetbuf(nullptr, 0);
+                file.open(file_paths[row], std::ios_base::in | std::ios_base::binary);
+                if (!file)
+                {
+                    throw fits_exception();
+                }
+
+                detail::read_header_blocks(file, buffer);
+                for (std::size_t i = 0; i < hdu_number; i++)
+                {
+                    hdu skipped(buffer.data(), buffer.data() + buffer.size());
+                    std::streamoff data_size = static_cast<std::streamoff>(skipped.data_size());
+                    file.seekg(data_size + (2880 - data_size % 2880) % 2880, std::ios_base::cur);
+                    detail::read_header_blocks(file, buffer);
+                }
+            }
+
+            hdu header(buffer.data(), buffer.data() + buffer.size());
+            for (auto& column : value_columns)
+            {
+                column->extract(header, row);
+            }
+        }
+        catch (std::exception const& e)
+        {
+            file_errors[row] = e.what();
+        }
+    }
+};
+
+//! options of scan_headers
+struct header_scan_options
+{
+    std::size_t threads = 0; //! number of threads parsing headers, 0 uses all the cores
+    std::size_t max_open_files = 4; //! number of files read at the same time
+    std::size_t hdu_number = 0; //! HDU whose header is scanned (0 is primary HDU)
+};
+
+//! collects the values of keywords from the header of every file without reading data units
+//! files which can not be read are reported by header_table::errors instead of throwing
+inline header_table scan_headers
+(
+    std::vector<std::string> const& paths,
+    header_query const& query,
+    header_scan_options const& options = header_scan_options()
+)
+{
+    header_table table(paths, query);
+    detail::counting_semaphore io_slots(options.max_open_files == 0 ? 1 : options.max_open_files);
+
+    detail::parallel_for(paths.size(), options.threads, [&](std::size_t row)
+    {
+        table.scan(row, options.hdu_number, io_slots);
+    });
+    return table;
+}
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_HEADER_SCAN_HPP
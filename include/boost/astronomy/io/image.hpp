@@ -11,387 +11,566 @@
 #include <string>
 #include <cmath>
 #include <numeric>
+#include <vector>
+#include <cstring>
+#include <limits>
+#include <type_traits>
 
 #include <boost/endian/conversion.hpp>
 #include <boost/cstdfloat.hpp>
 
 #include <boost/astronomy/io/bitpix.hpp>
+#include <boost/astronomy/detail/byteswap.hpp>
+#include <boost/astronomy/detail/physical.hpp>
+#include <boost/astronomy/detail/statistics.hpp>
+#include <boost/astronomy/detail/quantile.hpp>
+#include <boost/astronomy/io/byte_source.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
 
 
 namespace boost { namespace astronomy { namespace io {
 
-template <typename PixelType>
-struct image_buffer
+//! pixels [first, last) along an axis taking every stride-th pixel (0 based)
+struct axis_range
 {
-protected:
-    std::valarray<PixelType> data; //! stores the image
-    std::size_t width; //! width of image 
-    std::size_t height; //! height of image
-    //std::fstream image_file; //! image file
+    std::size_t first = 0;
+    std::size_t last = 0;
+    std::size_t stride = 1;
 
-    //! Used purly for Type punning
-    union pixel_data
-    {
-        PixelType pixel;
-        std::uint8_t byte[sizeof(PixelType)];
-        //char byte[sizeof(PixelType)];
-    };
+    axis_range() {}
 
-public:
-    image_buffer() {}
+    axis_range(std::size_t first_pixel, std::size_t last_pixel, std::size_t step = 1) :
+        first(first_pixel), last(last_pixel), stride(step) {}
 
-    image_buffer(std::size_t width, std::size_t height) : width(width), height(height)
+    //! returns the number of pixels selected by range
+    std::size_t size() const
     {
-        this->data.resize(width*height);
+        return (last - first + stride - 1) / stride;
     }
+};
 
-    virtual ~image_buffer() {}
+//! pixels left out of masked statistics besides NaN pixels, which are always left out
+struct bad_pixels
+{
+    bool has_blank = false; //! integer pixels equal to blank are bad
+    std::int64_t blank = 0; //! value of BLANK
+    std::uint8_t const* mask = nullptr; //! bad pixel mask, a byte per pixel, nonzero is bad
 
-    //! returns the maximum value of all the pixels in the image
-    PixelType max() const
+    bad_pixels() {}
+
+    //! pixels marked in mask plane (a byte for every pixel of image) are bad
+    explicit bad_pixels(std::uint8_t const* mask_plane) : mask(mask_plane) {}
+
+    //! pixels equal to BLANK of scaling (see hdu::scaling) and pixels marked in mask plane
+    //! (if not null) are bad
+    explicit bad_pixels
+    (
+        pixel_scaling const& scaling,
+        std::uint8_t const* mask_plane = nullptr
+    ) : has_blank(scaling.has_blank), blank(scaling.blank), mask(mask_plane) {}
+};
+
+//! statistics of the valid pixels of an image, all NaN if no pixel is valid
+//! variance and std_dev are NaN for less than 2 pixels, skewness and kurtosis are NaN if
+//! all the pixels are equal
+struct pixel_statistics
+{
+    std::size_t count = 0; //! number of valid pixels
+    double min = std::numeric_limits<double>::quiet_NaN(); //! minimum value
+    double max = std::numeric_limits<double>::quiet_NaN(); //! maximum value
+    double mean = std::numeric_limits<double>::quiet_NaN(); //! mean value
+    double variance = std::numeric_limits<double>::quiet_NaN(); //! sample variance (n - 1)
+    double std_dev = std::numeric_limits<double>::quiet_NaN(); //! standard deviation (n - 1)
+    double skewness = std::numeric_limits<double>::quiet_NaN(); //! m3 / m2^(3/2)
+    double kurtosis = std::numeric_limits<double>::quiet_NaN(); //! excess, m4 / m2^2 - 3
+};
+
+}}} //namespace boost::astronomy::io
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// completes ranges with the whole of remaining axes and checks them against axes
+inline std::vector<io::axis_range> cutout_ranges
+(
+    std::vector<io::axis_range> ranges,
+    std::vector<std::size_t> const& axes
+)
+{
+    if (ranges.size() > axes.size())
     {
-        return this->data.max();
+        throw invalid_cutout_range_exception();
     }
-
-    //! returns the manimum value of all the pixels in the image
-    PixelType min() const
+    for (std::size_t i = ranges.size(); i < axes.size(); i++)
     {
-        return this->data.min();
+        ranges.emplace_back(0, axes[i]);
     }
-
-    //! returns the mean value of all the pixels in image
-    double mean() const
+    for (std::size_t i = 0; i < axes.size(); i++)
     {
-        if (this->data.size() == 0)
+        if (ranges[i].stride == 0 || ranges[i].first >= ranges[i].last ||
+            ranges[i].last > axes[i])
         {
-            return 0;
+            throw invalid_cutout_range_exception();
         }
+    }
+    return ranges;
+}
 
-        return (std::accumulate(std::begin(this->data),
-            std::end(this->data), 0.0) / this->data.size());
+// pixels used by the statistics kernels for bad
+inline pixel_filter filter_of(io::bad_pixels const& bad)
+{
+    pixel_filter filter;
+    filter.has_blank = bad.has_blank;
+    filter.blank = bad.blank;
+    filter.mask = bad.mask;
+    return filter;
+}
+///@endcond
+
+} //namespace detail
+
+namespace io {
+
+template <typename PixelType>
+struct image_buffer
+{
+protected:
+    std::valarray<PixelType> data; //! stores the image
+    std::size_t width = 0; //! width of image
+    std::size_t height = 0; //! height of image
+    //std::fstream image_file; //! image file
+
+    //! number of pixels read from file at once by read_big_endian
+    static constexpr std::size_t read_chunk = (std::size_t(1) << 20) / sizeof(PixelType);
+
+    //! sets the dimension of image and allocates the storage for pixels
+    void resize(std::size_t image_width, std::size_t image_height)
+    {
+        this->width = image_width;
+        this->height = image_height;
+        this->data.resize(image_width*image_height);
     }
 
-    //! returns the median of all the pixel values in the image 
-    //! Note: uses additional space of order O(n) where n is the number of total pixels
-    PixelType median() const
+    //! reads all the pixels of image from current position of stream
+    //! pixels are read in large blocks and each block is converted from big-endian to
+    //! native byte order while it is still in cache
+    void read_big_endian(std::istream &image_file)
     {
-        std::valarray<PixelType> soreted_array = this->data;
-        std::nth_element(std::begin(soreted_array),
-            std::begin(soreted_array) + soreted_array.size() / 2, std::end(soreted_array));
+        PixelType* pixels = std::begin(this->data);
+        std::size_t const total = this->data.size();
+        std::size_t const chunk = read_chunk;
 
-        return soreted_array[soreted_array.size() / 2];
+        for (std::size_t first = 0; first < total; first += chunk)
+        {
+            std::size_t count = (std::min)(chunk, total - first);
+            image_file.read(reinterpret_cast<char*>(pixels + first),
+                static_cast<std::streamsize>(count * sizeof(PixelType)));
+            if (!image_file)
+            {
+                throw fits_exception();
+            }
+
+            detail::big_to_native_inplace(pixels + first, count);
+        }
     }
 
-    //! returns the standard deviation of all the pixel values in the image 
-    //! Note: uses additional space of order O(n) where n is the number of total pixels
-    double std_dev() const
+    //! reads all the pixels of image at offset of file with positioned reads
+    //! the file is not shared with other readers so images can be read concurrently
+    //! pixels of a source held in memory are converted straight from it
+    void read_big_endian(byte_source const& image_file, std::uint64_t offset)
     {
-        if (this->data.size() == 0)
+        PixelType* pixels = std::begin(this->data);
+        std::size_t const total = this->data.size();
+        std::size_t const chunk = read_chunk;
+
+        char const* in_place = image_file.view(offset, total * sizeof(PixelType));
+        if (in_place)
         {
-            return 0;
+            detail::big_to_native_copy(in_place, pixels, total);
+            return;
         }
 
-        double avg = this->mean();
-
-        std::valarray<double> diff(this->data.size());
-        for (size_t i = 0; i < diff.size(); i++)
+        for (std::size_t first = 0; first < total; first += chunk)
         {
-            diff[i] = this->data[i] - avg;
+            std::size_t count = (std::min)(chunk, total - first);
+            image_file.read_at(pixels + first, count * sizeof(PixelType),
+                offset + first * sizeof(PixelType));
+            detail::big_to_native_inplace(pixels + first, count);
         }
-                    
-        diff *= diff;
-        return std::sqrt(diff.sum() / (diff.size() - 1));
     }
 
-    PixelType operator() (std::size_t x, std::size_t y)
+    //! reads all the pixels stored with bitpix stored from current position of stream and
+    //! converts them to physical values (BZERO + BSCALE * stored value, BLANK to NaN)
+    //! byte order, conversion and scaling are done in one pass over each block read
+    void read_physical(std::istream &image_file, bitpix stored, pixel_scaling const& scaling)
     {
-        return this->data[(x*this->width) + y];
+        PixelType* pixels = std::begin(this->data);
+        std::size_t const total = this->data.size();
+        std::size_t const stored_size = bitpix_size(stored);
+        std::size_t const chunk = read_chunk;
+
+        std::vector<char> raw((std::min)(chunk, total) * stored_size);
+        for (std::size_t first = 0; first < total; first += chunk)
+        {
+            std::size_t count = (std::min)(chunk, total - first);
+            image_file.read(raw.data(), static_cast<std::streamsize>(count * stored_size));
+            if (!image_file)
+            {
+                throw fits_exception();
+            }
+            detail::big_to_physical(stored, raw.data(), pixels + first, count, scaling);
+        }
     }
-};
 
+    //! reads all the pixels stored with bitpix stored at offset of file with positioned
+    //! reads and converts them to physical values, pixels of a source held in memory are
+    //! converted straight from it
+    void read_physical
+    (
+        byte_source const& image_file,
+        std::uint64_t offset,
+        bitpix stored,
+        pixel_scaling const& scaling
+    )
+    {
+        PixelType* pixels = std::begin(this->data);
+        std::size_t const total = this->data.size();
+        std::size_t const stored_size = bitpix_size(stored);
+        std::size_t const chunk = read_chunk;
 
-template<bitpix args>
-struct image {};
+        char const* in_place = image_file.view(offset, total * stored_size);
+        if (in_place)
+        {
+            detail::big_to_physical(stored, in_place, pixels, total, scaling);
+            return;
+        }
 
+        std::vector<char> raw((std::min)(chunk, total) * stored_size);
+        for (std::size_t first = 0; first < total; first += chunk)
+        {
+            std::size_t count = (std::min)(chunk, total - first);
+            image_file.read_at(raw.data(), count * stored_size, offset + first * stored_size);
+            detail::big_to_physical(stored, raw.data(), pixels + first, count, scaling);
+        }
+    }
 
-template <>
-struct image<bitpix::B8> : public image_buffer<std::uint8_t>
-{
 public:
-    image() {}
-
-    image(std::string const& file, std::size_t width, std::size_t height, std::streamoff start) :
-        image_buffer<std::uint8_t>(width, height)
-    {   
-        std::fstream image_file(file);
-        image_file.seekg(start);
-        read_image_logic(image_file);
-        image_file.close();
-    }
+    image_buffer() {}
 
-    image(std::string const& file, std::size_t width, std::size_t height) :
-        image_buffer<std::uint8_t>(width, height)
+    image_buffer(std::size_t width, std::size_t height) : width(width), height(height)
     {
-        std::fstream image_file(file);
-        read_image_logic(image_file);
-        image_file.close();
+        this->data.resize(width*height);
     }
 
-    image(std::fstream &file, std::size_t width, std::size_t height, std::streamoff start)
-    {
-        read_image(file, width, height, start);
-    }
+    image_buffer(image_buffer const&) = default;
+    image_buffer(image_buffer&&) = default;
+    image_buffer& operator=(image_buffer const&) = default;
+    image_buffer& operator=(image_buffer&&) = default;
 
-    image(std::fstream &file, std::size_t width, std::size_t height)
-    {
-        read_image(file, width, height);
-    }
+    virtual ~image_buffer() {}
 
-    void read_image_logic(std::fstream &image_file)
+    //! returns the number of pixels in a row of image
+    std::size_t get_width() const
     {
-        image_file.read((char*)std::begin(data), width*height);
-        //std::copy_n(std::istreambuf_iterator<char>(file.rdbuf()), width*height, std::begin(data));
+        return this->width;
     }
 
-    void read_image
-    (
-        std::string const& file,
-        std::size_t width,
-        std::size_t height,
-        std::streamoff start
-    )
+    //! returns the number of rows of image
+    std::size_t get_height() const
     {
-        std::fstream image_file(file);
-        data.resize(width*height);
-        image_file.seekg(start);
-
-        read_image_logic(image_file);
-
-        image_file.close();
+        return this->height;
     }
 
-    void read_image(std::string const& file, std::size_t width, std::size_t height)
+    //! returns the pixels in native byte order, one row after another
+    PixelType const* pixels() const
     {
-        read_image(file, width, height, 0);
+        return std::begin(this->data);
     }
 
-    void read_image(std::fstream &file, std::size_t width, std::size_t height, std::streamoff start)
+    //! returns the pixels in native byte order, one row after another
+    PixelType* pixels()
     {
-        data.resize(width*height);
-        file.seekg(start);
-
-        read_image_logic(file);
+        return std::begin(this->data);
     }
 
-    void read_image(std::fstream &file, std::size_t width, std::size_t height)
+    //! returns the maximum value of all the pixels in the image
+    PixelType max() const
     {
-        read_image(file, width, height, file.tellg());
+        return this->data.max();
     }
-};
-
 
-template <>
-struct image<bitpix::B16> : public image_buffer<std::int16_t>
-{
-public:
-    image() {}
-
-    image(std::string const& file, std::size_t width, std::size_t height, std::streamoff start) :
-        image_buffer<std::int16_t>(width, height)
+    //! returns the manimum value of all the pixels in the image
+    PixelType min() const
     {
-        std::fstream image_file(file);
-        image_file.seekg(start);
-        read_image_logic(image_file);
-        image_file.close();
+        return this->data.min();
     }
 
-    image(std::string const& file, std::size_t width, std::size_t height) :
-        image_buffer<std::int16_t>(width, height)
+    //! returns the mean value of all the pixels in image
+    double mean() const
     {
-        std::fstream image_file(file);
-        read_image_logic(image_file);
-        image_file.close();
-    }
+        if (this->data.size() == 0)
+        {
+            return 0;
+        }
 
-    image(std::fstream &file, std::size_t width, std::size_t height, std::streamoff start)
-    {
-        read_image(file, width, height, start);
+        return (std::accumulate(std::begin(this->data),
+            std::end(this->data), 0.0) / this->data.size());
     }
 
-    image(std::fstream &file, std::size_t width, std::size_t height)
+    //! returns the median of all the pixel values in the image, NaN pixels are left out
+    //! (see median(bad_pixels const&))
+    PixelType median() const
     {
-        read_image(file, width, height);
+        return median(bad_pixels());
     }
 
-    void read_image_logic(std::fstream &image_file)
+    //! returns the standard deviation of all the pixel values in the image
+    //! computed in a single pass without additional space, large images are split among
+    //! all the cores
+    double std_dev() const
     {
-        for (std::size_t i = 0; i < height*width; i++)
+        if (this->data.size() == 0)
         {
-            image_file.read((char*)&data[i], 2);
-            data[i] = boost::endian::big_to_native(data[i]);
+            return 0;
         }
+
+        detail::pixel_filter every_pixel;
+        every_pixel.skip_nan = false;
+        detail::moments const result = detail::image_moments(std::begin(this->data),
+            this->data.size(), every_pixel, 0);
+        return std::sqrt(result.m2 / static_cast<double>(result.count - 1));
     }
 
-    void read_image
+    //! returns the count, min, max, mean, variance, skewness and kurtosis of the pixels
+    //! which are not bad (NaN pixels are never valid) gathered together in a single pass
+    //! without copying the pixels, images of millions of pixels are split among up to
+    //! threads threads (0 for all the cores) whose partial results are merged
+    pixel_statistics statistics
     (
-        std::string const& file,
-        std::size_t width,
-        std::size_t height,
-        std::streamoff start
-    )
+        bad_pixels const& bad = bad_pixels(),
+        std::size_t threads = 0
+    ) const
     {
-        std::fstream image_file(file);
-        image_file.open(file);
-        data.resize(width*height);
-        image_file.seekg(start);
+        detail::moments const summary = detail::image_moments(std::begin(this->data),
+            this->data.size(), detail::filter_of(bad), threads);
 
-        read_image_logic(image_file);
-
-        image_file.close();
+        pixel_statistics result;
+        result.count = summary.count;
+        if (summary.count == 0)
+        {
+            return result;
+        }
+        double const n = static_cast<double>(summary.count);
+        result.min = summary.min;
+        result.max = summary.max;
+        result.mean = summary.mean;
+        if (summary.count > 1)
+        {
+            result.variance = summary.m2 / (n - 1);
+            result.std_dev = std::sqrt(result.variance);
+        }
+        if (summary.m2 > 0)
+        {
+            result.skewness = std::sqrt(n) * summary.m3 / std::pow(summary.m2, 1.5);
+            result.kurtosis = n * summary.m4 / (summary.m2 * summary.m2) - 3;
+        }
+        return result;
     }
 
-    void read_image(std::string const& file, std::size_t width, std::size_t height)
+    //! returns the maximum value of the pixels which are not bad
+    //! (NaN for floating point pixels and 0 for integer pixels if no pixel is valid)
+    PixelType max(bad_pixels const& bad) const
     {
-        read_image(file, width, height, 0);
+        pixel_statistics const result = statistics(bad);
+        return result.count == 0 ? std::numeric_limits<PixelType>::quiet_NaN() :
+            static_cast<PixelType>(result.max);
     }
 
-    void read_image(std::fstream &file, std::size_t width, std::size_t height, std::streamoff start)
+    //! returns the minimum value of the pixels which are not bad
+    //! (NaN for floating point pixels and 0 for integer pixels if no pixel is valid)
+    PixelType min(bad_pixels const& bad) const
     {
-        data.resize(width*height);
-        file.seekg(start);
-
-        read_image_logic(file);
+        pixel_statistics const result = statistics(bad);
+        return result.count == 0 ? std::numeric_limits<PixelType>::quiet_NaN() :
+            static_cast<PixelType>(result.min);
     }
 
-    void read_image(std::fstream &file, std::size_t width, std::size_t height)
+    //! returns the mean value of the pixels which are not bad (NaN if no pixel is valid)
+    double mean(bad_pixels const& bad) const
     {
-        read_image(file, width, height, file.tellg());
+        return statistics(bad).mean;
     }
-};
-
 
-template <>
-struct image<bitpix::B32> : public image_buffer<std::int32_t>
-{
-public:
-    image() {}
-
-    image(std::string const& file, std::size_t width, std::size_t height, std::streamoff start) :
-        image_buffer<std::int32_t>(width, height)
+    //! returns the standard deviation of the pixels which are not bad
+    //! (NaN if less than 2 pixels are valid)
+    double std_dev(bad_pixels const& bad) const
     {
-        std::fstream image_file(file);
-        image_file.seekg(start);
-        read_image_logic(image_file);
-        image_file.close();
+        return statistics(bad).std_dev;
     }
 
-    image(std::string const& file, std::size_t width, std::size_t height) :
-        image_buffer<std::int32_t>(width, height)
+    //! returns the median (the pixel of rank m / 2 among the m valid pixels) of the pixels
+    //! which are not bad (NaN for floating point pixels and 0 for integer pixels if no pixel
+    //! is valid)
+    //! selects the pixel with radix histograms of the pixel values without copying the image,
+    //! a single pass for 8 and 16 bit pixels and one more pass for every 16 bits above
+    //! threads threads (0 for all the cores) share the passes over large images
+    PixelType median(bad_pixels const& bad, std::size_t threads = 0) const
     {
-        std::fstream image_file(file);
-        read_image_logic(image_file);
-        image_file.close();
+        detail::radix_selector<PixelType> const selector(std::begin(this->data),
+            this->data.size(), detail::filter_of(bad), threads);
+        if (selector.size() == 0)
+        {
+            return std::numeric_limits<PixelType>::quiet_NaN();
+        }
+        return selector.select(selector.size() / 2);
     }
 
-    image(std::fstream &file, std::size_t width, std::size_t height, std::streamoff start)
+    //! returns the q quantile (0 <= q <= 1) of the pixels which are not bad, interpolated
+    //! linearly between the valid pixels of rank floor(h) and ceil(h) where h = q * (m - 1)
+    //! (NaN if no pixel is valid)
+    //! exact, computed as median(bad_pixels const&, std::size_t) without copying the image
+    //! throws invalid_quantile_exception if q is not between 0 and 1
+    double quantile(double q, bad_pixels const& bad = bad_pixels(), std::size_t threads = 0)
+        const
     {
-        read_image(file, width, height, start);
+        return quantiles({q}, bad, threads)[0];
     }
 
-    image(std::fstream &file, std::size_t width, std::size_t height)
+    //! returns the quantiles of the pixels which are not bad for each of q (see quantile),
+    //! the first pass over the pixels is shared by all the quantiles
+    //! throws invalid_quantile_exception if any of q is not between 0 and 1
+    std::vector<double> quantiles
+    (
+        std::vector<double> const& q,
+        bad_pixels const& bad = bad_pixels(),
+        std::size_t threads = 0
+    ) const
     {
-        read_image(file, width, height);
-    }
+        for (double fraction : q)
+        {
+            if (!(fraction >= 0 && fraction <= 1))
+            {
+                throw invalid_quantile_exception();
+            }
+        }
 
-    void read_image_logic(std::fstream &image_file)
-    {
-        for (std::size_t i = 0; i < height*width; i++)
+        std::vector<double> result(q.size(), std::numeric_limits<double>::quiet_NaN());
+        detail::radix_selector<PixelType> const selector(std::begin(this->data),
+            this->data.size(), detail::filter_of(bad), threads);
+        if (selector.size() == 0)
         {
-            image_file.read((char*)&data[i], 4);
-            data[i] = boost::endian::big_to_native(data[i]);
+            return result;
         }
+        for (std::size_t i = 0; i < q.size(); i++)
+        {
+            double const h = q[i] * static_cast<double>(selector.size() - 1);
+            std::size_t const below = static_cast<std::size_t>(std::floor(h));
+            double const lower = static_cast<double>(selector.select(below));
+            double const weight = h - static_cast<double>(below);
+            result[i] = weight > 0 ? (1 - weight) * lower +
+                weight * static_cast<double>(selector.select(below + 1)) : lower;
+        }
+        return result;
     }
 
-    //!reads image
-    void read_image
-    (
-        std::string const& file,
-        std::size_t width,
-        std::size_t height,
-        std::streamoff start
-    )
-    {
-        std::fstream image_file(file);
-        data.resize(width*height);
-        image_file.seekg(start);
-
-        read_image_logic(image_file);
 
-        image_file.close();
+    PixelType operator() (std::size_t x, std::size_t y)
+    {
+        return this->data[(x*this->width) + y];
     }
 
-    void read_image(std::string const& file, std::size_t width, std::size_t height)
+    //! returns the pixels selected by ranges along width (NAXIS1) and height as a new image
+    //! missing ranges select the whole axis
+    image_buffer<PixelType> cutout(std::vector<axis_range> const& ranges) const
     {
-        read_image(file, width, height, 0);
+        std::vector<axis_range> const selected =
+            detail::cutout_ranges(ranges, {this->width, this->height});
+
+        axis_range const& x = selected[0];
+        axis_range const& y = selected[1];
+        image_buffer<PixelType> result(x.size(), y.size());
+
+        PixelType* destination = std::begin(result.data);
+        for (std::size_t row = y.first; row < y.last; row += y.stride)
+        {
+            PixelType const* source = std::begin(this->data) + row * this->width;
+            for (std::size_t column = x.first; column < x.last; column += x.stride)
+            {
+                *destination++ = source[column];
+            }
+        }
+        return result;
     }
 
-    void read_image(std::fstream &file, std::size_t width, std::size_t height, std::streamoff start)
+    //! copies big-endian pixels stored in memory (e.g. a mapped file) into the buffer
+    //! and converts them to native byte order
+    void decode_image(char const* bytes, std::size_t image_width, std::size_t image_height)
     {
-        data.resize(width*height);
-        file.seekg(start);
-
-        read_image_logic(file);
+        resize(image_width, image_height);
+        detail::big_to_native_copy(bytes, std::begin(this->data), this->data.size());
     }
 
-    void read_image(std::fstream &file, std::size_t width, std::size_t height)
+    //! converts big-endian pixels stored in memory with bitpix stored into the buffer as
+    //! physical values (BZERO + BSCALE * stored value, BLANK to NaN)
+    void decode_physical
+    (
+        char const* bytes,
+        std::size_t image_width,
+        std::size_t image_height,
+        bitpix stored,
+        pixel_scaling const& scaling
+    )
     {
-        read_image(file, width, height, file.tellg());
+        resize(image_width, image_height);
+        detail::big_to_physical(stored, bytes, std::begin(this->data), this->data.size(),
+            scaling);
     }
 };
 
 
-template <>
-struct image<bitpix::_B32> : public image_buffer<boost::float32_t>
+template <bitpix DataType>
+struct image : public image_buffer<typename bitpix_traits<DataType>::type>
 {
 public:
+    using pixel_type = typename bitpix_traits<DataType>::type;
+
     image() {}
 
+    //! creates an image of given dimension with all the pixels set to 0
+    image(std::size_t image_width, std::size_t image_height) :
+        image_buffer<pixel_type>(image_width, image_height) {}
+
     image(std::string const& file, std::size_t width, std::size_t height, std::streamoff start) :
-        image_buffer<boost::float32_t>(width, height)
+        image_buffer<pixel_type>(width, height)
     {
-        std::fstream image_file(file);
+        std::fstream image_file(file, std::ios_base::in | std::ios_base::binary);
         image_file.seekg(start);
         read_image_logic(image_file);
         image_file.close();
     }
 
     image(std::string const& file, std::size_t width, std::size_t height) :
-        image_buffer<boost::float32_t>(width, height)
+        image_buffer<pixel_type>(width, height)
     {
-        std::fstream image_file(file);
+        std::fstream image_file(file, std::ios_base::in | std::ios_base::binary);
         read_image_logic(image_file);
         image_file.close();
     }
 
-    image(std::fstream &file, std::size_t width, std::size_t height, std::streamoff start)
+    image(std::istream &file, std::size_t width, std::size_t height, std::streamoff start)
     {
         read_image(file, width, height, start);
     }
 
-    image(std::fstream &file, std::size_t width, std::size_t height)
+    image(std::istream &file, std::size_t width, std::size_t height)
     {
         read_image(file, width, height);
     }
 
-    void read_image_logic(std::fstream &image_file)
+    //! reads the whole image in blocks and converts it to native byte order
+    void read_image_logic(std::istream &image_file)
     {
-        pixel_data single_pixel;
-        for (std::size_t i = 0; i < height*width; i++)
-        {
-            image_file.read((char*)single_pixel.byte, 4);
-            data[i] = (single_pixel.byte[3] << 0) | (single_pixel.byte[2] << 8) |
-                (single_pixel.byte[1] << 16) | (single_pixel.byte[0] << 24);
-        }
+        this->read_big_endian(image_file);
     }
 
     void read_image
@@ -402,11 +581,12 @@ public:
         std::streamoff start
     )
     {
-        std::fstream image_file(file);
-        data.resize(width*height);
+        std::fstream image_file(file, std::ios_base::in | std::ios_base::binary);
+        this->resize(width, height);
         image_file.seekg(start);
 
         read_image_logic(image_file);
+
         image_file.close();
     }
 
@@ -415,100 +595,195 @@ public:
         read_image(file, width, height, 0);
     }
 
-    void read_image(std::fstream &file, std::size_t width, std::size_t height, std::streamoff start)
+    void read_image(std::istream &file, std::size_t width, std::size_t height, std::streamoff start)
     {
-        data.resize(width*height);
+        this->resize(width, height);
         file.seekg(start);
 
         read_image_logic(file);
     }
 
-    void read_image(std::fstream &file, std::size_t width, std::size_t height)
+    void read_image(std::istream &file, std::size_t width, std::size_t height)
     {
         read_image(file, width, height, file.tellg());
     }
-};
-
-
-template <>
-struct image<bitpix::_B64> : public image_buffer<boost::float64_t>
-{
-public:
-    image() {}
 
-    image(std::string const& file, std::size_t width, std::size_t height, std::streamoff start) :
-        image_buffer<boost::float64_t>(width, height)
+    //! reads the image starting at start of file with positioned reads
+    void read_image
+    (
+        byte_source const& file,
+        std::size_t image_width,
+        std::size_t image_height,
+        std::streamoff start
+    )
     {
-        std::fstream image_file(file);
-        image_file.seekg(start);
-        read_image_logic(image_file);
-        image_file.close();
+        this->resize(image_width, image_height);
+        this->read_big_endian(file, static_cast<std::uint64_t>(start));
     }
 
-    image(std::string const& file, std::size_t width, std::size_t height) :
-        image_buffer<boost::float64_t>(width, height)
+    //! reads the image of pixels stored with bitpix stored starting at start of file as
+    //! physical values BZERO + BSCALE * stored value, stored values equal to BLANK become NaN
+    //! e.g. unsigned 16 bit pixels (BITPIX = 16, BZERO = 32768) read into image<bitpix::_B32>
+    void read_physical_image
+    (
+        byte_source const& file,
+        std::size_t image_width,
+        std::size_t image_height,
+        std::streamoff start,
+        bitpix stored,
+        pixel_scaling const& scaling
+    )
     {
-        std::fstream image_file(file);
-        read_image_logic(image_file);
-        image_file.close();
+        static_assert(std::is_floating_point<pixel_type>::value,
+            "physical values are read into images of floating point pixels");
+        this->resize(image_width, image_height);
+        this->read_physical(file, static_cast<std::uint64_t>(start), stored, scaling);
     }
 
-    image(std::fstream &file, std::size_t width, std::size_t height, std::streamoff start)
+    //! reads the physical values of image from current position of stream
+    void read_physical_image
+    (
+        std::istream &file,
+        std::size_t image_width,
+        std::size_t image_height,
+        bitpix stored,
+        pixel_scaling const& scaling
+    )
     {
-        read_image(file, width, height, start);
+        static_assert(std::is_floating_point<pixel_type>::value,
+            "physical values are read into images of floating point pixels");
+        this->resize(image_width, image_height);
+        this->read_physical(file, stored, scaling);
     }
 
-    image(std::fstream &file, std::size_t width, std::size_t height)
+    //! reads only the pixels selected by ranges of the image starting at start of file
+    //! naxis contains the values of all the naxis (NAXIS, NAXIS1, NAXIS2...) and missing
+    //! ranges select the whole axis, width of cutout is the size of range along NAXIS1
+    //! and height is the product of the sizes along remaining axes
+    //! rows adjacent in file are read together with a single positioned read
+    void read_cutout
+    (
+        byte_source const& file,
+        std::streamoff start,
+        std::vector<std::size_t> const& naxis,
+        std::vector<axis_range> const& ranges
+    )
     {
-        read_image(file, width, height);
-    }
+        std::vector<std::size_t> const axes(naxis.empty() ? naxis.begin() : naxis.begin() + 1,
+            naxis.end());
+        if (axes.empty())
+        {
+            this->resize(0, 0);
+            return;
+        }
+        std::vector<axis_range> const selected = detail::cutout_ranges(ranges, axes);
 
-    void read_image_logic(std::fstream &image_file)
-    {
-        pixel_data single_pixel;
-        for (std::size_t i = 0; i < height*width; i++)
+        std::size_t rows = 1;
+        for (std::size_t i = 1; i < selected.size(); i++)
+        {
+            rows *= selected[i].size();
+        }
+        std::size_t const row_pixels = selected[0].size();
+        this->resize(row_pixels, rows);
+
+        //pixels between the first and last selected pixel of a row
+        std::size_t const span = (row_pixels - 1) * selected[0].stride + 1;
+        std::size_t const max_run = (std::max)(run_bytes / (span * sizeof(pixel_type)),
+            std::size_t(1));
+
+        std::vector<std::size_t> index(selected.size(), 0); //output row along each axis
+        std::size_t run_first_row = 0; //first output row of the run of adjacent rows
+        std::size_t run_pixel = 0; //first pixel of run in file
+        std::size_t run_rows = 0;
+
+        for (std::size_t row = 0; row < rows; row++)
         {
-            image_file.read((char*)single_pixel.byte, 8);
-            data[i] = (single_pixel.byte[7] << 0) | (single_pixel.byte[6] << 8) |
-                (single_pixel.byte[5] << 16) | (single_pixel.byte[4] << 24) |
-                (single_pixel.byte[3] << 32) | (single_pixel.byte[2] << 40) |
-                (single_pixel.byte[1] << 48) | (single_pixel.byte[0] << 56);
+            std::size_t pixel = selected[0].first;
+            std::size_t pitch = axes[0];
+            for (std::size_t i = 1; i < selected.size(); i++)
+            {
+                pixel += (selected[i].first + index[i] * selected[i].stride) * pitch;
+                pitch *= axes[i];
+            }
+
+            if (run_rows != 0 && (pixel != run_pixel + run_rows * axes[0] ||
+                span != axes[0] || run_rows == max_run))
+            {
+                read_run(file, start, run_pixel, run_first_row, run_rows, span, selected[0].stride);
+                run_rows = 0;
+            }
+            if (run_rows == 0)
+            {
+                run_first_row = row;
+                run_pixel = pixel;
+            }
+            run_rows++;
+
+            for (std::size_t i = 1; i < selected.size(); i++)
+            {
+                if (++index[i] < selected[i].size())
+                {
+                    break;
+                }
+                index[i] = 0;
+            }
         }
+        read_run(file, start, run_pixel, run_first_row, run_rows, span, selected[0].stride);
     }
 
-    void read_image
+    //! reads the cutout of image from the file at path
+    void read_cutout
     (
         std::string const& file,
-        std::size_t width,
-        std::size_t height,
-        std::streamoff start
+        std::streamoff start,
+        std::vector<std::size_t> const& naxis,
+        std::vector<axis_range> const& ranges
     )
     {
-        std::fstream image_file(file);
-        data.resize(width*height);
-        image_file.seekg(start);
-
-        read_image_logic(image_file);
-
-        image_file.close();
+        read_cutout(file_source(file), start, naxis, ranges);
     }
 
-    void read_image(std::string const& file, std::size_t width, std::size_t height)
-    {
-        read_image(file, width, height, 0);
-    }
+private:
+    //! maximum number of bytes read by a single positioned read of a cutout
+    static constexpr std::size_t run_bytes = std::size_t(8) << 20;
 
-    void read_image(std::fstream &file, std::size_t width, std::size_t height, std::streamoff start)
+    //! reads rows of cutout which are adjacent in file (or a single row if rows are strided)
+    void read_run
+    (
+        byte_source const& file,
+        std::streamoff start,
+        std::size_t first_pixel,
+        std::size_t first_row,
+        std::size_t rows,
+        std::size_t span,
+        std::size_t stride
+    )
     {
-        data.resize(width*height);
-        file.seekg(start);
+        std::size_t const row_pixels = this->width;
+        pixel_type* destination = std::begin(this->data) + first_row * row_pixels;
+        std::uint64_t const offset = static_cast<std::uint64_t>(start) +
+            static_cast<std::uint64_t>(first_pixel) * sizeof(pixel_type);
 
-        read_image_logic(file);
-    }
-
-    void read_image(std::fstream &file, std::size_t width, std::size_t height)
-    {
-        read_image(file, width, height, file.tellg());
+        if (stride == 1)
+        {
+            //rows are contiguous in file as well as in image
+            file.read_at(destination, rows * row_pixels * sizeof(pixel_type), offset);
+        }
+        else
+        {
+            using raw_type = typename detail::uint_of_size<sizeof(pixel_type)>::type;
+            std::vector<raw_type> raw(rows * span);
+            file.read_at(raw.data(), raw.size() * sizeof(raw_type), offset);
+            for (std::size_t r = 0; r < rows; r++)
+            {
+                for (std::size_t i = 0; i < row_pixels; i++)
+                {
+                    std::memcpy(destination + r * row_pixels + i, &raw[r * span + i * stride],
+                        sizeof(raw_type));
+                }
+            }
+        }
+        detail::big_to_native_inplace(destination, rows * row_pixels);
     }
 };
 
@@ -6,9 +6,11 @@
 #include <cstddef>
 #include <valarray>
 
+#include <boost/astronomy/io/byte_source.hpp>
 #include <boost/astronomy/io/hdu.hpp>
 #include <boost/astronomy/io/extension_hdu.hpp>
 #include <boost/astronomy/io/image.hpp>
+#include <boost/astronomy/io/image_view.hpp>
 
 namespace boost { namespace astronomy { namespace io {
 
@@ -19,7 +21,7 @@ protected:
     image<DataType> data;
 
 public:
-    image_extension(std::fstream &file) : extension_hdu(file)
+    image_extension(std::istream &file) : extension_hdu(file)
     {
         //read image according to dimension specified by naxis
         switch (this->naxis())
@@ -33,14 +35,14 @@ public:
             data.read_image(file, this->naxis(1), this->naxis(2));
             break;
         default:
-            data.read_image(file, this->naxis(1), std::accumulate(this->naxis_.begin()+ 1,
-                this->naxis_.end(), 0, std::multiplies<std::size_t>()));
+            data.read_image(file, this->naxis(1), std::accumulate(this->naxis_.begin() + 2,
+                this->naxis_.end(), std::size_t(1), std::multiplies<std::size_t>()));
             break;
         }
         set_unit_end(file);
     }
 
-    image_extension(std::fstream &file, hdu const& other) : extension_hdu(file, other)
+    image_extension(std::istream &file, hdu const& other) : extension_hdu(file, other)
     {
         //read image according to dimension specified by naxis
         switch (this->naxis())
@@ -54,14 +56,14 @@ public:
             data.read_image(file, this->naxis(1), this->naxis(2));
             break;
         default:
-            data.read_image(file, this->naxis(1), std::accumulate(this->naxis_.begin()+ 1,
-                this->naxis_.end(), 0, std::multiplies<std::size_t>()));
+            data.read_image(file, this->naxis(1), std::accumulate(this->naxis_.begin() + 2,
+                this->naxis_.end(), std::size_t(1), std::multiplies<std::size_t>()));
             break;
         }
         set_unit_end(file);
     }
 
-    image_extension(std::fstream &file, std::streampos pos) : extension_hdu(file, pos)
+    image_extension(std::istream &file, std::streampos pos) : extension_hdu(file, pos)
     {
         //read image according to dimension specified by naxis
         switch (this->naxis())
@@ -75,12 +77,51 @@ public:
             data.read_image(file, this->naxis(1), this->naxis(2));
             break;
         default:
-            data.read_image(file, this->naxis(1), std::accumulate(this->naxis_.begin()+ 1,
-                this->naxis_.end(), 0, std::multiplies<std::size_t>()));
+            data.read_image(file, this->naxis(1), std::accumulate(this->naxis_.begin() + 2,
+                this->naxis_.end(), std::size_t(1), std::multiplies<std::size_t>()));
             break;
         }
         set_unit_end(file);
     }
+
+    //!reads the data unit at data_offset of file with positioned reads, used to read
+    //!many extensions of a file concurrently
+    image_extension
+    (
+        byte_source const& file,
+        std::streamoff data_offset,
+        hdu const& other
+    ) : extension_hdu(other)
+    {
+        //read image according to dimension specified by naxis
+        switch (this->naxis())
+        {
+        case 0:
+            break;
+        case 1:
+            data.read_image(file, this->naxis(1), 1, data_offset);
+            break;
+        case 2:
+            data.read_image(file, this->naxis(1), this->naxis(2), data_offset);
+            break;
+        default:
+            data.read_image(file, this->naxis(1), std::accumulate(this->naxis_.begin() + 2,
+                this->naxis_.end(), std::size_t(1), std::multiplies<std::size_t>()), data_offset);
+            break;
+        }
+    }
+
+    //!pixels are decoded from the view of the data unit available in memory
+    image_extension(image_view<DataType> const& view, hdu const& other) : extension_hdu(other)
+    {
+        data = view.decode();
+    }
+
+    //!returnes the stored data
+    image<DataType> get_data() const
+    {
+        return this->data;
+    }
 };
 
 }}} //namespace boost::astronomy::io
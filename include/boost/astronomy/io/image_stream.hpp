@@ -0,0 +1,271 @@
+#ifndef BOOST_ASTRONOMY_IO_IMAGE_STREAM_HPP
+#define BOOST_ASTRONOMY_IO_IMAGE_STREAM_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <algorithm>
+
+#include <boost/astronomy/io/bitpix.hpp>
+#include <boost/astronomy/io/hdu_index.hpp>
+#include <boost/astronomy/io/gzip_istream.hpp>
+#include <boost/astronomy/detail/byteswap.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+//! decoded rows of an image read by image_stream
+//! for a stack the same rows of every plane are stored one plane after another
+template <typename PixelType>
+struct image_block
+{
+    PixelType const* data = nullptr; //! pixels in native byte order
+    std::size_t width = 0; //! pixels in a row (NAXIS1)
+    std::size_t rows = 0; //! rows in block (of each plane for a stack)
+    std::size_t planes = 1; //! planes in block, more than 1 only for a stack
+    std::size_t first_row = 0; //! index of first row in image (in its plane for a stack)
+
+    //! returns the number of pixels in block
+    std::size_t size() const
+    {
+        return width * rows * planes;
+    }
+
+    //! returns the pixels of row r of the block (of the given plane for a stack)
+    PixelType const* row(std::size_t r, std::size_t plane = 0) const
+    {
+        return data + (plane * rows + r) * width;
+    }
+};
+
+/*!
+Reads an image HDU in blocks of rows so that images larger than memory can be processed.
+Rows of all the axes after NAXIS1 are counted together (row r of plane p is p * NAXIS2 + r)
+and the buffer never holds more than the configured number of bytes (or a single row,
+plane or stack row if that is larger). Blocks are decoded to native byte order and are valid
+until the next block is read.
+*/
+template <bitpix DataType>
+struct image_stream
+{
+public:
+    using pixel_type = typename bitpix_traits<DataType>::type;
+
+protected:
+    std::unique_ptr<std::istream> owned_file; //! file opened by image_stream
+    std::istream* input = nullptr; //! file read
+    std::streamoff data_start = 0; //! offset of data unit in file
+    std::vector<std::size_t> axes; //! NAXIS1, NAXIS2 ...
+    std::size_t budget; //! bytes of buffer
+    std::size_t next_row = 0; //! row read by next_block
+    std::vector<pixel_type> buffer; //! pixels of last block
+
+public:
+    //! default size of buffer
+    static constexpr std::size_t default_block_bytes = std::size_t(4) << 20;
+
+    //! streams the image whose data unit starts at data_offset of file
+    //! naxis contains the values of all the naxis (NAXIS, NAXIS1, NAXIS2...)
+    image_stream
+    (
+        std::istream& file,
+        std::streamoff data_offset,
+        std::vector<std::size_t> const& naxis,
+        std::size_t block_bytes = default_block_bytes
+    ) :
+        input(&file),
+        data_start(data_offset),
+        axes(naxis.empty() ? naxis.begin() : naxis.begin() + 1, naxis.end()),
+        budget(block_bytes)
+    {
+        rewind();
+    }
+
+    //! streams the image HDU described by entry of the index of file at path, gzip compressed
+    //! files are decompressed while they are read (seeking back to an earlier row, e.g. by
+    //! rewind or for every block of for_each_stack, decompresses the file again)
+    image_stream
+    (
+        std::string const& path,
+        hdu_entry const& entry,
+        std::size_t block_bytes = default_block_bytes
+    ) :
+        owned_file(open_fits_stream(path)),
+        input(owned_file.get()),
+        data_start(entry.data_offset),
+        axes(entry.naxis.empty() ? entry.naxis.begin() : entry.naxis.begin() + 1,
+            entry.naxis.end()),
+        budget(block_bytes)
+    {
+        if (!*input)
+        {
+            throw fits_exception();
+        }
+        if (entry.bitpix_value != DataType || !(entry.is_primary() || entry.xtension == "IMAGE"))
+        {
+            throw wrong_extension_type();
+        }
+        rewind();
+    }
+
+    //! returns the number of pixels in a row (NAXIS1)
+    std::size_t width() const
+    {
+        return axes.empty() ? 0 : axes[0];
+    }
+
+    //! returns the number of rows in a plane (NAXIS2)
+    std::size_t plane_rows() const
+    {
+        return axes.size() < 2 ? (axes.empty() ? 0 : 1) : axes[1];
+    }
+
+    //! returns the number of planes (product of NAXIS3, NAXIS4...)
+    std::size_t planes() const
+    {
+        std::size_t result = axes.empty() ? 0 : 1;
+        for (std::size_t i = 2; i < axes.size(); i++)
+        {
+            result *= axes[i];
+        }
+        return result;
+    }
+
+    //! returns the number of rows in image counting rows of all the planes
+    std::size_t rows() const
+    {
+        return plane_rows() * planes();
+    }
+
+    //! returns the number of rows read at once by next_block
+    std::size_t block_rows() const
+    {
+        return rows_in_budget(1);
+    }
+
+    //! starts reading again from the first row
+    void rewind()
+    {
+        next_row = 0;
+        seek_row(0);
+    }
+
+    //! reads the next block of rows, returns false after the last row
+    bool next_block(image_block<pixel_type>& block)
+    {
+        if (next_row >= rows())
+        {
+            return false;
+        }
+
+        std::size_t count = (std::min)(block_rows(), rows() - next_row);
+        read_rows(count, 0);
+        block = make_block(next_row, count, 1);
+        next_row += count;
+        return true;
+    }
+
+    //! calls f(image_block const&) for every block of rows from the first row
+    template <typename Function>
+    void for_each_block(Function f)
+    {
+        rewind();
+        image_block<pixel_type> block;
+        while (next_block(block))
+        {
+            f(block);
+        }
+    }
+
+    //! calls f(image_block const&) for every plane, block holds the whole plane
+    template <typename Function>
+    void for_each_plane(Function f)
+    {
+        std::size_t const plane = plane_rows();
+        for (std::size_t p = 0; p < planes(); p++)
+        {
+            seek_row(p * plane);
+            read_rows(plane, 0);
+            f(make_block(p * plane, plane, 1));
+        }
+        rewind();
+    }
+
+    //! calls f(image_block const&) with the same block of rows from every plane
+    //! (e.g. to stack the planes of a cube pixel by pixel), rows are chosen so that
+    //! the rows of all the planes fit in the buffer
+    template <typename Function>
+    void for_each_stack(Function f)
+    {
+        std::size_t const plane = plane_rows();
+        std::size_t const stack = planes();
+        std::size_t const step = (std::min)(rows_in_budget(stack), plane);
+
+        for (std::size_t first = 0; first < plane; first += step)
+        {
+            std::size_t count = (std::min)(step, plane - first);
+            for (std::size_t p = 0; p < stack; p++)
+            {
+                seek_row(p * plane + first);
+                read_rows(count, p * count * width());
+            }
+            f(make_block(first, count, stack));
+        }
+        rewind();
+    }
+
+protected:
+    //! rows of every plane that fit in budget, atleast one
+    std::size_t rows_in_budget(std::size_t stack) const
+    {
+        std::size_t row_bytes = width() * stack * sizeof(pixel_type);
+        if (row_bytes == 0)
+        {
+            return 1;
+        }
+        return (std::max)(budget / row_bytes, std::size_t(1));
+    }
+
+    void seek_row(std::size_t row)
+    {
+        input->clear();
+        input->seekg(data_start +
+            static_cast<std::streamoff>(row * width() * sizeof(pixel_type)));
+    }
+
+    //! reads count rows from current position into buffer at offset (in pixels)
+    void read_rows(std::size_t count, std::size_t offset)
+    {
+        std::size_t const pixels = count * width();
+        if (buffer.size() < offset + pixels)
+        {
+            buffer.resize(offset + pixels);
+        }
+
+        input->read(reinterpret_cast<char*>(buffer.data() + offset),
+            static_cast<std::streamsize>(pixels * sizeof(pixel_type)));
+        if (!*input)
+        {
+            throw fits_exception();
+        }
+        detail::big_to_native_inplace(buffer.data() + offset, pixels);
+    }
+
+    image_block<pixel_type> make_block(std::size_t first_row, std::size_t count,
+        std::size_t stack) const
+    {
+        image_block<pixel_type> block;
+        block.data = buffer.data();
+        block.width = width();
+        block.rows = count;
+        block.planes = stack;
+        block.first_row = first_row;
+        return block;
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_IMAGE_STREAM_HPP
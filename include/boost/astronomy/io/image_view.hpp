@@ -0,0 +1,182 @@
+#ifndef BOOST_ASTRONOMY_IO_IMAGE_VIEW_HPP
+#define BOOST_ASTRONOMY_IO_IMAGE_VIEW_HPP
+
+#include <cstddef>
+#include <type_traits>
+
+#include <boost/astronomy/io/bitpix.hpp>
+#include <boost/astronomy/io/image.hpp>
+#include <boost/astronomy/detail/byteswap.hpp>
+#include <boost/astronomy/detail/physical.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+//! non-owning view of the big-endian pixels of an image stored in memory
+//! (usually a memory mapped FITS file), pixels are decoded only when accessed
+template <bitpix DataType>
+struct image_view
+{
+public:
+    using pixel_type = typename bitpix_traits<DataType>::type;
+
+protected:
+    char const* bytes_ = nullptr; //! first byte of the image in memory
+    std::size_t width_ = 0; //! width of image
+    std::size_t height_ = 0; //! height of image
+
+public:
+    image_view() {}
+
+    image_view(char const* bytes, std::size_t width, std::size_t height) :
+        bytes_(bytes), width_(width), height_(height) {}
+
+    //! returns the width of image
+    std::size_t width() const
+    {
+        return this->width_;
+    }
+
+    //! returns the height of image
+    std::size_t height() const
+    {
+        return this->height_;
+    }
+
+    //! returns the number of pixels in the image
+    std::size_t size() const
+    {
+        return this->width_ * this->height_;
+    }
+
+    //! returns the raw (big-endian) bytes of the image
+    char const* bytes() const
+    {
+        return this->bytes_;
+    }
+
+    //! returns the pixel at index i decoded to native byte order
+    pixel_type operator[] (std::size_t i) const
+    {
+        return detail::load_big_endian<pixel_type>(this->bytes_ + i * sizeof(pixel_type));
+    }
+
+    //! returns the pixel decoded to native byte order
+    //! uses the same indexing as boost::astronomy::io::image_buffer
+    pixel_type operator() (std::size_t x, std::size_t y) const
+    {
+        return (*this)[(x*this->width_) + y];
+    }
+
+    //! decodes count pixels starting from index first into the destination
+    void decode(pixel_type* destination, std::size_t first, std::size_t count) const
+    {
+        detail::big_to_native_copy(this->bytes_ + first * sizeof(pixel_type),
+            destination, count);
+    }
+
+    //! decodes the whole view into an owning image
+    image<DataType> decode() const
+    {
+        image<DataType> result;
+        result.decode_image(this->bytes_, this->width_, this->height_);
+        return result;
+    }
+};
+
+//! non-owning view of the pixels of an image stored in memory as physical values
+//! BZERO + BSCALE * stored value of type DataType (stored values equal to BLANK are NaN)
+//! pixels stored with bitpix stored are decoded, converted and scaled only when accessed
+template <bitpix DataType = bitpix::_B32>
+struct physical_view
+{
+public:
+    using pixel_type = typename bitpix_traits<DataType>::type;
+
+    static_assert(std::is_floating_point<pixel_type>::value,
+        "physical values are decoded to floating point pixels");
+
+protected:
+    char const* bytes_ = nullptr; //! first byte of the image in memory
+    std::size_t width_ = 0; //! width of image
+    std::size_t height_ = 0; //! height of image
+    bitpix stored_ = bitpix::B8; //! bitpix of pixels in memory
+    pixel_scaling scaling_; //! BSCALE, BZERO and BLANK of image
+
+public:
+    physical_view() {}
+
+    physical_view
+    (
+        char const* bytes,
+        std::size_t width,
+        std::size_t height,
+        bitpix stored,
+        pixel_scaling const& scaling
+    ) : bytes_(bytes), width_(width), height_(height), stored_(stored), scaling_(scaling) {}
+
+    //! returns the width of image
+    std::size_t width() const
+    {
+        return this->width_;
+    }
+
+    //! returns the height of image
+    std::size_t height() const
+    {
+        return this->height_;
+    }
+
+    //! returns the number of pixels in the image
+    std::size_t size() const
+    {
+        return this->width_ * this->height_;
+    }
+
+    //! returns the bitpix of pixels stored in memory
+    bitpix stored_bitpix() const
+    {
+        return this->stored_;
+    }
+
+    //! returns the scaling applied to stored pixels
+    pixel_scaling const& scaling() const
+    {
+        return this->scaling_;
+    }
+
+    //! returns the physical value of pixel at index i
+    pixel_type operator[] (std::size_t i) const
+    {
+        pixel_type value;
+        decode(&value, i, 1);
+        return value;
+    }
+
+    //! returns the physical value of pixel
+    //! uses the same indexing as boost::astronomy::io::image_buffer
+    pixel_type operator() (std::size_t x, std::size_t y) const
+    {
+        return (*this)[(x*this->width_) + y];
+    }
+
+    //! decodes the physical values of count pixels starting from index first into the
+    //! destination in a single pass
+    void decode(pixel_type* destination, std::size_t first, std::size_t count) const
+    {
+        detail::big_to_physical(this->stored_, this->bytes_ + first * bitpix_size(this->stored_),
+            destination, count, this->scaling_);
+    }
+
+    //! decodes the physical values of whole view into an owning image
+    image<DataType> decode() const
+    {
+        image<DataType> result;
+        result.decode_physical(this->bytes_, this->width_, this->height_, this->stored_,
+            this->scaling_);
+        return result;
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_IMAGE_VIEW_HPP
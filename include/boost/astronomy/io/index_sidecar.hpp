@@ -0,0 +1,467 @@
+#ifndef BOOST_ASTRONOMY_IO_INDEX_SIDECAR_HPP
+#define BOOST_ASTRONOMY_IO_INDEX_SIDECAR_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <boost/endian/conversion.hpp>
+
+#include <boost/astronomy/io/bitpix.hpp>
+#include <boost/astronomy/io/card.hpp>
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/hdu_index.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// size and modification time used to detect that a file changed after its index was saved
+struct file_signature
+{
+    std::uint64_t size = 0;
+    std::int64_t mtime_sec = 0;
+    std::int64_t mtime_nsec = 0;
+};
+
+inline bool get_file_signature(std::string const& path, file_signature& signature)
+{
+#if defined(_WIN32)
+    struct _stat64 status;
+    if (_stat64(path.c_str(), &status) != 0)
+    {
+        return false;
+    }
+#else
+    struct stat status;
+    if (::stat(path.c_str(), &status) != 0)
+    {
+        return false;
+    }
+#endif
+
+    signature.size = static_cast<std::uint64_t>(status.st_size);
+    signature.mtime_sec = static_cast<std::int64_t>(status.st_mtime);
+#if defined(__linux__)
+    signature.mtime_nsec = static_cast<std::int64_t>(status.st_mtim.tv_nsec);
+#elif defined(__APPLE__)
+    signature.mtime_nsec = static_cast<std::int64_t>(status.st_mtimespec.tv_nsec);
+#endif
+    return true;
+}
+
+inline bool same_signature(file_signature const& a, file_signature const& b)
+{
+    return a.size == b.size && a.mtime_sec == b.mtime_sec && a.mtime_nsec == b.mtime_nsec;
+}
+
+// appends little-endian fields to the sidecar buffer
+struct sidecar_writer
+{
+    std::string buffer;
+
+    template <typename T>
+    void put(T value)
+    {
+        T little = boost::endian::native_to_little(value);
+        buffer.append(reinterpret_cast<char const*>(&little), sizeof(T));
+    }
+
+    void put(std::string const& value)
+    {
+        put(static_cast<std::uint32_t>(value.size()));
+        buffer.append(value);
+    }
+};
+
+// reads little-endian fields from the sidecar buffer, ok is cleared on truncated input
+struct sidecar_reader
+{
+    char const* current;
+    char const* end;
+    bool ok = true;
+
+    sidecar_reader(char const* first, char const* last) : current(first), end(last) {}
+
+    template <typename T>
+    T get()
+    {
+        T value = T();
+        if (static_cast<std::size_t>(end - current) < sizeof(T))
+        {
+            ok = false;
+            return value;
+        }
+        std::memcpy(&value, current, sizeof(T));
+        current += sizeof(T);
+        return boost::endian::little_to_native(value);
+    }
+
+    std::string get_string()
+    {
+        std::size_t length = get<std::uint32_t>();
+        char const* first = get_bytes(length);
+        return ok ? std::string(first, length) : std::string();
+    }
+
+    // reads the number of elements that follow, a count larger than the remaining bytes
+    // can only come from a corrupt sidecar
+    std::size_t get_count()
+    {
+        std::size_t count = static_cast<std::size_t>(get<std::uint64_t>());
+        if (count > static_cast<std::size_t>(end - current))
+        {
+            ok = false;
+            return 0;
+        }
+        return count;
+    }
+
+    char const* get_bytes(std::size_t length)
+    {
+        if (!ok || static_cast<std::size_t>(end - current) < length)
+        {
+            ok = false;
+            return current;
+        }
+        current += length;
+        return current - length;
+    }
+};
+
+// first bytes of every sidecar
+inline char const* sidecar_magic()
+{
+    return "ASTRFIDX";
+}
+
+std::size_t const sidecar_magic_size = 8;
+std::uint32_t const sidecar_version = 2;
+
+inline int bitpix_to_int(io::bitpix value)
+{
+    switch (value)
+    {
+    case io::bitpix::B8:
+        return 8;
+    case io::bitpix::B16:
+        return 16;
+    case io::bitpix::B32:
+        return 32;
+    case io::bitpix::_B32:
+        return -32;
+    case io::bitpix::_B64:
+        return -64;
+    }
+    return 0;
+}
+
+inline bool int_to_bitpix(int value, io::bitpix& result)
+{
+    switch (value)
+    {
+    case 8:
+        result = io::bitpix::B8;
+        return true;
+    case 16:
+        result = io::bitpix::B16;
+        return true;
+    case 32:
+        result = io::bitpix::B32;
+        return true;
+    case -32:
+        result = io::bitpix::_B32;
+        return true;
+    case -64:
+        result = io::bitpix::_B64;
+        return true;
+    }
+    return false;
+}
+
+// creates the header from the cards saved in the sidecar
+inline std::shared_ptr<io::hdu> restore_header
+(
+    char const* first,
+    char const* last,
+    io::bitpix bitpix_value,
+    std::vector<std::size_t> const& naxis
+)
+{
+    sidecar_reader reader(first, last);
+
+    std::vector<io::card> cards(reader.get_count());
+    for (io::card& header_card : cards)
+    {
+        char const* raw = reader.get_bytes(80);
+        if (!reader.ok)
+        {
+            throw fits_exception();
+        }
+        header_card = io::card(raw);
+    }
+
+    return std::make_shared<io::hdu>(std::move(cards), bitpix_value, naxis);
+}
+
+// header of an entry restored from the sidecar the first time it is needed and shared by
+// the later calls, which may come from many threads
+class restored_header
+{
+    std::shared_ptr<std::string const> buffer_;
+    std::size_t offset_;
+    std::size_t size_;
+    io::bitpix bitpix_value_;
+    std::vector<std::size_t> naxis_;
+    std::once_flag restored_;
+    std::shared_ptr<io::hdu> header_;
+
+public:
+    restored_header
+    (
+        std::shared_ptr<std::string const> buffer,
+        std::size_t offset,
+        std::size_t size,
+        io::bitpix bitpix_value,
+        std::vector<std::size_t> naxis
+    ) : buffer_(std::move(buffer)), offset_(offset), size_(size), bitpix_value_(bitpix_value),
+        naxis_(std::move(naxis)) {}
+
+    std::shared_ptr<io::hdu> get()
+    {
+        std::call_once(restored_, [this]()
+        {
+            header_ = restore_header(buffer_->data() + offset_,
+                buffer_->data() + offset_ + size_, bitpix_value_, naxis_);
+        });
+        return header_;
+    }
+};
+///@endcond
+
+} //namespace detail
+
+namespace io {
+
+/*!
+The sidecar stores the HDU index of a FITS file along with the cards of every header,
+so reopening the file needs a single read of the sidecar and no parsing of values.
+Cards of a header are restored once, when its HDU is first read. The sidecar records
+the size and modification time of the FITS file taken before its headers were scanned
+and is ignored once the file changes.
+
+All the fields are stored in little-endian byte order
+magic (8 bytes), version (u32), file size (u64), mtime seconds (i64), mtime nanoseconds (i64)
+number of HDU (u64) followed by each HDU as
+header offset, data offset, data size (u64), BITPIX (i32), number of naxis values (u64),
+naxis values (u64), XTENSION, EXTNAME (u32 length + chars), size of the rest of HDU (u64),
+number of cards (u64), cards (80 chars each)
+*/
+
+//! returns the path of the sidecar used for a FITS file by default
+inline std::string default_sidecar_path(std::string const& fits_path)
+{
+    return fits_path + ".idx";
+}
+
+//! reads the index saved by write_index_sidecar
+//! returns false if the sidecar is missing, corrupt or older than the FITS file
+inline bool read_index_sidecar
+(
+    std::string const& sidecar_path,
+    std::string const& fits_path,
+    std::vector<hdu_entry>& index
+)
+{
+    detail::file_signature signature;
+    if (!detail::get_file_signature(fits_path, signature))
+    {
+        return false;
+    }
+
+    std::ifstream file(sidecar_path,
+        std::ios_base::in | std::ios_base::binary | std::ios_base::ate);
+    if (!file)
+    {
+        return false;
+    }
+    auto buffer = std::make_shared<std::string>(static_cast<std::size_t>(file.tellg()), '\0');
+    file.seekg(0);
+    file.read(&(*buffer)[0], static_cast<std::streamsize>(buffer->size()));
+    if (!file)
+    {
+        return false;
+    }
+
+    detail::sidecar_reader reader(buffer->data(), buffer->data() + buffer->size());
+    char const* magic = reader.get_bytes(detail::sidecar_magic_size);
+    if (!reader.ok || std::memcmp(magic, detail::sidecar_magic(), detail::sidecar_magic_size) ||
+        reader.get<std::uint32_t>() != detail::sidecar_version ||
+        reader.get<std::uint64_t>() != signature.size ||
+        reader.get<std::int64_t>() != signature.mtime_sec ||
+        reader.get<std::int64_t>() != signature.mtime_nsec)
+    {
+        return false;
+    }
+
+    std::vector<hdu_entry> result(reader.get_count());
+    for (hdu_entry& entry : result)
+    {
+        entry.header_offset = static_cast<std::streamoff>(reader.get<std::uint64_t>());
+        entry.data_offset = static_cast<std::streamoff>(reader.get<std::uint64_t>());
+        entry.data_size = static_cast<std::size_t>(reader.get<std::uint64_t>());
+        if (!detail::int_to_bitpix(reader.get<std::int32_t>(), entry.bitpix_value))
+        {
+            return false;
+        }
+
+        entry.naxis.resize(reader.get_count());
+        for (std::size_t& naxis : entry.naxis)
+        {
+            naxis = static_cast<std::size_t>(reader.get<std::uint64_t>());
+        }
+        entry.xtension = reader.get_string();
+        entry.extname = reader.get_string();
+
+        //cards are only skipped here and restored when the HDU is first read
+        std::size_t header_size = reader.get_count();
+        std::size_t header_offset = static_cast<std::size_t>(reader.current - buffer->data());
+        reader.get_bytes(header_size);
+
+        auto restored = std::make_shared<detail::restored_header>(buffer, header_offset,
+            header_size, entry.bitpix_value, entry.naxis);
+        entry.restore_header = [restored]()
+        {
+            return restored->get();
+        };
+    }
+
+    if (!reader.ok)
+    {
+        return false;
+    }
+    index = std::move(result);
+    return true;
+}
+
+//! saves the index of FITS file to the sidecar, entries must contain the parsed headers
+//! scanned is the signature of the FITS file taken before its headers were scanned, nothing
+//! is written if the file changed since (the index may describe neither version)
+//! sidecar is written to a temporary file first and then renamed so that a concurrent
+//! reader never sees a partially written sidecar, returns false if it can not be written
+inline bool write_index_sidecar
+(
+    std::string const& sidecar_path,
+    std::string const& fits_path,
+    std::vector<hdu_entry> const& index,
+    detail::file_signature const& scanned
+)
+{
+    detail::file_signature signature;
+    if (!detail::get_file_signature(fits_path, signature) ||
+        !detail::same_signature(signature, scanned))
+    {
+        return false;
+    }
+
+    detail::sidecar_writer writer;
+    writer.buffer.append(detail::sidecar_magic(), detail::sidecar_magic_size);
+    writer.put(detail::sidecar_version);
+    writer.put(signature.size);
+    writer.put(signature.mtime_sec);
+    writer.put(signature.mtime_nsec);
+
+    writer.put(static_cast<std::uint64_t>(index.size()));
+    for (hdu_entry const& entry : index)
+    {
+        if (!entry.header && !entry.restore_header)
+        {
+            return false;
+        }
+
+        writer.put(static_cast<std::uint64_t>(entry.header_offset));
+        writer.put(static_cast<std::uint64_t>(entry.data_offset));
+        writer.put(static_cast<std::uint64_t>(entry.data_size));
+        writer.put(static_cast<std::int32_t>(detail::bitpix_to_int(entry.bitpix_value)));
+
+        writer.put(static_cast<std::uint64_t>(entry.naxis.size()));
+        for (std::size_t naxis : entry.naxis)
+        {
+            writer.put(static_cast<std::uint64_t>(naxis));
+        }
+        writer.put(entry.xtension);
+        writer.put(entry.extname);
+
+        std::shared_ptr<hdu> header = entry.header;
+        if (!header)
+        {
+            header = entry.restore_header();
+        }
+
+        detail::sidecar_writer section;
+        std::vector<card> const& cards = header->get_cards();
+        section.put(static_cast<std::uint64_t>(cards.size()));
+        for (card const& header_card : cards)
+        {
+            section.buffer.append(header_card.data(), 80);
+        }
+
+        writer.put(static_cast<std::uint64_t>(section.buffer.size()));
+        writer.buffer.append(section.buffer);
+    }
+
+    std::random_device random;
+    std::string temp_path = sidecar_path + "." + std::to_string(random()) + ".tmp";
+    {
+        std::ofstream file(temp_path,
+            std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+        file.write(writer.buffer.data(), static_cast<std::streamsize>(writer.buffer.size()));
+        if (!file)
+        {
+            file.close();
+            std::remove(temp_path.c_str());
+            return false;
+        }
+    }
+
+    //rename does not replace an existing file on every platform
+    if (std::rename(temp_path.c_str(), sidecar_path.c_str()) != 0)
+    {
+        std::remove(sidecar_path.c_str());
+        if (std::rename(temp_path.c_str(), sidecar_path.c_str()) != 0)
+        {
+            std::remove(temp_path.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+//! saves the index of FITS file to the sidecar (see write_index_sidecar above) when the file
+//! is known to be unchanged since index was scanned
+inline bool write_index_sidecar
+(
+    std::string const& sidecar_path,
+    std::string const& fits_path,
+    std::vector<hdu_entry> const& index
+)
+{
+    detail::file_signature signature;
+    return detail::get_file_signature(fits_path, signature) &&
+        write_index_sidecar(sidecar_path, fits_path, index, signature);
+}
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_INDEX_SIDECAR_HPP
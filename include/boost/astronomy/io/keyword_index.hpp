@@ -0,0 +1,495 @@
+#ifndef BOOST_ASTRONOMY_IO_KEYWORD_INDEX_HPP
+#define BOOST_ASTRONOMY_IO_KEYWORD_INDEX_HPP
+
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#include <boost/utility/string_view.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+//! keywords of the header which are stored in fixed slots of keyword_index
+enum class keyword : std::uint8_t
+{
+    simple,
+    xtension,
+    bitpix,
+    naxis,
+    extend,
+    pcount,
+    gcount,
+    tfields,
+    extname,
+    bscale,
+    bzero,
+    blank,
+    end
+};
+
+//! indexed keywords (NAXISn, TFORMn ...) whose cards are stored in fixed slots by index
+enum class indexed_keyword : std::uint8_t
+{
+    naxis,
+    tform,
+    ttype,
+    tunit,
+    tbcol,
+    tscal,
+    tzero,
+    tnull,
+    tdim
+};
+
+}}} //namespace boost::astronomy::io
+
+namespace boost { namespace astronomy { namespace detail {
+
+///@cond INTERNAL
+// keyword padded with spaces to 8 chars packed in an integer, first char in the most
+// significant byte, a packed keyword is never 0 so 0 marks an empty slot
+constexpr std::uint64_t pack_keyword(char const* key, std::size_t length)
+{
+    std::uint64_t packed = 0;
+    for (std::size_t i = 0; i < 8; i++)
+    {
+        packed = (packed << 8) | static_cast<unsigned char>(i < length ? key[i] : ' ');
+    }
+    return packed;
+}
+
+template <std::size_t N>
+constexpr std::uint64_t pack_keyword(char const (&key)[N])
+{
+    return pack_keyword(key, N - 1);
+}
+
+// card index used for keywords which are not present
+std::uint32_t const absent_card = 0xFFFFFFFF;
+
+std::size_t const keyword_count = static_cast<std::size_t>(io::keyword::end) + 1;
+std::size_t const indexed_keyword_count = static_cast<std::size_t>(io::indexed_keyword::tdim) + 1;
+
+inline bool fixed_keyword(std::uint64_t packed, io::keyword& result)
+{
+    switch (packed)
+    {
+    case pack_keyword("SIMPLE"):
+        result = io::keyword::simple;
+        return true;
+    case pack_keyword("XTENSION"):
+        result = io::keyword::xtension;
+        return true;
+    case pack_keyword("BITPIX"):
+        result = io::keyword::bitpix;
+        return true;
+    case pack_keyword("NAXIS"):
+        result = io::keyword::naxis;
+        return true;
+    case pack_keyword("EXTEND"):
+        result = io::keyword::extend;
+        return true;
+    case pack_keyword("PCOUNT"):
+        result = io::keyword::pcount;
+        return true;
+    case pack_keyword("GCOUNT"):
+        result = io::keyword::gcount;
+        return true;
+    case pack_keyword("TFIELDS"):
+        result = io::keyword::tfields;
+        return true;
+    case pack_keyword("EXTNAME"):
+        result = io::keyword::extname;
+        return true;
+    case pack_keyword("BSCALE"):
+        result = io::keyword::bscale;
+        return true;
+    case pack_keyword("BZERO"):
+        result = io::keyword::bzero;
+        return true;
+    case pack_keyword("BLANK"):
+        result = io::keyword::blank;
+        return true;
+    case pack_keyword("END"):
+        result = io::keyword::end;
+        return true;
+    }
+    return false;
+}
+
+inline bool indexed_prefix(std::uint64_t packed_prefix, io::indexed_keyword& result)
+{
+    switch (packed_prefix)
+    {
+    case pack_keyword("NAXIS"):
+        result = io::indexed_keyword::naxis;
+        return true;
+    case pack_keyword("TFORM"):
+        result = io::indexed_keyword::tform;
+        return true;
+    case pack_keyword("TTYPE"):
+        result = io::indexed_keyword::ttype;
+        return true;
+    case pack_keyword("TUNIT"):
+        result = io::indexed_keyword::tunit;
+        return true;
+    case pack_keyword("TBCOL"):
+        result = io::indexed_keyword::tbcol;
+        return true;
+    case pack_keyword("TSCAL"):
+        result = io::indexed_keyword::tscal;
+        return true;
+    case pack_keyword("TZERO"):
+        result = io::indexed_keyword::tzero;
+        return true;
+    case pack_keyword("TNULL"):
+        result = io::indexed_keyword::tnull;
+        return true;
+    case pack_keyword("TDIM"):
+        result = io::indexed_keyword::tdim;
+        return true;
+    }
+    return false;
+}
+
+// splits the 8 chars of a keyword like NAXIS12 into the packed prefix and the index 12
+// returns false if the keyword does not end with an index (leading zeros are not allowed)
+inline bool split_indexed_keyword(char const* key, std::uint64_t& packed_prefix, std::size_t& n)
+{
+    std::size_t length = 8;
+    while (length > 0 && key[length - 1] == ' ')
+    {
+        length--;
+    }
+
+    std::size_t digits = length;
+    while (digits > 0 && key[digits - 1] >= '0' && key[digits - 1] <= '9')
+    {
+        digits--;
+    }
+    if (digits == 0 || digits == length || key[digits] == '0')
+    {
+        return false;
+    }
+
+    n = 0;
+    for (std::size_t i = digits; i < length; i++)
+    {
+        n = n * 10 + static_cast<std::size_t>(key[i] - '0');
+    }
+    packed_prefix = pack_keyword(key, digits);
+    return true;
+}
+///@endcond
+
+} //namespace detail
+
+namespace io {
+
+/*!
+Index from keyword to cards of a header.
+Keywords are packed in 64 bit integers and stored in a flat open addressing table so that
+lookup hashes a single integer and never allocates. The cards of mandatory and reserved
+keywords are also stored in fixed slots which are accessed directly.
+Keywords which appear more than once (HISTORY, COMMENT...) are chained in the order of cards,
+lookup of a single card returns the last occurrence.
+*/
+struct keyword_index
+{
+protected:
+    struct slot
+    {
+        std::uint64_t key = 0;
+        std::uint32_t first = detail::absent_card;
+        std::uint32_t last = detail::absent_card;
+        std::uint32_t count = 0;
+    };
+
+    std::vector<slot> slots; //! hash table, size is a power of 2
+    std::vector<std::uint32_t> next; //! next card with the same keyword for every card
+    std::array<std::uint32_t, detail::keyword_count> fixed; //! card of every fixed keyword
+    //! cards of indexed keywords by family and index
+    std::array<std::vector<std::uint32_t>, detail::indexed_keyword_count> indexed;
+    std::size_t keywords = 0; //! number of distinct keywords
+    unsigned shift = 64; //! shift of hashes to the bits of slot index
+
+public:
+    //! forward range over the indices of all the cards with the same keyword
+    struct card_range
+    {
+    protected:
+        std::vector<std::uint32_t> const* next; //! next card of every card
+        std::uint32_t first; //! first card of range
+
+    public:
+        struct iterator
+        {
+        protected:
+            std::vector<std::uint32_t> const* next; //! next card of every card
+            std::uint32_t current; //! card of iterator
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::size_t const*;
+            using reference = std::size_t;
+
+            iterator(std::vector<std::uint32_t> const* next_card, std::uint32_t card)
+                : next(next_card), current(card) {}
+
+            std::size_t operator*() const
+            {
+                return current;
+            }
+
+            iterator& operator++()
+            {
+                current = (*next)[current];
+                return *this;
+            }
+
+            iterator operator++(int)
+            {
+                iterator previous = *this;
+                ++*this;
+                return previous;
+            }
+
+            bool operator==(iterator const& other) const
+            {
+                return current == other.current;
+            }
+
+            bool operator!=(iterator const& other) const
+            {
+                return current != other.current;
+            }
+        };
+
+        card_range(std::vector<std::uint32_t> const* next_card, std::uint32_t first_card)
+            : next(next_card), first(first_card) {}
+
+        iterator begin() const
+        {
+            return iterator(next, first);
+        }
+
+        iterator end() const
+        {
+            return iterator(next, detail::absent_card);
+        }
+
+        bool empty() const
+        {
+            return first == detail::absent_card;
+        }
+    };
+
+    keyword_index()
+    {
+        fixed.fill(detail::absent_card);
+    }
+
+    //! reserves the space for the given number of cards
+    void reserve(std::size_t cards)
+    {
+        next.reserve(cards);
+        std::size_t capacity = 64;
+        while (capacity < 2 * cards)
+        {
+            capacity *= 2;
+        }
+        if (capacity > slots.size())
+        {
+            rehash(capacity);
+        }
+    }
+
+    //! adds the keyword (first 8 chars of card) of the card following the cards added so far
+    void push_back(char const* key)
+    {
+        std::uint32_t const card_index = static_cast<std::uint32_t>(next.size());
+        next.push_back(detail::absent_card);
+
+        if (2 * (keywords + 1) > slots.size())
+        {
+            rehash(slots.empty() ? 64 : 2 * slots.size());
+        }
+
+        std::uint64_t const packed = detail::pack_keyword(key, 8);
+        slot& entry = slots[probe(packed)];
+        if (entry.key == 0)
+        {
+            entry.key = packed;
+            entry.first = card_index;
+            keywords++;
+        }
+        else
+        {
+            next[entry.last] = card_index;
+        }
+        entry.last = card_index;
+        entry.count++;
+
+        io::keyword fixed_key;
+        io::indexed_keyword family;
+        std::uint64_t packed_prefix;
+        std::size_t n;
+        if (detail::fixed_keyword(packed, fixed_key))
+        {
+            fixed[static_cast<std::size_t>(fixed_key)] = card_index;
+        }
+        else if (detail::split_indexed_keyword(key, packed_prefix, n) &&
+            detail::indexed_prefix(packed_prefix, family))
+        {
+            std::vector<std::uint32_t>& cards = indexed[static_cast<std::size_t>(family)];
+            if (cards.size() < n)
+            {
+                cards.resize(n, detail::absent_card);
+            }
+            cards[n - 1] = card_index;
+        }
+    }
+
+    //! returns the number of cards indexed
+    std::size_t cards() const
+    {
+        return next.size();
+    }
+
+    //! returns the number of distinct keywords
+    std::size_t size() const
+    {
+        return keywords;
+    }
+
+    //! finds the card of keyword, returns false if keyword is not present
+    bool find(boost::string_view key, std::size_t& card_index) const
+    {
+        return found(find_slot(key).last, card_index);
+    }
+
+    //! finds the card of keyword stored in fixed slot
+    bool find(io::keyword key, std::size_t& card_index) const
+    {
+        return found(fixed[static_cast<std::size_t>(key)], card_index);
+    }
+
+    //! finds the card of n-th indexed keyword (e.g. NAXIS2 for indexed_keyword::naxis, 2)
+    bool find(io::indexed_keyword key, std::size_t n, std::size_t& card_index) const
+    {
+        std::vector<std::uint32_t> const& cards = indexed[static_cast<std::size_t>(key)];
+        if (n == 0 || n > cards.size())
+        {
+            return false;
+        }
+        return found(cards[n - 1], card_index);
+    }
+
+    //! finds the card of keyword formed by prefix followed by n (e.g. "CRVAL", 1 for CRVAL1)
+    //! returns false if the keyword would be longer than the 8 characters of FITS keywords
+    bool find(boost::string_view prefix, std::size_t n, std::size_t& card_index) const
+    {
+        char digits[20];
+        std::size_t count = 0;
+        do
+        {
+            digits[count++] = static_cast<char>('0' + n % 10);
+            n /= 10;
+        } while (n != 0);
+
+        std::size_t length = prefix.size();
+        if (length + count > 8)
+        {
+            return false;
+        }
+        char key[8];
+        prefix.copy(key, length);
+        while (count > 0)
+        {
+            key[length++] = digits[--count];
+        }
+
+        return find(boost::string_view(key, length), card_index);
+    }
+
+    //! returns true if keyword is present
+    bool contains(boost::string_view key) const
+    {
+        return find_slot(key).count != 0;
+    }
+
+    //! returns the number of cards with the keyword
+    std::size_t count(boost::string_view key) const
+    {
+        return find_slot(key).count;
+    }
+
+    //! returns the indices of all the cards with the keyword in the order of cards
+    card_range equal_range(boost::string_view key) const
+    {
+        return card_range(&next, find_slot(key).first);
+    }
+
+protected:
+    static bool found(std::uint32_t index, std::size_t& card_index)
+    {
+        if (index == detail::absent_card)
+        {
+            return false;
+        }
+        card_index = index;
+        return true;
+    }
+
+    //! returns the slot of packed keyword or the empty slot where it should be inserted
+    std::size_t probe(std::uint64_t packed) const
+    {
+        std::size_t const mask = slots.size() - 1;
+        std::size_t position = static_cast<std::size_t>(
+            (packed * 0x9E3779B97F4A7C15ull) >> shift) & mask;
+        while (slots[position].key != 0 && slots[position].key != packed)
+        {
+            position = (position + 1) & mask;
+        }
+        return position;
+    }
+
+    slot const& find_slot(boost::string_view key) const
+    {
+        static slot const empty;
+        if (slots.empty() || key.size() > 8)
+        {
+            return empty;
+        }
+        slot const& entry = slots[probe(detail::pack_keyword(key.data(), key.size()))];
+        return entry.key == 0 ? empty : entry;
+    }
+
+    void rehash(std::size_t capacity)
+    {
+        std::vector<slot> old(capacity);
+        old.swap(slots);
+
+        shift = 64;
+        for (std::size_t size = capacity; size > 1; size /= 2)
+        {
+            shift--;
+        }
+
+        for (slot const& entry : old)
+        {
+            if (entry.key != 0)
+            {
+                slots[probe(entry.key)] = entry;
+            }
+        }
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_KEYWORD_INDEX_HPP
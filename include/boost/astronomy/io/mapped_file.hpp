@@ -0,0 +1,62 @@
+#ifndef BOOST_ASTRONOMY_IO_MAPPED_FILE_HPP
+#define BOOST_ASTRONOMY_IO_MAPPED_FILE_HPP
+
+#include <string>
+#include <cstddef>
+#include <fstream>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+//! read-only memory mapping of a whole file
+struct mapped_file
+{
+protected:
+    boost::interprocess::file_mapping mapping; //! handle of the mapped file
+    boost::interprocess::mapped_region region; //! mapped view of the whole file
+
+public:
+    mapped_file() {}
+
+    mapped_file(std::string const& file_path)
+    {
+        open(file_path);
+    }
+
+    //! maps the file, previously mapped file (if any) is unmapped
+    void open(std::string const& file_path)
+    {
+        mapping = boost::interprocess::file_mapping(
+            file_path.c_str(), boost::interprocess::read_only);
+
+        //mapping an empty file is an error so empty region is kept for it
+        std::ifstream file(file_path, std::ios_base::in | std::ios_base::binary |
+            std::ios_base::ate);
+        if (file.tellg() <= 0)
+        {
+            region = boost::interprocess::mapped_region();
+            return;
+        }
+
+        region = boost::interprocess::mapped_region(mapping, boost::interprocess::read_only);
+        region.advise(boost::interprocess::mapped_region::advice_sequential);
+    }
+
+    //! returns pointer to the first byte of the file
+    char const* data() const
+    {
+        return static_cast<char const*>(region.get_address());
+    }
+
+    //! returns the size of the file in bytes
+    std::size_t size() const
+    {
+        return region.get_size();
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_MAPPED_FILE_HPP
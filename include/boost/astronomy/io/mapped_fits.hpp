@@ -0,0 +1,278 @@
+#ifndef BOOST_ASTRONOMY_IO_MAPPED_FITS_HPP
+#define BOOST_ASTRONOMY_IO_MAPPED_FITS_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <functional>
+
+#include <boost/utility/string_view.hpp>
+
+#include <boost/astronomy/io/bitpix.hpp>
+#include <boost/astronomy/io/card.hpp>
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/primary_hdu.hpp>
+#include <boost/astronomy/io/image_extension.hpp>
+#include <boost/astronomy/io/image_view.hpp>
+#include <boost/astronomy/io/array_view.hpp>
+#include <boost/astronomy/io/binary_table_extension.hpp>
+#include <boost/astronomy/io/mapped_file.hpp>
+#include <boost/astronomy/io/byte_source.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+//! cards of a header held in memory (e.g. in the mapping of mapped_fits) viewed in place,
+//! END and the blank cards after it are left out
+struct header_view
+{
+protected:
+    char const* first_card = nullptr; //! first character of cards
+    std::size_t card_count = 0; //! number of cards
+
+public:
+    header_view() {}
+
+    //! views count cards of 80 characters starting at cards
+    header_view(char const* cards, std::size_t count) : first_card(cards), card_count(count) {}
+
+    //! returns the number of cards
+    std::size_t size() const
+    {
+        return card_count;
+    }
+
+    //! returns the 80 characters of the card at index
+    boost::string_view text(std::size_t index) const
+    {
+        if (index >= card_count)
+        {
+            throw fits_exception();
+        }
+        return boost::string_view(first_card + index * 80, 80);
+    }
+
+    //! returns the keyword of the card at index without trailing spaces
+    boost::string_view key(std::size_t index) const
+    {
+        boost::string_view key = text(index).substr(0, 8);
+        while (!key.empty() && key.back() == ' ')
+        {
+            key.remove_suffix(1);
+        }
+        return key;
+    }
+
+    //! finds the last card with keyword key, like the value used by hdu for duplicate cards
+    bool find(boost::string_view key, std::size_t& index) const
+    {
+        for (std::size_t i = card_count; i > 0; i--)
+        {
+            if (this->key(i - 1) == key)
+            {
+                index = i - 1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //! returns a copy of the card at index, to parse its value
+    io::card card(std::size_t index) const
+    {
+        return io::card(text(index).data());
+    }
+};
+
+//! FITS file read through a read-only memory mapping (or any byte_source held in memory)
+//! only the headers are parsed while opening, data units are exposed as views into the
+//! mapping and are decoded only when accessed, header cards are also viewed in place by
+//! header_cards
+struct mapped_fits
+{
+protected:
+    //! header of a HDU along with the location of its cards and data unit in the mapping
+    struct mapped_hdu
+    {
+        io::hdu header;
+        std::size_t header_offset;
+        std::size_t card_count;
+        std::size_t data_offset;
+        std::size_t data_size;
+    };
+
+    std::shared_ptr<byte_source const> source; //! FITS held in memory
+    char const* begin = nullptr; //! first byte of FITS
+    std::size_t file_size = 0; //! size of FITS in bytes
+    std::vector<mapped_hdu> hdu_; //! stores all the HDU in file
+
+public:
+    mapped_fits() {}
+
+    mapped_fits(std::string const& file_path)
+    {
+        open(file_path);
+    }
+
+    //! reads the FITS from a source held in memory (memory_source or mapped_source)
+    explicit mapped_fits(std::shared_ptr<byte_source const> fits_source)
+    {
+        open(std::move(fits_source));
+    }
+
+    //! maps the file and reads the headers of all the HDU in it
+    void open(std::string const& file_path)
+    {
+        open(std::make_shared<mapped_source>(file_path));
+    }
+
+    //! reads the headers of all the HDU in source, which must be held in memory
+    //! (byte_source::view returns the whole source), otherwise throws fits_exception
+    void open(std::shared_ptr<byte_source const> fits_source)
+    {
+        hdu_.clear();
+        source = std::move(fits_source);
+        file_size = static_cast<std::size_t>(source->size());
+        begin = source->view(0, file_size);
+        if (!begin && file_size != 0)
+        {
+            throw fits_exception();
+        }
+
+        std::size_t offset = 0;
+        while (offset < file_size)
+        {
+            mapped_hdu unit;
+            unit.header_offset = offset;
+            offset += unit.header.read_header(begin + offset, begin + file_size);
+            unit.card_count = 0;
+            while (std::memcmp(begin + unit.header_offset + unit.card_count * 80, "END     ",
+                8) != 0)
+            {
+                unit.card_count++;
+            }
+
+            unit.data_offset = offset;
+            unit.data_size = unit.header.data_size();
+            if (unit.data_size > file_size - offset)
+            {
+                throw fits_exception();
+            }
+
+            //skip the data unit along with its padding
+            offset += unit.data_size + (2880 - unit.data_size % 2880) % 2880;
+            hdu_.push_back(std::move(unit));
+        }
+    }
+
+    //! returns the number of HDU in file
+    std::size_t size() const
+    {
+        return hdu_.size();
+    }
+
+    //! returns the header of the HDU at index
+    io::hdu const& header(std::size_t index) const
+    {
+        return hdu_.at(index).header;
+    }
+
+    //! returns the header of the HDU at index
+    io::hdu& header(std::size_t index)
+    {
+        return hdu_.at(index).header;
+    }
+
+    //! returns the cards of the header of HDU at index viewed in the mapping
+    header_view header_cards(std::size_t index) const
+    {
+        mapped_hdu const& unit = hdu_.at(index);
+        return header_view(begin + unit.header_offset, unit.card_count);
+    }
+
+    //! returns the pointer to the first byte of the data unit of HDU at index
+    char const* data(std::size_t index) const
+    {
+        return begin + hdu_.at(index).data_offset;
+    }
+
+    //! returns the size of the data unit of HDU at index in bytes (without padding)
+    std::size_t data_size(std::size_t index) const
+    {
+        return hdu_.at(index).data_size;
+    }
+
+    //! returns the view of the image stored in HDU at index
+    //! images with NAXIS > 2 are flattened as NAXIS1 x (NAXIS2 * NAXIS3 * ...)
+    template <bitpix DataType>
+    image_view<DataType> image(std::size_t index) const
+    {
+        io::hdu const& unit = header(index);
+        if (unit.bitpix() != DataType)
+        {
+            throw fits_exception();
+        }
+
+        switch (unit.naxis())
+        {
+        case 0:
+            return image_view<DataType>(data(index), 0, 0);
+        case 1:
+            return image_view<DataType>(data(index), unit.naxis(1), 1);
+        default:
+            std::vector<std::size_t> naxis = unit.all_naxis();
+            return image_view<DataType>(data(index), naxis[1], std::accumulate(
+                naxis.begin() + 2, naxis.end(), std::size_t(1), std::multiplies<std::size_t>()));
+        }
+    }
+
+    //! returns the view of the physical values (BZERO + BSCALE * stored value) of the image
+    //! stored in HDU at index with any bitpix, stored values equal to BLANK are NaN
+    //! e.g. physical_image(1) of unsigned 16 bit pixels (BITPIX = 16, BZERO = 32768)
+    template <bitpix DataType = bitpix::_B32>
+    physical_view<DataType> physical_image(std::size_t index) const
+    {
+        io::hdu const& unit = header(index);
+        std::size_t width = 0;
+        std::size_t height = 0;
+        if (unit.naxis() != 0)
+        {
+            std::vector<std::size_t> naxis = unit.all_naxis();
+            width = naxis[1];
+            height = std::accumulate(naxis.begin() + 2, naxis.end(), std::size_t(1),
+                std::multiplies<std::size_t>());
+        }
+        return physical_view<DataType>(data(index), width, height, unit.bitpix(),
+            unit.scaling());
+    }
+
+    //! returns the view of variable length array column with TTYPE name of the binary table
+    //! at index, arrays are exposed in place in the mapped heap
+    template <typename T>
+    variable_length_column<T> array_column(std::size_t index, std::string const& name) const
+    {
+        binary_table_extension table(header(index));
+        return table.array_column<T>(name, data(index), data_size(index));
+    }
+
+    //! decodes the primary HDU
+    template <bitpix DataType>
+    primary_hdu<DataType> read_primary_hdu() const
+    {
+        return primary_hdu<DataType>(image<DataType>(0), header(0));
+    }
+
+    //! decodes the image extension at index
+    template <bitpix DataType>
+    image_extension<DataType> read_image_extension(std::size_t index) const
+    {
+        return image_extension<DataType>(image<DataType>(index), header(index));
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_MAPPED_FITS_HPP
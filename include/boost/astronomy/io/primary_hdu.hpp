@@ -8,8 +8,10 @@
 #include <valarray>
 #include <fstream>
 
+#include <boost/astronomy/io/byte_source.hpp>
 #include <boost/astronomy/io/hdu.hpp>
 #include <boost/astronomy/io/image.hpp>
+#include <boost/astronomy/io/image_view.hpp>
 
 namespace boost { namespace astronomy { namespace io {
 
@@ -25,10 +27,10 @@ public:
     primary_hdu() {}
 
     //!This constructore should be used when file is never read and boost::astronomy::io::hdu object is not created of the file
-    primary_hdu(std::fstream &file) : hdu(file)
+    primary_hdu(std::istream &file) : hdu(file)
     {
         simple = this->value_of<bool>("SIMPLE");
-        extend = this->value_of<bool>("EXTEND");
+        extend = this->contains("EXTEND") && this->value_of<bool>("EXTEND");
 
         //read image according to dimension specified by naxis
         switch (this->naxis())
@@ -42,8 +44,8 @@ public:
             data.read_image(file, this->naxis(1), this->naxis(2));
             break;
         default:
-            data.read_image(file, this->naxis(1), std::accumulate(this->naxis_.begin()+1,
-                this->naxis_.end(), 0, std::multiplies<std::size_t>()));
+            data.read_image(file, this->naxis(1), std::accumulate(this->naxis_.begin() + 2,
+                this->naxis_.end(), std::size_t(1), std::multiplies<std::size_t>()));
             break;
         }
 
@@ -51,10 +53,10 @@ public:
     }
 
     //!This constructore should be used when boost::astronomy::io::hdu object already exist for the file 
-    primary_hdu(std::fstream &file, hdu const& other) : hdu(other)
+    primary_hdu(std::istream &file, hdu const& other) : hdu(other)
     {
         simple = this->value_of<bool>("SIMPLE");
-        extend = this->value_of<bool>("EXTEND");
+        extend = this->contains("EXTEND") && this->value_of<bool>("EXTEND");
 
         //read image according to dimension specified by naxis
         switch (this->naxis())
@@ -68,14 +70,54 @@ public:
             data.read_image(file, this->naxis(1), this->naxis(2));
             break;
         default:
-            data.read_image(file, this->naxis(1), std::accumulate(this->naxis_.begin()+ 1,
-                this->naxis_.end(), 0, std::multiplies<std::size_t>()));
+            data.read_image(file, this->naxis(1), std::accumulate(this->naxis_.begin() + 2,
+                this->naxis_.end(), std::size_t(1), std::multiplies<std::size_t>()));
             break;
         }
 
         set_unit_end(file);    //set cursor to the end of the HDU unit
     }
 
+    //!Reads the data unit at data_offset of file with positioned reads, used to read
+    //!many HDU of a file concurrently
+    primary_hdu
+    (
+        byte_source const& file,
+        std::streamoff data_offset,
+        hdu const& other
+    ) : hdu(other)
+    {
+        simple = this->value_of<bool>("SIMPLE");
+        extend = this->contains("EXTEND") && this->value_of<bool>("EXTEND");
+
+        //read image according to dimension specified by naxis
+        switch (this->naxis())
+        {
+        case 0:
+            break;
+        case 1:
+            data.read_image(file, this->naxis(1), 1, data_offset);
+            break;
+        case 2:
+            data.read_image(file, this->naxis(1), this->naxis(2), data_offset);
+            break;
+        default:
+            data.read_image(file, this->naxis(1), std::accumulate(this->naxis_.begin() + 2,
+                this->naxis_.end(), std::size_t(1), std::multiplies<std::size_t>()), data_offset);
+            break;
+        }
+    }
+
+    //!This constructore should be used when the data unit is available in memory
+    //!(e.g. boost::astronomy::io::mapped_fits), pixels are decoded from the view
+    primary_hdu(image_view<DataType> const& view, hdu const& other) : hdu(other)
+    {
+        simple = this->value_of<bool>("SIMPLE");
+        extend = this->contains("EXTEND") && this->value_of<bool>("EXTEND");
+
+        data = view.decode();
+    }
+
     //!returnes the stored data
     image<DataType> get_data() const
     {
@@ -0,0 +1,248 @@
+#ifndef BOOST_ASTRONOMY_IO_QUANTILE_SKETCH_HPP
+#define BOOST_ASTRONOMY_IO_QUANTILE_SKETCH_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <boost/astronomy/detail/statistics.hpp>
+#include <boost/astronomy/io/image.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
+
+namespace boost { namespace astronomy { namespace io {
+
+//! approximate quantiles of pixel values seen a chunk at a time (rows, tiles, frames of a
+//! stream...) in memory bounded by compression whatever the number of pixels
+//! the values are summarized by at most about compression centroids (merging t-digest with
+//! the scale function k(q) = compression / (2 pi) * asin(2 q - 1)), which are smaller near
+//! the ends so that the error on the rank of a quantile is of order q (1 - q) / compression
+//! sketches of parts of the data can be merged, to summarize chunks read by many threads
+struct quantile_sketch
+{
+protected:
+    struct centroid
+    {
+        double mean;
+        double weight;
+    };
+
+    double delta; //! compression of sketch, about the number of centroids kept
+    std::size_t buffer_capacity; //! values buffered before they are merged
+    std::vector<centroid> centroids; //! merged, ordered by mean
+    std::vector<double> buffer; //! values added since the last merge, unordered
+    std::uint64_t total = 0; //! number of values added
+    double minimum = std::numeric_limits<double>::infinity();
+    double maximum = -std::numeric_limits<double>::infinity();
+
+public:
+    //! creates an empty sketch keeping about compression centroids, larger values are more
+    //! accurate and use more memory
+    explicit quantile_sketch(double compression = 200) :
+        delta((std::max)(compression, 10.0)),
+        buffer_capacity(static_cast<std::size_t>(5 * delta))
+    {
+        buffer.reserve(buffer_capacity);
+    }
+
+    //! adds value to the sketch, NaN values are left out
+    void add(double value)
+    {
+        if (std::isnan(value))
+        {
+            return;
+        }
+        buffer.push_back(value);
+        total++;
+        minimum = (std::min)(minimum, value);
+        maximum = (std::max)(maximum, value);
+        if (buffer.size() >= buffer_capacity)
+        {
+            centroids = compress(merged());
+            buffer.clear();
+        }
+    }
+
+    //! adds count pixels to the sketch leaving out NaN pixels and the bad pixels of bad,
+    //! whose mask (if any) has a byte for each of these pixels
+    template <typename PixelType>
+    void add(PixelType const* pixels, std::size_t count, bad_pixels const& bad = bad_pixels())
+    {
+        detail::pixel_filter const filter = detail::filter_of(bad);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            if (detail::is_valid_pixel(pixels, bad.mask, i, filter))
+            {
+                add(static_cast<double>(pixels[i]));
+            }
+        }
+    }
+
+    //! adds the values summarized by other to the sketch
+    void merge(quantile_sketch const& other)
+    {
+        std::vector<centroid> const mine = merged();
+        std::vector<centroid> const theirs = other.merged();
+        std::vector<centroid> all(mine.size() + theirs.size());
+        std::merge(mine.begin(), mine.end(), theirs.begin(), theirs.end(), all.begin(),
+            by_mean);
+        total += other.total;
+        minimum = (std::min)(minimum, other.minimum);
+        maximum = (std::max)(maximum, other.maximum);
+        centroids = compress(all);
+        buffer.clear();
+    }
+
+    //! returns the number of values added to the sketch
+    std::uint64_t count() const
+    {
+        return total;
+    }
+
+    //! returns the approximate q quantile (0 <= q <= 1) of the values added to the sketch,
+    //! the exact minimum and maximum for 0 and 1 (NaN if no value was added)
+    //! throws invalid_quantile_exception if q is not between 0 and 1
+    double quantile(double q) const
+    {
+        if (!(q >= 0 && q <= 1))
+        {
+            throw invalid_quantile_exception();
+        }
+        if (total == 0)
+        {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+
+        std::vector<centroid> const summary = buffer.empty() ? centroids :
+            compress(merged());
+        double const values = static_cast<double>(total);
+        double const rank = q * values;
+
+        //each centroid stands for its mean at the middle of the ranks of its values,
+        //the values between are interpolated and min and max stand at both ends
+        double previous_rank = 0;
+        double previous_value = minimum;
+        double seen = 0;
+        for (centroid const& c : summary)
+        {
+            double const middle = seen + c.weight / 2;
+            if (rank < middle)
+            {
+                return interpolate(previous_rank, previous_value, middle, c.mean, rank);
+            }
+            previous_rank = middle;
+            previous_value = c.mean;
+            seen += c.weight;
+        }
+        return interpolate(previous_rank, previous_value, values, maximum, rank);
+    }
+
+protected:
+    static double interpolate(double rank0, double value0, double rank1, double value1,
+        double rank)
+    {
+        if (rank1 <= rank0)
+        {
+            return value1;
+        }
+        double const t = (rank - rank0) / (rank1 - rank0);
+        if (std::isinf(value0) || std::isinf(value1))
+        {
+            return t < 0.5 ? value0 : value1;
+        }
+        double const value = value0 + t * (value1 - value0);
+        return (std::min)((std::max)(value, (std::min)(value0, value1)),
+            (std::max)(value0, value1));
+    }
+
+    // k(q) of the scale function in units of centroids
+    double scale(double q) const
+    {
+        return delta / (2 * pi()) * std::asin(2 * q - 1);
+    }
+
+    // q of k(q) of the scale function
+    double inverse_scale(double k) const
+    {
+        if (k >= delta / 4)
+        {
+            return 1;
+        }
+        return (std::sin(k * 2 * pi() / delta) + 1) / 2;
+    }
+
+    static double pi()
+    {
+        return 3.14159265358979323846;
+    }
+
+    static bool by_mean(centroid const& a, centroid const& b)
+    {
+        return a.mean < b.mean;
+    }
+
+    // centroids and the values of buffer ordered by mean
+    std::vector<centroid> merged() const
+    {
+        std::vector<double> values(buffer);
+        std::sort(values.begin(), values.end());
+        std::vector<centroid> all;
+        all.reserve(centroids.size() + values.size());
+        std::size_t next = 0;
+        for (double value : values)
+        {
+            while (next < centroids.size() && centroids[next].mean < value)
+            {
+                all.push_back(centroids[next++]);
+            }
+            all.push_back(centroid{value, 1});
+        }
+        all.insert(all.end(), centroids.begin() + next, centroids.end());
+        return all;
+    }
+
+    // merges all (ordered by mean) into fewer centroids, a centroid grows while its values
+    // span less than 1 in k(q)
+    std::vector<centroid> compress(std::vector<centroid> const& all) const
+    {
+        std::vector<centroid> result;
+        if (all.empty())
+        {
+            return result;
+        }
+        double const values = static_cast<double>(total);
+        double seen = 0;
+        double limit = values * inverse_scale(scale(0) + 1);
+        centroid current = all[0];
+        for (std::size_t i = 1; i < all.size(); i++)
+        {
+            bool const finite = std::isfinite(current.mean) && std::isfinite(all[i].mean);
+            if (finite && seen + current.weight + all[i].weight <= limit)
+            {
+                current.weight += all[i].weight;
+                current.mean += (all[i].mean - current.mean) * all[i].weight / current.weight;
+                continue;
+            }
+            //infinities are never mixed with finite values, the ones of the same sign are
+            //equal and kept in a single centroid
+            if (!finite && std::isinf(current.mean) && std::isinf(all[i].mean) &&
+                std::signbit(current.mean) == std::signbit(all[i].mean))
+            {
+                current.weight += all[i].weight;
+                continue;
+            }
+            seen += current.weight;
+            result.push_back(current);
+            limit = values * inverse_scale(scale(seen / values) + 1);
+            current = all[i];
+        }
+        result.push_back(current);
+        return result;
+    }
+};
+
+}}} //namespace boost::astronomy::io
+
+#endif // !BOOST_ASTRONOMY_IO_QUANTILE_SKETCH_HPP
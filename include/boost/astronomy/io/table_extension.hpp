@@ -4,8 +4,11 @@
 #include <cstddef>
 #include <fstream>
 #include <string>
+#include <vector>
 #include <boost/astronomy/io/extension_hdu.hpp>
+#include <boost/astronomy/io/hdu_index.hpp>
 #include <boost/astronomy/io/column.hpp>
+#include <boost/astronomy/exception/fits_exception.hpp>
 
 namespace boost { namespace astronomy { namespace io {
 
@@ -20,22 +23,123 @@ protected:
 public:
     table_extension() {}
 
-    table_extension(std::fstream &file) : extension_hdu(file)
+    table_extension(std::istream &file) : extension_hdu(file)
     {
         tfields = this->value_of<std::size_t>("TFIELDS");
-        col_metadata.reserve(tfields);
+        read_column_metadata();
     }
 
-    table_extension(std::fstream &file, hdu const& other) : extension_hdu(file, other)
+    table_extension(std::istream &file, hdu const& other) : extension_hdu(file, other)
     {
         tfields = this->value_of<std::size_t>("TFIELDS");
-        col_metadata.reserve(tfields);
+        read_column_metadata();
     }
 
-    table_extension(std::fstream &file, std::streampos pos) : extension_hdu(file, pos)
+    table_extension(std::istream &file, std::streampos pos) : extension_hdu(file, pos)
     {
         tfields = this->value_of<std::size_t>("TFIELDS");
-        col_metadata.reserve(tfields);
+        read_column_metadata();
+    }
+
+    //!creates the table from header only, data unit is not read
+    table_extension(hdu const& other) : extension_hdu(other)
+    {
+        tfields = this->value_of<std::size_t>("TFIELDS");
+        read_column_metadata();
+    }
+
+    //!returns the number of bytes in a row (NAXIS1)
+    std::size_t row_size() const
+    {
+        return this->naxis(1);
+    }
+
+    //!returns the number of rows (NAXIS2)
+    std::size_t rows() const
+    {
+        return this->naxis(2);
+    }
+
+    //!returns the metadata of all the columns
+    std::vector<column> const& get_columns() const
+    {
+        return this->col_metadata;
+    }
+
+    //!returns the metadata of column with given TTYPE
+    column const& get_column_metadata(std::string const& name) const
+    {
+        for (column const& col : this->col_metadata)
+        {
+            if (col.TTYPE() == name)
+            {
+                return col;
+            }
+        }
+        throw key_not_defined_exception();
+    }
+
+    //!returns the data unit as stored in file (empty if not read)
+    std::vector<char> const& get_data() const
+    {
+        return this->data;
+    }
+
+protected:
+    //!reads TTYPEn, TFORMn, TBCOLn, TUNITn, TSCALn, TZEROn, TDISPn and TDIMn of all the columns
+    void read_column_metadata()
+    {
+        col_metadata.resize(tfields);
+        for (std::size_t i = 0; i < tfields; i++)
+        {
+            column& col = col_metadata[i];
+            std::size_t const n = i + 1;
+            col.index(n);
+            col.TFORM(detail::unquote(this->value_of<std::string>(indexed_keyword::tform, n)));
+
+            std::size_t card_index;
+            keyword_index const& keys = this->get_key_index();
+            if (keys.find(indexed_keyword::ttype, n, card_index))
+            {
+                col.TTYPE(detail::unquote(this->cards[card_index].value<std::string>()));
+            }
+            if (keys.find(indexed_keyword::tbcol, n, card_index))
+            {
+                col.TBCOL(this->cards[card_index].value<std::size_t>());
+            }
+            if (keys.find(indexed_keyword::tunit, n, card_index))
+            {
+                col.TUNIT(detail::unquote(this->cards[card_index].value<std::string>()));
+            }
+            if (keys.find(indexed_keyword::tscal, n, card_index))
+            {
+                col.TSCAL(this->cards[card_index].value<double>());
+            }
+            if (keys.find(indexed_keyword::tzero, n, card_index))
+            {
+                col.TZERO(this->cards[card_index].value<double>());
+            }
+            if (keys.find(indexed_keyword::tdim, n, card_index))
+            {
+                col.TDIM(detail::unquote(this->cards[card_index].value<std::string>()));
+            }
+            if (keys.find("TDISP", n, card_index))
+            {
+                col.TDISP(detail::unquote(this->cards[card_index].value<std::string>()));
+            }
+        }
+    }
+
+    //!reads the whole data unit (including the heap) from current position of file
+    void read_data(std::istream &file)
+    {
+        data.resize(this->data_size());
+        file.read(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!file)
+        {
+            throw fits_exception();
+        }
+        set_unit_end(file);
     }
 };
 
@@ -0,0 +1,247 @@
+#define BOOST_TEST_MODULE batch_reader_test
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/batch_reader.hpp>
+
+#include "fits_fixture.hpp"
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+//image B16 in primary HDU, image B32 with a header of several blocks, a binary table and a
+//cube of doubles, pixels depend on seed
+void write_survey(std::string const& path, int seed)
+{
+    std::vector<test_hdu> units(4);
+
+    units[0].cards = image_cards(16, {40, 30});
+    std::vector<std::int16_t> frame(1200);
+    for (std::size_t i = 0; i < frame.size(); i++)
+    {
+        frame[i] = static_cast<std::int16_t>(static_cast<int>(i) * 3 + seed);
+    }
+    append_big_endian(units[0].data, frame);
+
+    units[1].cards = image_cards(32, {25, 7}, "WIDE", false);
+    for (int i = 0; i < 200; i++)
+    {
+        units[1].cards.push_back(make_card("COMMENT"));
+    }
+    std::vector<std::int32_t> wide(175);
+    for (std::size_t i = 0; i < wide.size(); i++)
+    {
+        wide[i] = static_cast<std::int32_t>(i) * seed - 1000;
+    }
+    append_big_endian(units[1].data, wide);
+
+    units[2].cards = {make_card("XTENSION", "'BINTABLE'"), make_card("BITPIX", "8"),
+        make_card("NAXIS", "2"), make_card("NAXIS1", "4"), make_card("NAXIS2", "3"),
+        make_card("PCOUNT", "0"), make_card("GCOUNT", "1"), make_card("TFIELDS", "1"),
+        make_card("TFORM1", "'1J      '")};
+    append_big_endian(units[2].data, std::vector<std::int32_t>({1, 2, 3}));
+
+    units[3].cards = image_cards(-64, {20, 10, 3}, "CUBE", false);
+    std::vector<double> cube(600);
+    for (std::size_t i = 0; i < cube.size(); i++)
+    {
+        cube[i] = static_cast<double>(i) / 8 + seed;
+    }
+    append_big_endian(units[3].data, cube);
+
+    write_test_fits(path, units);
+}
+
+//expected value of pixel i of HDU in the survey written with seed
+double expected_pixel(std::size_t hdu_number, std::size_t i, int seed)
+{
+    switch (hdu_number)
+    {
+    case 0:
+        return static_cast<std::int16_t>(static_cast<int>(i) * 3 + seed);
+    case 1:
+        return static_cast<double>(static_cast<std::int32_t>(i) * seed - 1000);
+    default:
+        return static_cast<double>(i) / 8 + seed;
+    }
+}
+
+void truncate_file(std::string const& path, std::size_t removed)
+{
+    std::vector<char> bytes;
+    {
+        std::ifstream file(path, std::ios_base::in | std::ios_base::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    std::ofstream file(path,
+        std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - removed));
+}
+
+//pixels of every image read, keyed by file and HDU number
+using read_images = std::map<std::pair<std::size_t, std::size_t>, std::vector<double>>;
+
+batch_read_result read_all(std::vector<std::string> const& paths,
+    batch_read_options const& options, read_images& images)
+{
+    return batch_read_images(paths, [&](batch_image const& info, auto& image)
+    {
+        std::vector<double>& pixels = images[std::make_pair(info.file, info.hdu_number)];
+        std::size_t const count = image.get_width() * image.get_height();
+        for (std::size_t i = 0; i < count; i++)
+        {
+            pixels.push_back(static_cast<double>(image.pixels()[i]));
+        }
+    }, options);
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(batch_read)
+
+BOOST_AUTO_TEST_CASE(batch_read_every_image)
+{
+    std::vector<temp_file> files;
+    files.reserve(6);
+    std::vector<std::string> paths;
+    for (int i = 0; i < 5; i++)
+    {
+        files.emplace_back("batch_read_every_image_" + std::to_string(i) + ".fits");
+        write_survey(files.back().path, i + 1);
+        paths.push_back(files.back().path);
+    }
+    files.emplace_back("batch_read_every_image_truncated.fits");
+    write_survey(files.back().path, 9);
+    truncate_file(files.back().path, 2880);
+    paths.push_back(files.back().path);
+    paths.push_back("batch_read_every_image_missing.fits");
+
+    std::vector<io_backend> backends = {io_backend::thread_pool, io_backend::automatic};
+    if (boost::astronomy::detail::io_uring_supported())
+    {
+        backends.push_back(io_backend::io_uring);
+    }
+    else
+    {
+        batch_read_options options;
+        options.backend = io_backend::io_uring;
+        BOOST_CHECK_THROW(batch_read_images(paths, [](batch_image const&, auto&) {}, options),
+            boost::astronomy::unsupported_io_backend_exception);
+    }
+
+    for (io_backend backend : backends)
+    {
+        //few reads in flight, reads splitting pixels and little memory for pending images
+        batch_read_options options;
+        options.backend = backend;
+        options.queue_depth = 3;
+        options.threads = 2;
+        options.max_open_files = 2;
+        options.read_bytes = 250;
+        options.max_pending_bytes = 3000;
+
+        read_images images;
+        batch_read_result result = read_all(paths, options, images);
+        if (backend != io_backend::automatic)
+        {
+            BOOST_TEST((result.backend == backend));
+        }
+
+        BOOST_REQUIRE_EQUAL(result.errors.size(), 7u);
+        for (std::size_t file = 0; file < 5; file++)
+        {
+            BOOST_TEST(result.errors[file].empty());
+            for (std::size_t hdu_number : {0u, 1u, 3u})
+            {
+                std::vector<double> const& pixels = images[std::make_pair(file, hdu_number)];
+                BOOST_REQUIRE_EQUAL(pixels.size(), hdu_number == 0 ? 1200u :
+                    hdu_number == 1 ? 175u : 600u);
+                for (std::size_t i = 0; i < pixels.size(); i++)
+                {
+                    BOOST_TEST(pixels[i] == expected_pixel(hdu_number, i,
+                        static_cast<int>(file) + 1));
+                }
+            }
+        }
+        BOOST_TEST(result.errors[5] == "Data unit of HDU is truncated");
+        BOOST_TEST(!result.errors[6].empty());
+        BOOST_TEST(images.count(std::make_pair(std::size_t(5), std::size_t(3))) == 0u);
+        BOOST_TEST(result.images == images.size());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(batch_read_queue_depth_fallback)
+{
+    temp_file file("batch_read_queue_depth_fallback.fits");
+    write_survey(file.path, 2);
+    std::vector<std::string> const paths = {file.path};
+
+    //no reads in flight is read with one, more entries than a ring allows fall back to the
+    //thread pool
+    for (std::size_t queue_depth : {0u, 100000u})
+    {
+        batch_read_options options;
+        options.queue_depth = queue_depth;
+        options.threads = 2;
+        BOOST_CHECK_NO_THROW(batch_read_images({}, [](batch_image const&, auto&) {}, options));
+
+        read_images images;
+        batch_read_result result = read_all(paths, options, images);
+        BOOST_TEST(result.errors == std::vector<std::string>(1));
+        BOOST_TEST(images.size() == 3u);
+        BOOST_TEST(images[std::make_pair(std::size_t(0), std::size_t(3))][599] ==
+            expected_pixel(3, 599, 2));
+        if (queue_depth != 0)
+        {
+            BOOST_TEST((result.backend == io_backend::thread_pool));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(batch_read_selected_hdus)
+{
+    temp_file first("batch_read_selected_hdus_0.fits");
+    temp_file second("batch_read_selected_hdus_1.fits");
+    write_survey(first.path, 4);
+    write_survey(second.path, 5);
+    std::vector<std::string> const paths = {first.path, second.path};
+
+    batch_read_options options;
+    options.hdus = {3};
+    read_images images;
+    batch_read_result result = read_all(paths, options, images);
+    BOOST_TEST(result.errors == std::vector<std::string>(2));
+    BOOST_REQUIRE_EQUAL(images.size(), 2u);
+    BOOST_TEST(images[std::make_pair(std::size_t(1), std::size_t(3))][599] ==
+        expected_pixel(3, 599, 5));
+    BOOST_TEST(result.bytes == 2 * 600 * 8u);
+
+    //binary table is not an image and the file has only 4 HDU
+    options.hdus = {2};
+    BOOST_TEST(read_all(paths, options, images).errors[0] == "HDU is not an image");
+    options.hdus = {0, 7};
+    BOOST_TEST(read_all(paths, options, images).errors[1] == "HDU is not present in file");
+
+    //exception thrown by callback stops the reads
+    options.hdus.clear();
+    options.queue_depth = 4;
+    options.read_bytes = 512;
+    BOOST_CHECK_THROW(batch_read_images(paths, [](batch_image const& info, auto&)
+    {
+        if (info.hdu_number == 1)
+        {
+            throw std::runtime_error("stop");
+        }
+    }, options), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
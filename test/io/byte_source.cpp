@@ -0,0 +1,175 @@
+#define BOOST_TEST_MODULE byte_source_test
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <memory>
+#include <fstream>
+#include <iterator>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/byte_source.hpp>
+#include <boost/astronomy/io/fits.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/io/image_stream.hpp>
+#include <boost/astronomy/io/mapped_fits.hpp>
+
+#include "fits_fixture.hpp"
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+std::vector<char> read_file(std::string const& path)
+{
+    std::ifstream file(path, std::ios_base::in | std::ios_base::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>());
+}
+
+//FITS with an image in primary HDU, an image extension and a binary table
+void write_sample(std::string const& path)
+{
+    image<bitpix::B32> frame(12, 10);
+    for (std::size_t i = 0; i < 120; i++)
+    {
+        frame.pixels()[i] = static_cast<std::int32_t>(i * i) - 500;
+    }
+    image<bitpix::_B64> science(50, 40);
+    for (std::size_t i = 0; i < 2000; i++)
+    {
+        science.pixels()[i] = static_cast<double>(i) / 4;
+    }
+    std::vector<std::unique_ptr<column>> columns;
+    std::unique_ptr<column_data<float>> flux(new column_data<float>(column("1E")));
+    flux->TTYPE("FLUX");
+    flux->get_data() = {1.5f, -2.5f, 3.25f};
+    columns.push_back(std::move(flux));
+
+    fits_writer writer(path);
+    writer.write_primary_hdu(frame);
+    writer.write_image_extension(science, {card("EXTNAME", "'SCI     '")});
+    writer.write_binary_table(columns, {card("EXTNAME", "'CAT     '")});
+}
+
+//reads the sample through source and checks every kind of read
+void check_sample(std::shared_ptr<byte_source const> source)
+{
+    fits file(source);
+    BOOST_REQUIRE_EQUAL(file.size(), 3u);
+    BOOST_TEST(file.index()[2].extname == "CAT");
+
+    auto primary = std::dynamic_pointer_cast<primary_hdu<bitpix::B32>>(file.get_hdu(0));
+    BOOST_REQUIRE(primary);
+    BOOST_TEST(primary->get_data()(9, 11) == 119 * 119 - 500);
+
+    file.read_extensions_parallel();
+    auto science = std::dynamic_pointer_cast<image_extension<bitpix::_B64>>(
+        file.get_hdu("SCI"));
+    BOOST_REQUIRE(science);
+    BOOST_TEST(science->get_data()(39, 49) == 1999.0 / 4);
+
+    image<bitpix::_B64> cutout = file.read_cutout<bitpix::_B64>(1,
+        {axis_range(10, 13), axis_range(2, 6, 2)});
+    BOOST_TEST(cutout.get_width() == 3u);
+    BOOST_TEST(cutout.get_height() == 2u);
+    BOOST_TEST(cutout(1, 2) == (4 * 50 + 12) / 4.0);
+
+    std::vector<std::unique_ptr<column>> columns = file.read_table_columns(2, {"FLUX"});
+    BOOST_REQUIRE_EQUAL(columns.size(), 1u);
+    auto flux = dynamic_cast<column_data<float>*>(columns[0].get());
+    BOOST_REQUIRE(flux);
+    BOOST_TEST(flux->get_data() == std::vector<float>({1.5f, -2.5f, 3.25f}));
+
+    source_istream stream(*source, 1000);
+    image_stream<bitpix::_B64> rows(stream, file.index()[1].data_offset,
+        file.index()[1].naxis, 50 * 8 * 7);
+    std::size_t count = 0;
+    rows.for_each_block([&](image_block<double> const& block)
+    {
+        BOOST_TEST(block.row(0)[3] == static_cast<double>(block.first_row * 50 + 3) / 4);
+        count += block.rows;
+    });
+    BOOST_TEST(count == 40u);
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(byte_source_read)
+
+BOOST_AUTO_TEST_CASE(byte_source_positioned_reads)
+{
+    temp_file file("byte_source_positioned_reads.fits");
+    write_sample(file.path);
+    std::vector<char> const bytes = read_file(file.path);
+
+    file_source positioned(file.path);
+    memory_source borrowed(bytes.data(), bytes.size());
+    mapped_source mapped(file.path);
+
+    for (byte_source const* source : {static_cast<byte_source const*>(&positioned),
+        static_cast<byte_source const*>(&borrowed), static_cast<byte_source const*>(&mapped)})
+    {
+        BOOST_TEST(source->size() == bytes.size());
+        char block[100];
+        source->read_at(block, 100, 2880);
+        BOOST_TEST(std::equal(block, block + 100, bytes.begin() + 2880));
+        BOOST_CHECK_THROW(source->read_at(block, 100, bytes.size() - 50),
+            boost::astronomy::fits_exception);
+    }
+
+    BOOST_TEST(!positioned.view(0, 10));
+    BOOST_TEST(borrowed.view(10, 20) == bytes.data() + 10);
+    BOOST_TEST(std::equal(bytes.begin(), bytes.end(), mapped.view(0, bytes.size())));
+    BOOST_CHECK_THROW(borrowed.view(bytes.size(), 1), boost::astronomy::fits_exception);
+}
+
+BOOST_AUTO_TEST_CASE(source_istream_sequential_reads)
+{
+    temp_file file("source_istream_sequential_reads.fits");
+    write_sample(file.path);
+    std::vector<char> const bytes = read_file(file.path);
+
+    file_source positioned(file.path);
+    memory_source borrowed(bytes.data(), bytes.size());
+    for (byte_source const* source : {static_cast<byte_source const*>(&positioned),
+        static_cast<byte_source const*>(&borrowed)})
+    {
+        //buffer much smaller than the reads so that large reads bypass it
+        source_istream stream(*source, 64);
+        std::vector<char> result(bytes.size());
+        stream.read(result.data(), 10);
+        stream.read(result.data() + 10, static_cast<std::streamsize>(bytes.size() - 10));
+        BOOST_TEST(static_cast<bool>(stream));
+        BOOST_TEST(result == bytes);
+        BOOST_TEST(stream.get() == std::char_traits<char>::eof());
+
+        stream.clear();
+        stream.seekg(0, std::ios_base::end);
+        BOOST_TEST(stream.tellg() == static_cast<std::streamoff>(bytes.size()));
+        stream.seekg(5000);
+        BOOST_TEST(stream.get() == bytes[5000]);
+        stream.seekg(-2, std::ios_base::cur);
+        BOOST_TEST(stream.get() == bytes[4999]);
+        stream.seekg(static_cast<std::streamoff>(bytes.size()) + 1);
+        BOOST_TEST(stream.fail());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(fits_from_byte_sources)
+{
+    temp_file file("fits_from_byte_sources.fits");
+    write_sample(file.path);
+
+    check_sample(std::make_shared<memory_source>(read_file(file.path)));
+    check_sample(std::make_shared<mapped_source>(file.path));
+    check_sample(std::make_shared<file_source>(file.path));
+
+    mapped_fits in_memory(std::make_shared<memory_source>(read_file(file.path)));
+    BOOST_REQUIRE_EQUAL(in_memory.size(), 3u);
+    BOOST_TEST(in_memory.image<bitpix::B32>(0)(2, 3) == 27 * 27 - 500);
+    BOOST_CHECK_THROW(mapped_fits(std::make_shared<file_source>(file.path)),
+        boost::astronomy::fits_exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,124 @@
+#define BOOST_TEST_MODULE card_test
+
+#include <string>
+#include <cstdint>
+#include <limits>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/astronomy/io/card.hpp>
+#include <boost/astronomy/detail/charconv.hpp>
+
+#include "fits_fixture.hpp"
+
+using namespace boost::astronomy::io;
+namespace detail = boost::astronomy::detail;
+
+BOOST_AUTO_TEST_SUITE(card_parse)
+
+BOOST_AUTO_TEST_CASE(card_key_and_values)
+{
+    card naxis(make_card("NAXIS1", "                2048 / length of data axis 1"));
+    BOOST_TEST(naxis.key() == "NAXIS1");
+    BOOST_TEST(naxis.key(true) == "NAXIS1  ");
+    BOOST_TEST(naxis.value<int>() == 2048);
+    BOOST_TEST(naxis.value<std::size_t>() == 2048u);
+    BOOST_TEST(naxis.comment() == "length of data axis 1");
+
+    card exptime(make_card("EXPTIME", "1.5D+02"));
+    BOOST_TEST(exptime.value<double>() == 150.0);
+    BOOST_TEST(exptime.value<float>() == 150.0f);
+
+    card simple(make_card("SIMPLE", "                   T"));
+    BOOST_TEST(simple.value<bool>());
+
+    card date(make_card("DATE-OBS", "'2019-08-21T10:00:00' / UTC date/time"));
+    BOOST_TEST(date.key() == "DATE-OBS");
+    BOOST_TEST(date.value<std::string>() == "'2019-08-21T10:00:00'");
+    BOOST_TEST(date.comment() == "UTC date/time");
+
+    //slash inside string is not a comment
+    card path(make_card("FILENAME", "'raw/ccd1.fits'    / with '' quote"));
+    BOOST_TEST(path.value<boost::string_view>() == "'raw/ccd1.fits'");
+
+    card history(make_card("HISTORY") );
+    BOOST_TEST(history.key() == "HISTORY");
+    BOOST_TEST(!history.has_value());
+    BOOST_TEST(exptime.has_value());
+
+    card garbage(make_card("BITPIX", "sixteen"));
+    BOOST_CHECK_THROW(garbage.value<int>(), boost::bad_lexical_cast);
+}
+
+BOOST_AUTO_TEST_CASE(card_create)
+{
+    card number;
+    number.create_card("NAXIS", 2, "number of axes");
+    BOOST_TEST(std::string(number.data(), 80) ==
+        make_card("NAXIS", "                   2 / number of axes"));
+    BOOST_TEST(number.value<int>() == 2);
+
+    card flag;
+    flag.create_card("EXTEND", true);
+    BOOST_TEST(std::string(flag.data(), 80) == make_card("EXTEND", "                   T"));
+
+    card real;
+    real.create_card("CRVAL1", 0.1);
+    BOOST_TEST(real.value<double>() == 0.1);
+
+    //exponents are uppercase and values are read back exactly
+    card small;
+    small.create_card("EXPTIME", 1e-5);
+    BOOST_TEST(std::string(small.data(), 80) ==
+        make_card("EXPTIME", "1.0000000000000001E-05"));
+    BOOST_TEST(small.value<double>() == 1e-5);
+    card large;
+    large.create_card("BZERO", 6.02214076e23f);
+    BOOST_TEST(std::string(large.data(), 80) == make_card("BZERO", "      6.02214064E+23"));
+    BOOST_TEST(large.value<float>() == 6.02214076e23f);
+
+    card comment;
+    comment.create_commentary_card("COMMENT", "reduced by pipeline");
+    BOOST_TEST(comment.key() == "COMMENT");
+    BOOST_TEST(comment.value_with_comment().substr(0, 19) == "reduced by pipeline");
+
+    BOOST_CHECK_THROW(card("LONGKEYWORD", "1"), boost::astronomy::invalid_key_length_exception);
+}
+
+BOOST_AUTO_TEST_CASE(charconv_numbers)
+{
+    auto integer = [](std::string const& text, std::int32_t& value) {
+        return detail::parse_integer(text.data(), text.data() + text.size(), value);
+    };
+    auto real = [](std::string const& text, double& value) {
+        return detail::parse_real(text.data(), text.data() + text.size(), value);
+    };
+
+    std::int32_t i = 0;
+    BOOST_TEST(integer("-2147483648", i));
+    BOOST_TEST(i == std::numeric_limits<std::int32_t>::min());
+    BOOST_TEST(integer("+2147483647", i));
+    BOOST_TEST(i == std::numeric_limits<std::int32_t>::max());
+    BOOST_TEST(!integer("2147483648", i));
+    BOOST_TEST(!integer("12a", i));
+    BOOST_TEST(!integer("", i));
+
+    double d = 0;
+    BOOST_TEST(real("3.25", d));
+    BOOST_TEST(d == 3.25);
+    BOOST_TEST(real("-.5E-3", d));
+    BOOST_TEST(d == -0.0005);
+    BOOST_TEST(real("12.", d));
+    BOOST_TEST(d == 12.0);
+    BOOST_TEST(real("6.02214076D23", d));
+    BOOST_TEST(d == 6.02214076e23);
+    BOOST_TEST(real("0.12345678901234567890123", d));
+    BOOST_TEST(d == 0.12345678901234567890123);
+    BOOST_TEST(real("1e-300", d));
+    BOOST_TEST(d == 1e-300);
+    BOOST_TEST(!real("1.2.3", d));
+    BOOST_TEST(!real("E5", d));
+    BOOST_TEST(!real("1E", d));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,638 @@
+#define BOOST_TEST_MODULE compressed_image_test
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cmath>
+#include <memory>
+#include <algorithm>
+#include <future>
+#include <limits>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/detail/rice.hpp>
+#include <boost/astronomy/detail/gzip.hpp>
+#include <boost/astronomy/io/fits.hpp>
+#include <boost/astronomy/io/compressed_image_extension.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/io/async_fits_writer.hpp>
+
+#include "fits_fixture.hpp"
+
+using namespace boost::astronomy::io;
+namespace detail = boost::astronomy::detail;
+
+namespace {
+
+template <typename T>
+void append_field(std::vector<char>& row, T value)
+{
+    append_big_endian(row, std::vector<T>{value});
+}
+
+//pixel values of an image stored as tiles of given shape
+template <typename T>
+struct tiled
+{
+    std::vector<std::size_t> axes;
+    std::vector<std::size_t> tile;
+    std::vector<T> pixels;
+
+    //returns the pixels of every tile, axis 1 varying fastest
+    std::vector<std::vector<T>> tiles() const
+    {
+        std::vector<std::size_t> counts;
+        std::size_t total = 1;
+        for (std::size_t i = 0; i < axes.size(); i++)
+        {
+            counts.push_back((axes[i] + tile[i] - 1) / tile[i]);
+            total *= counts.back();
+        }
+
+        std::vector<std::vector<T>> result(total);
+        std::vector<std::size_t> position(axes.size(), 0);
+        for (std::size_t p = 0; p < pixels.size(); p++)
+        {
+            std::size_t index = 0;
+            std::size_t pitch = 1;
+            for (std::size_t i = 0; i < axes.size(); i++)
+            {
+                index += position[i] / tile[i] * pitch;
+                pitch *= counts[i];
+            }
+            //pixels are visited in the order of image, which is the order within a tile
+            result[index].push_back(pixels[p]);
+
+            for (std::size_t i = 0; i < axes.size(); i++)
+            {
+                if (++position[i] < axes[i])
+                {
+                    break;
+                }
+                position[i] = 0;
+            }
+        }
+        return result;
+    }
+};
+
+//primary HDU without data followed by a tile compressed image whose tiles are stored in
+//COMPRESSED_DATA, quantized images have ZSCALE, ZZERO and ZBLANK columns
+struct compressed_fixture
+{
+    int zbitpix = 16;
+    std::vector<std::size_t> axes;
+    std::vector<std::size_t> tile;
+    std::string cmptype = "RICE_1";
+    std::vector<std::string> cards;
+    std::vector<std::vector<unsigned char>> compressed;
+    std::vector<double> zscale;
+    std::vector<double> zzero;
+    std::vector<std::int32_t> zblank;
+
+    void write(std::string const& path) const
+    {
+        bool const quantized = !zscale.empty();
+        std::size_t const row_size = quantized ? 8 + 8 + 8 + 4 : 8;
+
+        std::vector<test_hdu> units(2);
+        units[0].cards = image_cards(8, {});
+
+        std::vector<char> heap;
+        std::vector<char>& data = units[1].data;
+        for (std::size_t t = 0; t < compressed.size(); t++)
+        {
+            append_field<std::uint32_t>(data, static_cast<std::uint32_t>(compressed[t].size()));
+            append_field<std::uint32_t>(data, static_cast<std::uint32_t>(heap.size()));
+            heap.insert(heap.end(), compressed[t].begin(), compressed[t].end());
+            if (quantized)
+            {
+                append_field<double>(data, zscale[t]);
+                append_field<double>(data, zzero[t]);
+                append_field<std::int32_t>(data, zblank[t]);
+            }
+        }
+
+        std::vector<std::string>& header = units[1].cards;
+        header.push_back(make_card("XTENSION", "'BINTABLE'"));
+        header.push_back(make_card("BITPIX", "8"));
+        header.push_back(make_card("NAXIS", "2"));
+        header.push_back(make_card("NAXIS1", std::to_string(row_size)));
+        header.push_back(make_card("NAXIS2", std::to_string(compressed.size())));
+        header.push_back(make_card("PCOUNT", std::to_string(heap.size())));
+        header.push_back(make_card("GCOUNT", "1"));
+        header.push_back(make_card("TFIELDS", quantized ? "4" : "1"));
+        header.push_back(make_card("TTYPE1", "'COMPRESSED_DATA'"));
+        header.push_back(make_card("TFORM1", "'1PB(100)'"));
+        if (quantized)
+        {
+            header.push_back(make_card("TTYPE2", "'ZSCALE  '"));
+            header.push_back(make_card("TFORM2", "'1D      '"));
+            header.push_back(make_card("TTYPE3", "'ZZERO   '"));
+            header.push_back(make_card("TFORM3", "'1D      '"));
+            header.push_back(make_card("TTYPE4", "'ZBLANK  '"));
+            header.push_back(make_card("TFORM4", "'1J      '"));
+        }
+        header.push_back(make_card("ZIMAGE", "T"));
+        header.push_back(make_card("ZBITPIX", std::to_string(zbitpix)));
+        header.push_back(make_card("ZNAXIS", std::to_string(axes.size())));
+        for (std::size_t i = 0; i < axes.size(); i++)
+        {
+            header.push_back(make_card("ZNAXIS" + std::to_string(i + 1),
+                std::to_string(axes[i])));
+            header.push_back(make_card("ZTILE" + std::to_string(i + 1),
+                std::to_string(tile[i])));
+        }
+        header.push_back(make_card("ZCMPTYPE", "'" + cmptype + "'"));
+        header.insert(header.end(), cards.begin(), cards.end());
+        header.push_back(make_card("EXTNAME", "'COMPRESSED_IMAGE'"));
+
+        data.insert(data.end(), heap.begin(), heap.end());
+        write_test_fits(path, units);
+    }
+};
+
+//image of 7 x 5 pixels with large and small differences between adjacent pixels
+tiled<std::int16_t> test_frame(std::vector<std::size_t> const& tile)
+{
+    tiled<std::int16_t> frame;
+    frame.axes = {7, 5};
+    frame.tile = tile;
+    for (int i = 0; i < 35; i++)
+    {
+        frame.pixels.push_back(static_cast<std::int16_t>(i % 3 == 0 ? i * 937 - 16000 : i));
+    }
+    return frame;
+}
+
+//returns uniformly distributed values in [-1, 1) from a fixed seed
+struct noise
+{
+    std::uint32_t state = 2024;
+
+    double operator()()
+    {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<double>(state) / 2147483648.0 - 1;
+    }
+};
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(rice_codec)
+
+BOOST_AUTO_TEST_CASE(rice_stream_format)
+{
+    //first pixel verbatim, split position 0 (00001), differences 0, 1, -2 mapped to 0, 2, 3
+    //and written as unary codes 1, 001, 0001
+    std::vector<std::int32_t> const pixels = {10, 11, 9};
+    std::vector<unsigned char> const expected = {0, 0, 0, 10, 0x0C, 0x88};
+
+    std::vector<unsigned char> stream;
+    detail::rice_compress<std::int32_t>(pixels.data(), pixels.size(), 32, stream);
+    BOOST_TEST(stream == expected);
+
+    std::vector<std::int32_t> decoded(3);
+    detail::rice_decompress<std::int32_t>(expected.data(), expected.size(), decoded.data(), 3,
+        32);
+    BOOST_TEST(decoded == pixels);
+
+    //block of equal pixels has split position -1 (00000)
+    std::vector<std::int32_t> const flat(40, 5);
+    stream.clear();
+    detail::rice_compress<std::int32_t>(flat.data(), flat.size(), 32, stream);
+    BOOST_TEST(stream.size() == 6u);
+    BOOST_TEST(stream[4] == 0);
+}
+
+BOOST_AUTO_TEST_CASE(rice_round_trip)
+{
+    //smooth, noisy and extreme values with a partial last block
+    std::vector<std::int32_t> values;
+    std::uint32_t state = 12345;
+    for (int i = 0; i < 1000; i++)
+    {
+        state = state * 1103515245u + 12345u;
+        if (i < 300)
+        {
+            values.push_back(i / 7);
+        }
+        else if (i < 600)
+        {
+            values.push_back(static_cast<std::int32_t>(state >> 8) % 200 - 100);
+        }
+        else
+        {
+            values.push_back(static_cast<std::int32_t>(state));
+        }
+    }
+    values.push_back(2147483647);
+    values.push_back(-2147483647 - 1);
+
+    std::vector<unsigned char> stream;
+    detail::rice_compress<std::int32_t>(values.data(), values.size(), 32, stream);
+    std::vector<std::int32_t> decoded(values.size());
+    detail::rice_decompress<std::int32_t>(stream.data(), stream.size(), decoded.data(),
+        decoded.size(), 32);
+    BOOST_TEST(decoded == values);
+
+    std::vector<std::int16_t> shorts;
+    for (std::int32_t value : values)
+    {
+        shorts.push_back(static_cast<std::int16_t>(value));
+    }
+    stream.clear();
+    detail::rice_compress<std::int16_t>(shorts.data(), shorts.size(), 16, stream);
+    std::vector<std::int16_t> decoded_shorts(shorts.size());
+    detail::rice_decompress<std::int16_t>(stream.data(), stream.size(), decoded_shorts.data(),
+        decoded_shorts.size(), 16);
+    BOOST_TEST(decoded_shorts == shorts);
+
+    std::vector<std::uint8_t> bytes;
+    for (std::int32_t value : values)
+    {
+        bytes.push_back(static_cast<std::uint8_t>(value));
+    }
+    stream.clear();
+    detail::rice_compress<std::uint8_t>(bytes.data(), bytes.size(), 32, stream);
+    std::vector<std::uint8_t> decoded_bytes(bytes.size());
+    detail::rice_decompress<std::uint8_t>(stream.data(), stream.size(), decoded_bytes.data(),
+        decoded_bytes.size(), 32);
+    BOOST_TEST(decoded_bytes == bytes);
+
+    //truncated stream
+    stream.resize(stream.size() / 2);
+    BOOST_CHECK_THROW(detail::rice_decompress<std::uint8_t>(stream.data(), stream.size(),
+        decoded_bytes.data(), decoded_bytes.size(), 32),
+        boost::astronomy::invalid_compressed_tile_exception);
+}
+
+BOOST_AUTO_TEST_CASE(dither_random_sequence)
+{
+    //the generator reaches this seed after 10000 values
+    float const* random = detail::dither_random_values();
+    BOOST_TEST(random[0] == static_cast<float>(16807.0 / 2147483647.0));
+    BOOST_TEST(random[9999] == static_cast<float>(1043618065.0 / 2147483647.0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(compressed_image_read)
+
+BOOST_AUTO_TEST_CASE(rice_tiles)
+{
+    temp_file file("compressed_image_rice.fits");
+
+    //tiles of 3 x 2 pixels, the last column and row of tiles are partial
+    tiled<std::int16_t> const frame = test_frame({3, 2});
+    compressed_fixture fixture;
+    fixture.axes = frame.axes;
+    fixture.tile = frame.tile;
+    fixture.cards = {make_card("ZNAME1", "'BLOCKSIZE'"), make_card("ZVAL1", "16"),
+        make_card("ZNAME2", "'BYTEPIX '"), make_card("ZVAL2", "2")};
+    for (std::vector<std::int16_t> const& pixels : frame.tiles())
+    {
+        fixture.compressed.emplace_back();
+        detail::rice_compress<std::int16_t>(pixels.data(), pixels.size(), 16,
+            fixture.compressed.back());
+    }
+    fixture.write(file.path);
+
+    fits compressed(file.path);
+    auto extension = std::dynamic_pointer_cast<compressed_image_extension>(
+        compressed.get_hdu("COMPRESSED_IMAGE"));
+    BOOST_REQUIRE(extension);
+    BOOST_TEST((extension->zbitpix() == bitpix::B16));
+    BOOST_TEST(extension->znaxis() == std::vector<std::size_t>({7, 5}));
+    BOOST_TEST(extension->tiles() == 9u);
+    BOOST_TEST(extension->compression() == "RICE_1");
+
+    image<bitpix::B16> whole = extension->decompress<bitpix::B16>();
+    BOOST_REQUIRE_EQUAL(whole.get_width(), 7u);
+    BOOST_REQUIRE_EQUAL(whole.get_height(), 5u);
+    for (std::size_t p = 0; p < 35; p++)
+    {
+        BOOST_TEST(whole.pixels()[p] == frame.pixels[p]);
+    }
+
+    //strided cutout read from file on a single thread and on all the cores
+    for (std::size_t threads : {std::size_t(1), std::size_t(0)})
+    {
+        image<bitpix::B16> cutout = compressed.read_compressed_image<bitpix::B16>(1,
+            {axis_range(1, 7, 2), axis_range(2, 5)}, threads);
+        BOOST_REQUIRE_EQUAL(cutout.get_width(), 3u);
+        BOOST_REQUIRE_EQUAL(cutout.get_height(), 3u);
+        for (std::size_t y = 0; y < 3; y++)
+        {
+            for (std::size_t x = 0; x < 3; x++)
+            {
+                BOOST_TEST(cutout(y, x) == frame.pixels[(y + 2) * 7 + 1 + 2 * x]);
+            }
+        }
+    }
+
+    BOOST_CHECK_THROW(extension->decompress<bitpix::B32>(), boost::astronomy::wrong_extension_type);
+    BOOST_CHECK_THROW(compressed.read_compressed_image<bitpix::B16>(0),
+        boost::astronomy::wrong_extension_type);
+}
+
+BOOST_AUTO_TEST_CASE(rice_row_tiles_of_cube)
+{
+    temp_file file("compressed_image_cube.fits");
+
+    //default tiles are rows which are decoded straight into the image
+    tiled<std::int32_t> cube;
+    cube.axes = {6, 4, 3};
+    cube.tile = {6, 1, 1};
+    for (int i = 0; i < 72; i++)
+    {
+        cube.pixels.push_back(i * i * 1000 - 50000);
+    }
+
+    compressed_fixture fixture;
+    fixture.zbitpix = 32;
+    fixture.axes = cube.axes;
+    fixture.tile = cube.tile;
+    for (std::vector<std::int32_t> const& pixels : cube.tiles())
+    {
+        fixture.compressed.emplace_back();
+        detail::rice_compress<std::int32_t>(pixels.data(), pixels.size(), 32,
+            fixture.compressed.back());
+    }
+    fixture.write(file.path);
+
+    fits compressed(file.path);
+    image<bitpix::B32> whole = compressed.read_compressed_image<bitpix::B32>(1);
+    BOOST_REQUIRE_EQUAL(whole.get_width(), 6u);
+    BOOST_REQUIRE_EQUAL(whole.get_height(), 12u);
+    for (std::size_t p = 0; p < 72; p++)
+    {
+        BOOST_TEST(whole.pixels()[p] == cube.pixels[p]);
+    }
+
+    //second plane only, only 4 of 12 tiles overlap it
+    image<bitpix::B32> plane = compressed.read_compressed_image<bitpix::B32>(1,
+        {axis_range(0, 6), axis_range(0, 4), axis_range(1, 2)});
+    BOOST_REQUIRE_EQUAL(plane.get_height(), 4u);
+    BOOST_TEST(plane(3, 5) == cube.pixels[24 + 3 * 6 + 5]);
+
+    //corrupted tile
+    fixture.compressed[7].resize(3);
+    fixture.write(file.path);
+    fits corrupted(file.path);
+    BOOST_CHECK_THROW(corrupted.read_compressed_image<bitpix::B32>(1),
+        boost::astronomy::invalid_compressed_tile_exception);
+    BOOST_TEST(corrupted.read_compressed_image<bitpix::B32>(1,
+        {axis_range(0, 6), axis_range(0, 1)}).get_height() == 3u);
+}
+
+BOOST_AUTO_TEST_CASE(quantized_float_tiles)
+{
+    temp_file file("compressed_image_quantized.fits");
+
+    tiled<float> frame;
+    frame.axes = {20, 3};
+    frame.tile = {20, 1};
+    for (int i = 0; i < 60; i++)
+    {
+        frame.pixels.push_back(100.0f + std::sin(static_cast<float>(i)) * 10.0f);
+    }
+
+    //quantize as the writer does, subtracting the dither sequence of every tile
+    compressed_fixture fixture;
+    fixture.zbitpix = -32;
+    fixture.axes = frame.axes;
+    fixture.tile = frame.tile;
+    fixture.cards = {make_card("ZQUANTIZ", "'SUBTRACTIVE_DITHER_1'"),
+        make_card("ZDITHER0", "42")};
+    double const scale = 0.01;
+    std::int32_t const blank = -2147483647;
+    std::vector<std::vector<float>> const tiles = frame.tiles();
+    for (std::size_t t = 0; t < tiles.size(); t++)
+    {
+        double const zero = 100.0 + static_cast<double>(t);
+        detail::dither_sequence dither(t, 42);
+        std::vector<std::int32_t> quantized;
+        for (float value : tiles[t])
+        {
+            double const offset = dither();
+            quantized.push_back(static_cast<std::int32_t>(
+                std::floor((value - zero) / scale + offset - 0.5 + 0.5)));
+        }
+        if (t == 1)
+        {
+            quantized[4] = blank;
+        }
+        fixture.compressed.emplace_back();
+        detail::rice_compress<std::int32_t>(quantized.data(), quantized.size(), 32,
+            fixture.compressed.back());
+        fixture.zscale.push_back(scale);
+        fixture.zzero.push_back(zero);
+        fixture.zblank.push_back(blank);
+    }
+    fixture.write(file.path);
+
+    fits compressed(file.path);
+    image<bitpix::_B32> restored = compressed.read_compressed_image<bitpix::_B32>(1);
+    BOOST_REQUIRE_EQUAL(restored.get_width(), 20u);
+    for (std::size_t p = 0; p < 60; p++)
+    {
+        if (p == 24)
+        {
+            BOOST_TEST(std::isnan(restored.pixels()[p]));
+        }
+        else
+        {
+            BOOST_TEST(std::abs(restored.pixels()[p] - frame.pixels[p]) <= scale / 2 + 1e-4);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(gzip_tiles)
+{
+    temp_file file("compressed_image_gzip.fits");
+
+    tiled<std::int16_t> const frame = test_frame({4, 3});
+    compressed_fixture fixture;
+    fixture.axes = frame.axes;
+    fixture.tile = frame.tile;
+
+    if (!detail::gzip_supported())
+    {
+        fixture.cmptype = "GZIP_1";
+        fixture.compressed.assign(frame.tiles().size(), std::vector<unsigned char>(4, 0));
+        fixture.write(file.path);
+        fits compressed(file.path);
+        BOOST_CHECK_THROW(compressed.read_compressed_image<bitpix::B16>(1),
+            boost::astronomy::unsupported_compression_exception);
+        return;
+    }
+
+    for (std::string const cmptype : {"GZIP_1", "GZIP_2"})
+    {
+        fixture.cmptype = cmptype;
+        fixture.compressed.clear();
+        for (std::vector<std::int16_t> const& pixels : frame.tiles())
+        {
+            std::vector<char> raw;
+            append_big_endian(raw, pixels);
+            std::vector<unsigned char> bytes(raw.begin(), raw.end());
+            if (cmptype == "GZIP_2")
+            {
+                detail::shuffle_bytes(reinterpret_cast<unsigned char const*>(raw.data()),
+                    bytes.data(), pixels.size(), 2);
+            }
+            fixture.compressed.emplace_back();
+            detail::gzip_compress(bytes.data(), bytes.size(), fixture.compressed.back());
+        }
+        fixture.write(file.path);
+
+        fits compressed(file.path);
+        image<bitpix::B16> whole = compressed.read_compressed_image<bitpix::B16>(1);
+        for (std::size_t p = 0; p < 35; p++)
+        {
+            BOOST_TEST(whole.pixels()[p] == frame.pixels[p]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(compressed_image_write)
+
+BOOST_AUTO_TEST_CASE(lossless_integer_images)
+{
+    temp_file file("compressed_image_write_integer.fits");
+
+    noise random;
+    image<bitpix::B16> frame(37, 23);
+    for (std::size_t p = 0; p < 37 * 23; p++)
+    {
+        frame.pixels()[p] = static_cast<std::int16_t>(
+            1000 + static_cast<double>(p % 37) * 3 + random() * 20);
+    }
+    frame.pixels()[100] = -32768;
+    frame.pixels()[101] = 32767;
+    image<bitpix::B32> cube(6, 12);
+    for (std::size_t p = 0; p < 72; p++)
+    {
+        cube.pixels()[p] = static_cast<std::int32_t>(p * p * 100000) - 2000000000;
+    }
+    image<bitpix::B8> mask(10, 4);
+    for (std::size_t p = 0; p < 40; p++)
+    {
+        mask.pixels()[p] = static_cast<std::uint8_t>(p % 5 == 0 ? 255 : 0);
+    }
+
+    {
+        fits_writer writer(file.path);
+        writer.write_primary_hdu();
+        compression_options tiles;
+        tiles.tile = {8, 5};
+        tiles.block_size = 16;
+        writer.write_compressed_image(frame, {card("EXTNAME", "'FRAME   '")}, {}, tiles);
+        writer.write_compressed_image(cube, {}, {6, 4, 3});
+        writer.write_compressed_image(mask);
+    }
+
+    fits compressed(file.path);
+    BOOST_REQUIRE_EQUAL(compressed.size(), 4u);
+    auto extension = std::dynamic_pointer_cast<compressed_image_extension>(
+        compressed.get_hdu("FRAME"));
+    BOOST_REQUIRE(extension);
+    BOOST_TEST(extension->ztile() == std::vector<std::size_t>({8, 5}));
+    BOOST_TEST(extension->tiles() == 25u);
+    image<bitpix::B16> frame_read = extension->decompress<bitpix::B16>();
+    BOOST_TEST(std::equal(frame.pixels(), frame.pixels() + 37 * 23, frame_read.pixels()));
+
+    image<bitpix::B32> cube_read = compressed.read_compressed_image<bitpix::B32>(2);
+    BOOST_TEST(compressed.get_hdu(2)->value_of<std::size_t>("ZNAXIS3") == 3u);
+    BOOST_TEST(std::equal(cube.pixels(), cube.pixels() + 72, cube_read.pixels()));
+
+    image<bitpix::B8> mask_read = compressed.read_compressed_image<bitpix::B8>(3);
+    BOOST_TEST(std::equal(mask.pixels(), mask.pixels() + 40, mask_read.pixels()));
+}
+
+BOOST_AUTO_TEST_CASE(quantized_float_images)
+{
+    temp_file file("compressed_image_write_float.fits");
+
+    //sky with noise of 2, a row of zeros, a few NaN and a constant row
+    noise random;
+    image<bitpix::_B32> sky(50, 8);
+    for (std::size_t p = 0; p < 400; p++)
+    {
+        sky.pixels()[p] = static_cast<float>(
+            500 + static_cast<double>(p % 50) + random() * 3.4);
+    }
+    for (std::size_t x = 0; x < 50; x++)
+    {
+        sky.pixels()[2 * 50 + x] = 0;
+        sky.pixels()[5 * 50 + x] = 7.25f;
+    }
+    sky.pixels()[7 * 50 + 3] = std::numeric_limits<float>::quiet_NaN();
+
+    image<bitpix::_B64> flux(20, 20);
+    for (std::size_t p = 0; p < 400; p++)
+    {
+        flux.pixels()[p] = 1e-3 * static_cast<double>(p) + random();
+    }
+
+    std::future<std::uint64_t> written;
+    {
+        async_fits_writer writer(file.path);
+        writer.write_primary_hdu();
+        compression_options zeros;
+        zeros.preserve_zeros = true;
+        zeros.dither_seed = 17;
+        writer.write_compressed_image(sky, {}, {}, zeros);
+        compression_options step;
+        step.quantize_level = -0.001;
+        step.tile = {20, 20};
+        written = writer.write_compressed_image(flux, {}, {}, step);
+        writer.close();
+    }
+    BOOST_TEST(written.get() > 2880u);
+
+    fits compressed(file.path);
+    auto extension = std::dynamic_pointer_cast<compressed_image_extension>(
+        compressed.get_hdu(1));
+    BOOST_REQUIRE(extension);
+    BOOST_TEST(extension->value_of<std::string>("ZQUANTIZ") == "'SUBTRACTIVE_DITHER_2'");
+    BOOST_TEST(extension->contains("ZBLANK"));
+
+    image<bitpix::_B32> sky_read = extension->decompress<bitpix::_B32>();
+    std::vector<double> const scale =
+        extension->get_column_data<double>("ZSCALE").get_data();
+    for (std::size_t y = 0; y < 8; y++)
+    {
+        //noise of 2 quantized with 4 levels per standard deviation
+        BOOST_TEST((y == 2 || y == 5 || (scale[y] > 0.2 && scale[y] < 1)));
+        for (std::size_t x = 0; x < 50; x++)
+        {
+            float const expected = sky.pixels()[y * 50 + x];
+            float const restored = sky_read.pixels()[y * 50 + x];
+            if (std::isnan(expected))
+            {
+                BOOST_TEST(std::isnan(restored));
+            }
+            else if (y == 2 || y == 5)
+            {
+                //zeros are kept by SUBTRACTIVE_DITHER_2, constant tile is not quantized
+                BOOST_TEST(restored == expected);
+            }
+            else
+            {
+                BOOST_TEST(std::abs(restored - expected) <= scale[y] / 2 + 1e-3);
+            }
+        }
+    }
+
+    image<bitpix::_B64> flux_read = compressed.read_compressed_image<bitpix::_B64>(2);
+    for (std::size_t p = 0; p < 400; p++)
+    {
+        BOOST_TEST(std::abs(flux_read.pixels()[p] - flux.pixels()[p]) <= 0.0005 + 1e-12);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
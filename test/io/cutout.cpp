@@ -0,0 +1,140 @@
+#define BOOST_TEST_MODULE cutout_test
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/fits.hpp>
+#include <boost/astronomy/io/image.hpp>
+
+#include "fits_fixture.hpp"
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+float pixel_value(std::size_t x, std::size_t y, std::size_t p)
+{
+    return static_cast<float>(10000 * p + 100 * y + x) + 0.25f;
+}
+
+//writes a 40 x 30 float image as primary HDU and 9 x 8 x 4 cube as extension
+void write_images(std::string const& path)
+{
+    std::vector<test_hdu> units(2);
+    units[0].cards = image_cards(-32, {40, 30});
+    units[1].cards = image_cards(-32, {9, 8, 4}, "CUBE", false);
+
+    std::vector<float> image;
+    for (std::size_t y = 0; y < 30; y++)
+    {
+        for (std::size_t x = 0; x < 40; x++)
+        {
+            image.push_back(pixel_value(x, y, 0));
+        }
+    }
+    append_big_endian(units[0].data, image);
+
+    std::vector<float> cube;
+    for (std::size_t p = 0; p < 4; p++)
+    {
+        for (std::size_t y = 0; y < 8; y++)
+        {
+            for (std::size_t x = 0; x < 9; x++)
+            {
+                cube.push_back(pixel_value(x, y, p));
+            }
+        }
+    }
+    append_big_endian(units[1].data, cube);
+    write_test_fits(path, units);
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(cutout_read)
+
+BOOST_AUTO_TEST_CASE(fits_read_cutout_image)
+{
+    temp_file file("fits_read_cutout_image.fits");
+    write_images(file.path);
+    fits images(file.path);
+
+    image<bitpix::_B32> stamp = images.read_cutout<bitpix::_B32>(0, {{5, 13}, {20, 26}});
+    for (std::size_t y = 0; y < 6; y++)
+    {
+        for (std::size_t x = 0; x < 8; x++)
+        {
+            BOOST_TEST(stamp(y, x) == pixel_value(5 + x, 20 + y, 0));
+        }
+    }
+    BOOST_TEST(stamp.max() == pixel_value(12, 25, 0));
+
+    //strided along both axes
+    image<bitpix::_B32> binned = images.read_cutout<bitpix::_B32>(0, {{1, 40, 3}, {0, 30, 7}});
+    for (std::size_t y = 0; y < 5; y++)
+    {
+        for (std::size_t x = 0; x < 13; x++)
+        {
+            BOOST_TEST(binned(y, x) == pixel_value(1 + 3 * x, 7 * y, 0));
+        }
+    }
+
+    //whole rows are read together
+    image<bitpix::_B32> rows = images.read_cutout<bitpix::_B32>(0, {{0, 40}, {3, 9}});
+    BOOST_TEST(rows(5, 39) == pixel_value(39, 8, 0));
+
+    BOOST_CHECK_THROW(images.read_cutout<bitpix::_B32>(0, {{0, 41}}),
+        boost::astronomy::invalid_cutout_range_exception);
+    BOOST_CHECK_THROW(images.read_cutout<bitpix::_B32>(0, {{0, 4, 0}}),
+        boost::astronomy::invalid_cutout_range_exception);
+    BOOST_CHECK_THROW(images.read_cutout<bitpix::_B32>(0, {{0, 4}, {0, 4}, {0, 1}}),
+        boost::astronomy::invalid_cutout_range_exception);
+    BOOST_CHECK_THROW(images.read_cutout<bitpix::B16>(0, {}), boost::astronomy::wrong_extension_type);
+}
+
+BOOST_AUTO_TEST_CASE(fits_read_cutout_cube)
+{
+    temp_file file("fits_read_cutout_cube.fits");
+    write_images(file.path);
+    fits images(file.path);
+
+    //every other plane of the cube, columns 2 to 4
+    image<bitpix::_B32> planes = images.read_cutout<bitpix::_B32>(1, {{2, 5}, {0, 8}, {0, 4, 2}});
+    for (std::size_t p = 0; p < 2; p++)
+    {
+        for (std::size_t y = 0; y < 8; y++)
+        {
+            for (std::size_t x = 0; x < 3; x++)
+            {
+                BOOST_TEST(planes(p * 8 + y, x) == pixel_value(2 + x, y, 2 * p));
+            }
+        }
+    }
+
+    //whole planes are contiguous in file
+    image<bitpix::_B32> last = images.read_cutout<bitpix::_B32>(1, {{0, 9}, {0, 8}, {3, 4}});
+    BOOST_TEST(last(7, 8) == pixel_value(8, 7, 3));
+    BOOST_TEST(last(0, 0) == pixel_value(0, 0, 3));
+}
+
+BOOST_AUTO_TEST_CASE(image_buffer_cutout)
+{
+    temp_file file("image_buffer_cutout.fits");
+    write_images(file.path);
+    fits images(file.path);
+
+    image<bitpix::_B32> whole = images.read_cutout<bitpix::_B32>(0, {});
+    image_buffer<float> stamp = whole.cutout({{10, 20, 2}, {4, 7}});
+    for (std::size_t y = 0; y < 3; y++)
+    {
+        for (std::size_t x = 0; x < 5; x++)
+        {
+            BOOST_TEST(stamp(y, x) == pixel_value(10 + 2 * x, 4 + y, 0));
+        }
+    }
+    BOOST_CHECK_THROW(whole.cutout({{10, 9}}), boost::astronomy::invalid_cutout_range_exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
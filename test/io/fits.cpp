@@ -0,0 +1,186 @@
+#define BOOST_TEST_MODULE fits_test
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <memory>
+#include <fstream>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/fits.hpp>
+
+#include "fits_fixture.hpp"
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+//writes primary HDU without data followed by count image extensions named CCD1, CCD2...
+void write_mosaic(std::string const& path, int count)
+{
+    std::vector<test_hdu> units(1);
+    units[0].cards = image_cards(8, {});
+
+    for (int i = 1; i <= count; i++)
+    {
+        test_hdu extension;
+        extension.cards = image_cards(16, {4, 3}, "CCD" + std::to_string(i), false);
+
+        std::vector<std::int16_t> pixels;
+        for (int j = 0; j < 12; j++)
+        {
+            pixels.push_back(static_cast<std::int16_t>(i * 100 + j));
+        }
+        append_big_endian(extension.data, pixels);
+        units.push_back(extension);
+    }
+    write_test_fits(path, units);
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(fits_index)
+
+BOOST_AUTO_TEST_CASE(fits_index_scans_headers)
+{
+    temp_file file("fits_index_scans_headers.fits");
+    write_mosaic(file.path, 5);
+
+    fits mosaic(file.path);
+    BOOST_REQUIRE_EQUAL(mosaic.size(), 6u);
+
+    std::vector<hdu_entry> const& index = mosaic.index();
+    BOOST_TEST(index[0].is_primary());
+    BOOST_TEST(index[0].data_size == 0u);
+    BOOST_TEST(index[1].header_offset == 2880);
+    BOOST_TEST(index[1].data_offset == 2 * 2880);
+    BOOST_TEST(index[1].data_size == 24u);
+    BOOST_TEST(index[5].header_offset == 9 * 2880);
+    BOOST_TEST(index[3].xtension == "IMAGE");
+    BOOST_TEST(index[3].extname == "CCD3");
+    BOOST_TEST((index[3].bitpix_value == bitpix::B16));
+    BOOST_TEST(index[3].naxis[1] == 4u);
+
+    //only primary HDU is read while opening
+    BOOST_TEST(mosaic.is_loaded(0));
+    for (std::size_t i = 1; i < mosaic.size(); i++)
+    {
+        BOOST_TEST(!mosaic.is_loaded(i));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(fits_random_access)
+{
+    temp_file file("fits_random_access.fits");
+    write_mosaic(file.path, 5);
+
+    fits mosaic(file.path);
+
+    auto ccd4 = std::dynamic_pointer_cast<image_extension<bitpix::B16>>(mosaic.get_hdu("CCD4"));
+    BOOST_REQUIRE(ccd4);
+    BOOST_TEST(ccd4->get_data()(0, 0) == 400);
+    BOOST_TEST(ccd4->get_data().max() == 411);
+    BOOST_TEST(mosaic.is_loaded(4));
+    BOOST_TEST(!mosaic.is_loaded(3));
+
+    auto ccd2 = std::dynamic_pointer_cast<image_extension<bitpix::B16>>(mosaic.get_hdu(2));
+    BOOST_REQUIRE(ccd2);
+    BOOST_TEST(ccd2->get_data().min() == 200);
+
+    BOOST_CHECK_THROW(mosaic.find("CCD9"), boost::astronomy::key_not_defined_exception);
+
+    mosaic.read_extensions();
+    BOOST_TEST(mosaic.is_loaded(5));
+}
+
+BOOST_AUTO_TEST_CASE(fits_open_errors)
+{
+    BOOST_CHECK_THROW(fits("fits_open_errors_missing.fits"),
+        boost::astronomy::fits_exception);
+
+    temp_file file("fits_open_errors_empty.fits");
+    std::ofstream(file.path).close();
+    BOOST_CHECK_THROW(fits(file.path), boost::astronomy::fits_exception);
+}
+
+BOOST_AUTO_TEST_CASE(fits_parallel_extensions)
+{
+    temp_file file("fits_parallel_extensions.fits");
+    write_mosaic(file.path, 9);
+
+    fits mosaic(file.path);
+    mosaic.get_hdu(3);
+    mosaic.read_extensions_parallel(4);
+
+    for (std::size_t i = 1; i <= 9; i++)
+    {
+        BOOST_REQUIRE(mosaic.is_loaded(i));
+        auto ccd = std::dynamic_pointer_cast<image_extension<bitpix::B16>>(mosaic.get_hdu(i));
+        BOOST_REQUIRE(ccd);
+        BOOST_TEST(ccd->get_data().min() == static_cast<std::int16_t>(i * 100));
+        BOOST_TEST(ccd->get_data()(2, 3) == static_cast<std::int16_t>(i * 100 + 11));
+        BOOST_TEST(ccd->value_of<std::string>("EXTNAME") == "'CCD" + std::to_string(i) + "'");
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(fits_sidecar)
+
+BOOST_AUTO_TEST_CASE(fits_sidecar_reopen)
+{
+    temp_file file("fits_sidecar_reopen.fits");
+    temp_file sidecar(default_sidecar_path(file.path));
+    write_mosaic(file.path, 4);
+
+    //first open scans the headers and writes the sidecar
+    {
+        fits mosaic(file.path, sidecar.path);
+        BOOST_TEST(mosaic.size() == 5u);
+    }
+
+    std::vector<hdu_entry> saved;
+    BOOST_REQUIRE(read_index_sidecar(sidecar.path, file.path, saved));
+    BOOST_REQUIRE_EQUAL(saved.size(), 5u);
+    BOOST_TEST(saved[2].extname == "CCD2");
+    BOOST_TEST(saved[2].data_offset == 4 * 2880);
+    BOOST_TEST(saved[2].restore_header()->value_of<int>("NAXIS2") == 3);
+    BOOST_TEST(saved[2].restore_header() == saved[2].restore_header());
+
+    fits mosaic(file.path, sidecar.path);
+    BOOST_TEST(mosaic.index()[4].naxis[2] == 3u);
+    auto ccd3 = std::dynamic_pointer_cast<image_extension<bitpix::B16>>(mosaic.get_hdu("CCD3"));
+    BOOST_REQUIRE(ccd3);
+    BOOST_TEST(ccd3->get_data()(2, 3) == 311);
+    BOOST_TEST(ccd3->value_of<std::string>("EXTNAME") == "'CCD3'");
+}
+
+BOOST_AUTO_TEST_CASE(fits_sidecar_stale)
+{
+    temp_file file("fits_sidecar_stale.fits");
+    temp_file sidecar(default_sidecar_path(file.path));
+    write_mosaic(file.path, 2);
+    fits(file.path, sidecar.path);
+
+    //sidecar describing a different file must be ignored and replaced
+    write_mosaic(file.path, 3);
+    fits mosaic(file.path, sidecar.path);
+    BOOST_TEST(mosaic.size() == 4u);
+
+    std::vector<hdu_entry> saved;
+    BOOST_REQUIRE(read_index_sidecar(sidecar.path, file.path, saved));
+    BOOST_TEST(saved.size() == 4u);
+
+    //index scanned before the file changed is not saved
+    boost::astronomy::detail::file_signature scanned;
+    BOOST_REQUIRE(boost::astronomy::detail::get_file_signature(file.path, scanned));
+    write_mosaic(file.path, 1);
+    BOOST_TEST(!write_index_sidecar(sidecar.path, file.path, saved, scanned));
+    BOOST_TEST(!read_index_sidecar(sidecar.path, file.path, saved));
+
+    //corrupt sidecar is rejected
+    std::ofstream(sidecar.path, std::ios_base::out | std::ios_base::binary) << "ASTRFIDX";
+    BOOST_TEST(!read_index_sidecar(sidecar.path, file.path, saved));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
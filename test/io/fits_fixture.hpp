@@ -0,0 +1,126 @@
+#ifndef BOOST_ASTRONOMY_TEST_IO_FITS_FIXTURE_HPP
+#define BOOST_ASTRONOMY_TEST_IO_FITS_FIXTURE_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+
+#include <boost/endian/conversion.hpp>
+
+// helpers used by io tests to create small FITS files on disk
+
+//returns a card of 80 chars with key in first 8 columns and value from column 11
+inline std::string make_card(std::string const& key, std::string const& value = "")
+{
+    std::string card = key;
+    card.resize(8, ' ');
+    if (!value.empty())
+    {
+        card += "= " + value;
+    }
+    card.resize(80, ' ');
+    return card;
+}
+
+//header and data of a single HDU
+struct test_hdu
+{
+    std::vector<std::string> cards;
+    std::vector<char> data;
+};
+
+//appends the values as big-endian bytes
+template <typename T>
+inline void append_big_endian(std::vector<char>& bytes, std::vector<T> const& values)
+{
+    for (T value : values)
+    {
+        char raw[sizeof(T)];
+        std::memcpy(raw, &value, sizeof(T));
+        if (boost::endian::order::native == boost::endian::order::little)
+        {
+            std::reverse(raw, raw + sizeof(T));
+        }
+        bytes.insert(bytes.end(), raw, raw + sizeof(T));
+    }
+}
+
+//cards of a basic image HDU, primary when xtension is empty
+inline std::vector<std::string> image_cards
+(
+    int bitpix,
+    std::vector<std::size_t> const& naxis,
+    std::string const& extname = "",
+    bool primary = true
+)
+{
+    std::vector<std::string> cards;
+    if (primary)
+    {
+        cards.push_back(make_card("SIMPLE", "T"));
+    }
+    else
+    {
+        cards.push_back(make_card("XTENSION", "'IMAGE   '"));
+    }
+    cards.push_back(make_card("BITPIX", std::to_string(bitpix)));
+    cards.push_back(make_card("NAXIS", std::to_string(naxis.size())));
+    for (std::size_t i = 0; i < naxis.size(); i++)
+    {
+        cards.push_back(make_card("NAXIS" + std::to_string(i + 1), std::to_string(naxis[i])));
+    }
+    if (primary)
+    {
+        cards.push_back(make_card("EXTEND", "T"));
+    }
+    else
+    {
+        cards.push_back(make_card("PCOUNT", "0"));
+        cards.push_back(make_card("GCOUNT", "1"));
+    }
+    if (!extname.empty())
+    {
+        cards.push_back(make_card("EXTNAME", "'" + extname + "'"));
+    }
+    return cards;
+}
+
+//writes all the HDU to file padding header and data to 2880 bytes blocks
+inline void write_test_fits(std::string const& path, std::vector<test_hdu> const& units)
+{
+    std::ofstream file(path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    for (test_hdu const& unit : units)
+    {
+        std::string header;
+        for (std::string const& card : unit.cards)
+        {
+            header += card;
+        }
+        header += make_card("END");
+        header.resize(header.size() + (2880 - header.size() % 2880) % 2880, ' ');
+        file.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+        std::vector<char> data = unit.data;
+        data.resize(data.size() + (2880 - data.size() % 2880) % 2880, 0);
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+}
+
+//temporary file removed at the end of the test
+struct temp_file
+{
+    std::string path;
+
+    temp_file(std::string const& name) : path(name) {}
+
+    ~temp_file()
+    {
+        std::remove(path.c_str());
+    }
+};
+
+#endif // !BOOST_ASTRONOMY_TEST_IO_FITS_FIXTURE_HPP
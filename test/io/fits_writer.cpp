@@ -0,0 +1,209 @@
+#define BOOST_TEST_MODULE fits_writer_test
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <memory>
+#include <fstream>
+#include <future>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/fits.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/io/async_fits_writer.hpp>
+
+#include "fits_fixture.hpp"
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+std::uint64_t file_size(std::string const& path)
+{
+    std::ifstream file(path, std::ios_base::in | std::ios_base::binary | std::ios_base::ate);
+    return static_cast<std::uint64_t>(file.tellg());
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(fits_writer_output)
+
+BOOST_AUTO_TEST_CASE(fits_writer_images)
+{
+    temp_file file("fits_writer_images.fits");
+
+    image<bitpix::B16> frame(5, 3);
+    for (std::size_t i = 0; i < 15; i++)
+    {
+        frame.pixels()[i] = static_cast<std::int16_t>(i * 1000 - 7000);
+    }
+    image<bitpix::_B64> cube(4, 6);
+    for (std::size_t i = 0; i < 24; i++)
+    {
+        cube.pixels()[i] = static_cast<double>(i) / 8;
+    }
+
+    {
+        //buffer smaller than a single HDU
+        fits_writer writer(file.path, 1);
+        writer.write_primary_hdu(frame, {card("OBJECT", "'M31     '")});
+        writer.write_image_extension(cube, {card("EXTNAME", "'CUBE    '")}, {4, 3, 2});
+        BOOST_TEST(writer.size() == 3u * 2880 + 192);
+    }
+    BOOST_TEST(file_size(file.path) == 4u * 2880);
+
+    fits result(file.path);
+    BOOST_REQUIRE_EQUAL(result.index().size(), 2u);
+    auto primary = std::dynamic_pointer_cast<primary_hdu<bitpix::B16>>(result.get_hdu(0));
+    BOOST_REQUIRE(primary);
+    BOOST_TEST(primary->is_simple());
+    BOOST_TEST(primary->value_of<std::string>("OBJECT") == "'M31     '");
+    image<bitpix::B16> frame_read = primary->get_data();
+    BOOST_TEST(frame_read.get_width() == 5u);
+    BOOST_TEST(frame_read(2, 4) == 7000);
+
+    auto extension = std::dynamic_pointer_cast<image_extension<bitpix::_B64>>(result.get_hdu(1));
+    BOOST_REQUIRE(extension);
+    BOOST_TEST(extension->naxis() == 3u);
+    BOOST_TEST(extension->naxis(3) == 2u);
+    BOOST_TEST(extension->get_data()(5, 3) == 23.0 / 8);
+}
+
+BOOST_AUTO_TEST_CASE(fits_writer_binary_table)
+{
+    temp_file file("fits_writer_binary_table.fits");
+
+    std::vector<std::unique_ptr<column>> columns;
+    std::unique_ptr<column_data<std::int32_t>> id(new column_data<std::int32_t>(column("1J")));
+    id->TTYPE("ID");
+    id->get_data() = {7, -8, 9};
+    std::unique_ptr<column_data<float>> pos(new column_data<float>(column("2E")));
+    pos->TTYPE("POS");
+    pos->TUNIT("deg");
+    pos->get_data() = {1.5f, -2.5f, 3.0f, 4.0f, 0.25f, 0.0f};
+    std::unique_ptr<column_data<std::string>> name(new column_data<std::string>(column("6A")));
+    name->TTYPE("NAME");
+    name->get_data() = {"vega", "altair", ""};
+    std::unique_ptr<column_data<std::int16_t>> count(new column_data<std::int16_t>(column("I")));
+    count->TTYPE("COUNT");
+    count->TZERO(32768);
+    count->get_data() = {-32768, 0, 32767};
+    columns.push_back(std::move(id));
+    columns.push_back(std::move(pos));
+    columns.push_back(std::move(name));
+    columns.push_back(std::move(count));
+
+    {
+        fits_writer writer(file.path);
+        writer.write_primary_hdu();
+        writer.write_binary_table(columns, {card("EXTNAME", "'STARS   '")});
+    }
+
+    fits result(file.path);
+    auto table = std::dynamic_pointer_cast<binary_table_extension>(result.get_hdu(1));
+    BOOST_REQUIRE(table);
+    BOOST_TEST(table->rows() == 3u);
+    BOOST_TEST(table->row_size() == 20u);
+    BOOST_TEST(table->get_column_metadata("POS").TUNIT() == "deg");
+    BOOST_TEST(table->get_column_data<std::int32_t>("ID").get_data() ==
+        std::vector<std::int32_t>({7, -8, 9}));
+    BOOST_TEST(table->get_column_data<float>("POS").get_data()[4] == 0.25f);
+    BOOST_TEST(table->get_column_data<std::string>("NAME").get_data() ==
+        std::vector<std::string>({"vega", "altair", ""}));
+    BOOST_TEST(table->get_column_data<std::uint16_t>("COUNT").get_data() ==
+        std::vector<std::uint16_t>({0, 32768, 65535}));
+
+    //tables read from file are copied as they are
+    temp_file copy("fits_writer_binary_table_copy.fits");
+    {
+        fits_writer writer(copy.path);
+        writer.write_primary_hdu();
+        writer.write_table_extension(*table);
+    }
+    fits copied(copy.path);
+    auto copied_table = std::dynamic_pointer_cast<binary_table_extension>(copied.get_hdu(1));
+    BOOST_REQUIRE(copied_table);
+    BOOST_TEST(copied_table->get_data() == table->get_data());
+}
+
+BOOST_AUTO_TEST_CASE(fits_writer_invalid_columns)
+{
+    temp_file file("fits_writer_invalid_columns.fits");
+    fits_writer writer(file.path);
+    writer.write_primary_hdu();
+
+    std::vector<std::unique_ptr<column>> columns;
+    columns.emplace_back(new column_data<double>(column("1J")));
+    BOOST_CHECK_THROW(writer.write_binary_table(columns),
+        boost::astronomy::invalid_table_colum_format);
+
+    columns.clear();
+    std::unique_ptr<column_data<double>> x(new column_data<double>(column("1D")));
+    x->get_data() = {1, 2};
+    std::unique_ptr<column_data<double>> y(new column_data<double>(column("1D")));
+    y->get_data() = {1, 2, 3};
+    columns.push_back(std::move(x));
+    columns.push_back(std::move(y));
+    BOOST_CHECK_THROW(writer.write_binary_table(columns),
+        boost::astronomy::invalid_table_colum_format);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(async_fits_writer_output)
+
+BOOST_AUTO_TEST_CASE(async_fits_writer_images)
+{
+    temp_file file("async_fits_writer_images.fits");
+
+    std::vector<std::future<std::uint64_t>> written;
+    {
+        //queue holds a single frame at a time
+        async_fits_writer writer(file.path, 64 * 64 * 4);
+        written.push_back(writer.write_primary_hdu());
+        for (int i = 0; i < 4; i++)
+        {
+            image<bitpix::B32> frame(64, 64);
+            for (std::size_t p = 0; p < 64 * 64; p++)
+            {
+                frame.pixels()[p] = static_cast<std::int32_t>(p) * (i + 1);
+            }
+            written.push_back(writer.write_image_extension(std::move(frame),
+                {card("EXTNAME", "'CCD" + std::to_string(i) + "    '")}));
+        }
+        writer.wait();
+        BOOST_TEST(writer.pending_bytes() == 0u);
+        writer.close();
+    }
+
+    //offsets of HDU in file
+    BOOST_TEST(written[0].get() == 0u);
+    BOOST_TEST(written[1].get() == 2880u);
+    BOOST_TEST(written[2].get() == 2880u + 7 * 2880);
+    BOOST_TEST(file_size(file.path) == 2880u + 4 * 7 * 2880);
+
+    fits result(file.path);
+    BOOST_REQUIRE_EQUAL(result.index().size(), 5u);
+    auto extension = std::dynamic_pointer_cast<image_extension<bitpix::B32>>(result.get_hdu(4));
+    BOOST_REQUIRE(extension);
+    BOOST_TEST(extension->get_data()(63, 63) == 4 * (64 * 64 - 1));
+}
+
+BOOST_AUTO_TEST_CASE(async_fits_writer_error)
+{
+    temp_file file("async_fits_writer_error.fits");
+    async_fits_writer writer(file.path);
+    std::future<std::uint64_t> primary = writer.write_primary_hdu();
+
+    std::vector<std::unique_ptr<column>> columns;
+    columns.emplace_back(new column_data<double>(column("1J")));
+    std::future<std::uint64_t> table = writer.write_binary_table(std::move(columns));
+    std::future<std::uint64_t> image_after = writer.write_image_extension(image<bitpix::B8>(2, 2));
+
+    BOOST_TEST(primary.get() == 0u);
+    BOOST_CHECK_THROW(table.get(), boost::astronomy::invalid_table_colum_format);
+    BOOST_CHECK_THROW(image_after.get(), boost::astronomy::invalid_table_colum_format);
+    BOOST_CHECK_THROW(writer.close(), boost::astronomy::invalid_table_colum_format);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,218 @@
+#define BOOST_TEST_MODULE gzip_stream_test
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <memory>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/detail/gzip.hpp>
+#include <boost/astronomy/io/fits.hpp>
+#include <boost/astronomy/io/fits_writer.hpp>
+#include <boost/astronomy/io/gzip_istream.hpp>
+#include <boost/astronomy/io/image_stream.hpp>
+
+#include "fits_fixture.hpp"
+
+using namespace boost::astronomy::io;
+namespace detail = boost::astronomy::detail;
+
+namespace {
+
+std::vector<unsigned char> read_file(std::string const& path)
+{
+    std::ifstream file(path, std::ios_base::in | std::ios_base::binary);
+    return std::vector<unsigned char>(std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>());
+}
+
+void write_file(std::string const& path, std::vector<unsigned char> const& bytes)
+{
+    std::ofstream file(path, std::ios_base::out | std::ios_base::binary);
+    file.write(reinterpret_cast<char const*>(bytes.data()),
+        static_cast<std::streamsize>(bytes.size()));
+}
+
+//appends bytes compressed as a single gzip member
+void append_member(std::vector<unsigned char>& file, unsigned char const* bytes,
+    std::size_t size)
+{
+    detail::gzip_compress(bytes, size, file);
+}
+
+//compresses bytes as BGZF, members of atmost block bytes whose size is recorded in the BC
+//subfield of the extra field followed by an empty member
+std::vector<unsigned char> bgzf(std::vector<unsigned char> const& bytes, std::size_t block)
+{
+    std::vector<unsigned char> file;
+    for (std::size_t first = 0; first <= bytes.size(); first += block)
+    {
+        std::size_t const size =
+            first < bytes.size() ? std::min(block, bytes.size() - first) : 0;
+        std::vector<unsigned char> member;
+        detail::gzip_compress(bytes.data() + first, size, member);
+
+        //zlib writes a header of 10 bytes without extra field
+        std::size_t const total = member.size() + 8;
+        std::vector<unsigned char> extra = {6, 0, 'B', 'C', 2, 0,
+            static_cast<unsigned char>((total - 1) & 0xFF),
+            static_cast<unsigned char>((total - 1) >> 8)};
+        member[3] |= 4;
+        member.insert(member.begin() + 10, extra.begin(), extra.end());
+        file.insert(file.end(), member.begin(), member.end());
+        if (size == 0)
+        {
+            break;
+        }
+    }
+    return file;
+}
+
+//FITS with an image in primary HDU, an image extension and a binary table
+void write_sample(std::string const& path)
+{
+    image<bitpix::B16> frame(30, 20);
+    for (std::size_t i = 0; i < 600; i++)
+    {
+        frame.pixels()[i] = static_cast<std::int16_t>(i * 7 % 1000);
+    }
+    image<bitpix::_B32> science(64, 48);
+    for (std::size_t i = 0; i < 64 * 48; i++)
+    {
+        science.pixels()[i] = static_cast<float>(i % 97) * 0.5f;
+    }
+    std::vector<std::unique_ptr<column>> columns;
+    std::unique_ptr<column_data<std::int32_t>> id(new column_data<std::int32_t>(column("1J")));
+    id->TTYPE("ID");
+    id->get_data() = {3, 1, 4, 1, 5};
+    columns.push_back(std::move(id));
+
+    fits_writer writer(path);
+    writer.write_primary_hdu(frame);
+    writer.write_image_extension(science, {card("EXTNAME", "'SCI     '")});
+    writer.write_binary_table(columns, {card("EXTNAME", "'CAT     '")});
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(gzip_stream_read)
+
+BOOST_AUTO_TEST_CASE(gzip_istream_members)
+{
+    temp_file plain("gzip_istream_members.fits");
+    temp_file concatenated("gzip_istream_members.fits.gz");
+    temp_file blocked("gzip_istream_members.fits.bgz");
+    write_sample(plain.path);
+    std::vector<unsigned char> const bytes = read_file(plain.path);
+
+    if (!detail::gzip_supported())
+    {
+        write_file(concatenated.path, {0x1f, 0x8b, 8, 0});
+        BOOST_CHECK_THROW(gzip_istream stream(concatenated.path),
+            boost::astronomy::unsupported_compression_exception);
+        return;
+    }
+
+    //two members decompressed one after another and BGZF decompressed in parallel
+    std::vector<unsigned char> members;
+    append_member(members, bytes.data(), 10000);
+    append_member(members, bytes.data() + 10000, bytes.size() - 10000);
+    write_file(concatenated.path, members);
+    write_file(blocked.path, bgzf(bytes, 4000));
+    BOOST_TEST(is_gzip_file(concatenated.path));
+    BOOST_TEST(!is_gzip_file(plain.path));
+
+    for (std::string const& path : {concatenated.path, blocked.path})
+    {
+        //window of two blocks so that it is refilled many times
+        gzip_istream stream(path, 3, 5760);
+        std::vector<unsigned char> const result((std::istreambuf_iterator<char>(stream)),
+            std::istreambuf_iterator<char>());
+        BOOST_TEST(result == bytes);
+
+        stream.clear();
+        stream.seekg(12345);
+        BOOST_TEST(stream.tellg() == 12345);
+        BOOST_TEST(stream.get() == bytes[12345]);
+
+        //forward past the window, back inside the window and back to the beginning
+        stream.seekg(20000);
+        BOOST_TEST(stream.get() == bytes[20000]);
+        stream.seekg(19000);
+        BOOST_TEST(stream.get() == bytes[19000]);
+        stream.seekg(3);
+        BOOST_TEST(stream.get() == bytes[3]);
+        BOOST_TEST(stream.tellg() == 4);
+
+        stream.seekg(0, std::ios_base::end);
+        BOOST_TEST(stream.fail());
+    }
+
+    //truncated file
+    members.resize(members.size() - 100);
+    write_file(concatenated.path, members);
+    gzip_istream truncated(concatenated.path);
+    std::vector<char> buffer(bytes.size());
+    truncated.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    BOOST_TEST(!truncated);
+}
+
+BOOST_AUTO_TEST_CASE(fits_from_gzip)
+{
+    if (!detail::gzip_supported())
+    {
+        return;
+    }
+
+    temp_file plain("fits_from_gzip.fits");
+    temp_file compressed("fits_from_gzip.fits.gz");
+    temp_file blocked("fits_from_gzip.fits.bgz");
+    write_sample(plain.path);
+    std::vector<unsigned char> const bytes = read_file(plain.path);
+    std::vector<unsigned char> member;
+    append_member(member, bytes.data(), bytes.size());
+    write_file(compressed.path, member);
+    write_file(blocked.path, bgzf(bytes, 2880));
+
+    for (std::string const& path : {compressed.path, blocked.path})
+    {
+        fits file(path);
+        BOOST_REQUIRE_EQUAL(file.size(), 3u);
+        BOOST_TEST(file.index()[1].data_offset == 3 * 2880);
+        BOOST_TEST(file.index()[2].extname == "CAT");
+
+        auto primary = std::dynamic_pointer_cast<primary_hdu<bitpix::B16>>(file.get_hdu(0));
+        BOOST_REQUIRE(primary);
+        BOOST_TEST(primary->get_data()(19, 29) == 599 * 7 % 1000);
+
+        //later HDU first so that the file is decompressed again for the earlier one
+        auto table = std::dynamic_pointer_cast<binary_table_extension>(file.get_hdu("CAT"));
+        BOOST_REQUIRE(table);
+        BOOST_TEST(table->get_column_data<std::int32_t>("ID").get_data() ==
+            std::vector<std::int32_t>({3, 1, 4, 1, 5}));
+
+        file.read_extensions_parallel();
+        auto science = std::dynamic_pointer_cast<image_extension<bitpix::_B32>>(
+            file.get_hdu("SCI"));
+        BOOST_REQUIRE(science);
+        BOOST_TEST(science->get_data()(47, 63) == static_cast<float>(3071 % 97) * 0.5f);
+
+        BOOST_CHECK_THROW(file.read_cutout<bitpix::_B32>(1, {axis_range(0, 2)}),
+            boost::astronomy::unsupported_compression_exception);
+
+        image_stream<bitpix::_B32> stream(path, file.index()[1], 64 * 4 * 10);
+        std::size_t rows = 0;
+        stream.for_each_block([&](image_block<float> const& block)
+        {
+            BOOST_TEST(block.row(0)[5] == static_cast<float>((block.first_row * 64 + 5) % 97)
+                * 0.5f);
+            rows += block.rows;
+        });
+        BOOST_TEST(rows == 48u);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
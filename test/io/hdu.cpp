@@ -0,0 +1,117 @@
+#define BOOST_TEST_MODULE hdu_test
+
+#include <string>
+#include <vector>
+#include <limits>
+#include <cstddef>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/hdu.hpp>
+#include <boost/astronomy/io/keyword_index.hpp>
+
+#include "fits_fixture.hpp"
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+//joins the cards and pads them to a complete header block
+std::string header_block(std::vector<std::string> cards)
+{
+    cards.push_back(make_card("END"));
+    std::string block;
+    for (std::string const& header_card : cards)
+    {
+        block += header_card;
+    }
+    block.resize(block.size() + (2880 - block.size() % 2880) % 2880, ' ');
+    return block;
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(hdu_keywords)
+
+BOOST_AUTO_TEST_CASE(hdu_value_of)
+{
+    std::vector<std::string> cards = image_cards(16, {10, 20, 3});
+    cards.push_back(make_card("HISTORY", "first step"));
+    cards.push_back(make_card("CRVAL1", "1.5"));
+    cards.push_back(make_card("CRVAL12", "2.5"));
+    cards.push_back(make_card("HISTORY", "second step"));
+    cards.push_back(make_card("OBJECT", "'M31'"));
+    cards.push_back(make_card("OBJECT", "'M32'"));
+    std::string block = header_block(cards);
+
+    hdu header(block.data(), block.data() + block.size());
+    BOOST_TEST(header.value_of<int>("BITPIX") == 16);
+    BOOST_TEST(header.value_of<int>(std::string("NAXIS3")) == 3);
+    BOOST_TEST(header.value_of<int>("NAXIS", 2) == 20);
+    BOOST_TEST(header.value_of<bool>(keyword::simple));
+    BOOST_TEST(header.value_of<int>(indexed_keyword::naxis, 1) == 10);
+    BOOST_TEST(header.value_of<double>("CRVAL", 12) == 2.5);
+    BOOST_TEST(header.all_naxis() == std::vector<std::size_t>({3, 10, 20, 3}));
+
+    //last of the duplicate cards is used for value
+    BOOST_TEST(header.value_of<std::string>("OBJECT") == "'M32'");
+
+    BOOST_TEST(header.contains("EXTEND"));
+    BOOST_TEST(header.contains(keyword::extend));
+    BOOST_TEST(!header.contains("EXTNAME"));
+    BOOST_TEST(!header.contains(keyword::extname));
+    BOOST_TEST(!header.contains("LONGKEYWORD"));
+    BOOST_CHECK_THROW(header.value_of<int>("GCOUNT"), boost::astronomy::key_not_defined_exception);
+    BOOST_CHECK_THROW(header.value_of<int>("NAXIS", 4), boost::astronomy::key_not_defined_exception);
+    BOOST_CHECK_THROW(header.value_of<int>(indexed_keyword::tform, 1),
+        boost::astronomy::key_not_defined_exception);
+
+    //lookup of missing key does not add it
+    BOOST_TEST(!header.contains("GCOUNT"));
+
+    std::vector<card const*> history = header.cards_of("HISTORY");
+    BOOST_REQUIRE_EQUAL(history.size(), 2u);
+    BOOST_TEST(history[0]->value_with_comment().substr(0, 10) == "first step");
+    BOOST_TEST(history[1]->value_with_comment().substr(0, 11) == "second step");
+    BOOST_TEST(header.get_key_index().count("OBJECT") == 2u);
+    BOOST_TEST(header.cards_of("COMMENT").empty());
+}
+
+BOOST_AUTO_TEST_CASE(keyword_index_growth)
+{
+    //enough keywords to grow the table several times
+    keyword_index index;
+    std::vector<std::string> keys;
+    for (std::size_t i = 1; i <= 500; i++)
+    {
+        keys.push_back(make_card("TFORM" + std::to_string(i)));
+        index.push_back(keys.back().data());
+    }
+    index.push_back(make_card("HISTORY").data());
+    index.push_back(make_card("HISTORY").data());
+
+    BOOST_TEST(index.size() == 501u);
+    BOOST_TEST(index.cards() == 502u);
+
+    std::size_t card_index = 0;
+    for (std::size_t i = 1; i <= 500; i++)
+    {
+        BOOST_REQUIRE(index.find("TFORM" + std::to_string(i), card_index));
+        BOOST_TEST(card_index == i - 1);
+        BOOST_REQUIRE(index.find(indexed_keyword::tform, i, card_index));
+        BOOST_TEST(card_index == i - 1);
+    }
+    BOOST_TEST(!index.find(indexed_keyword::tform, 501, card_index));
+    BOOST_TEST(!index.find("TFORM0", card_index));
+
+    //prefix followed by n longer than a keyword is never found
+    BOOST_TEST(index.find("TFORM", 500, card_index));
+    BOOST_TEST(!index.find("TFORM", 5000, card_index));
+    BOOST_TEST(!index.find("LONGNAME", 1, card_index));
+    BOOST_TEST(!index.find("LONGNAME", std::numeric_limits<std::size_t>::max(), card_index));
+
+    std::vector<std::size_t> history(index.equal_range("HISTORY").begin(),
+        index.equal_range("HISTORY").end());
+    BOOST_TEST(history == std::vector<std::size_t>({500, 501}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,98 @@
+#define BOOST_TEST_MODULE header_scan_test
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <memory>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/header_scan.hpp>
+
+#include "fits_fixture.hpp"
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+//writes a primary HDU with observation keywords followed by an image extension
+void write_observation(std::string const& path, int number, bool with_filter)
+{
+    std::vector<test_hdu> units(2);
+    units[0].cards = image_cards(16, {6, 4});
+    units[0].cards.push_back(make_card("DATE-OBS", "'2019-08-0" + std::to_string(number) + "'"));
+    units[0].cards.push_back(make_card("EXPTIME", std::to_string(number * 10) + ".5D0"));
+    if (with_filter)
+    {
+        units[0].cards.push_back(make_card("FILTER", "'R       '"));
+    }
+    append_big_endian(units[0].data, std::vector<std::int16_t>(24, 7));
+
+    units[1].cards = image_cards(8, {2}, "CCD" + std::to_string(number), false);
+    units[1].data.assign(2, 1);
+    write_test_fits(path, units);
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(header_scan)
+
+BOOST_AUTO_TEST_CASE(scan_headers_columns)
+{
+    std::vector<std::unique_ptr<temp_file>> files;
+    std::vector<std::string> paths;
+    for (int i = 1; i <= 7; i++)
+    {
+        files.emplace_back(new temp_file("scan_headers_" + std::to_string(i) + ".fits"));
+        write_observation(files.back()->path, i, i % 2 == 1);
+        paths.push_back(files.back()->path);
+    }
+    paths.push_back("scan_headers_missing.fits");
+
+    header_query query;
+    query.add<std::string>("DATE-OBS").add<double>("EXPTIME").add<std::string>("FILTER")
+        .add<int>("NAXIS2");
+
+    header_scan_options options;
+    options.threads = 3;
+    options.max_open_files = 2;
+    header_table table = scan_headers(paths, query, options);
+
+    BOOST_REQUIRE_EQUAL(table.rows(), 8u);
+    auto const& date = table.column<std::string>("DATE-OBS");
+    auto const& exptime = table.column<double>("EXPTIME");
+    auto const& filter = table.column<std::string>("FILTER");
+    for (std::size_t row = 0; row < 7; row++)
+    {
+        BOOST_TEST(table.errors()[row].empty());
+        BOOST_TEST(date.values[row] == "2019-08-0" + std::to_string(row + 1));
+        BOOST_TEST(exptime.values[row] == static_cast<double>(row + 1) * 10 + 0.5);
+        BOOST_TEST(table.column<int>("NAXIS2").values[row] == 4);
+        BOOST_TEST(filter.present[row] == (row % 2 == 0 ? 1 : 0));
+    }
+    BOOST_TEST(filter.values[0] == "R");
+
+    BOOST_TEST(!table.errors()[7].empty());
+    BOOST_TEST(date.present[7] == 0);
+
+    BOOST_CHECK_THROW(table.column<int>("OBJECT"), boost::astronomy::key_not_defined_exception);
+    BOOST_CHECK_THROW(table.column<int>("EXPTIME"), std::bad_cast);
+}
+
+BOOST_AUTO_TEST_CASE(scan_headers_extension)
+{
+    temp_file file("scan_headers_extension.fits");
+    write_observation(file.path, 3, false);
+
+    header_query query;
+    query.add<std::string>("EXTNAME").add<std::string>("DATE-OBS");
+
+    header_scan_options options;
+    options.hdu_number = 1;
+    header_table table = scan_headers({file.path}, query, options);
+
+    BOOST_TEST(table.errors()[0].empty());
+    BOOST_TEST(table.column<std::string>("EXTNAME").values[0] == "CCD3");
+    BOOST_TEST(table.column<std::string>("DATE-OBS").present[0] == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,442 @@
+#define BOOST_TEST_MODULE image_test
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <fstream>
+#include <cmath>
+#include <algorithm>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/image.hpp>
+#include <boost/astronomy/io/primary_hdu.hpp>
+#include <boost/astronomy/detail/byteswap.hpp>
+
+#include "fits_fixture.hpp"
+
+using namespace boost::astronomy::io;
+namespace detail = boost::astronomy::detail;
+
+BOOST_AUTO_TEST_SUITE(image_byteswap)
+
+template <typename T>
+void check_roundtrip(std::vector<T> const& values)
+{
+    std::vector<char> bytes;
+    append_big_endian(bytes, values);
+
+    //odd counts exercise the scalar tail after the vectorized body
+    for (std::size_t count = 0; count <= values.size(); count++)
+    {
+        std::vector<T> decoded(count);
+        detail::big_to_native_copy(bytes.data(), decoded.data(), count);
+        BOOST_TEST(std::memcmp(decoded.data(), values.data(), count * sizeof(T)) == 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(byteswap_integers)
+{
+    std::vector<std::int16_t> shorts;
+    std::vector<std::int32_t> ints;
+    for (int i = 0; i < 77; i++)
+    {
+        shorts.push_back(static_cast<std::int16_t>(i * 419 - 16000));
+        ints.push_back(i * 27644437 - 1000000000);
+    }
+    check_roundtrip(shorts);
+    check_roundtrip(ints);
+}
+
+BOOST_AUTO_TEST_CASE(byteswap_floats_bit_exact)
+{
+    std::vector<float> floats = {1.5f, -0.0f, std::numeric_limits<float>::infinity(),
+        std::numeric_limits<float>::denorm_min(), std::numeric_limits<float>::max()};
+    std::vector<double> doubles = {-2.5, 1e-300, std::numeric_limits<double>::lowest()};
+
+    //NaN with a payload must survive unchanged
+    std::uint32_t nan_bits = 0x7fc12345u;
+    float nan;
+    std::memcpy(&nan, &nan_bits, sizeof(float));
+    for (int i = 0; i < 40; i++)
+    {
+        floats.push_back(static_cast<float>(i) * 0.1f);
+        floats.push_back(nan);
+        doubles.push_back(static_cast<double>(i) / 3.0);
+    }
+    check_roundtrip(floats);
+    check_roundtrip(doubles);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(image_read)
+
+BOOST_AUTO_TEST_CASE(read_float_primary_hdu)
+{
+    temp_file file("read_float_primary_hdu.fits");
+
+    test_hdu primary;
+    primary.cards = image_cards(-32, {2, 3});
+    append_big_endian<float>(primary.data, {0.25f, -1.5f, 3.0e10f, 4.0f, -5.5f, 6.0f});
+    write_test_fits(file.path, {primary});
+
+    std::fstream stream(file.path, std::ios_base::in | std::ios_base::binary);
+    primary_hdu<bitpix::_B32> hdu(stream);
+
+    image<bitpix::_B32> data = hdu.get_data();
+    BOOST_TEST(data(0, 0) == 0.25f);
+    BOOST_TEST(data(0, 1) == -1.5f);
+    BOOST_TEST(data(1, 0) == 3.0e10f);
+    BOOST_TEST(data.min() == -5.5f);
+}
+
+BOOST_AUTO_TEST_CASE(read_cube_primary_hdu)
+{
+    temp_file file("read_cube_primary_hdu.fits");
+
+    std::vector<std::int16_t> pixels;
+    for (int i = 0; i < 2 * 3 * 4; i++)
+    {
+        pixels.push_back(static_cast<std::int16_t>(i - 12));
+    }
+
+    test_hdu primary;
+    primary.cards = image_cards(16, {2, 3, 4});
+    append_big_endian(primary.data, pixels);
+    write_test_fits(file.path, {primary});
+
+    std::fstream stream(file.path, std::ios_base::in | std::ios_base::binary);
+    primary_hdu<bitpix::B16> hdu(stream);
+
+    image<bitpix::B16> data = hdu.get_data();
+    BOOST_TEST(data.max() == 11);
+    BOOST_TEST(data.min() == -12);
+    BOOST_TEST(data(11, 1) == 11);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(image_statistics)
+
+BOOST_AUTO_TEST_CASE(masked_statistics_float)
+{
+    //NaN and masked pixels spread over the vectorized body and the scalar tail
+    image<bitpix::_B32> data(13, 7);
+    std::vector<std::uint8_t> mask(91, 0);
+    std::vector<double> valid;
+    for (std::size_t i = 0; i < 91; i++)
+    {
+        data.pixels()[i] = static_cast<float>((i * 37) % 101) * 0.5f + 1000.0f;
+        if (i % 11 == 3)
+        {
+            data.pixels()[i] = std::numeric_limits<float>::quiet_NaN();
+        }
+        else if (i % 7 == 5 || i == 90)
+        {
+            data.pixels()[i] = -1e30f;
+            mask[i] = 1;
+        }
+        else
+        {
+            valid.push_back(data.pixels()[i]);
+        }
+    }
+
+    double mean = 0;
+    for (double value : valid)
+    {
+        mean += value / static_cast<double>(valid.size());
+    }
+    double squares = 0;
+    for (double value : valid)
+    {
+        squares += (value - mean) * (value - mean);
+    }
+
+    pixel_statistics const result = data.statistics(bad_pixels(mask.data()));
+    BOOST_TEST(result.count == valid.size());
+    BOOST_TEST(result.min == *std::min_element(valid.begin(), valid.end()));
+    BOOST_TEST(result.max == *std::max_element(valid.begin(), valid.end()));
+    BOOST_CHECK_CLOSE(result.mean, mean, 1e-9);
+    BOOST_CHECK_CLOSE(result.std_dev, std::sqrt(squares / static_cast<double>(valid.size() - 1)), 1e-9);
+    BOOST_CHECK_CLOSE(data.mean(bad_pixels(mask.data())), mean, 1e-9);
+    BOOST_TEST(data.min(bad_pixels(mask.data())) == 1000.0f);
+
+    std::nth_element(valid.begin(), valid.begin() + valid.size() / 2, valid.end());
+    BOOST_TEST(data.median(bad_pixels(mask.data())) == valid[valid.size() / 2]);
+
+    //without the mask only NaN pixels are left out
+    BOOST_TEST(data.statistics(bad_pixels()).count == 91u - 8u);
+    BOOST_TEST(data.min(bad_pixels()) == -1e30f);
+}
+
+BOOST_AUTO_TEST_CASE(masked_statistics_blank)
+{
+    pixel_scaling scaling;
+    scaling.has_blank = true;
+    scaling.blank = -32768;
+
+    image<bitpix::B16> data(5, 3);
+    for (std::size_t i = 0; i < 15; i++)
+    {
+        data.pixels()[i] = static_cast<std::int16_t>(i % 2 == 0 ? -32768 : i);
+    }
+    pixel_statistics const result = data.statistics(bad_pixels(scaling));
+    BOOST_TEST(result.count == 7u);
+    BOOST_TEST(result.min == 1);
+    BOOST_TEST(data.max(bad_pixels(scaling)) == 13);
+    BOOST_TEST(result.mean == 7);
+    BOOST_CHECK_CLOSE(result.std_dev, std::sqrt(112.0 / 6), 1e-9);
+    BOOST_TEST(data.median(bad_pixels(scaling)) == 7);
+    BOOST_TEST(data.min() == -32768);
+
+    //every pixel bad
+    std::vector<std::uint8_t> mask(15, 1);
+    pixel_statistics const none = data.statistics(bad_pixels(scaling, mask.data()));
+    BOOST_TEST(none.count == 0u);
+    BOOST_TEST(std::isnan(none.mean));
+    BOOST_TEST(std::isnan(data.std_dev(bad_pixels(scaling, mask.data()))));
+
+    image<bitpix::_B32> empty(3, 1);
+    std::fill(empty.pixels(), empty.pixels() + 3, std::numeric_limits<float>::quiet_NaN());
+    BOOST_TEST(std::isnan(empty.min(bad_pixels())));
+    BOOST_TEST(std::isnan(empty.median(bad_pixels())));
+}
+
+BOOST_AUTO_TEST_CASE(masked_statistics_large_offset)
+{
+    //spread small compared to the mean must not be lost to cancellation
+    image<bitpix::_B32> data(1000, 1);
+    for (std::size_t i = 0; i < 1000; i++)
+    {
+        data.pixels()[i] = 1.0e6f + (i % 2 == 0 ? 0.25f : -0.25f);
+    }
+    pixel_statistics const result = data.statistics(bad_pixels());
+    BOOST_TEST(result.mean == 1.0e6);
+    BOOST_CHECK_CLOSE(result.std_dev, 0.25 * std::sqrt(1000.0 / 999), 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(statistics_moments)
+{
+    //skewed values with NaN spread over several blocks of the engine
+    image<bitpix::_B64> data(300, 50);
+    std::vector<double> valid;
+    for (std::size_t i = 0; i < 15000; i++)
+    {
+        double const x = static_cast<double>((i * 7919) % 1000) / 100;
+        data.pixels()[i] = i % 17 == 0 ? std::numeric_limits<double>::quiet_NaN() : x * x + 50;
+        if (i % 17 != 0)
+        {
+            valid.push_back(data.pixels()[i]);
+        }
+    }
+
+    double const n = static_cast<double>(valid.size());
+    double mean = 0;
+    for (double value : valid)
+    {
+        mean += value;
+    }
+    mean /= n;
+    double m2 = 0;
+    double m3 = 0;
+    double m4 = 0;
+    for (double value : valid)
+    {
+        double const d = value - mean;
+        m2 += d * d;
+        m3 += d * d * d;
+        m4 += d * d * d * d;
+    }
+
+    for (std::size_t threads : {1u, 3u})
+    {
+        pixel_statistics const result = data.statistics(bad_pixels(), threads);
+        BOOST_TEST(result.count == valid.size());
+        BOOST_TEST(result.min == 50);
+        BOOST_CHECK_CLOSE(result.mean, mean, 1e-10);
+        BOOST_CHECK_CLOSE(result.variance, m2 / (n - 1), 1e-10);
+        BOOST_CHECK_CLOSE(result.skewness, std::sqrt(n) * m3 / std::pow(m2, 1.5), 1e-8);
+        BOOST_CHECK_CLOSE(result.kurtosis, n * m4 / (m2 * m2) - 3, 1e-8);
+    }
+
+    //equal pixels have no skewness
+    image<bitpix::B8> flat(10, 10);
+    std::fill(flat.pixels(), flat.pixels() + 100, std::uint8_t(7));
+    pixel_statistics const constant = flat.statistics();
+    BOOST_TEST(constant.variance == 0);
+    BOOST_TEST(std::isnan(constant.skewness));
+}
+
+BOOST_AUTO_TEST_CASE(statistics_threads)
+{
+    //large enough to be split among threads, partial results must merge to the same values
+    std::size_t const width = 1024;
+    std::size_t const height = 3 * 1024 + 5;
+    image<bitpix::B16> data(width, height);
+    std::vector<std::uint8_t> mask(width * height, 0);
+    for (std::size_t i = 0; i < width * height; i++)
+    {
+        data.pixels()[i] = static_cast<std::int16_t>((i * 2654435761u) % 20000) - 10000;
+        mask[i] = i % 101 == 0;
+    }
+    data.pixels()[1] = 32767; //outlier first valid pixel
+
+    pixel_statistics const single = data.statistics(bad_pixels(mask.data()), 1);
+    pixel_statistics const parallel = data.statistics(bad_pixels(mask.data()), 4);
+    BOOST_TEST(single.count == parallel.count);
+    BOOST_TEST(single.min == parallel.min);
+    BOOST_TEST(single.max == 32767);
+    BOOST_CHECK_CLOSE(single.mean, parallel.mean, 1e-9);
+    BOOST_CHECK_CLOSE(single.variance, parallel.variance, 1e-9);
+    BOOST_CHECK_CLOSE(single.skewness, parallel.skewness, 1e-7);
+    BOOST_CHECK_CLOSE(single.kurtosis, parallel.kurtosis, 1e-7);
+
+    //std_dev of all the pixels in one pass matches the statistics of an unmasked image
+    BOOST_CHECK_CLOSE(data.std_dev(), data.statistics().std_dev, 1e-9);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+namespace {
+
+//checks median and quantiles of the pixels of data which are not bad against a sorted copy
+//of the valid pixels
+template <bitpix DataType>
+void check_quantiles(image<DataType> const& data, bad_pixels const& bad, std::size_t threads)
+{
+    std::vector<double> valid;
+    detail::pixel_filter const filter = detail::filter_of(bad);
+    for (std::size_t i = 0; i < data.get_width() * data.get_height(); i++)
+    {
+        if (detail::is_valid_pixel(data.pixels(), bad.mask, i, filter))
+        {
+            valid.push_back(static_cast<double>(data.pixels()[i]));
+        }
+    }
+    std::sort(valid.begin(), valid.end());
+    BOOST_REQUIRE(!valid.empty());
+
+    BOOST_TEST(static_cast<double>(data.median(bad, threads)) == valid[valid.size() / 2]);
+    std::vector<double> const q = {0, 0.001, 0.1, 0.25, 0.5, 0.7, 0.999, 1};
+    std::vector<double> const result = data.quantiles(q, bad, threads);
+    for (std::size_t i = 0; i < q.size(); i++)
+    {
+        double const h = q[i] * static_cast<double>(valid.size() - 1);
+        std::size_t const below = static_cast<std::size_t>(std::floor(h));
+        double const weight = h - static_cast<double>(below);
+        double const expected = weight > 0 ?
+            (1 - weight) * valid[below] + weight * valid[below + 1] : valid[below];
+        BOOST_TEST(result[i] == expected);
+        BOOST_TEST(data.quantile(q[i], bad, threads) == expected);
+    }
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(image_quantiles)
+
+BOOST_AUTO_TEST_CASE(quantiles_integers)
+{
+    std::size_t const width = 37;
+    std::size_t const height = 29;
+    std::vector<std::uint8_t> mask(width * height, 0);
+    image<bitpix::B8> bytes(width, height);
+    image<bitpix::B16> words(width, height);
+    image<bitpix::B32> integers(width, height);
+    for (std::size_t i = 0; i < width * height; i++)
+    {
+        std::uint32_t const random = static_cast<std::uint32_t>(i * 2654435761u);
+        bytes.pixels()[i] = static_cast<std::uint8_t>(random >> 24);
+        words.pixels()[i] = static_cast<std::int16_t>(random >> 16);
+        integers.pixels()[i] = static_cast<std::int32_t>(random);
+        mask[i] = i % 7 == 3;
+    }
+    words.pixels()[10] = words.pixels()[20] = -32768;
+    integers.pixels()[5] = std::numeric_limits<std::int32_t>::min();
+    integers.pixels()[6] = std::numeric_limits<std::int32_t>::max();
+
+    check_quantiles(bytes, bad_pixels(), 1);
+    check_quantiles(bytes, bad_pixels(mask.data()), 1);
+    check_quantiles(words, bad_pixels(), 1);
+    check_quantiles(integers, bad_pixels(), 1);
+    check_quantiles(integers, bad_pixels(mask.data()), 1);
+
+    //BLANK pixels are left out
+    pixel_scaling blanked;
+    blanked.has_blank = true;
+    blanked.blank = -32768;
+    check_quantiles(words, bad_pixels(blanked, mask.data()), 1);
+    BOOST_TEST(words.median() == words.median(bad_pixels()));
+}
+
+BOOST_AUTO_TEST_CASE(quantiles_floats)
+{
+    std::size_t const width = 41;
+    std::size_t const height = 23;
+    std::vector<std::uint8_t> mask(width * height, 0);
+    image<bitpix::_B32> floats(width, height);
+    image<bitpix::_B64> doubles(width, height);
+    for (std::size_t i = 0; i < width * height; i++)
+    {
+        double const value = std::sin(static_cast<double>(i) * 0.37) * 1e4 +
+            static_cast<double>(i % 13) * 1e-3;
+        floats.pixels()[i] = static_cast<float>(value);
+        doubles.pixels()[i] = value;
+        mask[i] = i % 11 == 0;
+    }
+    //signed zeros, infinities and NaN, which is left out
+    floats.pixels()[3] = -0.0f;
+    floats.pixels()[4] = 0.0f;
+    floats.pixels()[8] = -std::numeric_limits<float>::infinity();
+    floats.pixels()[9] = std::numeric_limits<float>::quiet_NaN();
+    doubles.pixels()[7] = std::numeric_limits<double>::denorm_min();
+    doubles.pixels()[12] = std::numeric_limits<double>::quiet_NaN();
+    doubles.pixels()[13] = -std::numeric_limits<double>::quiet_NaN();
+
+    check_quantiles(floats, bad_pixels(mask.data()), 1);
+    check_quantiles(doubles, bad_pixels(), 1);
+    check_quantiles(doubles, bad_pixels(mask.data()), 1);
+    BOOST_TEST(!std::isnan(floats.median()));
+    BOOST_TEST(floats.quantile(0) == -std::numeric_limits<double>::infinity());
+}
+
+BOOST_AUTO_TEST_CASE(quantiles_threads)
+{
+    //large enough to be split among threads
+    std::size_t const width = 1024;
+    std::size_t const height = 2 * 1024 + 7;
+    std::vector<std::uint8_t> mask(width * height, 0);
+    image<bitpix::B32> integers(width, height);
+    image<bitpix::_B32> floats(width, height);
+    for (std::size_t i = 0; i < width * height; i++)
+    {
+        std::uint32_t const random = static_cast<std::uint32_t>(i * 2654435761u);
+        integers.pixels()[i] = static_cast<std::int32_t>(random % 100000) - 50000;
+        floats.pixels()[i] = static_cast<float>(random % 1000003) * 0.25f - 1000;
+        mask[i] = i % 97 == 0;
+    }
+    check_quantiles(integers, bad_pixels(mask.data()), 4);
+    check_quantiles(floats, bad_pixels(), 3);
+    BOOST_TEST(floats.median(bad_pixels(), 1) == floats.median(bad_pixels(), 4));
+}
+
+BOOST_AUTO_TEST_CASE(quantiles_invalid)
+{
+    image<bitpix::_B32> data(4, 4);
+    BOOST_CHECK_THROW(data.quantile(-0.1), boost::astronomy::invalid_quantile_exception);
+    BOOST_CHECK_THROW(data.quantile(1.5), boost::astronomy::invalid_quantile_exception);
+    BOOST_CHECK_THROW(data.quantiles({0.5, std::numeric_limits<double>::quiet_NaN()}),
+        boost::astronomy::invalid_quantile_exception);
+
+    //no valid pixel
+    for (std::size_t i = 0; i < 16; i++)
+    {
+        data.pixels()[i] = std::numeric_limits<float>::quiet_NaN();
+    }
+    BOOST_TEST(std::isnan(data.median()));
+    BOOST_TEST(std::isnan(data.quantile(0.25)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,132 @@
+#define BOOST_TEST_MODULE image_stream_test
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/fits.hpp>
+#include <boost/astronomy/io/image_stream.hpp>
+
+#include "fits_fixture.hpp"
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+//pixel value at column x, row y of plane p
+std::int32_t cube_value(std::size_t x, std::size_t y, std::size_t p)
+{
+    return static_cast<std::int32_t>(1000 * p + 10 * y + x) * (p % 2 == 0 ? 1 : -1);
+}
+
+//writes primary HDU without data and a 7 x 5 x 3 cube in an image extension
+void write_cube(std::string const& path)
+{
+    std::vector<test_hdu> units(2);
+    units[0].cards = image_cards(8, {});
+    units[1].cards = image_cards(32, {7, 5, 3}, "CUBE", false);
+
+    std::vector<std::int32_t> pixels;
+    for (std::size_t p = 0; p < 3; p++)
+    {
+        for (std::size_t y = 0; y < 5; y++)
+        {
+            for (std::size_t x = 0; x < 7; x++)
+            {
+                pixels.push_back(cube_value(x, y, p));
+            }
+        }
+    }
+    append_big_endian(units[1].data, pixels);
+    write_test_fits(path, units);
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(image_stream_read)
+
+BOOST_AUTO_TEST_CASE(image_stream_blocks)
+{
+    temp_file file("image_stream_blocks.fits");
+    write_cube(file.path);
+    fits cube(file.path);
+
+    //buffer of 2 rows
+    image_stream<bitpix::B32> stream(file.path, cube.index()[1], 2 * 7 * 4);
+    BOOST_TEST(stream.width() == 7u);
+    BOOST_TEST(stream.plane_rows() == 5u);
+    BOOST_TEST(stream.planes() == 3u);
+    BOOST_TEST(stream.rows() == 15u);
+    BOOST_TEST(stream.block_rows() == 2u);
+
+    std::size_t rows = 0;
+    std::size_t blocks = 0;
+    stream.for_each_block([&](image_block<std::int32_t> const& block)
+    {
+        BOOST_TEST(block.first_row == rows);
+        BOOST_TEST(block.rows <= 2u);
+        for (std::size_t r = 0; r < block.rows; r++)
+        {
+            std::size_t row = block.first_row + r;
+            for (std::size_t x = 0; x < 7; x++)
+            {
+                BOOST_TEST(block.row(r)[x] == cube_value(x, row % 5, row / 5));
+            }
+        }
+        rows += block.rows;
+        blocks++;
+    });
+    BOOST_TEST(rows == 15u);
+    BOOST_TEST(blocks == 8u);
+
+    std::size_t planes = 0;
+    stream.for_each_plane([&](image_block<std::int32_t> const& plane)
+    {
+        BOOST_TEST(plane.rows == 5u);
+        BOOST_TEST(plane.row(4)[6] == cube_value(6, 4, planes));
+        planes++;
+    });
+    BOOST_TEST(planes == 3u);
+
+    BOOST_CHECK_THROW(image_stream<bitpix::B16>(file.path, cube.index()[1]),
+        boost::astronomy::wrong_extension_type);
+}
+
+BOOST_AUTO_TEST_CASE(image_stream_stack_median)
+{
+    temp_file file("image_stream_stack_median.fits");
+    write_cube(file.path);
+    fits cube(file.path);
+
+    //buffer holds a single row of each plane
+    image_stream<bitpix::B32> stream(file.path, cube.index()[1], 3 * 7 * 4);
+
+    std::vector<std::int32_t> median(7 * 5);
+    stream.for_each_stack([&](image_block<std::int32_t> const& stack)
+    {
+        BOOST_TEST(stack.planes == 3u);
+        BOOST_TEST(stack.rows == 1u);
+        for (std::size_t x = 0; x < stack.width; x++)
+        {
+            std::int32_t values[3];
+            for (std::size_t p = 0; p < 3; p++)
+            {
+                values[p] = stack.row(0, p)[x];
+            }
+            std::nth_element(values, values + 1, values + 3);
+            median[stack.first_row * 7 + x] = values[1];
+        }
+    });
+
+    for (std::size_t y = 0; y < 5; y++)
+    {
+        for (std::size_t x = 0; x < 7; x++)
+        {
+            BOOST_TEST(median[y * 7 + x] == cube_value(x, y, 0));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,93 @@
+#define BOOST_TEST_MODULE mapped_fits_test
+
+#include <vector>
+#include <cstdint>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/mapped_fits.hpp>
+
+#include "fits_fixture.hpp"
+
+using namespace boost::astronomy::io;
+
+BOOST_AUTO_TEST_SUITE(mapped_fits_read)
+
+BOOST_AUTO_TEST_CASE(mapped_fits_headers_and_views)
+{
+    temp_file file("mapped_fits_headers_and_views.fits");
+
+    test_hdu primary;
+    primary.cards = image_cards(16, {3, 2});
+    append_big_endian<std::int16_t>(primary.data, {1, -2, 3, 400, -500, 600});
+
+    test_hdu extension;
+    extension.cards = image_cards(-32, {2, 2}, "SCI", false);
+    append_big_endian<float>(extension.data, {1.5f, -2.25f, 3.0e10f, 0.0f});
+
+    write_test_fits(file.path, {primary, extension});
+
+    mapped_fits fits(file.path);
+    BOOST_REQUIRE_EQUAL(fits.size(), 2u);
+    BOOST_TEST((fits.header(0).bitpix() == bitpix::B16));
+    BOOST_TEST((fits.header(1).bitpix() == bitpix::_B32));
+    BOOST_TEST(fits.data_size(0) == 12u);
+    BOOST_TEST(fits.data_size(1) == 16u);
+    BOOST_TEST(fits.data(1) - fits.data(0) == 2 * 2880);
+
+    image_view<bitpix::B16> pixels = fits.image<bitpix::B16>(0);
+    BOOST_TEST(pixels.width() == 3u);
+    BOOST_TEST(pixels.height() == 2u);
+    BOOST_TEST(pixels[1] == -2);
+    BOOST_TEST(pixels(1, 0) == 400);
+
+    image_view<bitpix::_B32> floats = fits.image<bitpix::_B32>(1);
+    BOOST_TEST(floats[0] == 1.5f);
+    BOOST_TEST(floats[1] == -2.25f);
+    BOOST_TEST(floats[2] == 3.0e10f);
+
+    BOOST_CHECK_THROW(fits.image<bitpix::B32>(0), boost::astronomy::fits_exception);
+
+    //header cards are viewed in the mapping
+    header_view cards = fits.header_cards(1);
+    BOOST_REQUIRE_EQUAL(cards.size(), extension.cards.size());
+    for (std::size_t i = 0; i < cards.size(); i++)
+    {
+        BOOST_TEST(cards.text(i) == extension.cards[i]);
+    }
+    BOOST_TEST(cards.key(0) == "XTENSION");
+    BOOST_TEST(cards.text(0).data() == fits.data(0) + 2880);
+    std::size_t naxis2 = 0;
+    BOOST_REQUIRE(cards.find("NAXIS2", naxis2));
+    BOOST_TEST(cards.card(naxis2).value<int>() == 2);
+    BOOST_TEST(!cards.find("END", naxis2));
+    BOOST_TEST(fits.header_cards(0).text(0).data() == fits.data(0) - 2880);
+}
+
+BOOST_AUTO_TEST_CASE(mapped_fits_decode_hdu)
+{
+    temp_file file("mapped_fits_decode_hdu.fits");
+
+    test_hdu primary;
+    primary.cards = image_cards(32, {2, 2});
+    append_big_endian<std::int32_t>(primary.data, {7, -8, 90000, -100000});
+
+    test_hdu extension;
+    extension.cards = image_cards(-64, {3}, "ERR", false);
+    append_big_endian<double>(extension.data, {0.5, -1e300, 2.0});
+
+    write_test_fits(file.path, {primary, extension});
+
+    mapped_fits fits(file.path);
+
+    primary_hdu<bitpix::B32> decoded_primary = fits.read_primary_hdu<bitpix::B32>();
+    BOOST_TEST(decoded_primary.is_simple());
+    BOOST_TEST(decoded_primary.get_data()(1, 1) == -100000);
+    BOOST_TEST(decoded_primary.get_data().max() == 90000);
+
+    image_extension<bitpix::_B64> decoded_extension =
+        fits.read_image_extension<bitpix::_B64>(1);
+    BOOST_TEST(decoded_extension.get_data().min() == -1e300);
+    BOOST_TEST(decoded_extension.get_data()(0, 2) == 2.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
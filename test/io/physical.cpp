@@ -0,0 +1,199 @@
+#define BOOST_TEST_MODULE physical_test
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cmath>
+#include <memory>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/detail/physical.hpp>
+#include <boost/astronomy/io/fits.hpp>
+#include <boost/astronomy/io/mapped_fits.hpp>
+
+#include "fits_fixture.hpp"
+
+using namespace boost::astronomy::io;
+namespace detail = boost::astronomy::detail;
+
+namespace {
+
+//converts the big-endian values with big_to_physical and checks them against expected
+//for counts which are and are not multiples of the vector width
+template <typename Raw, typename Expected>
+void check_conversion(std::vector<Raw> const& values, pixel_scaling const& scaling,
+    Expected expected)
+{
+    std::vector<char> bytes;
+    append_big_endian(bytes, values);
+    for (std::size_t count : {values.size(), values.size() - 1, std::size_t(3)})
+    {
+        std::vector<float> physical(count);
+        detail::big_to_physical<Raw>(bytes.data(), physical.data(), count, scaling);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            if (scaling.has_blank && static_cast<std::int64_t>(values[i]) == scaling.blank)
+            {
+                BOOST_TEST(std::isnan(physical[i]));
+            }
+            else
+            {
+                BOOST_TEST(physical[i] == expected(values[i]));
+            }
+        }
+    }
+}
+
+//unsigned 16 bit image stored with BZERO = 32768 and BLANK
+void write_unsigned_image(std::string const& path, std::vector<std::uint16_t> const& pixels)
+{
+    std::vector<test_hdu> units(2);
+    units[0].cards = image_cards(8, {});
+
+    units[1].cards = image_cards(16, {7, 5}, "RAW", false);
+    units[1].cards.push_back(make_card("BZERO", "32768"));
+    units[1].cards.push_back(make_card("BSCALE", "1.0"));
+    units[1].cards.push_back(make_card("BLANK", "-32768"));
+    std::vector<std::int16_t> stored;
+    for (std::uint16_t pixel : pixels)
+    {
+        stored.push_back(static_cast<std::int16_t>(pixel - 32768));
+    }
+    append_big_endian(units[1].data, stored);
+    write_test_fits(path, units);
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(physical_values)
+
+BOOST_AUTO_TEST_CASE(big_to_physical_integers)
+{
+    //unsigned 16 bit pixels
+    pixel_scaling unsigned_16;
+    unsigned_16.bzero = 32768;
+    std::vector<std::int16_t> words;
+    for (int i = 0; i < 37; i++)
+    {
+        words.push_back(static_cast<std::int16_t>(i * 1771 - 32768));
+    }
+    words[5] = 32767;
+    check_conversion(words, unsigned_16, [](std::int16_t v) { return v + 32768.0f; });
+
+    pixel_scaling scaled;
+    scaled.bscale = 0.5;
+    scaled.bzero = -3;
+    scaled.has_blank = true;
+    scaled.blank = 255;
+    std::vector<std::uint8_t> bytes;
+    for (int i = 0; i < 45; i++)
+    {
+        bytes.push_back(static_cast<std::uint8_t>(i * 37));
+    }
+    bytes[2] = bytes[17] = 255;
+    check_conversion(bytes, scaled, [](std::uint8_t v) { return v * 0.5f - 3; });
+
+    scaled.bscale = 2;
+    scaled.bzero = 10;
+    scaled.blank = -7;
+    std::vector<std::int16_t> blanked(words);
+    blanked[0] = blanked[9] = blanked[36] = -7;
+    check_conversion(blanked, scaled, [](std::int16_t v) { return v * 2.0f + 10; });
+
+    std::vector<std::int32_t> integers;
+    for (int i = 0; i < 19; i++)
+    {
+        integers.push_back(i * 100003 - 900000);
+    }
+    integers[4] = -7;
+    check_conversion(integers, scaled, [](std::int32_t v)
+    {
+        return static_cast<float>(v) * 2.0f + 10;
+    });
+
+    //BLANK which can not be stored in 8 bits marks no pixel
+    scaled.blank = 1000;
+    check_conversion(bytes, scaled, [](std::uint8_t v) { return v * 2.0f + 10; });
+}
+
+BOOST_AUTO_TEST_CASE(big_to_physical_floats)
+{
+    std::vector<float> values = {1.5f, -2.25f, 0.0f, 1e20f, -7.0f};
+    std::vector<char> bytes;
+    append_big_endian(bytes, values);
+
+    //identity scaling only converts byte order, BLANK is ignored for floating point data
+    pixel_scaling identity;
+    std::vector<float> physical(values.size());
+    detail::big_to_physical(bitpix::_B32, bytes.data(), physical.data(), values.size(),
+        identity);
+    BOOST_TEST(physical == values);
+
+    pixel_scaling scaled;
+    scaled.bscale = 4;
+    scaled.bzero = 1;
+    scaled.has_blank = true;
+    scaled.blank = -7;
+    std::vector<double> doubles(values.size());
+    detail::big_to_physical(bitpix::_B32, bytes.data(), doubles.data(), values.size(), scaled);
+    for (std::size_t i = 0; i < values.size(); i++)
+    {
+        BOOST_TEST(doubles[i] == static_cast<double>(values[i]) * 4 + 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(read_physical_image)
+{
+    std::vector<std::uint16_t> pixels(35);
+    for (std::size_t i = 0; i < pixels.size(); i++)
+    {
+        pixels[i] = static_cast<std::uint16_t>(i * 1900 + 7);
+    }
+    pixels[3] = 65535;
+    pixels[12] = 0; //stored as BLANK
+    temp_file file("physical_unsigned.fits");
+    write_unsigned_image(file.path, pixels);
+
+    fits unsigned_fits(file.path);
+    pixel_scaling const scaling = unsigned_fits.get_hdu(1)->scaling();
+    BOOST_TEST(scaling.bzero == 32768);
+    BOOST_TEST(scaling.blank == -32768);
+    BOOST_TEST(!unsigned_fits.get_hdu(0)->scaling().has_blank);
+    BOOST_TEST(unsigned_fits.get_hdu(0)->scaling().is_identity());
+
+    image<bitpix::_B32> values = unsigned_fits.read_physical_image(1);
+    image<bitpix::_B64> precise = unsigned_fits.read_physical_image<bitpix::_B64>(1);
+    BOOST_REQUIRE_EQUAL(values.get_width(), 7u);
+    BOOST_REQUIRE_EQUAL(values.get_height(), 5u);
+    BOOST_TEST(unsigned_fits.read_physical_image(0).get_width() == 0u);
+
+    mapped_fits mapped(file.path);
+    physical_view<> view = mapped.physical_image(1);
+    image<bitpix::_B32> decoded = view.decode();
+    std::vector<float> part(20);
+    view.decode(part.data(), 10, part.size());
+    BOOST_REQUIRE_EQUAL(view.size(), pixels.size());
+
+    for (std::size_t i = 0; i < pixels.size(); i++)
+    {
+        if (i == 12)
+        {
+            BOOST_TEST(std::isnan(values.pixels()[i]));
+            BOOST_TEST(std::isnan(precise.pixels()[i]));
+            BOOST_TEST(std::isnan(view[i]));
+            BOOST_TEST(std::isnan(decoded.pixels()[i]));
+            continue;
+        }
+        BOOST_TEST(values.pixels()[i] == static_cast<float>(pixels[i]));
+        BOOST_TEST(precise.pixels()[i] == static_cast<double>(pixels[i]));
+        BOOST_TEST(view[i] == static_cast<float>(pixels[i]));
+        BOOST_TEST(decoded.pixels()[i] == static_cast<float>(pixels[i]));
+        if (i >= 10 && i < 30)
+        {
+            BOOST_TEST(part[i - 10] == static_cast<float>(pixels[i]));
+        }
+    }
+    BOOST_TEST(view(0, 3) == 65535.0f);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
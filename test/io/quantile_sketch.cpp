@@ -0,0 +1,135 @@
+#define BOOST_TEST_MODULE quantile_sketch_test
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/quantile_sketch.hpp>
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+//fraction of the sorted values which are less than value
+double rank_of(std::vector<double> const& sorted, double value)
+{
+    return static_cast<double>(std::lower_bound(sorted.begin(), sorted.end(), value) -
+        sorted.begin()) / static_cast<double>(sorted.size());
+}
+
+//skewed sky like values, most pixels near the background and a long tail of sources
+std::vector<float> sky_frame(std::size_t pixels, std::uint32_t seed)
+{
+    std::vector<float> frame(pixels);
+    for (std::size_t i = 0; i < pixels; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        double const uniform = (seed >> 8) / static_cast<double>(1u << 24);
+        frame[i] = static_cast<float>(1000 + 20 * std::log(uniform / (1 - uniform)) +
+            (uniform > 0.97 ? 5e4 * (uniform - 0.97) : 0));
+    }
+    return frame;
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(quantile_sketch_accuracy)
+
+BOOST_AUTO_TEST_CASE(streamed_chunks)
+{
+    std::vector<float> const frame = sky_frame(200000, 7);
+    std::vector<double> sorted(frame.begin(), frame.end());
+    std::sort(sorted.begin(), sorted.end());
+
+    //chunks of rows as read from a stream
+    quantile_sketch sketch;
+    for (std::size_t first = 0; first < frame.size(); first += 1000)
+    {
+        sketch.add(frame.data() + first, 1000);
+    }
+    BOOST_TEST(sketch.count() == frame.size());
+    BOOST_TEST(sketch.quantile(0) == sorted.front());
+    BOOST_TEST(sketch.quantile(1) == sorted.back());
+    for (double q : {0.001, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999})
+    {
+        double const estimate = sketch.quantile(q);
+        BOOST_TEST(std::abs(rank_of(sorted, estimate) - q) < 0.005);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(bad_pixels_and_merge)
+{
+    std::vector<float> frame = sky_frame(60000, 11);
+    std::vector<std::uint8_t> mask(frame.size(), 0);
+    std::vector<double> valid;
+    for (std::size_t i = 0; i < frame.size(); i++)
+    {
+        if (i % 10 == 0)
+        {
+            frame[i] = std::numeric_limits<float>::quiet_NaN();
+        }
+        mask[i] = i % 7 == 0;
+        if (i % 10 != 0 && i % 7 != 0)
+        {
+            valid.push_back(frame[i]);
+        }
+    }
+    std::sort(valid.begin(), valid.end());
+
+    //sketches of three parts merged into one
+    quantile_sketch parts[3];
+    std::size_t const part = frame.size() / 3;
+    for (std::size_t p = 0; p < 3; p++)
+    {
+        parts[p].add(frame.data() + p * part, part, bad_pixels(mask.data() + p * part));
+    }
+    quantile_sketch merged;
+    for (quantile_sketch const& sketch : parts)
+    {
+        merged.merge(sketch);
+    }
+    BOOST_TEST(merged.count() == valid.size());
+    for (double q : {0.01, 0.1, 0.5, 0.9, 0.99})
+    {
+        BOOST_TEST(std::abs(rank_of(valid, merged.quantile(q)) - q) < 0.01);
+    }
+
+    //integer pixels with BLANK
+    pixel_scaling scaling;
+    scaling.has_blank = true;
+    scaling.blank = -1;
+    std::vector<std::int16_t> words = {5, -1, 3, -1, 9, 1, 7};
+    quantile_sketch small;
+    small.add(words.data(), words.size(), bad_pixels(scaling));
+    BOOST_TEST(small.count() == 5u);
+    BOOST_TEST(small.quantile(0) == 1);
+    BOOST_TEST(small.quantile(0.5) == 5);
+    BOOST_TEST(small.quantile(1) == 9);
+}
+
+BOOST_AUTO_TEST_CASE(empty_and_invalid)
+{
+    quantile_sketch sketch(50);
+    BOOST_TEST(std::isnan(sketch.quantile(0.5)));
+    sketch.add(std::numeric_limits<double>::quiet_NaN());
+    BOOST_TEST(sketch.count() == 0u);
+    sketch.add(4.0);
+    BOOST_TEST(sketch.quantile(0.3) == 4);
+    BOOST_CHECK_THROW(sketch.quantile(2), boost::astronomy::invalid_quantile_exception);
+
+    //infinities are kept apart from the finite values
+    quantile_sketch infinite;
+    for (int i = 0; i < 10000; i++)
+    {
+        infinite.add(i % 10 == 0 ? -std::numeric_limits<double>::infinity() :
+            i % 10 == 9 ? std::numeric_limits<double>::infinity() : static_cast<double>(i));
+    }
+    BOOST_TEST(infinite.quantile(0.05) == -std::numeric_limits<double>::infinity());
+    BOOST_TEST(infinite.quantile(0.95) == std::numeric_limits<double>::infinity());
+    BOOST_TEST(std::abs(infinite.quantile(0.5) - 5000) < 100);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
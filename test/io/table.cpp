@@ -0,0 +1,408 @@
+#define BOOST_TEST_MODULE table_test
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <complex>
+#include <cmath>
+#include <memory>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/astronomy/io/fits.hpp>
+#include <boost/astronomy/io/mapped_fits.hpp>
+#include <boost/astronomy/io/binary_table_extension.hpp>
+#include <boost/astronomy/io/ascii_table_extension.hpp>
+
+#include "fits_fixture.hpp"
+
+using namespace boost::astronomy::io;
+
+namespace {
+
+template <typename T>
+void append_field(std::vector<char>& row, T value)
+{
+    append_big_endian(row, std::vector<T>{value});
+}
+
+//cards of a table extension with given TFORMn and TTYPEn
+std::vector<std::string> table_cards
+(
+    std::string const& xtension,
+    std::size_t row_size,
+    std::size_t rows,
+    std::vector<std::string> const& names,
+    std::vector<std::string> const& formats,
+    std::size_t pcount = 0
+)
+{
+    std::vector<std::string> cards;
+    cards.push_back(make_card("XTENSION", "'" + xtension + "'"));
+    cards.push_back(make_card("BITPIX", "8"));
+    cards.push_back(make_card("NAXIS", "2"));
+    cards.push_back(make_card("NAXIS1", std::to_string(row_size)));
+    cards.push_back(make_card("NAXIS2", std::to_string(rows)));
+    cards.push_back(make_card("PCOUNT", std::to_string(pcount)));
+    cards.push_back(make_card("GCOUNT", "1"));
+    cards.push_back(make_card("TFIELDS", std::to_string(names.size())));
+    for (std::size_t i = 0; i < names.size(); i++)
+    {
+        cards.push_back(make_card("TTYPE" + std::to_string(i + 1), "'" + names[i] + "'"));
+        cards.push_back(make_card("TFORM" + std::to_string(i + 1), "'" + formats[i] + "'"));
+    }
+    return cards;
+}
+
+//primary HDU without data followed by a binary table of 5 rows
+void write_catalog(std::string const& path)
+{
+    std::vector<test_hdu> units(2);
+    units[0].cards = image_cards(8, {});
+    units[1].cards = table_cards("BINTABLE", 44, 5,
+        {"ID", "MAG", "POS", "NAME", "FLAG", "COUNT", "BITS", "Z"},
+        {"1J", "1E", "2D", "8A", "1L", "1I", "3X", "1C"});
+    units[1].cards.push_back(make_card("TSCAL2", "2.0"));
+    units[1].cards.push_back(make_card("TZERO6", "32768"));
+    units[1].cards.push_back(make_card("TUNIT2", "'mag     '"));
+    units[1].cards.push_back(make_card("EXTNAME", "'CATALOG'"));
+
+    for (int r = 0; r < 5; r++)
+    {
+        std::vector<char>& data = units[1].data;
+        append_field<std::int32_t>(data, 1000 + r);
+        append_field<float>(data, 10.5f + static_cast<float>(r));
+        append_field<double>(data, r * 0.25);
+        append_field<double>(data, -r * 0.5);
+        std::string name = "star" + std::to_string(r);
+        name.resize(8, r % 2 == 0 ? ' ' : '\0');
+        data.insert(data.end(), name.begin(), name.end());
+        data.push_back(r % 2 == 0 ? 'T' : 'F');
+        append_field<std::int16_t>(data, static_cast<std::int16_t>(r * 10000 - 32768));
+        data.push_back(static_cast<char>(r << 5));
+        append_field<float>(data, static_cast<float>(r));
+        append_field<float>(data, -1.0f);
+    }
+    write_test_fits(path, units);
+}
+
+//primary HDU without data followed by a binary table of 3 rows with variable length arrays
+void write_spectra(std::string const& path)
+{
+    std::vector<std::vector<float>> const flux = {{1.5f, 2.5f, 3.5f}, {}, {-1, -2, -3, -4}};
+    std::vector<std::vector<double>> const times = {{0.25}, {1e10, -7}, {}};
+    std::vector<std::string> const labels = {"ab", "", "xyz"};
+
+    std::vector<test_hdu> units(2);
+    units[0].cards = image_cards(8, {});
+
+    std::vector<char> heap;
+    std::vector<char>& data = units[1].data;
+    for (std::size_t r = 0; r < 3; r++)
+    {
+        append_field<std::int32_t>(data, static_cast<std::int32_t>(r));
+
+        append_field<std::uint32_t>(data, static_cast<std::uint32_t>(flux[r].size()));
+        append_field<std::uint32_t>(data, static_cast<std::uint32_t>(heap.size()));
+        append_big_endian(heap, flux[r]);
+
+        append_field<std::uint64_t>(data, times[r].size());
+        append_field<std::uint64_t>(data, heap.size());
+        append_big_endian(heap, times[r]);
+
+        append_field<std::uint32_t>(data, static_cast<std::uint32_t>(labels[r].size()));
+        append_field<std::uint32_t>(data, static_cast<std::uint32_t>(heap.size()));
+        heap.insert(heap.end(), labels[r].begin(), labels[r].end());
+    }
+
+    //gap of 8 bytes between main table and heap
+    units[1].cards = table_cards("BINTABLE", 36, 3, {"ID", "FLUX", "TIME", "LABEL"},
+        {"1J", "1PE(4)", "1QD(3)", "PA(5)"}, heap.size() + 8);
+    units[1].cards.push_back(make_card("THEAP", std::to_string(data.size() + 8)));
+    data.resize(data.size() + 8, 0);
+    data.insert(data.end(), heap.begin(), heap.end());
+    write_test_fits(path, units);
+}
+
+//primary HDU without data followed by an ASCII table of 3 rows
+void write_ascii_catalog(std::string const& path)
+{
+    std::vector<test_hdu> units(2);
+    units[0].cards = image_cards(8, {});
+    units[1].cards = table_cards("TABLE", 40, 3,
+        {"NAME", "ID", "RA", "FLUX"}, {"A8", "I6", "F10.4", "E12.4"});
+    units[1].cards.push_back(make_card("TBCOL1", "1"));
+    units[1].cards.push_back(make_card("TBCOL2", "10"));
+    units[1].cards.push_back(make_card("TBCOL3", "17"));
+    units[1].cards.push_back(make_card("TBCOL4", "28"));
+    units[1].cards.push_back(make_card("TZERO2", "1000"));
+    units[1].cards.push_back(make_card("TNULL4", "'-99     '"));
+
+    std::string const rows =
+        "star0       100   123.4567   1.2345E+01 "
+        "star1              1234567          -99 "
+        "             -7       -0.5      1.5D-03 ";
+    units[1].data.assign(rows.begin(), rows.end());
+    write_test_fits(path, units);
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(binary_table)
+
+BOOST_AUTO_TEST_CASE(binary_table_metadata)
+{
+    temp_file file("binary_table_metadata.fits");
+    write_catalog(file.path);
+    fits catalog(file.path);
+
+    auto table = std::dynamic_pointer_cast<binary_table_extension>(catalog.get_hdu("CATALOG"));
+    BOOST_REQUIRE(table);
+    BOOST_TEST(table->rows() == 5u);
+    BOOST_TEST(table->row_size() == 44u);
+    BOOST_REQUIRE_EQUAL(table->get_columns().size(), 8u);
+
+    column const& pos = table->get_column_metadata("POS");
+    BOOST_TEST(pos.index() == 3u);
+    BOOST_TEST(pos.repeat() == 2u);
+    BOOST_TEST(pos.type() == 'D');
+    BOOST_TEST(pos.offset() == 8u);
+    BOOST_TEST(pos.width() == 16u);
+    BOOST_TEST(table->get_column_metadata("BITS").width() == 1u);
+    BOOST_TEST(table->get_column_metadata("MAG").TSCAL() == 2.0);
+    BOOST_TEST(table->get_column_metadata("MAG").TUNIT() == "mag");
+    BOOST_TEST(table->get_column_metadata("COUNT").TZERO() == 32768.0);
+    BOOST_TEST(table->get_column_metadata("ID").TZERO() == 0.0);
+    BOOST_CHECK_THROW(table->get_column_metadata("RA"), boost::astronomy::key_not_defined_exception);
+}
+
+BOOST_AUTO_TEST_CASE(binary_table_columns)
+{
+    temp_file file("binary_table_columns.fits");
+    write_catalog(file.path);
+    fits catalog(file.path);
+    auto table = std::dynamic_pointer_cast<binary_table_extension>(catalog.get_hdu(1));
+    BOOST_REQUIRE(table);
+
+    std::vector<std::int32_t> id = table->get_column_data<std::int32_t>("ID").get_data();
+    BOOST_TEST(id == std::vector<std::int32_t>({1000, 1001, 1002, 1003, 1004}));
+
+    std::vector<double> pos = table->get_column_data<double>("POS").get_data();
+    BOOST_REQUIRE_EQUAL(pos.size(), 10u);
+    BOOST_TEST(pos[6] == 0.75);
+    BOOST_TEST(pos[7] == -1.5);
+
+    std::vector<std::string> name = table->get_column_data<std::string>("NAME").get_data();
+    BOOST_TEST(name[0] == "star0");
+    BOOST_TEST(name[3] == "star3");
+
+    std::vector<bool> flag = table->get_column_data<bool>("FLAG").get_data();
+    BOOST_TEST(flag == std::vector<bool>({true, false, true, false, true}));
+
+    std::vector<std::uint8_t> bits = table->get_column_data<std::uint8_t>("BITS").get_data();
+    BOOST_TEST(bits[3] == 96);
+
+    std::vector<std::complex<float>> z = table->get_column_data<std::complex<float>>("Z").get_data();
+    BOOST_TEST(z[4].real() == 4.0f);
+    BOOST_TEST(z[4].imag() == -1.0f);
+
+    //physical values
+    std::vector<std::uint16_t> count = table->get_column_data<std::uint16_t>("COUNT").get_data();
+    BOOST_TEST(count[4] == 40000);
+    std::vector<double> mag = table->get_column_data<double>("MAG").get_data();
+    BOOST_TEST(mag[1] == 23.0);
+
+    //numeric columns read as logical values are true where the stored value is not 0
+    std::vector<bool> nonzero = table->get_column_data<bool>("ID").get_data();
+    BOOST_TEST(nonzero == std::vector<bool>(5, true));
+
+    BOOST_CHECK_THROW(table->get_column_data<int>("NAME"), boost::astronomy::invalid_table_colum_format);
+
+    std::unique_ptr<column> erased = table->get_column("MAG");
+    auto* values = dynamic_cast<column_data<float>*>(erased.get());
+    BOOST_REQUIRE(values);
+    BOOST_TEST(values->get_data()[2] == 12.5f);
+}
+
+BOOST_AUTO_TEST_CASE(binary_table_projection)
+{
+    temp_file file("binary_table_projection.fits");
+    write_catalog(file.path);
+    fits catalog(file.path);
+
+    //columns are read from file in blocks of 2 rows without reading the table HDU
+    binary_table_extension header(*catalog.index()[1].header);
+    std::vector<std::unique_ptr<column>> columns =
+        header.read_columns(file_source(file.path),
+            catalog.index()[1].data_offset, {"Z", "ID"}, 100);
+    BOOST_REQUIRE_EQUAL(columns.size(), 2u);
+    BOOST_TEST(columns[0]->TTYPE() == "Z");
+    BOOST_TEST(dynamic_cast<column_data<std::complex<float>>&>(*columns[0]).get_data().size() == 5u);
+    BOOST_TEST(dynamic_cast<column_data<std::int32_t>&>(*columns[1]).get_data()[4] == 1004);
+
+    std::vector<std::unique_ptr<column>> all = catalog.read_table_columns(1);
+    BOOST_REQUIRE_EQUAL(all.size(), 8u);
+    BOOST_TEST(dynamic_cast<column_data<std::string>&>(*all[3]).get_data()[2] == "star2");
+    BOOST_TEST(!catalog.is_loaded(1));
+
+    BOOST_CHECK_THROW(catalog.read_table_columns(0), boost::astronomy::wrong_extension_type);
+}
+
+BOOST_AUTO_TEST_CASE(binary_table_scan)
+{
+    temp_file file("binary_table_scan.fits");
+    write_catalog(file.path);
+    fits catalog(file.path);
+
+    //physical MAG is 21, 23, 25, 27, 29 and COUNT is 0, 10000, 20000, 30000, 40000
+    std::vector<column_predicate> const predicates = {
+        column_predicate("MAG", comparison::less, 26),
+        column_predicate("COUNT", comparison::not_equal, 10000)};
+
+    std::vector<std::unique_ptr<column>> columns =
+        catalog.scan_table(1, predicates, {"ID", "NAME"});
+    BOOST_REQUIRE_EQUAL(columns.size(), 2u);
+    BOOST_TEST(dynamic_cast<column_data<std::int32_t>&>(*columns[0]).get_data() ==
+        std::vector<std::int32_t>({1000, 1002}));
+    BOOST_TEST(dynamic_cast<column_data<std::string>&>(*columns[1]).get_data() ==
+        std::vector<std::string>({"star0", "star2"}));
+
+    //rows are scanned one at a time from the data unit read
+    auto table = std::dynamic_pointer_cast<binary_table_extension>(catalog.get_hdu(1));
+    BOOST_REQUIRE(table);
+    columns = table->scan({column_predicate("ID", comparison::greater_equal, 1003)}, {"POS"}, 1);
+    BOOST_TEST(dynamic_cast<column_data<double>&>(*columns[0]).get_data() ==
+        std::vector<double>({0.75, -1.5, 1.0, -2.0}));
+
+    columns = table->scan({column_predicate("MAG", comparison::equal, 22)}, {});
+    BOOST_REQUIRE_EQUAL(columns.size(), 8u);
+    BOOST_TEST(dynamic_cast<column_data<std::int32_t>&>(*columns[0]).get_data().empty());
+
+    BOOST_CHECK_THROW(table->scan({column_predicate("NAME", comparison::equal, 0)}, {}),
+        boost::astronomy::invalid_table_colum_format);
+}
+
+BOOST_AUTO_TEST_CASE(binary_table_variable_length_arrays)
+{
+    temp_file file("binary_table_variable_length_arrays.fits");
+    write_spectra(file.path);
+    fits spectra(file.path);
+
+    auto table = std::dynamic_pointer_cast<binary_table_extension>(spectra.get_hdu(1));
+    BOOST_REQUIRE(table);
+    column const& flux_metadata = table->get_column_metadata("FLUX");
+    BOOST_TEST(flux_metadata.type() == 'P');
+    BOOST_TEST(flux_metadata.array_type() == 'E');
+    BOOST_TEST(flux_metadata.max_length() == 4u);
+    BOOST_TEST(table->heap_offset() == 116u);
+
+    variable_length_column<float> flux = table->get_array_column<float>("FLUX");
+    BOOST_REQUIRE_EQUAL(flux.size(), 3u);
+    BOOST_TEST(flux[0].size() == 3u);
+    BOOST_TEST(flux[0][2] == 3.5f);
+    BOOST_TEST(flux[1].empty());
+    float decoded[4];
+    flux[2].decode(decoded);
+    BOOST_TEST(decoded[3] == -4.0f);
+
+    variable_length_column<double> times = table->get_array_column<double>("TIME");
+    BOOST_TEST(times[0][0] == 0.25);
+    BOOST_TEST(times[1].size() == 2u);
+    BOOST_TEST(times[1][1] == -7.0);
+
+    variable_length_column<char> labels = table->get_array_column<char>("LABEL");
+    BOOST_TEST(std::string(labels[2].bytes(), labels[2].size()) == "xyz");
+
+    BOOST_CHECK_THROW(table->get_array_column<double>("FLUX"),
+        boost::astronomy::invalid_table_colum_format);
+    BOOST_CHECK_THROW(table->get_array_column<std::int32_t>("ID"),
+        boost::astronomy::invalid_table_colum_format);
+
+    //descriptors are decoded as element count followed by heap offset
+    std::vector<std::uint32_t> descriptors =
+        table->get_column_data<std::uint32_t>("FLUX").get_data();
+    BOOST_TEST(descriptors == std::vector<std::uint32_t>({3, 0, 0, 22, 4, 38}));
+}
+
+BOOST_AUTO_TEST_CASE(binary_table_mapped_variable_length_arrays)
+{
+    temp_file file("binary_table_mapped_variable_length_arrays.fits");
+    write_spectra(file.path);
+    mapped_fits spectra(file.path);
+
+    variable_length_column<float> flux = spectra.array_column<float>(1, "FLUX");
+    BOOST_TEST(flux[2][0] == -1.0f);
+    BOOST_TEST(flux[0].bytes() == spectra.data(1) + 116);
+    BOOST_TEST(spectra.array_column<double>(1, "TIME")[1][0] == 1e10);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(ascii_table)
+
+BOOST_AUTO_TEST_CASE(ascii_table_columns)
+{
+    temp_file file("ascii_table_columns.fits");
+    write_ascii_catalog(file.path);
+    fits catalog(file.path);
+
+    auto table = std::dynamic_pointer_cast<ascii_table_extension>(catalog.get_hdu(1));
+    BOOST_REQUIRE(table);
+    BOOST_TEST(table->rows() == 3u);
+    BOOST_TEST(table->get_column_metadata("RA").offset() == 16u);
+    BOOST_TEST(table->get_column_metadata("RA").width() == 10u);
+
+    std::vector<std::string> name = table->get_column_data<std::string>("NAME").get_data();
+    BOOST_TEST(name == std::vector<std::string>({"star0", "star1", ""}));
+
+    std::vector<std::int64_t> id = table->get_column_data<std::int64_t>("ID").get_data();
+    BOOST_TEST(id == std::vector<std::int64_t>({100, 0, -7}));
+
+    //implied decimal point
+    std::vector<double> ra = table->get_column_data<double>("RA").get_data();
+    BOOST_TEST(ra[0] == 123.4567);
+    BOOST_TEST(ra[1] == 123.4567);
+    BOOST_TEST(ra[2] == -0.5);
+
+    std::vector<double> flux = table->get_column_data<double>("FLUX").get_data();
+    BOOST_TEST(flux[0] == 12.345);
+    BOOST_TEST(std::isnan(flux[1]));
+    BOOST_TEST(flux[2] == 0.0015);
+
+    //physical values
+    std::vector<int> physical_id = table->get_column_data<int>("ID").get_data();
+    BOOST_TEST(physical_id == std::vector<int>({1100, 1000, 993}));
+    std::vector<float> flux_float = table->get_column_data<float>("FLUX").get_data();
+    BOOST_TEST(flux_float[0] == 12.345f);
+}
+
+BOOST_AUTO_TEST_CASE(ascii_table_projection)
+{
+    temp_file file("ascii_table_projection.fits");
+    write_ascii_catalog(file.path);
+    fits catalog(file.path);
+
+    std::vector<std::unique_ptr<column>> columns = catalog.read_table_columns(1, {"FLUX", "ID"});
+    BOOST_REQUIRE_EQUAL(columns.size(), 2u);
+    BOOST_TEST(dynamic_cast<column_data<double>&>(*columns[0]).get_data()[2] == 0.0015);
+    BOOST_TEST(dynamic_cast<column_data<std::int64_t>&>(*columns[1]).get_data()[0] == 100);
+
+    //rows are read one at a time
+    ascii_table_extension header(*catalog.index()[1].header);
+    columns = header.read_columns(file_source(file.path),
+        catalog.index()[1].data_offset, {"NAME"}, 1);
+    BOOST_TEST(dynamic_cast<column_data<std::string>&>(*columns[0]).get_data()[1] == "star1");
+}
+
+BOOST_AUTO_TEST_CASE(ascii_table_invalid_field)
+{
+    std::vector<char> row(10, ' ');
+    row[2] = '1';
+    row[3] = 'x';
+    boost::astronomy::detail::ascii_field_format format;
+    format.width = 10;
+    std::vector<std::int64_t> values;
+    BOOST_CHECK_THROW(boost::astronomy::detail::decode_ascii_rows(row.data(), 1, 10, format, values),
+        boost::astronomy::invalid_table_field_exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()